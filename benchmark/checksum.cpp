@@ -0,0 +1,67 @@
+/**
+ * @file checksum.cpp
+ * @brief Cost of CRC32 trailer: time of ArrayBuffer::decodeArrayBuffer on plain messages and on the same
+ * messages with ARRAY_BUFFER_CHECKED_MARK and trailer, and throughput of mycrypto::CRC32 alone.
+ *
+ * CRC32结尾的开销：ArrayBuffer::decodeArrayBuffer 解码普通消息和带有 ARRAY_BUFFER_CHECKED_MARK 及结尾的
+ * 同样消息的耗时，以及单独的 mycrypto::CRC32 的吞吐量。
+ */
+#include "common.h"
+
+#define ROUNDS 20000
+
+static std::vector<uint8_t> addTrailer(const std::vector<uint8_t> &plain)
+{
+    std::vector<uint8_t> checked(1, ARRAY_BUFFER_CHECKED_MARK);
+    checked.insert(checked.end(), plain.begin(), plain.end());
+    uint32_t crc = mycrypto::CRC32::checksum(checked.data(), checked.size());
+    checked.insert(checked.end(), (uint8_t *)&crc, (uint8_t *)&crc + 4);
+    return checked;
+}
+
+static double decodeNs(std::vector<uint8_t> &buffer)
+{
+    uint64_t start = benchmark::nowNs();
+    for (int i = 0; i < ROUNDS; ++i)
+    {
+        Elements *output = ArrayBuffer::decodeArrayBuffer(buffer.data(), buffer.size());
+        benchmark::doNotOptimize(output);
+        for (auto it = output->begin(); it != output->end(); ++it)
+            delete (*it);
+        delete output;
+    }
+    return (double)(benchmark::nowNs() - start) / ROUNDS;
+}
+
+int main()
+{
+    printf("%-16s %8s %12s %14s %10s\n", "message", "bytes", "plain, ns", "checked, ns", "crc, MB/s");
+
+    std::vector<benchmark::Message> messages = benchmark::messages();
+
+    // ota data block, long payload
+    // ota数据块，较长的数据
+    std::vector<uint8_t> block(4096);
+    for (uint32_t i = 0; i < block.size(); ++i)
+        block[i] = (uint8_t)i;
+    messages.push_back({"ota_block",
+                        benchmark::encode({Element((uint8_t)0xac), Element(block.data(), (uint32_t)32),
+                                           Element(block.data(), (uint32_t)block.size()), Element((uint32_t)7)})});
+
+    for (auto &m : messages)
+    {
+        std::vector<uint8_t> checked = addTrailer(m.buffer);
+
+        uint64_t start = benchmark::nowNs();
+        uint32_t crc = 0;
+        for (int i = 0; i < ROUNDS; ++i)
+            crc ^= mycrypto::CRC32::checksum(checked.data(), checked.size() - 4);
+        benchmark::doNotOptimize(crc);
+        uint64_t crcNs = benchmark::nowNs() - start;
+
+        printf("%-16s %8u %12.1f %14.1f %10.1f\n", m.name, (unsigned)m.buffer.size(),
+               decodeNs(m.buffer), decodeNs(checked),
+               (double)(checked.size() - 4) * ROUNDS * 1000.0 / crcNs);
+    }
+    return 0;
+}
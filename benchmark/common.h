@@ -0,0 +1,135 @@
+/**
+ * @file common.h
+ * @brief Shared helpers for host benchmarks: heap allocation counter, timer
+ * and representative messages of our websocket / database traffic.
+ * Include this file in exactly ONE translation unit, it replaces global operator new/delete.
+ *
+ * 性能测试的公共部分: 堆内存分配计数、计时器和有代表性的websocket/数据库消息。
+ * 只能在 [一个] 编译单元中包含此文件，它替换了全局的 operator new/delete。
+ */
+#ifndef BENCHMARK_COMMON_H_
+#define BENCHMARK_COMMON_H_
+
+#include <Arduino.h>
+#include <arraybuffer.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace benchmark
+{
+    /**
+     * @brief heap allocations since last reset
+     * 上次重置后的堆内存分配次数和字节数
+     */
+    static uint64_t allocations = 0;
+    static uint64_t allocatedBytes = 0;
+
+    inline void resetAllocations()
+    {
+        allocations = 0;
+        allocatedBytes = 0;
+    }
+
+    inline uint64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     * @brief keep compiler from removing benchmark loops
+     * 防止编译器优化掉测试循环
+     */
+    template <class T>
+    inline void doNotOptimize(const T &value)
+    {
+        asm volatile(""
+                     :
+                     : "g"(&value)
+                     : "memory");
+    }
+
+    /**
+     * @brief a representative message
+     * 一条有代表性的消息
+     */
+    struct Message
+    {
+        const char *name;
+        std::vector<uint8_t> buffer;
+    };
+
+    inline std::vector<uint8_t> encode(std::initializer_list<Element> list)
+    {
+        uint32_t length = 0;
+        uint8_t *buffer = ArrayBuffer::createArrayBuffer(list, &length);
+        std::vector<uint8_t> output(buffer, buffer + length);
+        delete buffer;
+        return output;
+    }
+
+    /**
+     * @brief messages seen on device: short commands, database units, provider calls
+     * 设备上常见的消息：短命令、数据库单元、provider调用
+     */
+    inline std::vector<Message> messages()
+    {
+        uint8_t hash[32];
+        for (int i = 0; i < 32; ++i)
+            hash[i] = (uint8_t)(i * 7 + 1);
+
+        std::vector<Message> output;
+
+        // reply of local command 本地命令的回复
+        output.push_back({"command_reply",
+                          encode({Element((uint8_t)0x00), Element("OK"), Element((uint32_t)1024)})});
+
+        // database units 数据库单元
+        output.push_back({"db_units",
+                          encode({Element("wifiSSID"), Element("myHomeWiFi"),
+                                  Element("wifiPwd"), Element("12345678"),
+                                  Element("token"), Element("a1b2c3"),
+                                  Element("nickname"), Element("kitchen"),
+                                  Element("websocketPort"), Element((uint16_t)8080)})});
+
+        // log message to admin 发给管理员的日志消息
+        output.push_back({"log_message",
+                          encode({Element((uint8_t)0xac), Element(hash, (uint32_t)32),
+                                  Element("0123456789abcdef0123456789abcdef"),
+                                  Element("provider executed")})});
+
+        // execute command from remote 远程执行命令
+        output.push_back({"execute_command",
+                          encode({Element((uint8_t)0xb2), Element("ffa0"), Element((uint64_t)1680000000000ull),
+                                  Element(hash, (uint32_t)32), Element((uint16_t)3),
+                                  Element("on"), Element((uint8_t)1)})});
+        return output;
+    }
+}
+
+void *operator new(std::size_t size)
+{
+    ++benchmark::allocations;
+    benchmark::allocatedBytes += size;
+    void *p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+void *operator new[](std::size_t size) { return ::operator new(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    ++benchmark::allocations;
+    benchmark::allocatedBytes += size;
+    return std::malloc(size ? size : 1);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &t) noexcept { return ::operator new(size, t); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file compact_size.cpp
+ * @brief Size and time of normal mode and compact mode of ArrayBuffer for same messages.
+ *
+ * 同样的消息在ArrayBuffer普通模式和紧凑模式下的大小和耗时。
+ */
+#include "common.h"
+
+#define ROUNDS 20000
+
+/**
+ * @brief time of encoding and decoding one message, in ns
+ * 编码和解码一条消息的耗时，单位ns
+ */
+static void measure(Elements *elements, bool compact, uint32_t *length, double *encodeNs, double *decodeNs)
+{
+    uint64_t start = benchmark::nowNs();
+    for (int i = 0; i < ROUNDS; ++i)
+    {
+        uint8_t *buffer = compact ? ArrayBuffer::createCompactArrayBuffer(elements, length)
+                                  : ArrayBuffer::createArrayBuffer(elements, length);
+        benchmark::doNotOptimize(buffer);
+        delete[] buffer;
+    }
+    (*encodeNs) = (double)(benchmark::nowNs() - start) / ROUNDS;
+
+    uint8_t *buffer = compact ? ArrayBuffer::createCompactArrayBuffer(elements, length)
+                              : ArrayBuffer::createArrayBuffer(elements, length);
+    ElementArena arena;
+
+    start = benchmark::nowNs();
+    for (int i = 0; i < ROUNDS; ++i)
+    {
+        Elements *output = ArrayBuffer::decodeArrayBuffer(buffer, *length, &arena);
+        benchmark::doNotOptimize(output);
+        arena.reset();
+    }
+    (*decodeNs) = (double)(benchmark::nowNs() - start) / ROUNDS;
+    delete[] buffer;
+}
+
+int main()
+{
+    printf("%-16s %-8s %8s %10s %10s\n", "message", "mode", "bytes", "encode ns", "decode ns");
+
+    std::vector<benchmark::Message> messages = benchmark::messages();
+
+    for (auto &m : messages)
+    {
+        Elements *elements = ArrayBuffer::decodeArrayBuffer(m.buffer.data(), m.buffer.size());
+
+        for (int mode = 0; mode < 2; ++mode)
+        {
+            uint32_t length = 0;
+            double encodeNs = 0, decodeNs = 0;
+            measure(elements, mode, &length, &encodeNs, &decodeNs);
+            printf("%-16s %-8s %8u %10.1f %10.1f\n",
+                   m.name, mode ? "compact" : "normal", (unsigned)length, encodeNs, decodeNs);
+        }
+
+        for (auto it = elements->begin(); it != elements->end(); ++it)
+            delete (*it);
+        delete elements;
+    }
+    return 0;
+}
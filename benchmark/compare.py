@@ -0,0 +1,51 @@
+# compare two outputs of serialization.cpp, exit with 1 if any payload got worse
+# 比较 serialization.cpp 的两次输出，任何数据变差时以1退出
+#
+# python3 benchmark/compare.py baseline.jsonl current.jsonl [time tolerance, 0.2 for 20%]
+#
+# bytes and allocations are the same on every machine and must not grow,
+# time is only checked when a tolerance is given, both runs should come from the same machine
+# 字节数和内存分配次数在所有机器上都相同，不能增加，
+# 只有给出容差时才检查耗时，两次运行应该在同一台机器上
+import json
+import sys
+
+EXACT = ["bytes", "encode_allocs", "decode_allocs"]
+TIMED = ["encode_ns", "decode_ns"]
+
+
+def load(path):
+    results = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("{"):
+                result = json.loads(line)
+                results[result["payload"]] = result
+    return results
+
+
+if len(sys.argv) < 3:
+    print("usage: compare.py baseline.jsonl current.jsonl [time tolerance]")
+    sys.exit(2)
+
+baseline = load(sys.argv[1])
+current = load(sys.argv[2])
+tolerance = float(sys.argv[3]) if len(sys.argv) > 3 else None
+worse = False
+
+for name, old in baseline.items():
+    new = current.get(name)
+    if new is None:
+        print("%-16s missing" % name)
+        worse = True
+        continue
+    for key in EXACT + (TIMED if tolerance is not None else []):
+        limit = old[key] * (1 + tolerance) if key in TIMED else old[key]
+        mark = ""
+        if new[key] > limit:
+            mark = "  <- worse"
+            worse = True
+        print("%-16s %-14s %10s -> %10s%s" % (name, key, old[key], new[key], mark))
+
+sys.exit(1 if worse else 0)
@@ -0,0 +1,61 @@
+/**
+ * @file decode_alloc.cpp
+ * @brief Heap allocations and time per decoded message of ArrayBuffer::decodeArrayBuffer,
+ * on heap and with an ElementArena reused across messages.
+ * Build with -DELEMENT_INLINE_BUFFER_SIZE=16 to get the result with inline buffer of Element.
+ *
+ * ArrayBuffer::decodeArrayBuffer 解码每条消息的堆内存分配次数和耗时，分别测试堆内存和重复使用的ElementArena。
+ * 使用 -DELEMENT_INLINE_BUFFER_SIZE=16 编译可以得到使用Element内部缓冲区的结果。
+ */
+#include "common.h"
+
+#define ROUNDS 20000
+
+int main()
+{
+    printf("ELEMENT_INLINE_BUFFER_SIZE=%d, sizeof(Element)=%u\n",
+           ELEMENT_INLINE_BUFFER_SIZE, (unsigned)sizeof(Element));
+    printf("%-16s %-6s %8s %12s %14s %10s\n", "message", "mode", "bytes", "allocs/msg", "heapBytes/msg", "ns/msg");
+
+    std::vector<benchmark::Message> messages = benchmark::messages();
+
+    ElementArena arena;
+
+    for (auto &m : messages)
+    {
+        for (int mode = 0; mode < 2; ++mode)
+        {
+            benchmark::resetAllocations();
+            uint64_t start = benchmark::nowNs();
+
+            for (int i = 0; i < ROUNDS; ++i)
+            {
+                if (mode)
+                {
+                    Elements *output = ArrayBuffer::decodeArrayBuffer(m.buffer.data(), m.buffer.size(), &arena);
+                    benchmark::doNotOptimize(output);
+                    arena.reset();
+                }
+                else
+                {
+                    Elements *output = ArrayBuffer::decodeArrayBuffer(m.buffer.data(), m.buffer.size());
+                    benchmark::doNotOptimize(output);
+                    for (auto it = output->begin(); it != output->end(); ++it)
+                        delete (*it);
+                    delete output;
+                }
+            }
+
+            uint64_t elapsed = benchmark::nowNs() - start;
+
+            printf("%-16s %-6s %8u %12.2f %14.2f %10.1f\n",
+                   m.name,
+                   mode ? "arena" : "heap",
+                   (unsigned)m.buffer.size(),
+                   (double)benchmark::allocations / ROUNDS,
+                   (double)benchmark::allocatedBytes / ROUNDS,
+                   (double)elapsed / ROUNDS);
+        }
+    }
+    return 0;
+}
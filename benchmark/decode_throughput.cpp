@@ -0,0 +1,69 @@
+/**
+ * @file decode_throughput.cpp
+ * @brief Throughput of ArrayBuffer::decodeArrayBuffer on well formed messages and on truncated ones,
+ * heap allocations per message show whether a malformed message is rejected before anything is allocated.
+ *
+ * ArrayBuffer::decodeArrayBuffer 解码格式正确的消息和被截断的消息的吞吐量，
+ * 每条消息的堆内存分配次数可以看出格式错误的消息是否在分配任何内存之前就被拒绝。
+ */
+#include "common.h"
+
+#define ROUNDS 20000
+
+int main()
+{
+    printf("%-16s %-9s %8s %12s %10s %10s\n", "message", "input", "bytes", "allocs/msg", "ns/msg", "MB/s");
+
+    std::vector<benchmark::Message> messages = benchmark::messages();
+
+    // ota data block, long payload
+    // ota数据块，较长的数据
+    std::vector<uint8_t> block(4096);
+    for (uint32_t i = 0; i < block.size(); ++i)
+        block[i] = (uint8_t)i;
+    messages.push_back({"ota_block",
+                        benchmark::encode({Element((uint8_t)0xac), Element(block.data(), (uint32_t)32),
+                                           Element(block.data(), (uint32_t)block.size()), Element((uint32_t)7)})});
+
+    for (auto &m : messages)
+    {
+        for (int truncated = 0; truncated < 2; ++truncated)
+        {
+            // last byte is cut off, the declared length of last field runs past the end,
+            // bytes after length are still readable so old decoder can be measured too
+            // 去掉最后一个字节，最后一个字段声明的长度超出了末尾，
+            // 长度之后的字节依然可读，所以也可以测试旧的解码器
+            uint32_t length = m.buffer.size() - truncated;
+            uint32_t rejected = 0;
+
+            benchmark::resetAllocations();
+            uint64_t start = benchmark::nowNs();
+
+            for (int i = 0; i < ROUNDS; ++i)
+            {
+                Elements *output = ArrayBuffer::decodeArrayBuffer(m.buffer.data(), length);
+                benchmark::doNotOptimize(output);
+                if (!output)
+                {
+                    ++rejected;
+                    continue;
+                }
+                for (auto it = output->begin(); it != output->end(); ++it)
+                    delete (*it);
+                delete output;
+            }
+
+            uint64_t elapsed = benchmark::nowNs() - start;
+
+            printf("%-16s %-9s %8u %12.2f %10.1f %10.1f%s\n",
+                   m.name,
+                   truncated ? "truncated" : "valid",
+                   (unsigned)length,
+                   (double)benchmark::allocations / ROUNDS,
+                   (double)elapsed / ROUNDS,
+                   (double)length * ROUNDS * 1000.0 / elapsed,
+                   truncated && rejected != ROUNDS ? " (NOT rejected)" : "");
+        }
+    }
+    return 0;
+}
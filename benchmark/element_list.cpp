@@ -0,0 +1,164 @@
+/**
+ * @file element_list.cpp
+ * @brief Heap allocations and time to decode a message, walk every field and release it,
+ * with Elements on heap, Elements in ElementArena and ElementList, and to build and encode
+ * a find device response with new Element and with ElementList.
+ *
+ * 解码一条消息、遍历所有字段并释放的堆内存分配次数和耗时，
+ * 分别使用堆上的 Elements、ElementArena 中的 Elements 和 ElementList，
+ * 以及分别使用 new Element 和 ElementList 构建并编码查找设备响应的堆内存分配次数和耗时。
+ */
+#include "common.h"
+
+#define ROUNDS 20000
+#define BATCHES 10
+
+struct Result
+{
+    double allocs;
+    double ns;
+};
+
+// best of batches, allocations of one round
+// 多批中最快的结果，以及一轮的内存分配次数
+template <class F>
+static Result measure(F f)
+{
+    Result result = {0, 1e30};
+    for (int b = 0; b < BATCHES; ++b)
+    {
+        benchmark::resetAllocations();
+        uint64_t start = benchmark::nowNs();
+        for (int r = 0; r < ROUNDS; ++r)
+            f();
+        double ns = (double)(benchmark::nowNs() - start) / ROUNDS;
+        result.allocs = (double)benchmark::allocations / ROUNDS;
+        if (ns < result.ns)
+            result.ns = ns;
+    }
+    return result;
+}
+
+int main()
+{
+    printf("%-16s %6s %18s %18s %18s %18s %14s %14s %14s %14s\n", "message", "fields",
+           "elements, allocs", "arena, allocs", "list, allocs", "list+arena, allocs",
+           "elements, ns", "arena, ns", "list, ns", "list+arena, ns");
+
+    ElementArena arena;
+    std::vector<benchmark::Message> messages = benchmark::messages();
+    for (auto &m : messages)
+    {
+        uint8_t *data = m.buffer.data();
+        uint32_t length = m.buffer.size();
+        uint32_t fields = 0;
+
+        Result elements = measure(
+            [&]()
+            {
+                Elements *output = ArrayBuffer::decodeArrayBuffer(data, length);
+                uint32_t total = 0;
+                for (auto it = output->begin(); it != output->end(); ++it)
+                    total += (*it)->getOuterBufferLength();
+                benchmark::doNotOptimize(total);
+                fields = output->size();
+                for (auto it = output->begin(); it != output->end(); ++it)
+                    delete (*it);
+                delete output;
+            });
+
+        Result inArena = measure(
+            [&]()
+            {
+                Elements *output = ArrayBuffer::decodeArrayBuffer(data, length, &arena);
+                uint32_t total = 0;
+                for (auto it = output->begin(); it != output->end(); ++it)
+                    total += (*it)->getOuterBufferLength();
+                benchmark::doNotOptimize(total);
+                arena.reset();
+            });
+
+        Result list = measure(
+            [&]()
+            {
+                ElementList output;
+                ArrayBuffer::decodeArrayBuffer(data, length, &output);
+                uint32_t total = 0;
+                for (const Element &e : output)
+                    total += e.getOuterBufferLength();
+                benchmark::doNotOptimize(total);
+            });
+
+        Result listInArena = measure(
+            [&]()
+            {
+                {
+                    ElementList output;
+                    ArrayBuffer::decodeArrayBuffer(data, length, &output, &arena);
+                    uint32_t total = 0;
+                    for (const Element &e : output)
+                        total += e.getOuterBufferLength();
+                    benchmark::doNotOptimize(total);
+                }
+                arena.reset();
+            });
+
+        printf("%-16s %6u %18.2f %18.2f %18.2f %18.2f %14.1f %14.1f %14.1f %14.1f\n", m.name, (unsigned)fields,
+               elements.allocs, inArena.allocs, list.allocs, listInArena.allocs,
+               elements.ns, inArena.ns, list.ns, listInArena.ns);
+    }
+
+    // same fields as GlobalManager::getFindDeviceBuffer, providers buffer is shared
+    // 与 GlobalManager::getFindDeviceBuffer 的字段相同，provider缓存是共享的
+    std::vector<uint8_t> providers(420, 0x5a);
+    Element bufferProviders(providers.data(), (uint32_t)providers.size());
+    String version = String("1.0.0") + String("2023-01-01 00:00:00");
+
+    Result pointers = measure(
+        [&]()
+        {
+            Elements response;
+            response.push_back(new Element((uint8_t)0xaf));
+            response.push_back(new Element("0123456789abcdef0123456789abcdef"));
+            response.push_back(new Element((uint16_t)240));
+            response.push_back(new Element((uint8_t)96));
+            response.push_back(new Element((uint64_t)1680000000000ull));
+            response.push_back(new Element((uint32_t)180000));
+            response.push_back(new Element("kitchen"));
+            response.push_back(new Element("a0b1c2d3e4f5a6b7c8d9e0f1a2b3c4d5e6f7a8b9c0d1e2f3a4b5c6d7e8f9a0b1"));
+            response.push_back(new Element((uint8_t)2));
+            response.push_back(new Element(version));
+            response.push_back(new Element(bufferProviders));
+            uint32_t outLen = 0;
+            uint8_t *encoded = ArrayBuffer::createArrayBuffer(&response, &outLen);
+            benchmark::doNotOptimize(encoded);
+            delete[] encoded;
+            for (auto it = response.begin(); it != response.end(); ++it)
+                delete (*it);
+        });
+
+    Result values = measure(
+        [&]()
+        {
+            ElementList response;
+            response.emplace_back((uint8_t)0xaf);
+            response.emplace_back("0123456789abcdef0123456789abcdef");
+            response.emplace_back((uint16_t)240);
+            response.emplace_back((uint8_t)96);
+            response.emplace_back((uint64_t)1680000000000ull);
+            response.emplace_back((uint32_t)180000);
+            response.emplace_back("kitchen");
+            response.emplace_back("a0b1c2d3e4f5a6b7c8d9e0f1a2b3c4d5e6f7a8b9c0d1e2f3a4b5c6d7e8f9a0b1");
+            response.emplace_back((uint8_t)2);
+            response.emplace_back(version);
+            response.emplace_back(bufferProviders);
+            uint32_t outLen = 0;
+            uint8_t *encoded = ArrayBuffer::createArrayBuffer(&response, &outLen);
+            benchmark::doNotOptimize(encoded);
+            delete[] encoded;
+        });
+
+    printf("\n%-16s %14s %14s %12s %12s\n", "response", "new, allocs", "list, allocs", "new, ns", "list, ns");
+    printf("%-16s %14.2f %14.2f %12.1f %12.1f\n", "find_device", pointers.allocs, values.allocs, pointers.ns, values.ns);
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file element_operators.cpp
+ * @brief Time of number operators of Element: comparison, arithmetic with a number,
+ * compound assignment and Element with Element, over Elements holding every number type.
+ * Build with -Os -c and run `size` on the object to compare code size.
+ *
+ * Element 数字运算符的耗时：比较、与数字运算、复合赋值以及 Element 之间的运算，
+ * 操作数覆盖所有数字类型。使用 -Os -c 编译后对目标文件运行 `size` 可以比较代码大小。
+ */
+#include "common.h"
+
+#define ROUNDS 200000
+
+static std::vector<Element> makeNumbers()
+{
+    std::vector<Element> numbers(10);
+    numbers[0] = (uint8_t)200;
+    numbers[1] = (int8_t)-100;
+    numbers[2] = (uint16_t)60000;
+    numbers[3] = (int16_t)-30000;
+    numbers[4] = (uint32_t)4000000000u;
+    numbers[5] = (int32_t)-2000000000;
+    numbers[6] = (uint64_t)0xfffffffffffffff0ull;
+    numbers[7] = (int64_t)-9000000000000000000ll;
+    numbers[8] = (float)1.5f;
+    numbers[9] = (double)-2.25;
+    return numbers;
+}
+
+// every number operator with every number type, so that size of object covers all of them
+// 每个数字运算符与每种数字类型各调用一次，使目标文件大小覆盖所有运算符
+#define TOUCH(T)                                                                       \
+    {                                                                                  \
+        T n = (T)v;                                                                    \
+        r += (a == n) + (a != n) + (a < n) + (a > n) + (a <= n) + (a >= n);            \
+        r += (a && n) + (a || n);                                                      \
+        r += (int64_t)(a + n) + (int64_t)(a - n) + (int64_t)(a * n) + (int64_t)(a / n); \
+        a += n;                                                                        \
+        a -= n;                                                                        \
+        a *= n;                                                                        \
+        a = n;                                                                         \
+    }
+
+__attribute__((noinline)) int64_t touchAll(Element &a, int v)
+{
+    int64_t r = 0;
+    TOUCH(uint8_t)
+    TOUCH(int8_t)
+    TOUCH(uint16_t)
+    TOUCH(int16_t)
+    TOUCH(uint32_t)
+    TOUCH(int32_t)
+    TOUCH(uint64_t)
+    TOUCH(int64_t)
+    TOUCH(double)
+    r += (a % (int32_t)v).getType();
+    a /= (int32_t)v;
+    a &= (uint32_t)v;
+    a |= (uint32_t)v;
+    a ^= (uint32_t)v;
+    Element b = a + a;
+    b = b - a;
+    b = b * a;
+    b = b / a;
+    return r + b.getType();
+}
+
+static uint64_t run(int op, const std::vector<Element> &numbers)
+{
+    uint64_t hits = 0;
+    for (int i = 0; i < ROUNDS; ++i)
+    {
+        const Element &e = numbers[i % 10];
+        switch (op)
+        {
+        case 0:
+            hits += (e == (uint32_t)i) + (e < (int64_t)i) + (e >= (double)i) + (e != (int16_t)i);
+            break;
+        case 1:
+            hits += (uint32_t)(e + (uint32_t)i) + (int64_t)(e * (int64_t)3) + (int32_t)(e - (int32_t)i);
+            break;
+        case 2:
+        {
+            Element t = e;
+            t += (int32_t)i;
+            t *= (uint16_t)3;
+            t -= (int64_t)1;
+            hits += t.getType();
+            break;
+        }
+        default:
+        {
+            Element t = e + numbers[(i + 3) % 10];
+            t = t * numbers[(i + 7) % 10];
+            hits += t.getType();
+            break;
+        }
+        }
+    }
+    return hits;
+}
+
+int main()
+{
+    Element touched((int32_t)3);
+    benchmark::doNotOptimize(touchAll(touched, 7));
+
+    std::vector<Element> numbers = makeNumbers();
+    const char *names[] = {"compare", "arithmetic", "compound", "element"};
+
+    printf("%-12s %10s\n", "op", "ns/op");
+
+    for (int op = 0; op < 4; ++op)
+    {
+        // best of 5 runs
+        // 5次中最好的结果
+        uint64_t best = 0;
+        for (int i = 0; i < 5; ++i)
+        {
+            uint64_t start = benchmark::nowNs();
+            uint64_t hits = run(op, numbers);
+            uint64_t elapsed = benchmark::nowNs() - start;
+            benchmark::doNotOptimize(hits);
+            if (!i || elapsed < best)
+                best = elapsed;
+        }
+        printf("%-12s %10.1f\n", names[op], (double)best / ROUNDS);
+    }
+
+    // integers beyond 2^53 are compared exactly only without a round trip through double
+    // 超过2^53的整数只有不经过double转换时才能精确比较
+    Element big((uint64_t)0);
+    big = (uint64_t)9007199254740993ull;
+    printf("exact 2^53+1 == 2^53: %s\n", big == (uint64_t)9007199254740992ull ? "no" : "yes");
+    return 0;
+}
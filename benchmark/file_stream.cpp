@@ -0,0 +1,118 @@
+/**
+ * @file file_stream.cpp
+ * @brief Heap bytes and time to send a file in a message (command, file as uint8 array)
+ * through ArrayBufferWriter to a websocket-like sink: file read into RAM first against
+ * an ETYPE_FILE Element streamed from the file. The file is read by stdio, as MyFSFileSource reads LittleFS.
+ *
+ * 在消息(命令，文件作为二进制数组)中通过 ArrayBufferWriter 向类似websocket的输出端发送文件的
+ * 堆内存字节数和耗时：先把文件读入内存，与从文件流式读取的 ETYPE_FILE 类型Element对比。
+ * 文件使用stdio读取，与 MyFSFileSource 读取LittleFS的方式相同。
+ */
+#include "common.h"
+#include <cstdio>
+
+#define ROUNDS 20
+
+// same as MyFSFileSource, file is opened on first read and closed after the last byte
+// 与 MyFSFileSource 相同，第一次读取时打开文件，读取完最后一个字节后关闭
+class StdioFileSource : public ElementFileSource
+{
+private:
+    const char *path;
+    uint32_t size;
+    FILE *file = nullptr;
+
+public:
+    StdioFileSource(const char *path, uint32_t size) : path(path), size(size) {}
+    ~StdioFileSource()
+    {
+        if (this->file)
+            fclose(this->file);
+    }
+    uint32_t length() const override { return this->size; }
+    bool read(uint32_t offset, uint8_t *buffer, uint32_t length) override
+    {
+        if (!this->file && !(this->file = fopen(this->path, "rb")))
+            return false;
+        if ((uint32_t)ftell(this->file) != offset)
+            fseek(this->file, offset, SEEK_SET);
+        bool done = fread(buffer, 1, length, this->file) == length;
+        if (!done || offset + length == this->size)
+        {
+            fclose(this->file);
+            this->file = nullptr;
+        }
+        return done;
+    }
+};
+
+int main()
+{
+    const char *path = "/tmp/file_stream.bin";
+    printf("%10s %16s %16s %12s %12s\n", "bytes", "ram, heap bytes", "file, heap bytes", "ram, us", "file, us");
+
+    const uint32_t sizes[] = {64 * 1024, 1024 * 1024, 8 * 1024 * 1024};
+    for (uint32_t s = 0; s < 3; ++s)
+    {
+        uint32_t size = sizes[s];
+        {
+            std::vector<uint8_t> blob(size);
+            for (uint32_t i = 0; i < size; ++i)
+                blob[i] = (uint8_t)(i * 31 + 7);
+            FILE *f = fopen(path, "wb");
+            fwrite(blob.data(), 1, size, f);
+            fclose(f);
+        }
+
+        // websocket frame, bytes are counted and dropped
+        // websocket数据帧，只计数然后丢弃
+        uint64_t sent = 0;
+        ArrayBufferSink sink = [&sent](const uint8_t *data, uint32_t length) -> bool
+        {
+            sent += length;
+            benchmark::doNotOptimize(data);
+            return true;
+        };
+
+        // read whole file, then send
+        // 读取整个文件后发送
+        benchmark::resetAllocations();
+        uint64_t start = benchmark::nowNs();
+        for (int r = 0; r < ROUNDS; ++r)
+        {
+            uint8_t *data = new (std::nothrow) uint8_t[size];
+            FILE *f = fopen(path, "rb");
+            fread(data, 1, size, f);
+            fclose(f);
+            Element command((uint8_t)0xab), file;
+            file.adoptBuffer(data, size);
+            ArrayBufferWriter writer(sink);
+            writer.write(command);
+            writer.write(file);
+            writer.flush();
+        }
+        double ramUs = (double)(benchmark::nowNs() - start) / ROUNDS / 1000;
+        double ramBytes = (double)benchmark::allocatedBytes / ROUNDS;
+
+        // stream from file
+        // 从文件流式读取
+        benchmark::resetAllocations();
+        start = benchmark::nowNs();
+        for (int r = 0; r < ROUNDS; ++r)
+        {
+            Element command((uint8_t)0xab), file(new StdioFileSource(path, size));
+            ArrayBufferWriter writer(sink);
+            writer.write(command);
+            writer.write(file);
+            writer.flush();
+        }
+        double fileUs = (double)(benchmark::nowNs() - start) / ROUNDS / 1000;
+        double fileBytes = (double)benchmark::allocatedBytes / ROUNDS;
+
+        if (sent != (uint64_t)(size + 7) * ROUNDS * 2)
+            printf("sent bytes differ\n");
+        printf("%10u %16.0f %16.0f %12.1f %12.1f\n", (unsigned)size, ramBytes, fileBytes, ramUs, fileUs);
+    }
+    remove(path);
+    return 0;
+}
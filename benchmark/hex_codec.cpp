@@ -0,0 +1,78 @@
+/**
+ * @file hex_codec.cpp
+ * @brief Time of hex encoding and decoding, sprintf / sscanf per byte against lookup tables of mycrypto::Hex.
+ * Sizes are a sha256 digest (authorize) and a 1KB uint8 array.
+ *
+ * 十六进制编解码的耗时，逐字节 sprintf / sscanf 与 mycrypto::Hex 查找表的对比。
+ * 数据大小为一个sha256摘要(认证时使用)和一个1KB的二进制数组。
+ */
+#include "common.h"
+
+#define ROUNDS 20000
+
+static void encodeFormatted(const uint8_t *data, uint32_t length, char *output)
+{
+    for (uint32_t i = 0; i < length; ++i)
+        sprintf(output + i * 2, "%02x", data[i]);
+}
+
+static void decodeFormatted(const char *hex, uint32_t length, uint8_t *output)
+{
+    int tmp = 0;
+    for (uint32_t i = 0; i < length; i += 2)
+    {
+        sscanf(hex + i, "%02x", &tmp);
+        output[i / 2] = (uint8_t)tmp;
+    }
+}
+
+int main()
+{
+    printf("%-8s %-8s %14s %14s %8s\n", "bytes", "op", "sprintf ns", "table ns", "speedup");
+
+    uint32_t sizes[] = {32, 1024};
+    for (uint32_t size : sizes)
+    {
+        std::vector<uint8_t> data(size), decoded(size);
+        std::vector<char> hex(size * 2 + 1);
+        for (uint32_t i = 0; i < size; ++i)
+            data[i] = (uint8_t)(i * 31 + 7);
+
+        for (int op = 0; op < 2; ++op)
+        {
+            uint64_t elapsed[2];
+            for (int table = 0; table < 2; ++table)
+            {
+                uint64_t start = benchmark::nowNs();
+                for (int i = 0; i < ROUNDS; ++i)
+                {
+                    if (!op)
+                    {
+                        if (table)
+                            mycrypto::Hex::encode(data.data(), size, hex.data());
+                        else
+                            encodeFormatted(data.data(), size, hex.data());
+                        benchmark::doNotOptimize(hex);
+                    }
+                    else
+                    {
+                        if (table)
+                            mycrypto::Hex::decode(hex.data(), size * 2, decoded.data());
+                        else
+                            decodeFormatted(hex.data(), size * 2, decoded.data());
+                        benchmark::doNotOptimize(decoded);
+                    }
+                }
+                elapsed[table] = benchmark::nowNs() - start;
+            }
+
+            printf("%-8u %-8s %14.1f %14.1f %7.1fx\n",
+                   size,
+                   op ? "decode" : "encode",
+                   (double)elapsed[0] / ROUNDS,
+                   (double)elapsed[1] / ROUNDS,
+                   (double)elapsed[0] / elapsed[1]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file Arduino.h
+ * @brief Minimal host replacement of Arduino.h, only for building benchmarks on PC.
+ * Covers the parts of String and ESP-IDF logging used by lib/arraybuffer.
+ *
+ * 仅用于在电脑上编译性能测试的简化版Arduino.h。
+ * 只包含 lib/arraybuffer 用到的 String 和 ESP-IDF 日志部分。
+ */
+#ifndef BENCHMARK_HOST_ARDUINO_H_
+#define BENCHMARK_HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <string>
+#include <new>
+#include <algorithm>
+
+#define ESP_LOGD(tag, ...) ((void)0)
+#define ESP_LOGW(tag, ...) ((void)0)
+#define ESP_LOGE(tag, ...) ((void)0)
+#define ESP_LOGI(tag, ...) ((void)0)
+#define ESP_LOGV(tag, ...) ((void)0)
+#define ESP_IDF_VERSION_MAJOR 4
+
+inline long random(long howbig) { return howbig ? rand() % howbig : 0; }
+inline long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+inline void yield() {}
+
+class String
+{
+    std::string s;
+
+public:
+    String() {}
+    String(const char *c) : s(c ? c : "") {}
+    String(const std::string &c) : s(c) {}
+    String(char c) : s(1, c) {}
+    explicit String(int v) : s(std::to_string(v)) {}
+    explicit String(unsigned int v) : s(std::to_string(v)) {}
+    explicit String(long v) : s(std::to_string(v)) {}
+    explicit String(unsigned long v) : s(std::to_string(v)) {}
+    explicit String(long long v) : s(std::to_string(v)) {}
+    explicit String(unsigned long long v) : s(std::to_string(v)) {}
+    explicit String(double v) : s(std::to_string(v)) {}
+    const char *c_str() const { return s.c_str(); }
+    unsigned int length() const { return (unsigned int)s.size(); }
+    bool reserve(unsigned int n)
+    {
+        s.reserve(n);
+        return true;
+    }
+    char operator[](unsigned int i) const { return s[i]; }
+    char &operator[](unsigned int i) { return s[i]; }
+    bool operator==(const String &o) const { return s == o.s; }
+    bool operator==(const char *o) const { return s == o; }
+    bool operator!=(const String &o) const { return s != o.s; }
+    bool operator!=(const char *o) const { return s != o; }
+    bool operator<(const String &o) const { return s < o.s; }
+    String &operator+=(const String &o)
+    {
+        s += o.s;
+        return *this;
+    }
+    String &operator+=(const char *o)
+    {
+        s += o;
+        return *this;
+    }
+    String &operator+=(char o)
+    {
+        s += o;
+        return *this;
+    }
+    bool concat(const char *o, unsigned int n)
+    {
+        s.append(o, n);
+        return true;
+    }
+    friend String operator+(const String &a, const String &b) { return String(a.s + b.s); }
+    friend String operator+(const String &a, const char *b) { return String(a.s + b); }
+    friend String operator+(const char *a, const String &b) { return String(a + b.s); }
+    int indexOf(const String &t) const
+    {
+        size_t p = s.find(t.s);
+        return p == std::string::npos ? -1 : (int)p;
+    }
+    int indexOf(char t) const
+    {
+        size_t p = s.find(t);
+        return p == std::string::npos ? -1 : (int)p;
+    }
+    int lastIndexOf(const String &t) const
+    {
+        size_t p = s.rfind(t.s);
+        return p == std::string::npos ? -1 : (int)p;
+    }
+    int lastIndexOf(char t) const
+    {
+        size_t p = s.rfind(t);
+        return p == std::string::npos ? -1 : (int)p;
+    }
+    bool startsWith(const String &t) const { return s.compare(0, t.s.size(), t.s) == 0; }
+    bool endsWith(const String &t) const { return s.size() >= t.s.size() && s.compare(s.size() - t.s.size(), t.s.size(), t.s) == 0; }
+    String substring(unsigned int a) const { return a > s.size() ? String() : String(s.substr(a)); }
+    String substring(unsigned int a, unsigned int b) const
+    {
+        if (a > b)
+            std::swap(a, b);
+        if (a > s.size())
+            return String();
+        return String(s.substr(a, b - a));
+    }
+    void replace(const String &a, const String &b)
+    {
+        if (!a.s.size())
+            return;
+        size_t p = 0;
+        while ((p = s.find(a.s, p)) != std::string::npos)
+        {
+            s.replace(p, a.s.size(), b.s);
+            p += b.s.size();
+        }
+    }
+    long toInt() const { return atol(s.c_str()); }
+    void toUpperCase()
+    {
+        for (auto &c : s)
+            c = toupper(c);
+    }
+    void toLowerCase()
+    {
+        for (auto &c : s)
+            c = tolower(c);
+    }
+};
+
+#endif
@@ -0,0 +1,7 @@
+// host placeholder, hardware peripherals are not used by benchmarks
+// 主机占位文件，性能测试不使用硬件外设
+#pragma once
+#define PERIPH_AES_MODULE 0
+#define PERIPH_SHA_MODULE 1
+inline void periph_module_enable(int) {}
+inline void periph_module_disable(int) {}
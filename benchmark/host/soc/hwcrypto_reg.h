@@ -0,0 +1,3 @@
+// host placeholder, hardware registers are not used by benchmarks
+// 主机占位文件，性能测试不使用硬件寄存器
+#pragma once
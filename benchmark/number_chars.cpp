@@ -0,0 +1,142 @@
+/**
+ * @file number_chars.cpp
+ * @brief Time to write and read numbers as text: snprintf / strtoull / strtod against
+ * ElementNumber::toChars / ElementNumber::fromChars, and how many results differ.
+ *
+ * 将数字写为文本和从文本读取数字的耗时：snprintf / strtoull / strtod 与
+ * ElementNumber::toChars / ElementNumber::fromChars 的对比，以及结果不同的次数。
+ */
+#include "common.h"
+
+#define COUNT 4096
+#define ROUNDS 50
+
+static uint64_t seed = 88172645463325252ull;
+
+static uint64_t next()
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+template <class Old, class New>
+static void run(const char *name, Old oldPath, New newPath, uint32_t differences)
+{
+    uint64_t start = benchmark::nowNs();
+    for (int r = 0; r < ROUNDS; ++r)
+        for (uint32_t i = 0; i < COUNT; ++i)
+            oldPath(i);
+    double oldNs = (double)(benchmark::nowNs() - start) / ROUNDS / COUNT;
+
+    benchmark::resetAllocations();
+    start = benchmark::nowNs();
+    for (int r = 0; r < ROUNDS; ++r)
+        for (uint32_t i = 0; i < COUNT; ++i)
+            newPath(i);
+    double newNs = (double)(benchmark::nowNs() - start) / ROUNDS / COUNT;
+
+    printf("%-16s %10.1f %10.1f %8u %8u\n", name, oldNs, newNs, (unsigned)benchmark::allocations, (unsigned)differences);
+}
+
+int main()
+{
+    static uint64_t timestamps[COUNT];
+    static int32_t integers[COUNT];
+    static double doubles[COUNT];
+    static char integerText[COUNT][ELEMENT_NUMBER_CHARS_SIZE];
+    static char doubleText[COUNT][32];
+    char buf[32], other[32];
+
+    for (uint32_t i = 0; i < COUNT; ++i)
+    {
+        timestamps[i] = 1660000000000ull + next() % 100000000000ull;
+        integers[i] = (int32_t)next();
+        doubles[i] = (double)(int64_t)(next() % 2000000 - 1000000) / 100;
+        snprintf(integerText[i], sizeof(integerText[i]), "%llu", (unsigned long long)next());
+        // random mantissa and exponent, up to 17 significant digits
+        snprintf(doubleText[i], sizeof(doubleText[i]), "%.*e", (int)(next() % 17), (double)next() * pow(10.0, (int)(next() % 60) - 30));
+    }
+
+    printf("%-16s %10s %10s %8s %8s\n", "case", "libc, ns", "chars, ns", "allocs", "differ");
+
+    uint32_t differences = 0;
+    for (uint32_t i = 0; i < COUNT; ++i)
+    {
+        snprintf(buf, sizeof(buf), "%llu", (unsigned long long)timestamps[i]);
+        ElementNumber::of(timestamps[i]).toChars(other);
+        differences += strcmp(buf, other) != 0;
+    }
+    run(
+        "uint64 write", [&](uint32_t i)
+        { benchmark::doNotOptimize(snprintf(buf, sizeof(buf), "%llu", (unsigned long long)timestamps[i])); },
+        [&](uint32_t i)
+        { benchmark::doNotOptimize(ElementNumber::of(timestamps[i]).toChars(buf)); },
+        differences);
+
+    differences = 0;
+    for (uint32_t i = 0; i < COUNT; ++i)
+    {
+        snprintf(buf, sizeof(buf), "%d", (int)integers[i]);
+        ElementNumber::of(integers[i]).toChars(other);
+        differences += strcmp(buf, other) != 0;
+    }
+    run(
+        "int32 write", [&](uint32_t i)
+        { benchmark::doNotOptimize(snprintf(buf, sizeof(buf), "%d", (int)integers[i])); },
+        [&](uint32_t i)
+        { benchmark::doNotOptimize(ElementNumber::of(integers[i]).toChars(buf)); },
+        differences);
+
+    differences = 0;
+    for (uint32_t i = 0; i < COUNT; ++i)
+    {
+        snprintf(buf, sizeof(buf), "%.2f", doubles[i]);
+        ElementNumber::of(doubles[i]).toChars(other);
+        differences += strcmp(buf, other) != 0;
+    }
+    run(
+        "double write", [&](uint32_t i)
+        { benchmark::doNotOptimize(snprintf(buf, sizeof(buf), "%.2f", doubles[i])); },
+        [&](uint32_t i)
+        { benchmark::doNotOptimize(ElementNumber::of(doubles[i]).toChars(buf)); },
+        differences);
+
+    differences = 0;
+    for (uint32_t i = 0; i < COUNT; ++i)
+    {
+        ElementNumber n;
+        ElementNumber::fromChars(integerText[i], strlen(integerText[i]), &n);
+        differences += n.u != strtoull(integerText[i], nullptr, 10);
+    }
+    run(
+        "uint64 read", [&](uint32_t i)
+        { benchmark::doNotOptimize(strtoull(integerText[i], nullptr, 10)); },
+        [&](uint32_t i)
+        {
+            ElementNumber n;
+            ElementNumber::fromChars(integerText[i], strlen(integerText[i]), &n);
+            benchmark::doNotOptimize(n.u);
+        },
+        differences);
+
+    differences = 0;
+    for (uint32_t i = 0; i < COUNT; ++i)
+    {
+        ElementNumber n;
+        ElementNumber::fromChars(doubleText[i], strlen(doubleText[i]), &n);
+        differences += n.d != strtod(doubleText[i], nullptr);
+    }
+    run(
+        "double read", [&](uint32_t i)
+        { benchmark::doNotOptimize(strtod(doubleText[i], nullptr)); },
+        [&](uint32_t i)
+        {
+            ElementNumber n;
+            ElementNumber::fromChars(doubleText[i], strlen(doubleText[i]), &n);
+            benchmark::doNotOptimize(n.d);
+        },
+        differences);
+    return 0;
+}
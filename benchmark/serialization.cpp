@@ -0,0 +1,164 @@
+/**
+ * @file serialization.cpp
+ * @brief Regression suite of the serialization core: bytes, heap allocations and time of
+ * ArrayBuffer::createArrayBuffer and ArrayBuffer::decodeArrayBuffer on payloads built the way the firmware builds them,
+ * find device response, providers buffer, OTA data block and database dump.
+ * One JSON object per line is printed, compare two runs with compare.py.
+ *
+ * 序列化核心的回归测试：在与固件构建方式相同的数据上测试 ArrayBuffer::createArrayBuffer 和
+ * ArrayBuffer::decodeArrayBuffer 的字节数、堆内存分配次数和耗时，
+ * 包括查找设备的响应、provider缓存、OTA数据块和数据库导出。
+ * 每行输出一个JSON对象，用 compare.py 比较两次运行的结果。
+ */
+#include "common.h"
+
+#define ROUNDS 5000
+#define BATCHES 10
+
+struct Payload
+{
+    const char *name;
+    Elements fields;
+};
+
+// same layout as Provider::write, id, settings, name and custom id in a nested uint8 array
+// 与 Provider::write 的格式相同，id、设置、名称和自定义id位于嵌套的二进制数组中
+static void writeProvider(ArrayBufferWriter *writer, uint16_t id, uint8_t settings, const char *name, uint64_t customID)
+{
+    Element fields[4] = {Element(id), Element(settings), Element(name), Element(customID)};
+    uint32_t length = 0;
+    for (uint8_t i = 0; i < 4; ++i)
+        length += fields[i].getOuterBufferLength();
+    writer->writeHeader(ETYPE_BUFFER, length);
+    for (uint8_t i = 0; i < 4; ++i)
+        if (fields[i].getOuterBufferLength())
+            writer->write(fields[i]);
+}
+
+static std::vector<Payload *> payloads()
+{
+    uint8_t hash[32];
+    for (int i = 0; i < 32; ++i)
+        hash[i] = (uint8_t)(i * 7 + 1);
+
+    // 16 providers as GlobalManager::buildProvidersBuffer writes them
+    // 与 GlobalManager::buildProvidersBuffer 写入的一样的16个provider
+    std::vector<uint8_t> providers;
+    {
+        const char *names[] = {"switch", "brightness", "color temperature", "timer", "restart", "reset wifi",
+                               "ota", "schedule", "scene", "sensor", "log level", "nickname",
+                               "led", "fan speed", "mode", "status"};
+        ArrayBufferWriter writer(ArrayBufferWriter::toVector(&providers));
+        for (uint16_t i = 0; i < 16; ++i)
+            writeProvider(&writer, 0x0100 + i, (uint8_t)(0x20 | (i % 4)), names[i], i % 3 ? 0 : 1000 + i);
+    }
+
+    std::vector<Payload *> output;
+
+    // same fields as GlobalManager::getFindDeviceBuffer
+    // 与 GlobalManager::getFindDeviceBuffer 的字段相同
+    Payload *findDevice = new Payload{"find_device", {}};
+    findDevice->fields = {new Element((uint8_t)0xfa), new Element("5f2d8c1ab7e94e03"), new Element((uint16_t)240),
+                          new Element((uint8_t)0xa0), new Element((uint64_t)1680000000000ull), new Element((uint32_t)183544),
+                          new Element("kitchen light"), new Element(Element(hash, (uint32_t)32).getHex().c_str()),
+                          new Element("42.1.0"), new Element("1.0.3 2023-03-23 10:24:51"),
+                          new Element(providers.data(), (uint32_t)providers.size())};
+    output.push_back(findDevice);
+
+    // providers buffer alone, one nested uint8 array per provider
+    // 单独的provider缓存，每个provider是一个嵌套的二进制数组
+    Payload *providerBuffer = new Payload{"provider_buffer", {}};
+    Elements *decoded = ArrayBuffer::decodeArrayBuffer(providers.data(), providers.size());
+    providerBuffer->fields = *decoded;
+    delete decoded;
+    output.push_back(providerBuffer);
+
+    // OTA data block: command, hash, data and index
+    // OTA数据块：命令、哈希、数据和索引
+    std::vector<uint8_t> block(4096);
+    for (uint32_t i = 0; i < block.size(); ++i)
+        block[i] = (uint8_t)(i * 31);
+    Payload *otaBlock = new Payload{"ota_block", {}};
+    otaBlock->fields = {new Element((uint8_t)0xac), new Element(hash, (uint32_t)32),
+                        new Element(block.data(), (uint32_t)block.size()), new Element((uint32_t)7)};
+    output.push_back(otaBlock);
+
+    // keys and values one after another as MyDB::dump writes them
+    // 与 MyDB::dump 写入的一样依次排列的键和值
+    Payload *dbDump = new Payload{"db_dump", {}};
+    const char *keys[] = {"wifiSSID", "wifiPwd", "token", "nickname", "websocketPort", "universalID",
+                          "userName", "password", "admin", "apSSID", "apPwd", "timezone",
+                          "ntpServer", "lastBoot", "bootCount", "logLevel"};
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        dbDump->fields.push_back(new Element(keys[i]));
+        if (i == 5)
+            dbDump->fields.push_back(new Element(hash, (uint32_t)32));
+        else if (i == 13)
+            dbDump->fields.push_back(new Element((uint64_t)1680000000000ull + i));
+        else if (i % 3 == 1)
+            dbDump->fields.push_back(new Element((uint16_t)(8000 + i)));
+        else
+            dbDump->fields.push_back(new Element("0123456789abcdef" + (i % 8)));
+    }
+    output.push_back(dbDump);
+
+    return output;
+}
+
+// best batch, allocations are the same in every batch
+// 取最快的一批，每批的内存分配次数相同
+template <class F>
+static double run(F f, double *allocations)
+{
+    double best = 1e30;
+    for (int b = 0; b < BATCHES; ++b)
+    {
+        benchmark::resetAllocations();
+        uint64_t start = benchmark::nowNs();
+        for (int r = 0; r < ROUNDS; ++r)
+            f();
+        double ns = (double)(benchmark::nowNs() - start) / ROUNDS;
+        best = ns < best ? ns : best;
+        *allocations = (double)benchmark::allocations / ROUNDS;
+    }
+    return best;
+}
+
+int main()
+{
+    std::vector<Payload *> all = payloads();
+    for (auto p : all)
+    {
+        uint32_t length = 0;
+        uint8_t *encoded = ArrayBuffer::createArrayBuffer(&(p->fields), &length);
+
+        double encodeAllocations = 0, decodeAllocations = 0;
+        double encodeNs = run([&]()
+                              {
+                                  uint32_t outLen = 0;
+                                  uint8_t *output = ArrayBuffer::createArrayBuffer(&(p->fields), &outLen);
+                                  benchmark::doNotOptimize(output);
+                                  delete[] output; },
+                              &encodeAllocations);
+        double decodeNs = run([&]()
+                              {
+                                  Elements *output = ArrayBuffer::decodeArrayBuffer(encoded, length);
+                                  benchmark::doNotOptimize(output);
+                                  for (auto it = output->begin(); it != output->end(); ++it)
+                                      delete (*it);
+                                  delete output; },
+                              &decodeAllocations);
+
+        printf("{\"payload\": \"%s\", \"fields\": %u, \"bytes\": %u, "
+               "\"encode_allocs\": %.2f, \"encode_ns\": %.1f, \"decode_allocs\": %.2f, \"decode_ns\": %.1f}\n",
+               p->name, (unsigned)p->fields.size(), (unsigned)length,
+               encodeAllocations, encodeNs, decodeAllocations, decodeNs);
+
+        delete[] encoded;
+        for (auto it = p->fields.begin(); it != p->fields.end(); ++it)
+            delete (*it);
+        delete p;
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file shared_copy.cpp
+ * @brief Time and heap allocations to put a copy of one uint8 array Element into a response
+ * (new Element(e), encode, delete), like the providers buffer in every find device response.
+ * Add -DELEMENT_SHARED_BUFFER_MIN_SIZE=0 to get results of deep copy.
+ *
+ * 将一个二进制数组Element的拷贝放入响应(new Element(e)，编码，delete)的耗时和堆内存分配次数，
+ * 类似每个查找设备响应中的provider缓存。
+ * 添加 -DELEMENT_SHARED_BUFFER_MIN_SIZE=0 可以得到深拷贝的结果。
+ */
+#include "common.h"
+
+#define ROUNDS 20000
+
+int main()
+{
+    printf("%8s %12s %12s %12s\n", "bytes", "allocs", "copy, ns", "response, ns");
+
+    const uint32_t sizes[] = {64, 1024, 16384};
+    for (uint32_t s = 0; s < 3; ++s)
+    {
+        std::vector<uint8_t> blob(sizes[s], 0x5a);
+        Element source(blob.data(), sizes[s]);
+
+        // copy and release only
+        // 只拷贝和释放
+        benchmark::resetAllocations();
+        uint64_t start = benchmark::nowNs();
+        for (int i = 0; i < ROUNDS; ++i)
+        {
+            Element *copy = new Element(source);
+            benchmark::doNotOptimize(copy);
+            delete copy;
+        }
+        double copyNs = (double)(benchmark::nowNs() - start) / ROUNDS;
+        double allocs = (double)benchmark::allocations / ROUNDS;
+
+        // a response with a few small fields and the copy, encoded and released
+        // 包含几个小字段和该拷贝的响应，编码后释放
+        start = benchmark::nowNs();
+        for (int i = 0; i < ROUNDS; ++i)
+        {
+            Elements response = {new Element((uint8_t)0xaf), new Element((uint32_t)i), new Element(source)};
+            uint32_t length = 0;
+            uint8_t *encoded = ArrayBuffer::createArrayBuffer(&response, &length);
+            benchmark::doNotOptimize(encoded);
+            delete[] encoded;
+            for (auto it = response.begin(); it != response.end(); ++it)
+                delete (*it);
+        }
+        double responseNs = (double)(benchmark::nowNs() - start) / ROUNDS;
+
+        printf("%8u %12.2f %12.1f %12.1f\n", (unsigned)sizes[s], allocs, copyNs, responseNs);
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file slice_forward.cpp
+ * @brief Time and heap allocations to split an OTA block into frames and encode every frame
+ * (command, index, part of block), with parts copied by offset and with Element::slice.
+ *
+ * 将OTA数据块分帧并编码每一帧(命令，序号，数据块的一部分)的耗时和堆内存分配次数，
+ * 分别使用按偏移量拷贝和 Element::slice 取得数据块的一部分。
+ */
+#include "common.h"
+
+#define ROUNDS 20000
+
+int main()
+{
+    printf("%8s %8s %-8s %12s %12s\n", "block", "frame", "method", "allocs", "ns/block");
+
+    const uint32_t blocks[] = {4096, 16384};
+    const uint32_t frames[] = {256, 1024};
+    for (uint32_t b = 0; b < 2; ++b)
+    {
+        std::vector<uint8_t> raw(blocks[b]);
+        for (uint32_t i = 0; i < blocks[b]; ++i)
+            raw[i] = (uint8_t)i;
+        Element block(raw.data(), blocks[b]);
+
+        for (uint32_t f = 0; f < 2; ++f)
+        {
+            for (int method = 0; method < 2; ++method)
+            {
+                benchmark::resetAllocations();
+                uint64_t start = benchmark::nowNs();
+                for (int r = 0; r < ROUNDS; ++r)
+                {
+                    for (uint32_t i = 0; i < blocks[b]; i += frames[f])
+                    {
+                        Element command((uint8_t)0x51), index(i / frames[f]);
+                        Element part = method ? block.slice(i, i + frames[f])
+                                              : Element(raw.data(), frames[f], true, i);
+                        Elements frame = {&command, &index, &part};
+                        uint32_t length = 0;
+                        uint8_t *encoded = ArrayBuffer::createArrayBuffer(&frame, &length);
+                        benchmark::doNotOptimize(encoded);
+                        delete[] encoded;
+                    }
+                }
+                uint64_t elapsed = benchmark::nowNs() - start;
+
+                printf("%8u %8u %-8s %12.2f %12.1f\n", (unsigned)blocks[b], (unsigned)frames[f],
+                       method ? "slice" : "copy", (double)benchmark::allocations / ROUNDS, (double)elapsed / ROUNDS);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file sorted_lookup.cpp
+ * @brief Time and heap allocations to look up one key in an encoded key/value map:
+ * decoding whole buffer and scanning, scanning with ArrayBufferView, and binary search with
+ * ArrayBufferSortedView on a buffer made by ArrayBuffer::createSortedArrayBuffer.
+ *
+ * 在编码后的键值映射中查找一个键的耗时和堆内存分配次数：
+ * 解码整个数组后遍历、使用 ArrayBufferView 遍历，以及在 ArrayBuffer::createSortedArrayBuffer
+ * 生成的数组上使用 ArrayBufferSortedView 二分查找。
+ */
+#include "common.h"
+
+#define ROUNDS 20000
+
+static void run(uint32_t count)
+{
+    Elements units;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        char key[16];
+        sprintf(key, "setting%u", (unsigned)i);
+        units.push_back(new Element(key));
+        units.push_back(new Element((uint32_t)i));
+    }
+
+    uint32_t length = 0, sortedLength = 0;
+    uint8_t *plain = ArrayBuffer::createArrayBuffer(&units, &length);
+    uint8_t *sorted = ArrayBuffer::createSortedArrayBuffer(&units, &sortedLength);
+
+    // every key is looked up once per round
+    // 每一轮中每个键都查找一次
+    std::vector<String> keys;
+    for (uint32_t i = 0; i < count; ++i)
+        keys.push_back(String("setting") + i);
+
+    const char *names[] = {"decode", "view", "sorted"};
+    for (int method = 0; method < 3; ++method)
+    {
+        uint64_t hits = 0;
+        benchmark::resetAllocations();
+        uint64_t start = benchmark::nowNs();
+        for (int r = 0; r < ROUNDS; ++r)
+        {
+            const char *key = keys[r % count].c_str();
+            if (method == 0)
+            {
+                Elements *output = ArrayBuffer::decodeArrayBuffer(plain, length);
+                for (uint32_t i = 0; i < output->size(); i += 2)
+                {
+                    if (!strcmp(output->at(i)->c_str(), key))
+                    {
+                        hits += output->at(i + 1)->getUint32();
+                        break;
+                    }
+                }
+                for (auto it = output->begin(); it != output->end(); ++it)
+                    delete (*it);
+                delete output;
+            }
+            else if (method == 1)
+            {
+                ArrayBufferView view(plain, length);
+                for (auto it = view.begin(); it != view.end(); ++it)
+                {
+                    if (!strcmp(it->c_str(), key))
+                    {
+                        hits += (*++it).getUint32();
+                        break;
+                    }
+                    ++it;
+                }
+            }
+            else
+            {
+                hits += ArrayBufferSortedView(sorted, sortedLength).get(key).getUint32();
+            }
+        }
+        uint64_t elapsed = benchmark::nowNs() - start;
+        benchmark::doNotOptimize(hits);
+
+        printf("%6u %-8s %8u %12.2f %12.1f\n", (unsigned)count, names[method],
+               (unsigned)(method == 2 ? sortedLength : length),
+               (double)benchmark::allocations / ROUNDS, (double)elapsed / ROUNDS);
+    }
+
+    for (auto it = units.begin(); it != units.end(); ++it)
+        delete (*it);
+    delete[] plain;
+    delete[] sorted;
+}
+
+int main()
+{
+    printf("%6s %-8s %8s %12s %12s\n", "keys", "method", "bytes", "allocs", "ns/lookup");
+    run(16);
+    run(256);
+    run(2048);
+    return 0;
+}
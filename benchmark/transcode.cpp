@@ -0,0 +1,95 @@
+/**
+ * @file transcode.cpp
+ * @brief Encoded size of every message as ArrayBuffer, compact ArrayBuffer, MessagePack and CBOR,
+ * and time to encode / decode it: createArrayBuffer / decodeArrayBuffer for ArrayBuffer,
+ * ArrayBufferTranscoder from / back to ArrayBuffer for MessagePack and CBOR.
+ *
+ * 每条消息编码为ArrayBuffer、紧凑模式ArrayBuffer、MessagePack和CBOR后的大小，
+ * 以及编码 / 解码的耗时：ArrayBuffer使用 createArrayBuffer / decodeArrayBuffer，
+ * MessagePack和CBOR使用 ArrayBufferTranscoder 从ArrayBuffer转换和转换回ArrayBuffer。
+ */
+#include "common.h"
+#include <arraybuffertranscoder.hpp>
+
+#define ROUNDS 20000
+#define BATCHES 10
+
+// best batch, other processes on the machine only make it slower
+// 取最快的一批，机器上的其他进程只会让结果变慢
+template <class F>
+static double run(F f)
+{
+    double best = 1e30;
+    for (int b = 0; b < BATCHES; ++b)
+    {
+        uint64_t start = benchmark::nowNs();
+        for (int r = 0; r < ROUNDS; ++r)
+            f();
+        double ns = (double)(benchmark::nowNs() - start) / ROUNDS;
+        best = ns < best ? ns : best;
+    }
+    return best;
+}
+
+int main()
+{
+    printf("%-16s %-12s %8s %12s %12s\n", "message", "format", "bytes", "encode, ns", "decode, ns");
+
+    std::vector<benchmark::Message> messages = benchmark::messages();
+    for (auto &m : messages)
+    {
+        Elements *fields = ArrayBuffer::decodeArrayBuffer(m.buffer.data(), m.buffer.size());
+
+        uint32_t compactLength = 0;
+        uint8_t *compact = ArrayBuffer::createCompactArrayBuffer(fields, &compactLength);
+        delete[] compact;
+
+        double encodeNs = run([&]()
+                              {
+                                  uint32_t length = 0;
+                                  uint8_t *encoded = ArrayBuffer::createArrayBuffer(fields, &length);
+                                  benchmark::doNotOptimize(encoded);
+                                  delete[] encoded; });
+        double decodeNs = run([&]()
+                              {
+                                  Elements *output = ArrayBuffer::decodeArrayBuffer(m.buffer.data(), m.buffer.size());
+                                  for (auto it = output->begin(); it != output->end(); ++it)
+                                      delete (*it);
+                                  delete output; });
+        printf("%-16s %-12s %8u %12.1f %12.1f\n", m.name, "arraybuffer", (unsigned)m.buffer.size(), encodeNs, decodeNs);
+        printf("%-16s %-12s %8u %12s %12s\n", m.name, "compact", (unsigned)compactLength, "-", "-");
+
+        const char *names[] = {"messagepack", "cbor"};
+        for (int f = 0; f < 2; ++f)
+        {
+            ArrayBufferTranscoder::Format format = (ArrayBufferTranscoder::Format)f;
+
+            // outputs keep their capacity, nothing is allocated in loops
+            // 输出保留容量，循环中不分配内存
+            std::vector<uint8_t> converted, restored;
+            converted.reserve(1024);
+            restored.reserve(1024);
+            ArrayBufferTranscoder::encode(format, m.buffer.data(), m.buffer.size(), ArrayBufferWriter::toVector(&converted));
+
+            encodeNs = run([&]()
+                           {
+                               std::vector<uint8_t> *output = &restored;
+                               output->clear();
+                               ArrayBufferTranscoder::encode(format, m.buffer.data(), m.buffer.size(), ArrayBufferWriter::toVector(output));
+                               benchmark::doNotOptimize(output); });
+            decodeNs = run([&]()
+                           {
+                               restored.clear();
+                               ArrayBufferWriter writer(ArrayBufferWriter::toVector(&restored));
+                               ArrayBufferTranscoder::decode(format, converted.data(), converted.size(), &writer);
+                               writer.finish();
+                               benchmark::doNotOptimize(restored); });
+            printf("%-16s %-12s %8u %12.1f %12.1f\n", m.name, names[f], (unsigned)converted.size(), encodeNs, decodeNs);
+        }
+
+        for (auto it = fields->begin(); it != fields->end(); ++it)
+            delete (*it);
+        delete fields;
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file typed_array.cpp
+ * @brief A batch of int16 sensor samples as a list of Elements, one Element each,
+ * against one typed array: encoded size, heap allocations and time to build and encode,
+ * time to decode, and time of sum / min / max.
+ *
+ * 一批 int16 传感器采样值，以每个值一个 Element 的列表与一个类型化数组对比：
+ * 编码后大小、构建并编码的堆内存分配次数和耗时、解码耗时以及求和/最小值/最大值的耗时。
+ */
+#include "common.h"
+
+#define ROUNDS 200
+
+static std::vector<int16_t> makeSamples(uint32_t count)
+{
+    std::vector<int16_t> samples(count);
+    for (uint32_t i = 0; i < count; ++i)
+        samples[i] = (int16_t)((i * 7919) % 4096 - 2048);
+    return samples;
+}
+
+static Element buildList(const std::vector<int16_t> &samples)
+{
+    Element list;
+    list.setList();
+    for (uint32_t i = 0; i < samples.size(); ++i)
+        list.push(Element(samples[i]));
+    return list;
+}
+
+static Element buildArray(const std::vector<int16_t> &samples)
+{
+    Element array;
+    array.setArray(samples.data(), samples.size());
+    return array;
+}
+
+static int64_t reduceList(const Element &list)
+{
+    int64_t sum = 0, min = 0, max = 0;
+    for (uint32_t i = 0; i < list.size(); ++i)
+    {
+        int16_t v = list.at(i)->getInt16();
+        sum += v;
+        min = !i || v < min ? v : min;
+        max = !i || v > max ? v : max;
+    }
+    return sum + min + max;
+}
+
+static int64_t reduceArray(const Element &array)
+{
+    ElementArrayView<int16_t> items = array.getArray<int16_t>();
+    return items.sum() + items.min() + items.max();
+}
+
+template <class Build, class Reduce>
+static void run(const char *name, uint32_t count, Build build, Reduce reduce)
+{
+    std::vector<int16_t> samples = makeSamples(count);
+    uint64_t encodeNs = 0, decodeNs = 0, reduceNs = 0, allocs = 0;
+    uint32_t length = 0;
+
+    for (int i = 0; i < ROUNDS; ++i)
+    {
+        benchmark::resetAllocations();
+        uint64_t start = benchmark::nowNs();
+        Element e = build(samples);
+        std::vector<Element *> container = {&e};
+        uint8_t *encoded = ArrayBuffer::createArrayBuffer(&container, &length);
+        encodeNs += benchmark::nowNs() - start;
+        allocs += benchmark::allocations;
+
+        start = benchmark::nowNs();
+        Elements *output = ArrayBuffer::decodeArrayBuffer(encoded, length);
+        decodeNs += benchmark::nowNs() - start;
+
+        start = benchmark::nowNs();
+        benchmark::doNotOptimize(reduce(*output->at(0)));
+        reduceNs += benchmark::nowNs() - start;
+
+        delete output->at(0);
+        delete output;
+        delete[] encoded;
+    }
+
+    printf("%-6s %6u %8u %10.1f %12.1f %12.1f %12.1f\n", name, count, length,
+           (double)allocs / ROUNDS, (double)encodeNs / ROUNDS / 1000,
+           (double)decodeNs / ROUNDS / 1000, (double)reduceNs / ROUNDS / 1000);
+}
+
+int main()
+{
+    printf("%-6s %6s %8s %10s %12s %12s %12s\n", "kind", "count", "bytes", "allocs", "encode, us", "decode, us", "reduce, us");
+    const uint32_t counts[] = {64, 1024, 8192};
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        run("list", counts[i], buildList, reduceList);
+        run("array", counts[i], buildArray, reduceArray);
+    }
+    return 0;
+}
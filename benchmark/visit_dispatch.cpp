@@ -0,0 +1,96 @@
+/**
+ * @file visit_dispatch.cpp
+ * @brief Time to walk decoded messages and sum every number and the length of every string and uint8 array,
+ * with a getType() ladder and getters, and with Element::visit.
+ *
+ * 遍历解码后的消息，对所有数字求和并累加字符串和二进制数组的长度的耗时，
+ * 分别使用 getType() 判断加读取函数和 Element::visit。
+ */
+#include "common.h"
+
+#define ROUNDS 200000
+
+// consumer code written as usual, every getter checks type once more
+// 通常写法的使用者代码，每个读取函数都会再检查一次类型
+static double ladder(const Element *e)
+{
+    ElementType type = e->getType();
+    if (type == ETYPE_UINT8)
+        return e->getUint8();
+    else if (type == ETYPE_INT8)
+        return e->getInt8();
+    else if (type == ETYPE_UINT16)
+        return e->getUint16();
+    else if (type == ETYPE_INT16)
+        return e->getInt16();
+    else if (type == ETYPE_UINT32)
+        return e->getUint32();
+    else if (type == ETYPE_INT32)
+        return e->getInt32();
+    else if (type == ETYPE_UINT64)
+        return e->getUint64();
+    else if (type == ETYPE_INT64)
+        return e->getInt64();
+    else if (type == ETYPE_FLOAT)
+        return e->getFloat();
+    else if (type == ETYPE_DOUBLE)
+        return e->getDouble();
+    else if (type == ETYPE_STRING)
+        return e->getStringView().length();
+    else if (type == ETYPE_BUFFER)
+        return e->getRawBufferLength();
+    return 0;
+}
+
+struct Sum
+{
+    template <class T>
+    double operator()(T n) const { return n; }
+    template <class T>
+    double operator()(ElementArrayView<T> a) const { return a.size(); }
+    double operator()(ElementVoid) const { return 0; }
+    double operator()(ElementStringView s) const { return s.length(); }
+    double operator()(ElementBufferView b) const { return b.size(); }
+    double operator()(ElementListView) const { return 0; }
+    double operator()(ElementMapView) const { return 0; }
+};
+
+int main()
+{
+    printf("%-16s %8s %12s %12s\n", "message", "fields", "ladder, ns", "visit, ns");
+
+    std::vector<benchmark::Message> messages = benchmark::messages();
+    for (auto &m : messages)
+    {
+        Elements *output = ArrayBuffer::decodeArrayBuffer(m.buffer.data(), m.buffer.size());
+
+        double total = 0;
+        uint64_t start = benchmark::nowNs();
+        for (int r = 0; r < ROUNDS; ++r)
+        {
+            for (auto it = output->begin(); it != output->end(); ++it)
+                total += ladder(*it);
+            benchmark::doNotOptimize(total);
+        }
+        double ladderNs = (double)(benchmark::nowNs() - start) / ROUNDS;
+
+        double visited = 0;
+        start = benchmark::nowNs();
+        for (int r = 0; r < ROUNDS; ++r)
+        {
+            for (auto it = output->begin(); it != output->end(); ++it)
+                visited += (*it)->visit(Sum());
+            benchmark::doNotOptimize(visited);
+        }
+        double visitNs = (double)(benchmark::nowNs() - start) / ROUNDS;
+
+        if (total != visited)
+            printf("results differ\n");
+        printf("%-16s %8u %12.1f %12.1f\n", m.name, (unsigned)output->size(), ladderNs, visitNs);
+
+        for (auto it = output->begin(); it != output->end(); ++it)
+            delete (*it);
+        delete output;
+    }
+    return 0;
+}
@@ -32,8 +32,15 @@
 
 #include <vector>
 #include <Arduino.h>
+#include <math.h>
 #include <functional>
+#include <algorithm>
 #include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <atomic>
+#include <new>
+#include <cstddef>
 #include <mycrypto.h>
 
 #define ARRAY_BUFFER_DEBUG_HEADER "Array Buffer"
@@ -50,8 +57,8 @@
 // 注意：此功能正在开发
 #define AUTO_EXTEND_DATA_RANGE
 
-// will handle "+", "-", "*" for different types if defined
-// 如果定义了此宏，会处理不同类型之间的加减乘
+// will handle "+", "-", "*", "/" for different types if defined
+// 如果定义了此宏，会处理不同类型之间的加减乘除
 #define CROSS_TYPE_CLACULATE
 
 #define ARRAY_BUFFER_DEBUG_ON
@@ -60,6 +67,27 @@
 // 如果定义了此宏，默认的 "int" 构造函数将会自动设置类型和数据
 #define ENABLE_INT_DEFAULT_CONSTRUCTOR_AUTO_SET_TYPE_AND_DATA
 
+// string or uint8 array not longer than this(including '\0') will be stored inside Element
+// without allocating from heap, 0 to disable
+// every Element grows by this size, numbers and containers included, so a decoded message takes
+// more heap in total though fewer allocations, and ElementList on stack grows by ELEMENT_LIST_INLINE_CAPACITY times of it,
+// see benchmark/README.md for numbers
+// 不超过此长度(包括'\0')的字符串或二进制数组会直接存储在Element内部，不从堆上分配内存，设为0则禁用此功能
+// 每个Element都会增大这么多，包括数字和容器，所以解码一条消息分配次数变少但是总共占用更多堆内存，
+// 栈上的ElementList会增大它的 ELEMENT_LIST_INLINE_CAPACITY 倍，具体数据见 benchmark/README.md
+#ifndef ELEMENT_INLINE_BUFFER_SIZE
+#define ELEMENT_INLINE_BUFFER_SIZE 0
+#endif
+
+// string, uint8 array or typed array on heap not shorter than this is shared by copies of Element
+// with a reference count, it is really copied only when one of them modifies it in place
+// set to 0 to disable
+// 堆上不短于此长度的字符串、二进制数组或类型化数组由Element的拷贝通过引用计数共享，
+// 只有在其中一个原地修改它时才真正拷贝，设为0则禁用此功能
+#ifndef ELEMENT_SHARED_BUFFER_MIN_SIZE
+#define ELEMENT_SHARED_BUFFER_MIN_SIZE 64
+#endif
+
 /**
  * @brief all you need right here
  * 你需要的一切类型都有了
@@ -98,10 +126,39 @@ typedef enum : int8_t
 
     // reserved
     // 保留类型
-    ETYPE_EXTRA = 11
+    ETYPE_EXTRA = 11,
+
+    // list of elements, payload is a whole ArrayBuffer
+    // 元素列表，数据是一个完整的ArrayBuffer
+    ETYPE_LIST = 16,
+
+    // map with string keys, payload is an ArrayBuffer of key(string) and value one after another
+    // 以字符串为键的映射，数据是一个键(字符串)和值依次排列的ArrayBuffer
+    ETYPE_MAP = 17,
+
+    // typed array, numbers of one type without type mark for each, payload is item type and items in little endian
+    // 类型化数组，同一类型的数字且每个都没有类型标志，数据是元素类型和小端序的元素
+    ETYPE_ARRAY = 18,
+
+    // uint8 array kept in a file, read in chunks when encoding and encoded as ETYPE_BUFFER,
+    // so this type never appears in encoded data
+    // 保存在文件中的二进制数组，编码时分块读取并编码为ETYPE_BUFFER，
+    // 所以编码后的数据中不会出现此类型
+    ETYPE_FILE = 19
 
 } ElementType;
 
+#ifndef ARRAY_BUFFER_MAX_DEPTH
+// max nesting depth of list and map when decoding, deeper data is treated as malformed
+// to keep stack usage bounded
+// 解码时列表和映射的最大嵌套深度，更深的数据会被当作格式错误，以限制栈的使用
+#define ARRAY_BUFFER_MAX_DEPTH 8
+#endif
+
+class Element;
+class ElementFileSource;
+typedef std::vector<Element *> Elements;
+
 /**
  * @brief error code description
  * 错误代码描述
@@ -127,6 +184,12 @@ typedef union
         uint8_t *p;            // 4 bytes
         uint32_t bufferLength; // 4 bytes
     } buffer;
+    Elements *list; // children of list or map 列表或映射的子元素
+    struct
+    {
+        ElementFileSource *source; // 4 bytes
+        uint32_t length;           // 4 bytes
+    } file;                        // uint8 array kept in a file 保存在文件中的二进制数组
     uint16_t u16;
     int16_t i16;
     uint32_t u32;
@@ -142,5285 +205,8727 @@ typedef union
     } e;
 } ElementData;
 
-class Element;
-class ElementObject;
+// first byte of a buffer in compact mode, no type uses this mark,
+// so decoders without compact mode reject such buffer as malformed
+// 紧凑模式数组的第一个字节，没有任何类型使用此标志
+// 所以不支持紧凑模式的解码器会把这种数组当作格式错误拒绝
+#define ARRAY_BUFFER_COMPACT_MARK 0x7f
+
+// first byte of a buffer with CRC32 trailer, followed by a buffer in normal or compact mode
+// and CRC32 of all bytes before trailer in little endian
+// 带有CRC32结尾的数组的第一个字节，后面是普通或紧凑模式的数组，
+// 最后是之前所有字节的CRC32，小端序
+#define ARRAY_BUFFER_CHECKED_MARK 0x7e
+
+// first byte of a key/value map sorted by key, followed by number of entries(4 bytes),
+// width of offsets(1 byte, 2 or 4), offset of every key counted from first field,
+// then keys and values in normal mode one after another
+// 按键排序的键值映射的第一个字节，后面是条目数量(4字节)、偏移量的宽度(1字节，2或4)、
+// 从第一个字段开始计算的每个键的偏移量，然后是依次排列的普通模式的键和值
+#define ARRAY_BUFFER_SORTED_MARK 0x7d
 
 /**
- * @brief this class hold basic data in RAM
- * 这个类用来在RAM中存储基础数据
+ * @brief helpers of compact mode
+ * integers and lengths are LEB128 encoded, signed integers are zigzag encoded before that
+ * float, double and payload of string and uint8 array are same as normal mode
+ *
+ * 紧凑模式的辅助函数
+ * 整数和长度使用LEB128编码，有符号整数会先进行zigzag编码
+ * 单精度、双精度浮点数以及字符串和二进制数组的数据与普通模式相同
  */
-class Element
+class ArrayBufferVarint
 {
-private:
-    /**
-     * @brief data type of current object stored
-     * 指示当前对象存储的数据类型
-     */
-    ElementType type = ETYPE_VOID;
-
+public:
     /**
-     * @brief last error code of this element object
-     * 这个对象的最后一个错误的错误代码
-     *
+     * @brief bytes needed by a number
+     * 一个数字编码后需要的字节数
      */
-    ElementErrorCode err = E_ERROR_NO_ERROR;
+    static inline uint32_t length(uint64_t n)
+    {
+        uint32_t i = 1;
+        while (n >>= 7)
+            ++i;
+        return i;
+    }
 
     /**
-     * @brief almost all data will be make a copy in this class
-     * but in some cases, you wouldn't like to copy it
-     * so there is a constructor with bool ahead will NOT copy original data
-     * and this varible will indicate clear buffer or not when object deconstructing
-     * default set to true
+     * @brief write a number, buffer must have 10 bytes available
+     * 写入一个数字，缓冲区需要有10个字节可用
      *
-     * 在这个类中，几乎所有的数据都会拷贝一份来存储
-     * 但是有些时候你不想在创建一份拷贝
-     * 所以有一个构造函数bool参数开头的可以只拷贝指针，而【不拷贝】原始数据
-     * 这个变量用于指示是否需要清理拷贝的buffer
-     * 默认是true
-     */
-    volatile bool copiedBuffer = true;
-
-    /**
-     * @brief hold data
-     * 存储数据
+     * @return bytes written 写入的字节数
      */
-    ElementData data;
+    static inline uint32_t write(uint8_t *buffer, uint64_t n)
+    {
+        uint32_t i = 0;
+        while (n >= 0x80)
+        {
+            buffer[i++] = (uint8_t)(n | 0x80);
+            n >>= 7;
+        }
+        buffer[i++] = (uint8_t)n;
+        return i;
+    }
 
     /**
-     * @brief set string buffer
-     * 设置字符串
+     * @brief read a number
+     * 读取一个数字
      *
-     * @param data c string c字符串
-     * @param offset offset that copy data from original buffer 从源数组开始拷贝的数据的偏移量
-     * @param length length of c string 字符串的长度
-     * @return true valid data 有效数据
-     * @return false invalid data 无效数据
+     * @param buffer source 源数组
+     * @param available bytes available in source 源数组中可读的字节数
+     * @param n output 输出
+     * @return int32_t bytes consumed, -2 if truncated or too long 读取的字节数，数据不完整或过长时返回-2
      */
-    bool _setString(const char *data, uint32_t offset = 0, uint32_t length = 0)
+    static inline int32_t read(const uint8_t *buffer, uint32_t available, uint64_t *n)
     {
-        if (data)
+        uint64_t result = 0;
+        for (uint32_t i = 0; i < available && i < 10; ++i)
         {
-            // get length of string
-            // 获取目标字符串的长度
-            if (!length)
-            {
-                length = strlen(data);
-            }
-            if (length)
+            result |= (uint64_t)(buffer[i] & 0x7f) << (7 * i);
+            if (!(buffer[i] & 0x80))
             {
-                ++length;
-                // clear buffer if current object already stored data
-                // 如果当前对象已经存储了其他数据会清除掉其他数据
-                this->reset(ETYPE_STRING);
-
-                // copy original data if length is non zero
-                // 如果不是空字符串就拷贝数据
-                return this->_copyBuffer((uint8_t *)data, length, offset, ETYPE_STRING);
+                (*n) = result;
+                return i + 1;
             }
         }
-        ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "type set to NONE");
-        this->type = ETYPE_VOID;
-        return false;
+        return -2;
     }
 
-    bool _setString(const String &data)
+    static inline uint64_t zigzag(int64_t n) { return ((uint64_t)n << 1) ^ (uint64_t)(n >> 63); }
+    static inline int64_t unzigzag(uint64_t n) { return (int64_t)(n >> 1) ^ -(int64_t)(n & 1); }
+
+    /**
+     * @brief get number to be written from an integer by its type
+     * 根据类型获取整数需要写入的数字
+     */
+    static uint64_t fromData(const ElementData &d, ElementType type)
     {
-        return this->_setString(data.c_str());
+        switch (type)
+        {
+        case ETYPE_UINT8:
+            return d.u8;
+        case ETYPE_INT8:
+            return zigzag(d.i8);
+        case ETYPE_UINT16:
+            return d.u16;
+        case ETYPE_INT16:
+            return zigzag(d.i16);
+        case ETYPE_UINT32:
+            return d.u32;
+        case ETYPE_INT32:
+            return zigzag(d.i32);
+        case ETYPE_UINT64:
+            return d.u64;
+        case ETYPE_INT64:
+            return zigzag(d.i64);
+        default:
+            return 0;
+        }
     }
 
     /**
-     * @brief copy raw data from another area
-     * 从另一个buffer拷贝原始数据
+     * @brief put a number read into a zeroed union as integer of given type
+     * 把读取到的数字按给定的整数类型放入已置零的联合体
      *
-     * @param buffer binary uint8 array 二进制数组指针
-     * @param length length of data 数组长度
-     * @param offset offset in source 需要从原始缓冲区开始拷贝的偏移量
-     * @param type default type 默认类型
-     *
-     * @return true success 成功
-     * @return false failed 失败
+     * @return false if number is out of range of type 数字超出类型的范围时返回false
      */
-    bool _copyBuffer(uint8_t *buffer, uint32_t length, uint32_t offset = 0, ElementType type = ETYPE_BUFFER)
+    static bool toData(uint64_t n, ElementType type, ElementData *d)
     {
-// allocate buffer
-// 分配内存
-#ifdef CONFIG_IDF_TARGET_ESP32C3
-        try
-        {
-            this->data.buffer.p = new uint8_t[length];
-        }
-        catch (const std::bad_alloc &e)
-        {
-            this->data.buffer.p = nullptr;
-        }
-#else
-        this->data.buffer.p = new (std::nothrow) uint8_t[length];
-#endif
+        uint32_t width = type < 0 ? -type : type;
+        if (width != 1 && width != 2 && width != 4 && width != 8)
+            return false;
 
-        // check memory allocation
-        // 检测内存分配
-        if (!this->data.buffer.p)
+        if (type > 0)
         {
-            this->type = ETYPE_VOID;
-            this->err = E_ERROR_HEAP_FULL;
-            this->data.buffer.bufferLength = 0;
-            return false;
+            if (width < 8 && (n >> (width * 8)))
+                return false;
+            memcpy((uint8_t *)d, &n, width);
+            return true;
         }
-        memset(this->data.buffer.p, 0, length);
 
-        // copy from origin
-        // 从原始位置拷贝数据
-        memcpy(this->data.buffer.p, buffer + offset, length);
-        // Serial.printf("copy data length: %lu, offset: %lu\n", length, offset);
-        if (type == ETYPE_STRING)
+        int64_t v = unzigzag(n);
+        if (width < 8)
         {
-            (this->data.buffer.p)[length - 1] = 0;
+            int64_t limit = (int64_t)1 << (width * 8 - 1);
+            if (v < -limit || v >= limit)
+                return false;
         }
-        this->type = type;
-        this->data.buffer.bufferLength = length;
-        // Serial.printf("this->data.buffer.bufferLength: %lu\n", this->data.buffer.bufferLength);
-        this->copiedBuffer = true;
+        memcpy((uint8_t *)d, &v, width);
         return true;
     }
+};
 
-    template <class T0, class T1>
-    inline bool issame()
-    {
-        return std::is_same<T0, T1>::value;
-    }
+// size of buffer for any number written by ElementNumber::toChars or Element::toChars, including '\0'
+// ElementNumber::toChars 或 Element::toChars 写入任意数字所需的缓冲区大小，包括'\0'
+#define ELEMENT_NUMBER_CHARS_SIZE 24
 
+/**
+ * @brief a number of any type held as signed integer, unsigned integer or floating point,
+ * all number operators of Element are generated from this one definition,
+ * integers are calculated and compared exactly, they never go through double
+ *
+ * 以有符号整数、无符号整数或浮点数形式保存的任意类型的数字，
+ * Element 所有的数字运算符都由这一个定义生成，
+ * 整数的运算和比较都是精确的，不会转换为double
+ */
+class ElementNumber
+{
 public:
-    /**
-     * @brief default constructor, type set to ETYPE_VOID
-     * 默认无参构造函数, 类型被设置为ETYPE_VOID
-     */
-    inline Element() { this->type = ETYPE_VOID; }
-
-    /**
-     * @brief copy from another element, this is a special copy constructor
-     * using pointer of another object
-     * 拷贝构造函数， 可以从另一个对象拷贝一模一样的数据
-     * @param e pointer of another object 另一个对象的指针
-     */
-    inline Element(const Element *e)
+    typedef enum : uint8_t
     {
-        this->copyFrom((Element *)e);
-    }
+        SIGNED = 0,
+        UNSIGNED = 1,
+        FLOATING = 2
+    } Kind;
 
-    inline Element(const Element &e)
+    typedef enum : uint8_t
     {
-        this->copyFrom((Element *)(&e));
-    }
+        ADD,
+        SUB,
+        MUL,
+        DIV,
+        MOD,
+        AND,
+        OR,
+        XOR
+    } Operation;
 
     /**
-     * @brief specific constructor
-     * 专门类型的构造函数
+     * @brief comparison and assignment are enabled for arithmetic types and enums,
+     * arithmetic returning a T only for arithmetic types, bitwise and modulo only for integers
      *
-     * @param n number 数字
+     * 比较和赋值对算术类型和枚举启用，
+     * 返回T的算术运算仅对算术类型启用，位运算和取模仅对整数启用
      */
-    inline Element(const uint8_t &n) : type(ETYPE_UINT8) { this->data.u8 = n; }
-    inline Element(const int8_t &n) : type(ETYPE_INT8) { this->data.i8 = n; };
-    inline Element(const uint16_t &n) : type(ETYPE_UINT16) { this->data.u16 = n; };
-    inline Element(const int16_t &n) : type(ETYPE_INT16) { this->data.i16 = n; };
-    inline Element(const uint32_t &n) : type(ETYPE_UINT32) { this->data.u32 = n; };
-
-#ifdef ENABLE_INT_DEFAULT_CONSTRUCTOR_AUTO_SET_TYPE_AND_DATA
-
-#if CONFIG_IDF_TARGET_ESP32C3 //
-    inline Element(const int &n)
+    template <class T, class R>
+    struct Enable : std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, R>
     {
-        this->setNumber(n);
-    }
-#else
+    };
 
-    inline Element(const int32_t &n)
+    template <class T, class R>
+    struct EnableArithmetic : std::enable_if<std::is_arithmetic<T>::value, R>
     {
-        this->setNumber(n);
-    }
-#endif
-#else
-    inline Element(const int32_t &n) : type(ETYPE_INT32)
+    };
+
+    template <class T, class R>
+    struct EnableInteger : std::enable_if<std::is_integral<T>::value, R>
     {
-        this->data.i32 = n;
     };
-#endif
 
-    inline Element(const uint64_t &n) : type(ETYPE_UINT64)
+    Kind kind;
+    union
     {
-        this->data.u64 = n;
+        int64_t i;
+        uint64_t u;
+        double d;
     };
-    inline Element(const int64_t &n) : type(ETYPE_INT64) { this->data.i64 = n; };
-    inline Element(const float &n) : type(ETYPE_FLOAT) { this->data.f = n; };
-    inline Element(const double &n) : type(ETYPE_DOUBLE) { this->data.d = n; };
+
+    ElementNumber() : kind(SIGNED), i(0) {}
 
     /**
-     * @brief copy data from c string
-     * 从c字符串中拷贝原始数据
+     * @brief type of Element holding a T,
+     * values of ElementType of integers are their size, negative for signed ones
      *
-     * @param str c string; c字符串
+     * 存储T类型时Element的类型，
+     * 整数的ElementType的值是其大小，有符号的为负数
      */
-    inline Element(const char *str) : type(ETYPE_STRING) { this->_setString(str); }
+    template <class T>
+    static constexpr ElementType typeOf()
+    {
+        return std::is_floating_point<T>::value
+                   ? (sizeof(T) == sizeof(float) ? ETYPE_FLOAT : ETYPE_DOUBLE)
+                   : (ElementType)(_isSigned<T>() ? -(int8_t)sizeof(T) : (int8_t)sizeof(T));
+    }
+
+    template <class T>
+    static inline ElementNumber of(const T &n)
+    {
+        ElementNumber r;
+        if (std::is_floating_point<T>::value)
+        {
+            r.kind = FLOATING;
+            r.d = (double)n;
+        }
+        else if (_isSigned<T>())
+        {
+            r.i = (int64_t)n;
+        }
+        else
+        {
+            r.kind = UNSIGNED;
+            r.u = (uint64_t)n;
+        }
+        return r;
+    }
 
     /**
-     * @brief string constructor, always make a copy
-     * 字符串的构造函数，会拷贝原始字符串
+     * @brief read number stored in union by type, zero if type is not a number,
+     * integers are read by their size, which is absolute value of their type
      *
-     * @param str c string or arduino String(object or pointer) c字符串或Arduino字符串(对象或指针)
+     * 按类型读取联合体中存储的数字，类型不是数字时为0，
+     * 整数按其大小读取，大小即类型的绝对值
      */
-    inline Element(const char *str, uint32_t offset, uint32_t length)
+    static ElementNumber from(const ElementData &d, ElementType type)
     {
-        this->_setString(str, offset, length ? length : strlen(str));
+        ElementNumber r;
+        if (type == ETYPE_FLOAT || type == ETYPE_DOUBLE)
+        {
+            r.kind = FLOATING;
+            r.d = type == ETYPE_FLOAT ? (double)d.f : d.d;
+        }
+        else if (type && type < 9)
+        {
+            // integer at lowest bytes of union(little endian), higher bytes may be anything
+            // 整数位于联合体的低字节（小端），高字节可能是任意值
+            uint8_t shift = 64 - 8 * (type < 0 ? -type : type);
+            uint64_t u = d.u64 << shift;
+            r.kind = type < 0 ? SIGNED : UNSIGNED;
+            r.u = type < 0 ? (uint64_t)((int64_t)u >> shift) : u >> shift;
+        }
+        return r;
     }
-    inline Element(const String &str, uint32_t offset = 0)
+
+    template <class T>
+    inline typename std::enable_if<std::is_floating_point<T>::value, T>::type to() const
     {
-        this->_setString(str.c_str(), offset, str.length());
+        return this->kind == FLOATING ? (T)this->d : (this->kind == SIGNED ? (T)this->i : (T)this->u);
     }
-    inline Element(const String *str, uint32_t offset = 0)
+
+    // same bits for signed and unsigned integers, negative floating point is truncated as signed
+    // 有符号和无符号整数的位相同，负的浮点数按有符号截断
+    template <class T>
+    inline typename std::enable_if<!std::is_floating_point<T>::value, T>::type to() const
     {
-        this->_setString(str->c_str(), offset, str->length());
+        return (T)(this->kind != FLOATING ? this->u : (this->d < 0 ? (uint64_t)(int64_t)this->d : (uint64_t)this->d));
     }
-    inline Element(const std::string &str, uint32_t offset = 0)
+
+    /**
+     * @brief write into a union as given type, integers are truncated to their size
+     * 以给定类型写入联合体，整数会被截断为其大小
+     */
+    void store(ElementData *d, ElementType type) const
     {
-        this->_setString(str.c_str(), offset, str.length());
+        d->u64 = 0;
+        if (type == ETYPE_FLOAT)
+        {
+            d->f = this->to<float>();
+        }
+        else if (type == ETYPE_DOUBLE)
+        {
+            d->d = this->to<double>();
+        }
+        else if (type && type < 9)
+        {
+            uint8_t shift = 64 - 8 * (type < 0 ? -type : type);
+            d->u64 = (this->to<uint64_t>() << shift) >> shift;
+        }
     }
-    inline Element(const std::string *str, uint32_t offset = 0)
+
+    /**
+     * @brief kind of result, mixed signed and unsigned integers are calculated as signed 64 bits
+     * 结果的类别，有符号和无符号整数混合时按64位有符号整数计算
+     */
+    static inline Kind promote(Kind a, Kind b)
     {
-        this->_setString(str->c_str(), offset, str->length());
+        static const Kind table[3][3] = {
+            // signed, unsigned, floating
+            {SIGNED, SIGNED, FLOATING},
+            {SIGNED, UNSIGNED, FLOATING},
+            {FLOATING, FLOATING, FLOATING}};
+        return table[a][b];
     }
 
     /**
-     * @brief raw uint8 array constructor, this will copy from original buffer
-     * 二进制数组的构造函数
+     * @brief compare two numbers, a negative integer is less than any unsigned integer
+     * 比较两个数字，负整数小于任何无符号整数
      *
-     * @param buffer source uint8 array 源数组
-     * @param bufferLength length of uint8 array 数组长度
-     * @param copyOrigin copy origin data or not 是否拷贝原始数据
-     * @param offsetInSrc offset in source 源数组开始拷贝的偏移量
+     * @return -1, 0, 1, or 2 if unordered(NaN) 无法比较(NaN)时返回2
      */
-    explicit inline Element(uint8_t *buffer, uint32_t bufferLength, bool copyOrigin = true, uint32_t offsetInSrc = 0)
+    static int8_t compare(const ElementNumber &a, const ElementNumber &b)
     {
-        if (copyOrigin)
+        if (a.kind == FLOATING || b.kind == FLOATING)
         {
-            if (!this->_copyBuffer(buffer, bufferLength, offsetInSrc, ETYPE_BUFFER))
-            {
-                this->type = ETYPE_VOID;
-                // this->data.buffer.p = nullptr;
-                bzero(&(this->data), sizeof(ElementData));
-                this->data.buffer.bufferLength = 0;
-            }
+            double x = a.to<double>(), y = b.to<double>();
+            return x < y ? -1 : (x > y ? 1 : (x == y ? 0 : 2));
         }
-        else
+
+        if (a.kind != b.kind)
         {
-            this->reset(ETYPE_BUFFER);
-            this->data.buffer.p = buffer;
-            this->data.buffer.bufferLength = bufferLength;
-            this->copiedBuffer = false;
+            if (a.kind == SIGNED && a.i < 0)
+                return -1;
+            if (b.kind == SIGNED && b.i < 0)
+                return 1;
+        }
+        else if (a.kind == SIGNED)
+        {
+            return a.i < b.i ? -1 : (a.i > b.i ? 1 : 0);
         }
+
+        // both are not negative now
+        // 此时两者都不是负数
+        return a.u < b.u ? -1 : (a.u > b.u ? 1 : 0);
     }
 
-#ifdef ARRAY_BUFFER_DEBUG_ON
-    uint8_t *getRAM(int32_t *outLen = nullptr) const
+    /**
+     * @brief integers wrap around like uint64_t, integer division by zero gives zero,
+     * bitwise operations on floating point take their integer part
+     *
+     * 整数像 uint64_t 一样溢出回绕，整数除以0结果为0，
+     * 浮点数的位运算使用其整数部分
+     */
+    static inline ElementNumber calculate(Operation op, const ElementNumber &a, const ElementNumber &b)
     {
-        if (outLen)
+        // most common case inline, bits of sum, difference and product of integers are same
+        // whatever their signs are
+        // 最常见的情况内联，整数的和、差、积的位与其符号无关
+        if (op <= MUL && a.kind != FLOATING && b.kind != FLOATING)
         {
-            (*outLen) = sizeof(ElementData);
+            ElementNumber r;
+            r.kind = promote(a.kind, b.kind);
+            r.u = op == ADD ? a.u + b.u : (op == SUB ? a.u - b.u : a.u * b.u);
+            return r;
         }
-        return (uint8_t *)(this->data.u64);
+        return _calculate(op, a, b);
     }
-#endif
+
     /**
-     * @brief set type automatically by data range
-     * 自动根据数据大小设置类型
+     * @brief write number as text, like std::to_chars, nothing is allocated,
+     * floating point is written with fixed decimals like String(double),
+     * or as d.ddde+N if it is too large for fixed point
      *
-     * @note only integer match this function
-     * 仅整数适用此函数
+     * 将数字写为文本，类似 std::to_chars，不分配任何内存，
+     * 浮点数像String(double)一样使用固定的小数位数，数值太大时写为 d.ddde+N
      *
-     * this function fit in default int type to set correct type automatically
-     * 这个函数适用于默认int自动设置对应的类型
+     * @param output at least ELEMENT_NUMBER_CHARS_SIZE bytes, ends with '\0'
+     * 至少 ELEMENT_NUMBER_CHARS_SIZE 字节，以'\0'结尾
+     * @param decimals decimals of floating point, at most 9 浮点数的小数位数，最多9位
+     * @return length without '\0' 不包括'\0'的长度
+     */
+    uint32_t toChars(char *output, uint8_t decimals = 2) const
+    {
+        if (this->kind == FLOATING)
+            return _writeDouble(output, this->d, decimals);
+        if (this->kind == SIGNED && this->i < 0)
+        {
+            *output = '-';
+            return 1 + _writeUnsigned(output + 1, 0 - this->u);
+        }
+        return _writeUnsigned(output, this->u);
+    }
+
+    /**
+     * @brief read a number from text, like std::from_chars, nothing is allocated,
+     * no leading space or '+' is accepted, text with '.' or exponent is floating point,
+     * an integer is signed only if it is negative
+     * floating point is exact when it has at most 15 significant digits and exponent within 22,
+     * which covers most of configurations, otherwise it is within 2 ulp of strtod
      *
-     * @param n number 数字
-     * @param forceType manually set type 手动设置类型
+     * 从文本中读取数字，类似 std::from_chars，不分配任何内存，
+     * 不接受前导空格和'+'，包含'.'或指数的文本为浮点数，整数仅在为负数时为有符号
+     * 有效数字不超过15位且指数在22以内时浮点数是精确的，可以覆盖大部分配置，否则与strtod的误差在2 ulp以内
+     *
+     * @param str text, not necessarily ending with '\0' 文本，不一定以'\0'结尾
+     * @param length length of text 文本长度
+     * @param out result, unchanged if failed 结果，失败时不修改
+     * @return characters used, 0 if there is no number or integer is out of range
+     * 使用的字符数，没有数字或整数超出范围时为0
      */
-    void setNumber(int64_t n, ElementType forceType = ETYPE_VOID)
+    static uint32_t fromChars(const char *str, uint32_t length, ElementNumber *out)
     {
-        /**
-         * @brief
-         * in this part, it may should use like std::is_same<T, int>::value to set type and value
-         * but in some cases, that may cause problem, so use number to set type and value
-         *
-         * 这部分可能应该使用类似于std::is_same<T, int>::value 来设置类型和数据
-         * 但是在某些情况下可能会导致错误，所以直接使用数组的大小来设置类型和值
-         *
-         */
-        this->clearBuffer();
+        const char *p = str, *end = str + length;
+        bool negative = p < end && *p == '-';
+        p += negative;
 
-        if (n >= 0)
+        // digits after 19 significant ones only change exponent
+        // 19位有效数字之后的数字只改变指数
+        uint64_t mantissa = 0;
+        int32_t exponent = 0;
+        bool any = false, floating = false, overflow = false;
+
+        for (; p < end && _isDigit(*p); ++p)
         {
-            // unsigned
-            if (n < 256)
-            {
-                this->reset(ETYPE_UINT8);
-                this->data.u8 = n;
-            }
-            else if (n > 0xff && n < 65536)
+            any = true;
+            if (!_append(&mantissa, *p))
             {
-                this->reset(ETYPE_UINT16);
-                this->data.u16 = n;
-            }
-            else if (n > 0xffff && n < 4294967296)
-            {
-                this->reset(ETYPE_UINT32);
-                this->data.u32 = n;
-            }
-            else
-            {
-                this->reset(ETYPE_UINT64);
-                this->data.u64 = n;
+                overflow = true;
+                ++exponent;
             }
         }
-        else
+
+        if (p < end && *p == '.')
         {
-            // signed
-            if (n >= -128)
+            for (++p; p < end && _isDigit(*p); ++p)
             {
-                this->reset(ETYPE_INT8);
-                this->data.i8 = n;
-            }
-            else if (n < -128 && n >= -32768)
-            {
-                this->reset(ETYPE_INT16);
-                this->data.i16 = n;
-            }
-            else if (n < -32768 && n >= -2147483647)
-            {
-                this->reset(ETYPE_INT32);
-                this->data.i32 = n;
+                any = true;
+                if (_append(&mantissa, *p))
+                    --exponent;
             }
-            else
+            floating = true;
+        }
+
+        if (!any)
+            return 0;
+
+        // exponent is only taken when it has digits
+        // 指数只有在有数字时才被使用
+        if (p < end && (*p == 'e' || *p == 'E'))
+        {
+            const char *q = p + 1;
+            bool negativeExponent = q < end && *q == '-';
+            q += q < end && (*q == '-' || *q == '+');
+            if (q < end && _isDigit(*q))
             {
-                this->reset(ETYPE_INT64);
-                this->data.i64 = n;
+                int32_t e = 0;
+                for (; q < end && _isDigit(*q); ++q)
+                    e = e < 100000 ? e * 10 + (*q - '0') : e;
+                exponent += negativeExponent ? -e : e;
+                floating = true;
+                p = q;
             }
         }
-        if (forceType != ETYPE_VOID)
+
+        if (floating)
         {
-            this->type = forceType;
+            double d = _scale(mantissa, exponent);
+            out->kind = FLOATING;
+            out->d = negative ? -d : d;
+        }
+        else
+        {
+            if (overflow || (negative && mantissa > ((uint64_t)1 << 63)))
+                return 0;
+            out->kind = negative ? SIGNED : UNSIGNED;
+            out->u = negative ? 0 - mantissa : mantissa;
         }
+        return p - str;
     }
 
-    /**
-     * @brief this function will indicate current object if has available data
-     * 这个函数用来指示当前对象是否存储了有用的数据
-     *
-     * @return true object stored valid data 对象存储了有效的数据可供读取
-     * @return false object hasn't any valid data stored 对象没有存储任何有效数据
-     */
-    inline bool available() const
+private:
+    static inline bool _isDigit(char c) { return (uint8_t)(c - '0') < 10; }
+
+    // false if one more digit does not fit
+    // 再多一位数字放不下时返回false
+    static inline bool _append(uint64_t *n, char c)
     {
-        return this->type != ETYPE_VOID && this->err == E_ERROR_NO_ERROR;
+        uint8_t digit = c - '0';
+        if (*n > 1844674407370955161ULL || (*n == 1844674407370955161ULL && digit > 5))
+            return false;
+        *n = *n * 10 + digit;
+        return true;
     }
 
-    /**
-     * @brief manually copy object by developer
-     * 开发者可以使用这两个函数手动从另一个对象或者缓存拷贝数据
-     *
-     * @param e pointer of another object
-     * 另一个对象的指针
-     * @return true success 成功
-     * @return false failed 失败
-     */
-    bool copyFrom(Element *e)
+    static const double *_powers()
     {
-        if (!e)
+        static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        return powers;
+    }
+
+    // mantissa * 10 ^ exponent, one correctly rounded operation when both are exact doubles
+    // mantissa * 10 ^ exponent，两者都是精确的double时只有一次正确舍入的运算
+    static double _scale(uint64_t mantissa, int32_t exponent)
+    {
+        const double *powers = _powers();
+        double d = (double)mantissa;
+        if (!mantissa)
+            return 0;
+        for (; exponent > 22 && d <= 1.7976931348623157e308; exponent -= 22)
+            d *= 1e22;
+        for (; exponent < -22 && d > 0; exponent += 22)
+            d /= 1e22;
+        return exponent < 0 ? d / powers[-exponent] : d * powers[exponent];
+    }
+
+    // two digits a time, and 32 bits division wherever possible, 64 bits division is slow on esp32
+    // 每次两位数字，尽量使用32位除法，64位除法在esp32上很慢
+    static uint32_t _writeUnsigned(char *output, uint64_t n)
+    {
+        static const char pairs[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                                    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                                    "8081828384858687888990919293949596979899";
+        char buffer[20];
+        char *p = buffer + 20;
+
+        while (n > 0xffffffff)
         {
-            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "copy target is nullptr");
-            return false;
+            uint32_t low = (uint32_t)(n % 1000000000);
+            n /= 1000000000;
+            for (uint8_t i = 0; i < 4; ++i, low /= 100)
+                memcpy(p -= 2, pairs + (low % 100) * 2, 2);
+            *--p = '0' + low;
         }
 
-        if (e->getType() == ETYPE_VOID)
+        uint32_t v = (uint32_t)n;
+        for (; v >= 100; v /= 100)
+            memcpy(p -= 2, pairs + (v % 100) * 2, 2);
+        if (v >= 10)
+            memcpy(p -= 2, pairs + v * 2, 2);
+        else
+            *--p = '0' + v;
+
+        uint32_t length = buffer + 20 - p;
+        memcpy(output, p, length);
+        output[length] = 0;
+        return length;
+    }
+
+    static uint32_t _writeDouble(char *output, double n, uint8_t decimals)
+    {
+        char *p = output;
+        if (n != n)
         {
-            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "the type of copy target has type ETYPE_VOID");
-            return false;
+            memcpy(output, "nan", 4);
+            return 3;
+        }
+        if (n < 0)
+        {
+            *p++ = '-';
+            n = -n;
+        }
+        if (n > 1.7976931348623157e308)
+        {
+            memcpy(p, "inf", 4);
+            return p - output + 3;
         }
 
-        this->clearBuffer();
-        ElementType type = e->getType();
-        this->type = type;
-        switch (type)
+        decimals = decimals > 9 ? 9 : decimals;
+        uint32_t scale = (uint32_t)_powers()[decimals];
+        int32_t exponent = 0;
+
+        // rounded to decimals as a fixed point integer, or d.ddd and exponent if it does not fit
+        // 按小数位数舍入为定点整数，放不下时使用 d.ddd 和指数
+        double scaled = n * scale + 0.5;
+        if (scaled >= 18446744073709551616.0)
         {
-        case ETYPE_UINT8:
-        case ETYPE_INT8:
-            this->data.i8 = e->getInt8();
+            exponent = (int32_t)floor(log10(n));
+            n /= pow(10.0, exponent);
+            scaled = n * scale + 0.5;
+            if (scaled >= 10.0 * scale)
+            {
+                scaled = n / 10 * scale + 0.5;
+                ++exponent;
+            }
+        }
+
+        uint64_t v = (uint64_t)scaled;
+        uint64_t integer = v <= 0xffffffff ? (uint32_t)v / scale : v / scale;
+        uint32_t fraction = (uint32_t)(v - integer * scale);
+
+        p += _writeUnsigned(p, integer);
+        if (decimals)
+        {
+            *p++ = '.';
+            for (uint8_t i = decimals; i; --i, fraction /= 10)
+                p[i - 1] = '0' + fraction % 10;
+            p += decimals;
+        }
+        if (exponent)
+        {
+            memcpy(p, "e+", 2);
+            p += 2 + _writeUnsigned(p + 2, exponent);
+        }
+        *p = 0;
+        return p - output;
+    }
+
+    static ElementNumber _calculate(Operation op, const ElementNumber &a, const ElementNumber &b)
+    {
+        ElementNumber r;
+        r.kind = promote(a.kind, b.kind);
+
+        if (r.kind == FLOATING && op < AND)
+        {
+            double x = a.to<double>(), y = b.to<double>();
+            switch (op)
+            {
+            case ADD:
+                r.d = x + y;
+                break;
+            case SUB:
+                r.d = x - y;
+                break;
+            case MUL:
+                r.d = x * y;
+                break;
+            case DIV:
+                r.d = x / y;
+                break;
+            default:
+                r.d = fmod(x, y);
+                break;
+            }
+            return r;
+        }
+
+        if (r.kind == FLOATING)
+            r.kind = SIGNED;
+
+        // two's complement, same bits for signed and unsigned
+        // 补码，有符号和无符号的位相同
+        uint64_t x = a.kind == FLOATING ? (uint64_t)(int64_t)a.d : a.u;
+        uint64_t y = b.kind == FLOATING ? (uint64_t)(int64_t)b.d : b.u;
+        switch (op)
+        {
+        case ADD:
+            r.u = x + y;
             break;
-        case ETYPE_UINT16:
-        case ETYPE_INT16:
-            this->data.i16 = e->getInt16();
+        case SUB:
+            r.u = x - y;
             break;
-        case ETYPE_UINT32:
-        case ETYPE_INT32:
-            this->data.i32 = e->getInt32();
+        case MUL:
+            r.u = x * y;
             break;
-        case ETYPE_UINT64:
-        case ETYPE_INT64:
-            this->data.i64 = e->getInt64();
+        case DIV:
+        case MOD:
+            if (!y)
+                r.u = 0;
+            else if (r.kind == UNSIGNED)
+                r.u = op == DIV ? x / y : x % y;
+            else if ((int64_t)y == -1)
+                // INT64_MIN / -1 overflows
+                // INT64_MIN / -1 会溢出
+                r.u = op == DIV ? 0 - x : 0;
+            else
+                r.i = op == DIV ? (int64_t)x / (int64_t)y : (int64_t)x % (int64_t)y;
             break;
-        case ETYPE_FLOAT:
-            this->data.f = e->getFloat();
+        case AND:
+            r.u = x & y;
             break;
-        case ETYPE_DOUBLE:
-            this->data.d = e->getDouble();
+        case OR:
+            r.u = x | y;
             break;
-        case ETYPE_STRING:
-            return this->_setString((const char *)e->getRawBuffer(), 0, e->getRawBufferLength() - 1);
-        case ETYPE_BUFFER:
-            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "copy from another element u8a");
-            return this->copyFrom(e->getUint8Array(), e->getU8aLen());
         default:
-            this->type = ETYPE_VOID;
-            return false;
+            r.u = x ^ y;
+            break;
         }
-        ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "copy finished");
-        return true;
+        return r;
     }
 
-    /**
-     * @brief manually copy object by developer
-     * 开发者可以使用这两个函数手动从另一个对象或者缓存拷贝数据
-     *
-     * @param element another object
-     * 另一个对象
-     * @return true success 成功
-     * @return false failed 失败
-     */
-    inline bool copyFrom(Element element)
+    // enums are signed as their underlying types
+    // 枚举的符号与其底层类型相同
+    template <class T>
+    static constexpr bool _isSigned()
     {
-        return this->copyFrom(&element);
+        return std::is_signed<typename std::conditional<std::is_enum<T>::value,
+                                                        std::underlying_type<T>,
+                                                        std::common_type<T>>::type::type>::value;
     }
+};
+
+/**
+ * @brief read only view of characters stored somewhere else, like std::string_view,
+ * nothing is copied or allocated, the view is invalid once the storage is changed or released
+ *
+ * 对存储在其他地方的字符的只读视图，类似 std::string_view，
+ * 不拷贝也不分配内存，原存储修改或释放后视图失效
+ *
+ * @example
+ * if (db("wifiSSID")->getStringView().length()) ...
+ */
+class ElementStringView
+{
+private:
+    const char *p = "";
+    uint32_t len = 0;
+
+public:
+    ElementStringView() {}
+    ElementStringView(const char *data, uint32_t length) : p(data ? data : ""), len(data ? length : 0) {}
+    ElementStringView(const char *str) : p(str ? str : ""), len(str ? strlen(str) : 0) {}
+    ElementStringView(const String &str) : p(str.c_str()), len(str.length()) {}
+
+    inline const char *data() const { return this->p; }
+    inline uint32_t length() const { return this->len; }
+    inline uint32_t size() const { return this->len; }
+    inline bool empty() const { return !this->len; }
+    inline const char *begin() const { return this->p; }
+    inline const char *end() const { return this->p + this->len; }
+    inline char operator[](uint32_t i) const { return this->p[i]; }
 
     /**
-     * @brief copy data from uint8 array
-     * 从一个buffer拷贝数据
+     * @brief compare byte by byte, shorter one is less if it is prefix of the other
+     * 逐字节比较，若较短的是另一个的前缀则较短的更小
      *
-     * @param buffer pointer of source buffer 源数组指针
-     * @param length length of data that will be copied 需要拷贝的长度
-     * @return true success 成功
-     * @return false failed 失败
+     * @return <0, 0 or >0 小于0、0或大于0
      */
-    bool copyFrom(uint8_t *buffer, uint32_t length)
+    int compare(const ElementStringView &other) const
     {
-        this->clearBuffer();
-        return this->_copyBuffer(buffer, length, 0);
+        uint32_t n = this->len < other.len ? this->len : other.len;
+        int r = n ? memcmp(this->p, other.p, n) : 0;
+        if (r)
+            return r;
+        return this->len < other.len ? -1 : (this->len > other.len ? 1 : 0);
+    }
+
+    inline bool operator==(const ElementStringView &other) const
+    {
+        return this->len == other.len && (!this->len || !memcmp(this->p, other.p, this->len));
+    }
+    inline bool operator!=(const ElementStringView &other) const { return !this->operator==(other); }
+    inline bool operator<(const ElementStringView &other) const { return this->compare(other) < 0; }
+    inline bool operator>(const ElementStringView &other) const { return this->compare(other) > 0; }
+    inline bool operator<=(const ElementStringView &other) const { return this->compare(other) <= 0; }
+    inline bool operator>=(const ElementStringView &other) const { return this->compare(other) >= 0; }
+
+    inline bool startsWith(const ElementStringView &prefix) const
+    {
+        return prefix.len <= this->len && (!prefix.len || !memcmp(this->p, prefix.p, prefix.len));
+    }
+
+    inline bool endsWith(const ElementStringView &suffix) const
+    {
+        return suffix.len <= this->len &&
+               (!suffix.len || !memcmp(this->p + this->len - suffix.len, suffix.p, suffix.len));
     }
 
     /**
-     * @brief check current object equals to another or not
-     * 检查当前对象是否等于另一个对象
+     * @brief find a character or a string, same as String::indexOf
+     * 查找字符或字符串，与 String::indexOf 相同
      *
-     * @param obj another object; 另一个对象
-     * @return true
-     * @return false
+     * @return index of first match, -1 if not found 第一个匹配的位置，未找到返回-1
      */
-    bool equalsTo(const Element *obj) const
+    int indexOf(char c, uint32_t from = 0) const
     {
-        auto typeA = this->type, typeB = obj->getType();
+        if (from >= this->len)
+            return -1;
+        const char *r = (const char *)memchr(this->p + from, c, this->len - from);
+        return r ? (int)(r - this->p) : -1;
+    }
 
-        if (typeA != typeB)
+    int indexOf(const ElementStringView &target, uint32_t from = 0) const
+    {
+        if (from > this->len || target.len > this->len - from)
+            return -1;
+        if (!target.len)
+            return from;
+        uint32_t last = this->len - target.len;
+        for (uint32_t i = from; i <= last; ++i)
         {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-            typeA = this->getType(true);
-            typeB = obj->getType(true);
-
-            double a = 0.0, b = 0.0;
-            bool aFloat = false, bFloat = false;
-
-            if (typeA == ETYPE_FLOAT)
-            {
-                a = this->data.f;
-                aFloat = true;
-            }
-            else if (typeA == ETYPE_DOUBLE)
-            {
-                a = this->data.d;
-                aFloat = true;
-            }
-
-            if (typeB == ETYPE_FLOAT)
-            {
-                b = obj->getFloat();
-                bFloat = true;
-            }
-            else if (typeB == ETYPE_DOUBLE)
-            {
-                b = obj->getDouble();
-                bFloat = true;
-            }
+            const char *r = (const char *)memchr(this->p + i, target.p[0], last - i + 1);
+            if (!r)
+                return -1;
+            i = r - this->p;
+            if (!memcmp(r, target.p, target.len))
+                return i;
+        }
+        return -1;
+    }
 
-            if (aFloat && bFloat)
-            {
-                // both float or double
-                return a == b;
-            }
-            else if (aFloat && !bFloat)
-            {
-                // a is float or double, b is integer
-                return a == obj->getNumber();
-            }
-            else if (!aFloat && bFloat)
-            {
-                // a is integer, b is float or double
-                return this->getNumber() == b;
-            }
-            else
-            {
-                // both are integers
-                return this->getNumber() == obj->getNumber();
-            }
+    int lastIndexOf(char c) const
+    {
+        for (uint32_t i = this->len; i > 0; --i)
+            if (this->p[i - 1] == c)
+                return i - 1;
+        return -1;
+    }
 
-#else
-            // return false if two elements have different type
-            // 如果两个对象所存储的数据类型不一样直接返回false
-            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "type unequaled, a type: %d, b type: %d", obj->getType(), this->type);
-            return false;
-#endif
-        }
-        else
-        {
-            if (this->type == ETYPE_BUFFER || this->type == ETYPE_STRING)
-            {
-                // return false if length is unequaled of two elements when they stored uint8 array
-                // 如果两个对象都存储了二进制数组但是长度不一样直接返回false
-                // ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "type: %d, lengthA: %u, lengthB: %u", obj->getBufferLength(), this->data.buffer.bufferLength);
-                if (obj->getRawBufferLength() != this->data.buffer.bufferLength)
-                {
-                    // ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "length not equal, length obj: %d, length this: %d\n string obj: [%s]\n string this: [%s]\n, ",
-                    //          obj->getBufferLength(),
-                    //          this->data.buffer.bufferLength,
-                    //          obj->c_str(),
-                    //          this->c_str());
-                    return false;
-                }
-                else
-                {
-                    // ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "string result: %s\n", h ? "true" : "false");
-                    return !strncmp((const char *)(obj->getRawBuffer()), (const char *)(this->getRawBuffer()), this->data.buffer.bufferLength);
-                }
-            }
-            else
-            {
-                switch (this->type)
-                {
-                    // compare number if they both stored numner
-                    // 数字直接进行比较
-                case ETYPE_UINT8:
-                    return obj->getUint8() == this->data.u8;
-                case ETYPE_INT8:
-                    return obj->getInt8() == this->data.i8;
-                case ETYPE_UINT16:
-                    return obj->getUint16() == this->data.u16;
-                case ETYPE_INT16:
-                    return obj->getInt16() == this->data.i16;
-                case ETYPE_UINT32:
-                    return obj->getUint32() == this->data.u32;
-                case ETYPE_INT32:
-                    return obj->getInt32() == this->data.i32;
-                case ETYPE_UINT64:
-                    return obj->getUint64() == this->data.u64;
-                case ETYPE_INT64:
-                    return obj->getInt64() == this->data.i64;
-                case ETYPE_FLOAT:
-                    return obj->getFloat() == this->data.f;
-                case ETYPE_DOUBLE:
-                    return obj->getDouble() == this->data.d;
-                default:
-                    return false;
-                }
-            }
-        }
-        return false;
+    int lastIndexOf(const ElementStringView &target) const
+    {
+        if (target.len > this->len)
+            return -1;
+        for (uint32_t i = this->len - target.len + 1; i > 0; --i)
+            if (!target.len || !memcmp(this->p + i - 1, target.p, target.len))
+                return i - 1;
+        return -1;
     }
 
     /**
-     * @brief compare two elements
-     * 比较两个对象
-     *
-     * @param b pointer to another object; 另一个对象的指针
-     * @param lessThanB less than or greater than; 小于还是大于
-     * @return true
-     * @return false
+     * @brief part of this view, [from, to), clamped to length
+     * 当前视图的一部分，[from, to)，超出长度的部分会被截断
      */
-    bool compareElements(const Element *b, bool lessThanB) const
+    ElementStringView substring(uint32_t from, uint32_t to = 0xffffffff) const
     {
-        auto typeA = this->type, typeB = b->getType();
-
-        if (typeA < 9)
-        {
-            // current object stored number
-            if (typeB < 9)
-            {
-                // target object stored number
-                if (lessThanB)
-                    return this->getUniversalDouble() < b->getUniversalDouble();
-                else
-                    return this->getUniversalDouble() > b->getUniversalDouble();
-            }
-            else if (typeB == ETYPE_STRING || typeB == ETYPE_BUFFER)
-            {
-                // a is number, b is string or buffer
-                // compare first byte
+        if (to > this->len)
+            to = this->len;
+        if (from > to)
+            from = to;
+        return ElementStringView(this->p + from, to - from);
+    }
 
-                if (lessThanB)
-                    return this->getUniversalDouble() < b->getRawBuffer()[0];
-                else
-                    return this->getUniversalDouble() > b->getRawBuffer()[0];
-            }
-            else
-            {
-                ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "INVALID TYPE");
-                return false;
-            }
-        }
-        else
+    /**
+     * @brief copy into a String, only when a String is really needed
+     * 拷贝为String，仅在确实需要String时使用
+     */
+    String toString() const
+    {
+        // copied on stack chunk by chunk, String grows only once
+        // 在栈上分块拷贝，String只增长一次
+        char chunk[65];
+        String s;
+        s.reserve(this->len);
+        for (uint32_t i = 0; i < this->len; i += 64)
         {
-            // a NOT a number
-            if (typeA == ETYPE_BUFFER || typeA == ETYPE_STRING)
-            {
-                if (typeB < 9)
-                {
-                    // b is a number
-                    if (lessThanB)
-                        return (this->data.buffer.p)[0] < b->getUniversalDouble();
-                    else
-                        return (this->data.buffer.p)[0] > b->getUniversalDouble();
-                }
-                else
-                {
-                    // b NOT a number
-                    if (typeB == ETYPE_BUFFER || typeB == ETYPE_STRING)
-                    {
-                        if (lessThanB)
-                            return (this->data.buffer.p)[0] < b->getRawBuffer()[0];
-                        else
-                            return (this->data.buffer.p)[0] > b->getRawBuffer()[0];
-                    }
-                }
-            }
-            else
-            {
-                ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "INVALID TYPE");
-                return false;
-            }
+            uint32_t n = this->len - i < 64 ? this->len - i : 64;
+            memcpy(chunk, this->p + i, n);
+            chunk[n] = 0;
+            s += chunk;
         }
-        return false;
+        return s;
     }
 
     /**
-     * @brief convert any types of number to double and return;
-     * it won't change object itself
-     *
-     * 转换所有类型的数字到双精度浮点，然后返回；
-     * 这不会修改对象自身
-     *
-     * @return double
+     * @brief same as Element::hash() of an Element holding this string
+     * 与存储此字符串的Element的hash()相同
      */
-    inline double getUniversalDouble() const
+    uint32_t hash() const
     {
-        double a = 0.0;
-        if (this->type == ETYPE_FLOAT)
-        {
-            a = this->data.f;
-        }
-        else if (this->type == ETYPE_DOUBLE)
-        {
-            a = this->data.d;
-        }
-        else
+        // empty string is stored as void
+        // 空字符串存储为void
+        uint32_t seed = (this->len ? ETYPE_STRING : ETYPE_VOID) + 2166136261u;
+        if (!this->len)
+            return seed;
+        for (uint32_t i = 0; i < this->len; ++i)
         {
-            switch (this->type)
-            {
-            case ETYPE_UINT8:
-                a = this->data.u8;
-                break;
-            case ETYPE_INT8:
-                a = this->data.i8;
-                break;
-            case ETYPE_UINT16:
-                a = this->data.u16;
-                break;
-            case ETYPE_INT16:
-                a = this->data.i16;
-                break;
-            case ETYPE_UINT32:
-                a = this->data.u32;
-                break;
-            case ETYPE_INT32:
-                a = this->data.i32;
-                break;
-            case ETYPE_UINT64:
-                a = this->data.u64;
-                break;
-            case ETYPE_INT64:
-                a = this->data.i64;
-                break;
-            default:
-                break;
-            }
+            seed ^= (uint8_t)this->p[i];
+            seed *= 16777619u;
         }
-        return a;
+
+        // terminator is part of stored string
+        // 结束符是存储的字符串的一部分
+        return seed * 16777619u;
     }
+};
 
-    // operators, almost all operators were overloaded
-    // 重载的运算符，几乎所有的运算符都已经被重载
+/**
+ * @brief read only view of bytes stored somewhere else, uint8 array counterpart of ElementStringView
+ * 对存储在其他地方的字节的只读视图，相当于二进制数组的 ElementStringView
+ */
+class ElementBufferView
+{
+private:
+    const uint8_t *p = nullptr;
+    uint32_t len = 0;
 
-    // =
-    uint8_t operator=(const uint8_t &n)
+public:
+    ElementBufferView() {}
+    ElementBufferView(const uint8_t *data, uint32_t length) : p(data), len(data ? length : 0) {}
+
+    inline const uint8_t *data() const { return this->p; }
+    inline uint32_t size() const { return this->len; }
+    inline bool empty() const { return !this->len; }
+    inline const uint8_t *begin() const { return this->p; }
+    inline const uint8_t *end() const { return this->p + this->len; }
+    inline uint8_t operator[](uint32_t i) const { return this->p[i]; }
+
+    /**
+     * @brief part of this view, [from, to), clamped to length
+     * 当前视图的一部分，[from, to)，超出长度的部分会被截断
+     */
+    ElementBufferView slice(uint32_t from, uint32_t to = 0xffffffff) const
     {
-        this->reset(ETYPE_UINT8);
-        this->data.u8 = n;
-        return n;
+        if (to > this->len)
+            to = this->len;
+        if (from > to)
+            from = to;
+        return ElementBufferView(this->p + from, to - from);
     }
+};
+
+/**
+ * @brief arguments of Element::visit for ETYPE_VOID, ETYPE_LIST and ETYPE_MAP,
+ * children are owned by the Element visited
+ *
+ * Element::visit 对 ETYPE_VOID、ETYPE_LIST 和 ETYPE_MAP 使用的参数，
+ * 子元素由被访问的Element持有
+ */
+struct ElementVoid
+{
+};
+
+class ElementListView
+{
+private:
+    const Elements *items;
+
+public:
+    explicit ElementListView(const Elements *items) : items(items) {}
+
+    inline uint32_t size() const { return this->items->size(); }
+    inline Element *operator[](uint32_t i) const { return (*this->items)[i]; }
+    inline Elements::const_iterator begin() const { return this->items->begin(); }
+    inline Elements::const_iterator end() const { return this->items->end(); }
+};
+
+class ElementMapView
+{
+private:
+    const Elements *items;
+
+public:
+    explicit ElementMapView(const Elements *items) : items(items) {}
+
+    inline uint32_t size() const { return this->items->size() / 2; }
+    inline Element *key(uint32_t i) const { return (*this->items)[i * 2]; }
+    inline Element *value(uint32_t i) const { return (*this->items)[i * 2 + 1]; }
+};
+
+/**
+ * @brief read only view of items of a typed array, like std::span,
+ * items are loaded by memcpy so the view works on unaligned payload inside an encoded buffer too,
+ * nothing is copied or allocated, the view is invalid once the storage is changed or released
+ *
+ * 类型化数组元素的只读视图，类似 std::span，
+ * 元素通过 memcpy 读取，所以也可以直接用于编码后数组中未对齐的数据，
+ * 不拷贝也不分配内存，原存储修改或释放后视图失效
+ *
+ * @example
+ * ElementArrayView<int16_t> samples = e.getArray<int16_t>();
+ * int64_t total = samples.sum();
+ */
+template <class T>
+class ElementArrayView
+{
+private:
+    const uint8_t *p = nullptr;
+    uint32_t count = 0;
 
-    int8_t operator=(const int8_t &n)
+    /**
+     * @brief min or max in four lanes
+     * 以四个通道求最小值或最大值
+     */
+    template <bool min>
+    static inline T _pick(T a, T b)
     {
-        this->reset(ETYPE_INT8);
-        this->data.i8 = n;
-        return n;
+        return (min ? a < b : a > b) ? a : b;
     }
 
-    uint16_t operator=(const uint16_t &n)
+    template <bool min>
+    T _select() const
     {
-        this->reset(ETYPE_UINT16);
-        this->data.u16 = n;
-        return n;
+        if (!this->count)
+            return 0;
+
+        T r0 = (*this)[0], r1 = r0, r2 = r0, r3 = r0;
+        uint32_t i = 1;
+        for (; i + 4 <= this->count; i += 4)
+        {
+            r0 = _pick<min>((*this)[i], r0);
+            r1 = _pick<min>((*this)[i + 1], r1);
+            r2 = _pick<min>((*this)[i + 2], r2);
+            r3 = _pick<min>((*this)[i + 3], r3);
+        }
+        for (; i < this->count; ++i)
+            r0 = _pick<min>((*this)[i], r0);
+        return _pick<min>(_pick<min>(r0, r1), _pick<min>(r2, r3));
     }
 
-    int16_t operator=(const int16_t &n)
+public:
+    /**
+     * @brief integers are summed in 64 bits of same signedness, floating point in double
+     * 整数以相同符号的64位求和，浮点数以double求和
+     */
+    typedef typename std::conditional<std::is_floating_point<T>::value, double,
+                                      typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type>::type
+        SumType;
+
+    inline ElementArrayView() {}
+    inline ElementArrayView(const uint8_t *items, uint32_t count) : p(items), count(count) {}
+
+    inline uint32_t size() const { return this->count; }
+    inline bool empty() const { return !this->count; }
+
+    /**
+     * @brief items in little endian, may be unaligned
+     * 小端序的元素，可能没有对齐
+     */
+    inline const uint8_t *data() const { return this->p; }
+
+    inline T operator[](uint32_t index) const
     {
-        this->reset(ETYPE_INT16);
-        this->data.i16 = n;
-        return n;
+        T v;
+        memcpy(&v, this->p + index * sizeof(T), sizeof(T));
+        return v;
     }
 
-    uint32_t operator=(const uint32_t &n)
+    /**
+     * @brief reductions are plain loops without branches on item type,
+     * four independent lanes keep the pipeline busy at -Os and -O2, and compilers vectorize them at -O3
+     * min and max of empty array are 0
+     * 归约是不依赖元素类型分支的简单循环，
+     * 四个互不依赖的通道在 -Os 和 -O2 下保持流水线繁忙，编译器在 -O3 下可以将其向量化
+     * 空数组的最小值和最大值为0
+     */
+    SumType sum() const
     {
-        this->reset(ETYPE_UINT32);
-        this->data.u32 = n;
-        return n;
-    }
-#if CONFIG_IDF_TARGET_ESP32C3
-    int32_t operator=(const int &n)
-    {
-        this->reset(ETYPE_INT32);
-        this->data.i32 = n;
-        return n;
-    }
-#endif
-    int32_t operator=(const int32_t &n)
-    {
-        this->reset(ETYPE_INT32);
-        this->data.i32 = n;
-        return n;
+        SumType r[4] = {0, 0, 0, 0};
+        uint32_t i = 0;
+        for (; i + 4 <= this->count; i += 4)
+        {
+            r[0] += (*this)[i];
+            r[1] += (*this)[i + 1];
+            r[2] += (*this)[i + 2];
+            r[3] += (*this)[i + 3];
+        }
+        for (; i < this->count; ++i)
+            r[0] += (*this)[i];
+        return (r[0] + r[1]) + (r[2] + r[3]);
     }
 
-    uint64_t operator=(const uint64_t &n)
+    T min() const
     {
-        this->reset(ETYPE_UINT64);
-        this->data.u64 = n;
-        return n;
+        return this->template _select<true>();
     }
 
-    int64_t operator=(const int64_t &n)
+    T max() const
     {
-        this->reset(ETYPE_INT64);
-        this->data.i64 = n;
-        return n;
+        return this->template _select<false>();
     }
 
-    float operator=(const float &n)
+    inline double mean() const
     {
-        this->reset(ETYPE_FLOAT);
-        this->data.f = n;
-        return n;
+        return this->count ? (double)this->sum() / this->count : 0;
     }
+};
 
-    double operator=(const double &n)
-    {
-        this->reset(ETYPE_DOUBLE);
-        this->data.d = n;
-        return n;
-    }
+/**
+ * @brief heap block of a payload shared by copies of Element, reference count is right before payload,
+ * count is atomic so copies may be used and released in different tasks,
+ * but one Element object is still not safe to be used by two tasks at the same time
+ *
+ * 由Element的拷贝共享的数据所在的堆内存块，引用计数位于数据之前，
+ * 计数是原子的，所以拷贝可以在不同的任务中使用和释放，
+ * 但是同一个Element对象依然不能同时被两个任务使用
+ */
+class ElementSharedBuffer
+{
+private:
+    // payload keeps 8 bytes alignment of new[] for typed arrays of 64 bits numbers
+    // 数据保持new[]的8字节对齐，用于64位数字的类型化数组
+    static const uint32_t HEADER_SIZE = 8;
 
-    const char *operator=(const char *str)
+    static inline std::atomic<uint32_t> *_count(const uint8_t *payload)
     {
-        this->_setString(str);
-        return str;
+        return (std::atomic<uint32_t> *)(payload - HEADER_SIZE);
     }
 
-    String operator=(const String &str)
+public:
+    /**
+     * @brief allocate a block with count 1
+     * 分配一个计数为1的内存块
+     *
+     * @return payload, nullptr if heap is full 数据，堆内存不足时为空指针
+     */
+    static uint8_t *allocate(uint32_t length)
     {
-        this->_setString(str.c_str());
-        return str;
+        uint8_t *block = nullptr;
+        if (length > UINT32_MAX - HEADER_SIZE)
+            return nullptr;
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+        try
+        {
+            block = new uint8_t[HEADER_SIZE + length];
+        }
+        catch (const std::bad_alloc &e)
+        {
+            block = nullptr;
+        }
+#else
+        block = new (std::nothrow) uint8_t[HEADER_SIZE + length];
+#endif
+        if (!block)
+            return nullptr;
+        new (block) std::atomic<uint32_t>(1);
+        return block + HEADER_SIZE;
     }
 
-    const String *operator=(const String *str)
+    static inline void retain(const uint8_t *payload)
     {
-        this->_setString(str->c_str());
-        return str;
+        _count(payload)->fetch_add(1, std::memory_order_relaxed);
     }
 
-    std::string operator=(const std::string &str)
+    /**
+     * @brief decrease count, block is freed by the last one
+     * 减少计数，由最后一个持有者释放内存块
+     */
+    static inline void release(uint8_t *payload)
     {
-        this->_setString(str.c_str());
-        return str;
+        if (_count(payload)->fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete[] (payload - HEADER_SIZE);
     }
 
-    const std::string *operator=(const std::string *str)
+    static inline uint32_t count(const uint8_t *payload)
     {
-        this->_setString(str->c_str());
-        return str;
+        return _count(payload)->load(std::memory_order_acquire);
     }
+};
 
-    Element &operator=(const Element &e)
-    {
-        this->copyFrom(e);
-        return *this;
-    }
+/**
+ * @brief payload of an ETYPE_FILE Element kept outside RAM, such as a range of a file in flash,
+ * it is read part by part when encoding, copies of the Element share one source with a reference count
+ *
+ * ETYPE_FILE 类型Element的数据，保存在内存之外，比如flash中文件的一段，
+ * 编码时分段读取，Element的拷贝通过引用计数共享同一个数据源
+ */
+class ElementFileSource
+{
+private:
+    std::atomic<uint32_t> references;
 
-    const Element *operator=(const Element *e)
+public:
+    ElementFileSource() : references(1) {}
+    virtual ~ElementFileSource() {}
+
+    ElementFileSource(const ElementFileSource &) = delete;
+    ElementFileSource &operator=(const ElementFileSource &) = delete;
+
+    /**
+     * @brief length of payload
+     * 数据的长度
+     */
+    virtual uint32_t length() const = 0;
+
+    /**
+     * @brief read part of payload, called with increasing offset when encoding
+     * 读取一部分数据，编码时偏移量依次递增
+     *
+     * @param offset offset in payload 数据中的偏移量
+     * @param buffer output 输出
+     * @param length bytes to read 需要读取的字节数
+     * @return false if less than length bytes are read 读取的字节数不足时返回false
+     */
+    virtual bool read(uint32_t offset, uint8_t *buffer, uint32_t length) = 0;
+
+    inline void retain() { this->references.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief decrease count, source is deleted by the last one
+     * 减少计数，由最后一个持有者删除数据源
+     */
+    inline void release()
     {
-        this->copyFrom(*e);
-        return e;
+        if (this->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
     }
+};
 
-    // ()
+class ElementObject;
+class ElementArena;
 
+/**
+ * @brief this class hold basic data in RAM
+ * 这个类用来在RAM中存储基础数据
+ */
+class Element
+{
+private:
     /**
-     * @brief set an uint8 array to element
+     * @brief data type of current object stored
+     * 指示当前对象存储的数据类型
+     */
+    ElementType type = ETYPE_VOID;
+
+    /**
+     * @brief type of items when current object is a typed array
+     * 当前对象是类型化数组时元素的类型
+     */
+    ElementType itemType = ETYPE_VOID;
+
+    /**
+     * @brief last error code of this element object
+     * 这个对象的最后一个错误的错误代码
      *
-     * @param buffer pointer
-     * @param length length of buffer
-     * @return Element& self
      */
-    Element &operator()(uint8_t *buffer, uint32_t length)
+    ElementErrorCode err = E_ERROR_NO_ERROR;
+
+    /**
+     * @brief almost all data will be make a copy in this class
+     * but in some cases, you wouldn't like to copy it
+     * so there is a constructor with bool ahead will NOT copy original data
+     * and this varible will indicate clear buffer or not when object deconstructing
+     * default set to true
+     *
+     * 在这个类中，几乎所有的数据都会拷贝一份来存储
+     * 但是有些时候你不想在创建一份拷贝
+     * 所以有一个构造函数bool参数开头的可以只拷贝指针，而【不拷贝】原始数据
+     * 这个变量用于指示是否需要清理拷贝的buffer
+     * 默认是true
+     */
+    volatile bool copiedBuffer = true;
+
+    /**
+     * @brief buffer on heap is an ElementSharedBuffer, it is released instead of deleted
+     * 堆上的数据是 ElementSharedBuffer，释放时减少计数而不是直接删除
+     */
+    bool sharedBuffer = false;
+
+    /**
+     * @brief hold data
+     * 存储数据
+     */
+    ElementData data;
+
+#if ELEMENT_INLINE_BUFFER_SIZE > 0
+    /**
+     * @brief storage for short string and uint8 array, data.buffer.p points here when used
+     * so all functions read buffer as usual
+     * 短字符串和二进制数组的存储区，使用时 data.buffer.p 会指向这里
+     * 所以所有函数都像平常一样读取数据
+     */
+    uint8_t inlineBuffer[ELEMENT_INLINE_BUFFER_SIZE];
+#endif
+
+    /**
+     * @brief buffer is stored inside object or not
+     * 数据是否存储在对象内部
+     */
+    inline bool _isInlineBuffer() const
     {
-        this->copyFrom(buffer, length);
-        return *this;
+#if ELEMENT_INLINE_BUFFER_SIZE > 0
+        return this->data.buffer.p == this->inlineBuffer;
+#else
+        return false;
+#endif
     }
 
-    // ==
-
-    inline bool operator==(const char *str) const
+    /**
+     * @brief set string buffer
+     * 设置字符串
+     *
+     * @param data c string c字符串
+     * @param offset offset that copy data from original buffer 从源数组开始拷贝的数据的偏移量
+     * @param length length of c string 字符串的长度
+     * @return true valid data 有效数据
+     * @return false invalid data 无效数据
+     */
+    bool _setString(const char *data, uint32_t offset = 0, uint32_t length = 0)
     {
-        uint32_t targetLen = strlen(str);
-        if (!targetLen)
+        if (data)
         {
-            if (!this->available())
-            {
-                return true;
-            }
-            else if (this->type == ETYPE_STRING && (this->data.buffer.bufferLength - 1 <= 0))
+            // get length of string
+            // 获取目标字符串的长度
+            if (!length)
             {
-                return true;
+                length = strlen(data);
             }
-            else
+            if (length)
             {
-                return false;
+                ++length;
+                // clear buffer if current object already stored data
+                // 如果当前对象已经存储了其他数据会清除掉其他数据
+                this->reset(ETYPE_STRING);
+
+                // copy original data if length is non zero
+                // 如果不是空字符串就拷贝数据
+                return this->_copyBuffer((uint8_t *)data, length, offset, ETYPE_STRING);
             }
         }
-        if (targetLen != (this->data.buffer.bufferLength - 1))
-        {
-            return false;
-        }
-        else
-        {
-            return !strncmp(str, this->c_str(), targetLen);
-        }
+        ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "type set to NONE");
+        this->type = ETYPE_VOID;
+        return false;
     }
 
-    inline bool operator==(const String &str) const
+    bool _setString(const String &data)
     {
-        return this->operator==(str.c_str());
+        return this->_setString(data.c_str());
     }
 
-    inline bool operator==(const String *str) const
+    /**
+     * @brief canonical form of stored number, used by equalsTo and hash,
+     * integral value in range of int64 is kind 0 whatever its type is,
+     * uint64 above range of int64 is kind 1, others are kind 2 and key is bits of double
+     *
+     * 存储的数字的规范形式，用于 equalsTo 和 hash，
+     * 在int64范围内的整数值无论类型都是0类，
+     * 超出int64范围的uint64是1类，其他是2类，key是double的二进制表示
+     */
+    uint8_t _getNumberKey(uint64_t *key) const
     {
-        return this->operator==(str->c_str());
+        if (this->type == ETYPE_FLOAT || this->type == ETYPE_DOUBLE)
+        {
+            double d = this->type == ETYPE_FLOAT ? (double)this->data.f : this->data.d;
+            if (d >= -9223372036854775808.0 && d < 9223372036854775808.0 && d == (double)(int64_t)d)
+            {
+                (*key) = (uint64_t)(int64_t)d;
+                return 0;
+            }
+            if (d >= 9223372036854775808.0 && d < 18446744073709551616.0 && d == (double)(uint64_t)d)
+            {
+                (*key) = (uint64_t)d;
+                return 1;
+            }
+            memcpy(key, &d, sizeof(d));
+            return 2;
+        }
+
+        if (this->type == ETYPE_UINT64 && this->data.u64 > (uint64_t)INT64_MAX)
+        {
+            (*key) = this->data.u64;
+            return 1;
+        }
+
+        (*key) = (uint64_t)this->getNumber();
+        return 0;
     }
 
-    inline bool operator==(const std::string &str) const
+    inline bool _isNumber() const { return this->type != ETYPE_VOID && this->type < 9; }
+    inline bool _isInteger() const { return this->_isNumber() && this->type != ETYPE_FLOAT && this->type != ETYPE_DOUBLE; }
+    inline ElementNumber _toNumber() const { return ElementNumber::from(this->data, this->type); }
+
+    /**
+     * @brief integer of current object sign or zero extended to 64 bits, same bits as ElementNumber::from,
+     * current object must be an integer
+     * 当前对象的整数按符号扩展或零扩展为64位，与 ElementNumber::from 的位相同，当前对象必须是整数
+     */
+    inline uint64_t _integerBits() const
     {
-        return this->operator==(str.c_str());
+        uint8_t shift = 64 - 8 * (this->type < 0 ? -this->type : this->type);
+        uint64_t u = this->data.u64 << shift;
+        return this->type < 0 ? (uint64_t)((int64_t)u >> shift) : u >> shift;
     }
 
-    inline bool operator==(const std::string *str) const
+    /**
+     * @brief number of current object as double, current object must be a number
+     * 当前对象的数字转换为double，当前对象必须是数字
+     */
+    inline double _toDouble() const
     {
-        return this->operator==(str->c_str());
+        return this->type == ETYPE_FLOAT    ? (double)this->data.f
+               : this->type == ETYPE_DOUBLE ? this->data.d
+               : this->type < 0             ? (double)(int64_t)this->_integerBits()
+                                            : (double)this->_integerBits();
     }
 
-    inline bool operator==(const Element &obj) const
+    static inline uint64_t _applyInteger(ElementNumber::Operation op, uint64_t a, uint64_t b)
     {
-        return obj.equalsTo(this);
+        return op == ElementNumber::ADD ? a + b : (op == ElementNumber::SUB ? a - b : a * b);
     }
 
-    inline bool operator==(const Element *obj) const
+    static inline double _applyDouble(ElementNumber::Operation op, double a, double b)
     {
-        return obj->equalsTo(this);
+        return op == ElementNumber::ADD ? a + b : (op == ElementNumber::SUB ? a - b : (op == ElementNumber::MUL ? a * b : a / b));
     }
 
-    inline bool operator==(const uint8_t &n) const
+    inline void _setNumber(const ElementNumber &n, ElementType type)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() == n;
-#else
-        if (this->type == ETYPE_UINT8)
-        {
-            return this->data.u8 == n;
-        }
-        return false;
-#endif
+        // numbers own nothing on heap
+        // 数字不持有堆内存
+        if (this->type >= 9)
+            this->clearBuffer();
+        this->type = type;
+        n.store(&this->data, type);
     }
 
-    inline bool operator==(const int8_t &n) const
+    /**
+     * @brief compare with a number, numbers of any type are compared by value
+     * when ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON is defined, or type must be same
+     *
+     * 与一个数字比较，定义了 ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON 时
+     * 任意类型的数字按数值比较，否则类型必须相同
+     *
+     * @return -1, 0, 1, or 2 if they are not comparable 无法比较时返回2
+     */
+    int8_t _compareNumber(const ElementNumber &n, ElementType type) const
     {
 #ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() == n;
+        // type doesn't matter, only value is compared
+        // 类型无关，只比较数值
+        (void)type;
+        if (!this->_isNumber())
+            return 2;
 #else
-        if (this->tpe == ETYPE_INT8)
-        {
-            return this->data.i8 == n;
-        }
-        return false;
+        if (this->type != type)
+            return 2;
 #endif
+        return ElementNumber::compare(this->_toNumber(), n);
     }
 
-    inline bool operator==(const uint16_t &n) const
+    template <class T>
+    inline int8_t _compareNumber(const T &n) const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() == n;
-#else
-        if (this->type == ETYPE_UINT16)
-        {
-            return this->data.u16 == n;
-        }
-        return false;
-#endif
+        return this->_compareNumber(ElementNumber::of(n), ElementNumber::typeOf<T>());
     }
 
-    inline bool operator==(const int16_t &n) const
+    inline ElementNumber _calculateNumber(ElementNumber::Operation op, const ElementNumber &n) const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() == n;
-#else
-        if (this->type == ETYPE_INT16)
-        {
-            return this->data.i16 == n;
-        }
-        return false;
-#endif
+        return ElementNumber::calculate(op, this->_toNumber(), n);
     }
 
-    inline bool operator==(const uint32_t &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() == n;
-#else
-        if (this->type == ETYPE_UINT32)
-        {
-            return this->data.u32 == n;
-        }
-        return false;
-#endif
+    /**
+     * @brief number operation with a number, result has type of the number,
+     * + - * of two integers and any operation of floating point skip the promotion table,
+     * results are same as going through ElementNumber
+     *
+     * 与数字运算，结果为该数字的类型，
+     * 两个整数的 + - * 以及浮点数的运算跳过类型提升表，结果与经过 ElementNumber 相同
+     */
+    template <class T>
+    inline typename std::enable_if<std::is_integral<T>::value, T>::type _calculateWith(ElementNumber::Operation op, const T &n) const
+    {
+        if (op <= ElementNumber::MUL && this->_isInteger())
+            return (T)_applyInteger(op, this->_integerBits(), (uint64_t)n);
+        return this->_calculateNumber(op, ElementNumber::of(n)).template to<T>();
     }
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    inline bool operator==(const int &n) const
+    template <class T>
+    inline typename std::enable_if<std::is_floating_point<T>::value, T>::type _calculateWith(ElementNumber::Operation op, const T &n) const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() == n;
-#else
-        if (this->type == ETYPE_INT32)
-        {
-            return this->data.i32 == n;
-        }
-        return false;
-#endif
+        if (op <= ElementNumber::DIV && this->_isNumber())
+            return (T)_applyDouble(op, this->_toDouble(), (double)n);
+        return this->_calculateNumber(op, ElementNumber::of(n)).template to<T>();
     }
 
-#endif
-    inline bool operator==(const int32_t &n) const
+    /**
+     * @brief number operation of two Elements, void if either one is string, uint8 array or container,
+     * void itself counts as zero, result is int64 or double with CROSS_TYPE_CLACULATE,
+     * or types must be same and result has the same type
+     *
+     * 两个Element的数字运算，任何一个是字符串、二进制数组或容器时结果为void，
+     * void本身视为0，定义了 CROSS_TYPE_CLACULATE 时结果为int64或double，
+     * 否则类型必须相同且结果类型不变
+     */
+    Element _calculate(ElementNumber::Operation op, const Element &rvalue) const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() == n;
-#else
-        if (this->type == ETYPE_INT32)
+        Element tmp;
+        if (this->type >= 9 || rvalue.type >= 9)
+            return tmp;
+
+#ifdef CROSS_TYPE_CLACULATE
+        // fast paths, same results as below
+        // 快速路径，结果与下面相同
+        if (op <= ElementNumber::MUL && this->_isInteger() && rvalue._isInteger())
         {
-            return this->data.i32 == n;
+            tmp.type = ETYPE_INT64;
+            tmp.data.u64 = _applyInteger(op, this->_integerBits(), rvalue._integerBits());
+            return tmp;
         }
-        return false;
-#endif
-    }
-
-    inline bool operator==(const uint64_t &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() == n;
-#else
-        if (this->type == ETYPE_UINT64)
+        if (op <= ElementNumber::DIV && this->_isNumber() && rvalue._isNumber() &&
+            !(this->_isInteger() && rvalue._isInteger()))
         {
-            return this->data.u64 == n;
+            tmp.type = ETYPE_DOUBLE;
+            tmp.data.d = _applyDouble(op, this->_toDouble(), rvalue._toDouble());
+            return tmp;
         }
-        return false;
 #endif
-    }
 
-    inline bool operator==(const int64_t &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() == n;
+        ElementNumber r = ElementNumber::calculate(op, this->_toNumber(), rvalue._toNumber());
+#ifdef CROSS_TYPE_CLACULATE
+        tmp._setNumber(r, r.kind == ElementNumber::FLOATING ? ETYPE_DOUBLE : ETYPE_INT64);
 #else
-        if (this->type == ETYPE_INT64)
-        {
-            return this->data.i64 == n;
-        }
-        return false;
+        if (this->type == rvalue.type)
+            tmp._setNumber(r, this->type);
 #endif
+        return tmp;
     }
 
-    inline bool operator==(const float &n) const
+    /**
+     * @brief compound assignment with a number, result has type of the number,
+     * float is extended to double
+     *
+     * 与数字的复合赋值，结果为该数字的类型，float会扩展为double
+     */
+    Element &_assignNumber(ElementNumber::Operation op, const ElementNumber &n, ElementType type)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() == n;
-#else
-        if (this->type == ETYPE_FLOAT)
-        {
-            return this->data.f == n;
-        }
-        return false;
-#endif
+        this->_setNumber(this->_calculateNumber(op, n), type);
+        return *this;
     }
 
-    inline bool operator==(const double &n) const
+    template <class T>
+    inline Element &_assignNumber(ElementNumber::Operation op, const T &n)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->data.d == n;
-#else
-        if (this->type == ETYPE_DOUBLE)
+        // fast paths, same results as going through ElementNumber, integer is truncated to size of T
+        // 快速路径，结果与经过 ElementNumber 相同，整数被截断为T的大小
+        if (std::is_integral<T>::value && op <= ElementNumber::MUL && this->_isInteger())
         {
-            return this->data.d == n;
+            uint64_t bits = _applyInteger(op, this->_integerBits(), (uint64_t)n);
+            this->type = ElementNumber::typeOf<T>();
+            this->data.u64 = 0;
+            memcpy((uint8_t *)&(this->data), &bits, sizeof(T));
+            return *this;
         }
-        return false;
-#endif
+        if (std::is_floating_point<T>::value && op <= ElementNumber::DIV && this->_isNumber())
+        {
+            this->data.d = _applyDouble(op, this->_toDouble(), (double)n);
+            this->type = ETYPE_DOUBLE;
+            return *this;
+        }
+        return this->_assignNumber(op, ElementNumber::of(n),
+                                   ElementNumber::typeOf<T>() == ETYPE_FLOAT ? ETYPE_DOUBLE : ElementNumber::typeOf<T>());
     }
 
-    // !=
-
-    inline bool operator!=(const Element &obj) const
+    /**
+     * @brief bitwise operation of two Elements, current object must be an integer,
+     * result has type of current object
+     *
+     * 两个Element的位运算，当前对象必须是整数，结果为当前对象的类型
+     */
+    Element _bitwise(ElementNumber::Operation op, const Element &rvalue) const
     {
-        return !obj.equalsTo(this);
+        Element tmp;
+        if (this->_isInteger() && rvalue.available())
+            tmp._setNumber(this->_calculateNumber(op, rvalue._toNumber()), this->type);
+        return tmp;
     }
 
-    inline bool operator!=(const Element *obj) const
-    {
-        return !obj->equalsTo(this);
-    }
+    friend class ElementArena;
 
-    inline bool operator!=(const uint8_t &n) const
+    template <class Visitor>
+    auto _visitArray(Visitor &visitor) const -> decltype(visitor(ElementVoid()))
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() != n;
-#else
-        if (this->type == ETYPE_UINT8)
+        switch (this->itemType)
         {
-            return this->data.u8 != n;
+        case ETYPE_UINT8:
+            return visitor(this->getArray<uint8_t>());
+        case ETYPE_INT8:
+            return visitor(this->getArray<int8_t>());
+        case ETYPE_UINT16:
+            return visitor(this->getArray<uint16_t>());
+        case ETYPE_INT16:
+            return visitor(this->getArray<int16_t>());
+        case ETYPE_UINT32:
+            return visitor(this->getArray<uint32_t>());
+        case ETYPE_INT32:
+            return visitor(this->getArray<int32_t>());
+        case ETYPE_UINT64:
+            return visitor(this->getArray<uint64_t>());
+        case ETYPE_INT64:
+            return visitor(this->getArray<int64_t>());
+        case ETYPE_FLOAT:
+            return visitor(this->getArray<float>());
+        case ETYPE_DOUBLE:
+            return visitor(this->getArray<double>());
+        default:
+            return visitor(ElementVoid());
         }
-        return false;
-#endif
     }
 
-    inline bool operator!=(const int8_t &n) const
+    /**
+     * @brief reference memory owned by others, nothing will be copied or freed
+     * 引用其他地方持有的内存，不会拷贝也不会释放
+     *
+     * @param buffer memory 内存
+     * @param length length of memory 内存长度
+     * @param type ETYPE_STRING or ETYPE_BUFFER
+     */
+    void _setReference(uint8_t *buffer, uint32_t length, ElementType type)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() != n;
-#else
-        if (this->tpe == ETYPE_INT8)
-        {
-            return this->data.i8 != n;
-        }
-        return false;
-#endif
+        this->reset(type);
+        this->data.buffer.p = buffer;
+        this->data.buffer.bufferLength = length;
+        this->copiedBuffer = false;
     }
 
-    inline bool operator!=(const uint16_t &n) const
+    /**
+     * @brief make current object a typed array, items are copied
+     * 把当前对象设置为类型化数组，元素会被拷贝
+     *
+     * @param length length of items in bytes 元素的字节长度
+     */
+    bool _setArray(ElementType itemType, const uint8_t *items, uint32_t length)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() != n;
-#else
-        if (this->type == ETYPE_UINT16)
-        {
-            return this->data.u16 != n;
-        }
-        return false;
-#endif
+        uint8_t size = Element::getItemSize(itemType);
+
+        this->reset(ETYPE_VOID);
+        if (!size || length % size || (length && !items))
+            return false;
+
+        // empty array holds no memory
+        // 空数组不持有内存
+        if (length && !this->_copyBuffer((uint8_t *)items, length, 0, ETYPE_ARRAY))
+            return false;
+
+        this->type = ETYPE_ARRAY;
+        this->itemType = itemType;
+        return true;
     }
 
-    inline bool operator!=(const int16_t &n) const
+    /**
+     * @brief append items to typed array, storage is reallocated once
+     * 向类型化数组追加元素，存储空间只重新分配一次
+     *
+     * @param length length of items in bytes 元素的字节长度
+     */
+    bool _appendArray(const uint8_t *items, uint32_t length)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() != n;
-#else
-        if (this->type == ETYPE_INT16)
+        uint8_t *former = this->data.buffer.p;
+        uint32_t formerLength = this->data.buffer.bufferLength;
+        uint8_t *p = nullptr;
+
+        if (!length)
+            return true;
+        if (length > UINT32_MAX - formerLength)
+            return false;
+
+#if ELEMENT_INLINE_BUFFER_SIZE > 0
+        if (formerLength + length <= ELEMENT_INLINE_BUFFER_SIZE && (!formerLength || this->_isInlineBuffer()))
         {
-            return this->data.i16 != n;
+            p = this->inlineBuffer;
         }
-        return false;
+        else
 #endif
-    }
-
-    inline bool operator!=(const uint32_t &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() != n;
-#else
-        if (this->type == ETYPE_UINT32)
         {
-            return this->data.u32 != n;
+            // former payload may be shared, it is released but never written
+            // 原有数据可能被共享，只会被释放而不会被写入
+            bool shared = false;
+            p = _allocateBuffer(formerLength + length, &shared);
+
+            // array is unchanged when heap is full
+            // 堆内存不足时数组保持不变
+            if (!p)
+            {
+                this->err = E_ERROR_HEAP_FULL;
+                return false;
+            }
+            if (formerLength)
+                memcpy(p, former, formerLength);
+            if (formerLength && this->copiedBuffer && !this->_isInlineBuffer())
+                _freeBuffer(former, this->sharedBuffer);
+            this->sharedBuffer = shared;
         }
-        return false;
-#endif
+
+        memcpy(p + formerLength, items, length);
+        this->data.buffer.p = p;
+        this->data.buffer.bufferLength = formerLength + length;
+        this->copiedBuffer = true;
+        return true;
     }
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    inline bool operator!=(const int &n) const
+    /**
+     * @brief reduce typed array of T, op is 0 for sum, 1 for min and 2 for max
+     * 对T类型的数组进行归约，op为0求和，1求最小值，2求最大值
+     */
+    template <class T>
+    static Element _reduce(const ElementArrayView<T> &items, uint8_t op)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() != n;
-#else
-        if (this->type == ETYPE_INT32)
+        Element r;
+        if (!op)
         {
-            return this->data.i32 != n;
+            typename ElementArrayView<T>::SumType sum = items.sum();
+            r._setNumber(ElementNumber::of(sum), ElementNumber::typeOf<decltype(sum)>());
         }
-        return false;
-#endif
+        else if (!items.empty())
+        {
+            r._setNumber(ElementNumber::of(op == 1 ? items.min() : items.max()), ElementNumber::typeOf<T>());
+        }
+        return r;
     }
-#endif
 
-    inline bool operator!=(const int32_t &n) const
+    Element _reduceArray(uint8_t op) const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() != n;
-#else
-        if (this->type == ETYPE_INT32)
+        switch (this->getArrayType())
         {
-            return this->data.i32 != n;
+        case ETYPE_UINT8:
+            return Element::_reduce(this->getArray<uint8_t>(), op);
+        case ETYPE_INT8:
+            return Element::_reduce(this->getArray<int8_t>(), op);
+        case ETYPE_UINT16:
+            return Element::_reduce(this->getArray<uint16_t>(), op);
+        case ETYPE_INT16:
+            return Element::_reduce(this->getArray<int16_t>(), op);
+        case ETYPE_UINT32:
+            return Element::_reduce(this->getArray<uint32_t>(), op);
+        case ETYPE_INT32:
+            return Element::_reduce(this->getArray<int32_t>(), op);
+        case ETYPE_UINT64:
+            return Element::_reduce(this->getArray<uint64_t>(), op);
+        case ETYPE_INT64:
+            return Element::_reduce(this->getArray<int64_t>(), op);
+        case ETYPE_FLOAT:
+            return Element::_reduce(this->getArray<float>(), op);
+        case ETYPE_DOUBLE:
+            return Element::_reduce(this->getArray<double>(), op);
+        default:
+            return Element();
         }
-        return false;
-#endif
     }
 
-    inline bool operator!=(const uint64_t &n) const
+    /**
+     * @brief make current object an empty list or map
+     * 把当前对象设置为空的列表或映射
+     */
+    bool _setChildren(ElementType type)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() != n;
-#else
-        if (this->type == ETYPE_UINT64)
+        this->reset(type);
+
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+        try
         {
-            return this->data.u64 != n;
+            this->data.list = new Elements();
         }
-        return false;
+        catch (const std::bad_alloc &e)
+        {
+            this->data.list = nullptr;
+        }
+#else
+        this->data.list = new (std::nothrow) Elements();
 #endif
-    }
 
-    inline bool operator!=(const int64_t &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() != n;
-#else
-        if (this->type == ETYPE_INT64)
+        if (!this->data.list)
         {
-            return this->data.i64 != n;
+            this->type = ETYPE_VOID;
+            this->err = E_ERROR_HEAP_FULL;
+            return false;
         }
-        return false;
-#endif
+        this->copiedBuffer = true;
+        return true;
     }
 
-    inline bool operator!=(const float &n) const
+    /**
+     * @brief reference children owned by others, they will not be deleted
+     * 引用其他地方持有的子元素，它们不会被删除
+     */
+    void _setChildrenReference(Elements *children, ElementType type)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() != n;
-#else
-        if (this->type == ETYPE_FLOAT)
-        {
-            return this->data.f != n;
-        }
-        return false;
-#endif
+        this->reset(type);
+        this->data.list = children;
+        this->copiedBuffer = false;
     }
 
-    inline bool operator!=(const double &n) const
+    /**
+     * @brief whether another object is one of children of current object, at any depth
+     * 另一个对象是否为当前对象任意层级的子元素
+     */
+    inline bool _contains(const Element *e) const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->data.d != n;
-#else
-        if (this->type == ETYPE_DOUBLE)
-        {
-            return this->data.d != n;
-        }
-        return false;
-#endif
+        // only a list or map has children, checked inline as it is called by every copy and move
+        // 只有列表或映射有子元素，每次拷贝和移动都会调用，所以内联检查
+        return (this->type == ETYPE_LIST || this->type == ETYPE_MAP) && this->data.list && this->_containsChild(e);
     }
 
-    //<
-    inline bool operator<(const uint8_t &n) const
+    bool _containsChild(const Element *e) const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() < n;
-#else
-        if (this->type == ETYPE_UINT8)
+        for (auto it = this->data.list->begin(); it != this->data.list->end(); ++it)
         {
-            return this->data.u8 < n;
+            if (*it == e || (*it)->_contains(e))
+                return true;
         }
         return false;
-#endif
     }
 
-    inline bool operator<(const int8_t &n) const
+    /**
+     * @brief length of one encoded entry of list(one item) or map(key and value),
+     * 0 if any part of it is empty, such entry is skipped when encoding
+     * 列表(一个元素)或映射(键和值)中一个条目编码后的长度，
+     * 任何部分为空时返回0，编码时会跳过这个条目
+     */
+    uint32_t _getEntryLength(uint32_t index, bool compact) const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() < n;
-#else
-        if (this->type == ETYPE_INT8)
+        uint32_t length = this->data.list->at(index)->getOuterBufferLength(compact);
+        if (length && this->type == ETYPE_MAP)
         {
-            return this->data.i8 < n;
+            uint32_t valueLength = this->data.list->at(index + 1)->getOuterBufferLength(compact);
+            length = valueLength ? length + valueLength : 0;
         }
-        return false;
-#endif
+        return length;
     }
 
-    inline bool operator<(const uint16_t &n) const
+    /**
+     * @brief decode children of list or map from payload
+     * 从数据中解码列表或映射的子元素
+     */
+    bool _setChildrenFromBuffer(uint8_t *buffer, uint32_t offset, uint32_t length,
+                                ElementType type, bool compact, uint8_t depth)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() < n;
-#else
-        if (this->type == ETYPE_UINT16)
+        if (depth >= ARRAY_BUFFER_MAX_DEPTH || !this->_setChildren(type))
+            return false;
+
+        uint32_t end = offset + length;
+
+        while (offset < end)
         {
-            return this->data.u16 < n;
+            Element *e = new Element();
+
+            // pushed first, so it is released with list when error occurs
+            // 先放入列表，出错时会随列表一起释放
+            this->data.list->push_back(e);
+
+            int32_t used = e->setFromOuterBuffer(buffer, offset, end, compact, depth + 1);
+            if (used < 0)
+            {
+                this->reset(ETYPE_VOID);
+                return false;
+            }
+            offset += used;
         }
-        return false;
-#endif
-    }
 
-    inline bool operator<(const int16_t &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() < n;
-#else
-        if (this->type == ETYPE_INT16)
+        if (type == ETYPE_MAP)
         {
-            return this->data.i16 < n;
+            // keys at even positions must be strings
+            // 偶数位置的键必须是字符串
+            if (this->data.list->size() % 2)
+            {
+                this->reset(ETYPE_VOID);
+                return false;
+            }
+            for (uint32_t i = 0; i < this->data.list->size(); i += 2)
+            {
+                if (this->data.list->at(i)->getType() != ETYPE_STRING)
+                {
+                    this->reset(ETYPE_VOID);
+                    return false;
+                }
+            }
         }
-        return false;
-#endif
+        return true;
     }
 
-    inline bool operator<(const uint32_t &n) const
+    /**
+     * @brief allocate payload on heap, long one is shareable
+     * 在堆上分配数据，较长的数据可以共享
+     *
+     * @param shared set to true if payload is an ElementSharedBuffer 数据是 ElementSharedBuffer 时设为true
+     * @return nullptr if heap is full 堆内存不足时为空指针
+     */
+    static uint8_t *_allocateBuffer(uint32_t length, bool *shared)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() < n;
+#if ELEMENT_SHARED_BUFFER_MIN_SIZE > 0
+        *shared = length >= ELEMENT_SHARED_BUFFER_MIN_SIZE;
+        if (*shared)
+            return ElementSharedBuffer::allocate(length);
 #else
-        if (this->type == ETYPE_UINT32)
+        *shared = false;
+#endif
+
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+        try
         {
-            return this->data.u32 < n;
+            return new uint8_t[length];
         }
-        return false;
+        catch (const std::bad_alloc &e)
+        {
+            return nullptr;
+        }
+#else
+        return new (std::nothrow) uint8_t[length];
 #endif
     }
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    inline bool operator<(const int &n) const
+    static inline void _freeBuffer(uint8_t *buffer, bool shared)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() < n;
-#else
-        if (this->type == ETYPE_INT32)
-        {
-            return this->data.i32 < n;
-        }
-        return false;
-#endif
+        if (shared)
+            ElementSharedBuffer::release(buffer);
+        else
+            delete[] buffer;
     }
-#endif
 
-    inline bool operator<(const int32_t &n) const
+    /**
+     * @brief release payload, file source or children owned by current object, used by clearBuffer
+     * 释放当前对象持有的数据、文件数据源或子元素，由 clearBuffer 使用
+     */
+    void _releaseBuffer()
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() < n;
-#else
-        if (this->type == ETYPE_INT32)
+        // buffer stored inside object or referenced from elsewhere is not owned by heap
+        // 存储在对象内部或引用自其他位置的数据不需要释放
+        if ((this->type == ETYPE_STRING || this->type == ETYPE_BUFFER || this->type == ETYPE_ARRAY) &&
+            this->data.buffer.p &&
+            this->data.buffer.bufferLength &&
+            this->copiedBuffer &&
+            !this->_isInlineBuffer())
+        {
+
+            // clear length 归零长度
+            // this->data.buffer.bufferLength = 0;
+
+            // clear buffer, shared one is freed by its last owner
+            // 清除buffer，共享的数据由最后一个持有者释放
+            _freeBuffer(this->data.buffer.p, this->sharedBuffer);
+
+            // reset pointer 重置指针
+            // this->data.buffer.p = nullptr;
+        }
+        else if (this->type == ETYPE_FILE && this->data.file.source)
         {
-            return this->data.i32 < n;
+            // source is deleted by its last owner
+            // 数据源由最后一个持有者删除
+            this->data.file.source->release();
+        }
+        else if ((this->type == ETYPE_LIST || this->type == ETYPE_MAP) &&
+                 this->data.list &&
+                 this->copiedBuffer)
+        {
+            // list owns its children
+            // 列表持有它的子元素
+            for (auto it = this->data.list->begin(); it != this->data.list->end(); ++it)
+            {
+                delete (*it);
+            }
+            delete this->data.list;
         }
-        return false;
-#endif
     }
 
-    inline bool operator<(const uint64_t &n) const
+    /**
+     * @brief make payload owned by current object only before it is modified in place
+     * 原地修改数据之前使数据只由当前对象持有
+     *
+     * @return false if heap is full, payload is unchanged 堆内存不足时返回false，数据不变
+     */
+    bool _detachBuffer()
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() < n;
-#else
-        if (this->type == ETYPE_UINT64)
+        if (!this->sharedBuffer || ElementSharedBuffer::count(this->data.buffer.p) == 1)
+            return true;
+
+        bool shared = false;
+        uint8_t *p = _allocateBuffer(this->data.buffer.bufferLength, &shared);
+        if (!p)
         {
-            return this->data.u64 < n;
+            this->err = E_ERROR_HEAP_FULL;
+            return false;
         }
-        return false;
-#endif
+        memcpy(p, this->data.buffer.p, this->data.buffer.bufferLength);
+        ElementSharedBuffer::release(this->data.buffer.p);
+        this->data.buffer.p = p;
+        this->sharedBuffer = shared;
+        return true;
     }
 
-    inline bool operator<(const int64_t &n) const
+    /**
+     * @brief copy raw data from another area
+     * 从另一个buffer拷贝原始数据
+     *
+     * @param buffer binary uint8 array 二进制数组指针
+     * @param length length of data 数组长度
+     * @param offset offset in source 需要从原始缓冲区开始拷贝的偏移量
+     * @param type default type 默认类型
+     *
+     * @return true success 成功
+     * @return false failed 失败
+     */
+    bool _copyBuffer(uint8_t *buffer, uint32_t length, uint32_t offset = 0, ElementType type = ETYPE_BUFFER)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() < n;
-#else
-        if (this->type == ETYPE_INT64)
+#if ELEMENT_INLINE_BUFFER_SIZE > 0
+        // short data is stored inside object
+        // 短数据存储在对象内部
+        if (length && length <= ELEMENT_INLINE_BUFFER_SIZE)
         {
-            return this->data.i64 < n;
+            this->data.buffer.p = this->inlineBuffer;
         }
-        return false;
+        else
 #endif
-    }
+        {
+            // allocate buffer
+            // 分配内存
+            bool shared = false;
+            this->data.buffer.p = _allocateBuffer(length, &shared);
+            this->sharedBuffer = shared && this->data.buffer.p;
+        }
 
-    inline bool operator<(const float &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() < n;
-#else
-        if (this->type == ETYPE_FLOAT)
+        // check memory allocation
+        // 检测内存分配
+        if (!this->data.buffer.p)
         {
-            return this->data.f < n;
+            this->type = ETYPE_VOID;
+            this->err = E_ERROR_HEAP_FULL;
+            this->data.buffer.bufferLength = 0;
+            return false;
         }
-        return false;
-#endif
-    }
+        memset(this->data.buffer.p, 0, length);
 
-    inline bool operator<(const double &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() < n;
-#else
-        if (this->type == ETYPE_DOUBLE)
+        // copy from origin
+        // 从原始位置拷贝数据
+        memcpy(this->data.buffer.p, buffer + offset, length);
+        // Serial.printf("copy data length: %lu, offset: %lu\n", length, offset);
+        if (type == ETYPE_STRING)
         {
-            return this->data.d < n;
+            (this->data.buffer.p)[length - 1] = 0;
         }
-        return false;
-#endif
+        this->type = type;
+        this->data.buffer.bufferLength = length;
+        // Serial.printf("this->data.buffer.bufferLength: %lu\n", this->data.buffer.bufferLength);
+        this->copiedBuffer = true;
+        return true;
     }
 
-    inline bool operator<(const char *str) const
+    /**
+     * @brief take over data of another object, another object will be set to ETYPE_VOID
+     * buffer on heap changes owner only, inline buffer is copied
+     * 接管另一个对象的数据，另一个对象会被设置为ETYPE_VOID
+     * 堆上的数据只是更换持有者，内部存储的数据会被拷贝
+     *
+     * @param e another object 另一个对象
+     */
+    void _moveFrom(Element &e) noexcept
     {
-        if (!str || !strlen(str))
-            return false;
-#ifndef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() < str[0];
-#else
-        if (this->type == ETYPE_STRING)
+        this->type = e.type;
+        this->itemType = e.itemType;
+        this->err = e.err;
+        this->copiedBuffer = e.copiedBuffer;
+        this->sharedBuffer = e.sharedBuffer;
+        this->data = e.data;
+
+#if ELEMENT_INLINE_BUFFER_SIZE > 0
+        if ((e.type == ETYPE_STRING || e.type == ETYPE_BUFFER || e.type == ETYPE_ARRAY) && e._isInlineBuffer())
         {
-            int32_t sizeA = this->data.buffer.bufferLength - 1;
-            int32_t sizeB = strlen(str);
-            return strncmp(this->c_str(), str, sizeA < sizeB ? sizeA : sizeB) < 0;
+            memcpy(this->inlineBuffer, e.inlineBuffer, e.data.buffer.bufferLength);
+            this->data.buffer.p = this->inlineBuffer;
         }
-        return false;
 #endif
-    }
 
-    inline bool operator<(const String &str) const
-    {
-        return this->operator<(str.c_str());
+        e.type = ETYPE_VOID;
+        e.err = E_ERROR_NO_ERROR;
+        e.copiedBuffer = true;
+        e.sharedBuffer = false;
+        bzero((uint8_t *)&(e.data), sizeof(ElementData));
     }
 
-    inline bool operator<(const String *str) const
+    /**
+     * @brief decode one field in compact mode, all reads are bounds checked
+     * 以紧凑模式解码一个字段，所有读取都会检查边界
+     */
+    int32_t _setFromCompactBuffer(uint8_t *buffer, uint32_t offset, uint32_t length, uint8_t depth)
     {
-        return this->operator<(str->c_str());
-    }
+        if (offset >= length)
+            return -2;
 
-    inline bool operator<(const std::string &str) const
-    {
-        return this->operator<(str.c_str());
-    }
+        uint32_t available = length - offset - 1;
+        int8_t mark = (int8_t)buffer[offset];
+        uint64_t n = 0;
+        int32_t used = 0;
 
-    inline bool operator<(const std::string *str) const
-    {
-        return this->operator<(str->c_str());
-    }
+        this->reset(ETYPE_VOID);
 
-    inline bool operator<(const Element &e) const
-    {
-        return this->compareElements(&e, true);
+        switch (mark)
+        {
+        case ETYPE_FLOAT:
+            if (available < 4)
+                return -2;
+            memcpy(&(this->data.f), buffer + offset + 1, 4);
+            this->type = ETYPE_FLOAT;
+            return 5;
+        case ETYPE_DOUBLE:
+            if (available < 8)
+                return -2;
+            memcpy(&(this->data.d), buffer + offset + 1, 8);
+            this->type = ETYPE_DOUBLE;
+            return 9;
+        case ETYPE_STRING:
+        case ETYPE_BUFFER:
+            used = ArrayBufferVarint::read(buffer + offset + 1, available, &n);
+            if (used < 0 || n > available - used ||
+                (mark == ETYPE_STRING && (!n || buffer[offset + used + n])))
+                return -2;
+            if (!this->_copyBuffer(buffer, n, offset + 1 + used, (ElementType)mark))
+                return -2;
+            return (int32_t)(1 + used + n);
+        case ETYPE_ARRAY:
+            // payload starts with item type
+            // 数据以元素类型开头
+            used = ArrayBufferVarint::read(buffer + offset + 1, available, &n);
+            if (used < 0 || !n || n > available - used ||
+                !this->_setArray((ElementType)buffer[offset + 1 + used], buffer + offset + 2 + used, n - 1))
+                return -2;
+            return (int32_t)(1 + used + n);
+        case ETYPE_LIST:
+        case ETYPE_MAP:
+            used = ArrayBufferVarint::read(buffer + offset + 1, available, &n);
+            if (used < 0 || n > available - used ||
+                !this->_setChildrenFromBuffer(buffer, offset + 1 + used, n, (ElementType)mark, true, depth))
+                return -2;
+            return (int32_t)(1 + used + n);
+        default:
+            used = ArrayBufferVarint::read(buffer + offset + 1, available, &n);
+            if (used < 0 || !ArrayBufferVarint::toData(n, (ElementType)mark, &(this->data)))
+            {
+                bzero((uint8_t *)&(this->data), sizeof(ElementData));
+                return -2;
+            }
+            this->type = (ElementType)mark;
+            return 1 + used;
+        }
     }
 
-    inline bool operator<(const Element *e) const
+    template <class T0, class T1>
+    inline bool issame()
     {
-        return this->compareElements(e, true);
+        return std::is_same<T0, T1>::value;
     }
 
-    //>
-    inline bool operator>(const uint8_t &n) const
+public:
+    /**
+     * @brief default constructor, type set to ETYPE_VOID
+     * 默认无参构造函数, 类型被设置为ETYPE_VOID
+     */
+    inline Element() { this->type = ETYPE_VOID; }
+
+    /**
+     * @brief copy from another element, this is a special copy constructor
+     * using pointer of another object
+     * 拷贝构造函数， 可以从另一个对象拷贝一模一样的数据
+     * @param e pointer of another object 另一个对象的指针
+     */
+    inline Element(const Element *e)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() > n;
-#else
-        if (this->type == ETYPE_UINT8)
-        {
-            return this->data.u8 > n;
-        }
-        return false;
-#endif
+        this->copyFrom((Element *)e);
     }
 
-    inline bool operator>(const int8_t &n) const
+    inline Element(const Element &e)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() > n;
-#else
-        if (this->type == ETYPE_INT8)
-        {
-            return this->data.i8 > n;
-        }
-        return false;
-#endif
+        this->copyFrom((Element *)(&e));
     }
 
-    inline bool operator>(const uint16_t &n) const
+    /**
+     * @brief move constructor, string or uint8 array on heap will be taken over without copying
+     * another object will be set to ETYPE_VOID
+     * 移动构造函数，堆上的字符串或二进制数组会被直接接管而不拷贝
+     * 另一个对象会被设置为ETYPE_VOID
+     *
+     * @param e another object 另一个对象
+     */
+    inline Element(Element &&e) noexcept
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() > n;
-#else
-        if (this->type == ETYPE_UINT16)
-        {
-            return this->data.u16 > n;
-        }
-        return false;
-#endif
+        this->_moveFrom(e);
     }
 
-    inline bool operator>(const int16_t &n) const
+    /**
+     * @brief uint8 array kept in a file, same as adoptFile
+     * 保存在文件中的二进制数组，与 adoptFile 相同
+     */
+    explicit inline Element(ElementFileSource *source)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() > n;
-#else
-        if (this->type == ETYPE_INT16)
-        {
-            return this->data.i16 > n;
-        }
-        return false;
-#endif
+        this->adoptFile(source);
     }
 
-    inline bool operator>(const uint32_t &n) const
+    /**
+     * @brief specific constructor
+     * 专门类型的构造函数
+     *
+     * @param n number 数字
+     */
+    inline Element(const uint8_t &n) : type(ETYPE_UINT8) { this->data.u8 = n; }
+    inline Element(const int8_t &n) : type(ETYPE_INT8) { this->data.i8 = n; };
+    inline Element(const uint16_t &n) : type(ETYPE_UINT16) { this->data.u16 = n; };
+    inline Element(const int16_t &n) : type(ETYPE_INT16) { this->data.i16 = n; };
+    inline Element(const uint32_t &n) : type(ETYPE_UINT32) { this->data.u32 = n; };
+
+#ifdef ENABLE_INT_DEFAULT_CONSTRUCTOR_AUTO_SET_TYPE_AND_DATA
+
+#if CONFIG_IDF_TARGET_ESP32C3 //
+    inline Element(const int &n)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() > n;
-#else
-        if (this->type == ETYPE_UINT32)
-        {
-            return this->data.u32 > n;
-        }
-        return false;
-#endif
+        this->setNumber(n);
     }
+#else
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    inline bool operator>(const int &n) const
+    inline Element(const int32_t &n)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() > n;
-#else
-        if (this->type == ETYPE_INT32)
-        {
-            return this->data.i32 > n;
-        }
-        return false;
-#endif
+        this->setNumber(n);
     }
 #endif
-
-    inline bool operator>(const int32_t &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() > n;
 #else
-        if (this->type == ETYPE_INT32)
-        {
-            return this->data.i32 > n;
-        }
-        return false;
-#endif
-    }
-
-    inline bool operator>(const uint64_t &n) const
+    inline Element(const int32_t &n) : type(ETYPE_INT32)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() > n;
-#else
-        if (this->type == ETYPE_UINT64)
-        {
-            return this->data.u64 > n;
-        }
-        return false;
+        this->data.i32 = n;
+    };
 #endif
-    }
 
-    inline bool operator>(const int64_t &n) const
+    inline Element(const uint64_t &n) : type(ETYPE_UINT64)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() > n;
-#else
-        if (this->type == ETYPE_INT64)
-        {
-            return this->data.i64 > n;
-        }
-        return false;
-#endif
-    }
+        this->data.u64 = n;
+    };
+    inline Element(const int64_t &n) : type(ETYPE_INT64) { this->data.i64 = n; };
+    inline Element(const float &n) : type(ETYPE_FLOAT) { this->data.f = n; };
+    inline Element(const double &n) : type(ETYPE_DOUBLE) { this->data.d = n; };
 
-    inline bool operator>(const float &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() > n;
-#else
-        if (this->type == ETYPE_FLOAT)
-        {
-            return this->data.f > n;
-        }
-        return false;
-#endif
-    }
-
-    inline bool operator>(const double &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() > n;
-#else
-        if (this->type == ETYPE_DOUBLE)
-        {
-            return this->data.d > n;
-        }
-        return false;
-#endif
-    }
-
-    inline bool operator>(const char *str) const
-    {
-        if (!str || !strlen(str))
-            return false;
-#ifndef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() > str[0];
-#else
-        if (this->type == ETYPE_STRING)
-        {
-            int32_t sizeA = this->data.buffer.bufferLength - 1;
-            int32_t sizeB = strlen(str);
-            return strncmp(this->c_str(), str, sizeA > sizeB ? sizeA : sizeB) > 0;
-        }
-        return false;
-#endif
-    }
-
-    inline bool operator>(const String &str) const
-    {
-        return this->operator>(str.c_str());
-    }
+    /**
+     * @brief copy data from c string
+     * 从c字符串中拷贝原始数据
+     *
+     * @param str c string; c字符串
+     */
+    inline Element(const char *str) : type(ETYPE_STRING) { this->_setString(str); }
 
-    inline bool operator>(const String *str) const
+    /**
+     * @brief string constructor, always make a copy
+     * 字符串的构造函数，会拷贝原始字符串
+     *
+     * @param str c string or arduino String(object or pointer) c字符串或Arduino字符串(对象或指针)
+     */
+    inline Element(const char *str, uint32_t offset, uint32_t length)
     {
-        return this->operator>(str->c_str());
+        this->_setString(str, offset, length ? length : strlen(str));
     }
-
-    inline bool operator>(const std::string &str) const
+    inline Element(const String &str, uint32_t offset = 0)
     {
-        return this->operator>(str.c_str());
+        this->_setString(str.c_str(), offset, str.length());
     }
-
-    inline bool operator>(const std::string *str) const
+    inline Element(const String *str, uint32_t offset = 0)
     {
-        return this->operator>(str->c_str());
+        this->_setString(str->c_str(), offset, str->length());
     }
-
-    inline bool operator>(const Element &e) const
+    inline Element(const std::string &str, uint32_t offset = 0)
     {
-        return this->compareElements(&e, false);
+        this->_setString(str.c_str(), offset, str.length());
     }
-
-    inline bool operator>(const Element *e) const
+    inline Element(const std::string *str, uint32_t offset = 0)
     {
-        return this->compareElements(e, false);
+        this->_setString(str->c_str(), offset, str->length());
     }
 
-    //<=
-
-    inline bool operator<=(const uint8_t &n) const
+    /**
+     * @brief raw uint8 array constructor, this will copy from original buffer
+     * 二进制数组的构造函数
+     *
+     * @param buffer source uint8 array 源数组
+     * @param bufferLength length of uint8 array 数组长度
+     * @param copyOrigin copy origin data or not 是否拷贝原始数据
+     * @param offsetInSrc offset in source 源数组开始拷贝的偏移量
+     */
+    explicit inline Element(uint8_t *buffer, uint32_t bufferLength, bool copyOrigin = true, uint32_t offsetInSrc = 0)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() <= n;
-#else
-        if (this->type == ETYPE_UINT8)
+        if (copyOrigin)
         {
-            return this->data.u8 <= n;
+            if (!this->_copyBuffer(buffer, bufferLength, offsetInSrc, ETYPE_BUFFER))
+            {
+                this->type = ETYPE_VOID;
+                // this->data.buffer.p = nullptr;
+                bzero(&(this->data), sizeof(ElementData));
+                this->data.buffer.bufferLength = 0;
+            }
         }
-        return false;
-#endif
-    }
-
-    inline bool operator<=(const int8_t &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() <= n;
-#else
-        if (this->type == ETYPE_INT8)
+        else
         {
-            return this->data.i8 <= n;
+            this->reset(ETYPE_BUFFER);
+            this->data.buffer.p = buffer;
+            this->data.buffer.bufferLength = bufferLength;
+            this->copiedBuffer = false;
         }
-        return false;
-#endif
     }
 
-    inline bool operator<=(const uint16_t &n) const
+#ifdef ARRAY_BUFFER_DEBUG_ON
+    uint8_t *getRAM(int32_t *outLen = nullptr) const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() <= n;
-#else
-        if (this->type == ETYPE_UINT16)
+        if (outLen)
         {
-            return this->data.u16 <= n;
+            (*outLen) = sizeof(ElementData);
         }
-        return false;
-#endif
+        return (uint8_t *)(this->data.u64);
     }
-
-    inline bool operator<=(const int16_t &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() <= n;
-#else
-        if (this->type == ETYPE_INT16)
-        {
-            return this->data.i16 <= n;
-        }
-        return false;
 #endif
-    }
-
-    inline bool operator<=(const uint32_t &n) const
+    /**
+     * @brief set type automatically by data range
+     * 自动根据数据大小设置类型
+     *
+     * @note only integer match this function
+     * 仅整数适用此函数
+     *
+     * this function fit in default int type to set correct type automatically
+     * 这个函数适用于默认int自动设置对应的类型
+     *
+     * @param n number 数字
+     * @param forceType manually set type 手动设置类型
+     */
+    void setNumber(int64_t n, ElementType forceType = ETYPE_VOID)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() <= n;
-#else
-        if (this->type == ETYPE_UINT32)
+        /**
+         * @brief
+         * in this part, it may should use like std::is_same<T, int>::value to set type and value
+         * but in some cases, that may cause problem, so use number to set type and value
+         *
+         * 这部分可能应该使用类似于std::is_same<T, int>::value 来设置类型和数据
+         * 但是在某些情况下可能会导致错误，所以直接使用数组的大小来设置类型和值
+         *
+         */
+        this->clearBuffer();
+
+        if (n >= 0)
         {
-            return this->data.u32 <= n;
+            // unsigned
+            if (n < 256)
+            {
+                this->reset(ETYPE_UINT8);
+                this->data.u8 = n;
+            }
+            else if (n > 0xff && n < 65536)
+            {
+                this->reset(ETYPE_UINT16);
+                this->data.u16 = n;
+            }
+            else if (n > 0xffff && n < 4294967296)
+            {
+                this->reset(ETYPE_UINT32);
+                this->data.u32 = n;
+            }
+            else
+            {
+                this->reset(ETYPE_UINT64);
+                this->data.u64 = n;
+            }
         }
-        return false;
-#endif
-    }
-
-#if CONFIG_IDF_TARGET_ESP32C3
-    inline bool operator<=(const int &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() <= n;
-#else
-        if (this->type == ETYPE_INT32)
+        else
         {
-            return this->data.i32 <= n;
+            // signed
+            if (n >= -128)
+            {
+                this->reset(ETYPE_INT8);
+                this->data.i8 = n;
+            }
+            else if (n < -128 && n >= -32768)
+            {
+                this->reset(ETYPE_INT16);
+                this->data.i16 = n;
+            }
+            else if (n < -32768 && n >= -2147483647)
+            {
+                this->reset(ETYPE_INT32);
+                this->data.i32 = n;
+            }
+            else
+            {
+                this->reset(ETYPE_INT64);
+                this->data.i64 = n;
+            }
         }
-        return false;
-#endif
-    }
-#endif
-
-    inline bool operator<=(const int32_t &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() <= n;
-#else
-        if (this->type == ETYPE_INT32)
+        if (forceType != ETYPE_VOID)
         {
-            return this->data.i32 <= n;
+            this->type = forceType;
         }
-        return false;
-#endif
     }
 
-    inline bool operator<=(const uint64_t &n) const
+    /**
+     * @brief write number stored as text, nothing is allocated, see ElementNumber::toChars
+     * 将存储的数字写为文本，不分配任何内存，见 ElementNumber::toChars
+     *
+     * @param output at least ELEMENT_NUMBER_CHARS_SIZE bytes, ends with '\0'
+     * 至少 ELEMENT_NUMBER_CHARS_SIZE 字节，以'\0'结尾
+     * @param decimals decimals of float and double, at most 9 单精度和双精度浮点数的小数位数，最多9位
+     * @return length without '\0', 0 if current object is not a number 不包括'\0'的长度，当前对象不是数字时为0
+     */
+    uint32_t toChars(char *output, uint8_t decimals = 2) const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() <= n;
-#else
-        if (this->type == ETYPE_UINT64)
-        {
-            return this->data.u64 <= n;
-        }
-        return false;
-#endif
+        *output = 0;
+        return this->_isNumber() ? this->_toNumber().toChars(output, decimals) : 0;
     }
 
-    inline bool operator<=(const int64_t &n) const
+    /**
+     * @brief set number from text, integers get smallest type like setNumber, others are double,
+     * see ElementNumber::fromChars
+     *
+     * 从文本设置数字，整数像setNumber一样使用最小的类型，其他为双精度浮点数，
+     * 见 ElementNumber::fromChars
+     *
+     * @param str text 文本
+     * @param length length of text, strlen(str) if 0 文本长度，为0时使用strlen(str)
+     * @return false and nothing is changed if whole text is not a number
+     * 整个文本不是数字时返回false且不做任何修改
+     */
+    bool fromChars(const char *str, uint32_t length = 0)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() <= n;
-#else
-        if (this->type == ETYPE_INT64)
-        {
-            return this->data.i64 <= n;
-        }
-        return false;
-#endif
+        ElementNumber n;
+        length = length ? length : (str ? strlen(str) : 0);
+        if (!length || ElementNumber::fromChars(str, length, &n) != length)
+            return false;
+
+        if (n.kind == ElementNumber::FLOATING)
+            this->_setNumber(n, ETYPE_DOUBLE);
+        else if (n.kind == ElementNumber::UNSIGNED && n.u > 0x7fffffffffffffffULL)
+            this->_setNumber(n, ETYPE_UINT64);
+        else
+            this->setNumber(n.i);
+        return true;
     }
 
-    inline bool operator<=(const float &n) const
+    /**
+     * @brief this function will indicate current object if has available data
+     * 这个函数用来指示当前对象是否存储了有用的数据
+     *
+     * @return true object stored valid data 对象存储了有效的数据可供读取
+     * @return false object hasn't any valid data stored 对象没有存储任何有效数据
+     */
+    inline bool available() const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() <= n;
-#else
-        if (this->type == ETYPE_FLOAT)
-        {
-            return this->data.f <= n;
-        }
-        return false;
-#endif
+        return this->type != ETYPE_VOID && this->err == E_ERROR_NO_ERROR;
     }
 
-    inline bool operator<=(const double &n) const
-    {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() <= n;
-#else
-        if (this->type == ETYPE_DOUBLE)
+    /**
+     * @brief manually copy object by developer
+     * 开发者可以使用这两个函数手动从另一个对象或者缓存拷贝数据
+     *
+     * @param e pointer of another object
+     * 另一个对象的指针
+     * @return true success 成功
+     * @return false failed 失败
+     */
+    bool copyFrom(Element *e)
+    {
+        if (!e)
         {
-            return this->data.d <= n;
+            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "copy target is nullptr");
+            return false;
         }
-        return false;
-#endif
-    }
 
-    inline bool operator<=(const char *str) const
-    {
-        if (!str || !strlen(str))
+        if (e->getType() == ETYPE_VOID)
+        {
+            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "the type of copy target has type ETYPE_VOID");
             return false;
-#ifndef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() <= str[0];
-#else
-        if (this->type == ETYPE_STRING)
+        }
+
+        if (e == this)
+            return true;
+
+        // numbers own nothing on heap, copied as they are, read before current object is cleared
+        // in case it is a child of current object
+        // 数字不持有堆内存，直接拷贝，在清除当前对象之前读取，以防它是当前对象的子元素
+        if (e->_isNumber())
         {
-            int32_t sizeA = this->data.buffer.bufferLength - 1;
-            int32_t sizeB = strlen(str);
-            return strncmp(this->c_str(), str, sizeA <= sizeB ? sizeA : sizeB) <= 0;
+            ElementType type = e->type;
+            ElementData d = e->data;
+            if (this->type >= 9)
+                this->clearBuffer();
+            this->type = type;
+            this->data = d;
+            return true;
         }
-        return false;
-#endif
-    }
 
-    inline bool operator<=(const String &str) const
-    {
-        return this->operator<=(str.c_str());
+        // another object would be released by clearBuffer() if it is a child of current object,
+        // such as list = list.at(0), so copy it out first then take over the copy
+        // 如果另一个对象是当前对象的子元素，它会被 clearBuffer() 释放，比如 list = list.at(0)，
+        // 所以先拷贝出来，再接管这个副本
+        if (this->_contains(e))
+        {
+            Element copy;
+            if (!copy.copyFrom(e))
+                return false;
+            this->clearBuffer();
+            this->_moveFrom(copy);
+            return true;
+        }
+
+        this->clearBuffer();
+        ElementType type = e->getType();
+        this->type = type;
+
+        // payload on heap is shared, it is copied when either one modifies it in place
+        // 堆上的数据被共享，其中任意一个原地修改它时才会拷贝
+        if (e->sharedBuffer)
+        {
+            ElementSharedBuffer::retain(e->data.buffer.p);
+            this->itemType = e->itemType;
+            this->data = e->data;
+            this->copiedBuffer = true;
+            this->sharedBuffer = true;
+            return true;
+        }
+
+        switch (type)
+        {
+        case ETYPE_UINT8:
+        case ETYPE_INT8:
+            this->data.i8 = e->getInt8();
+            break;
+        case ETYPE_UINT16:
+        case ETYPE_INT16:
+            this->data.i16 = e->getInt16();
+            break;
+        case ETYPE_UINT32:
+        case ETYPE_INT32:
+            this->data.i32 = e->getInt32();
+            break;
+        case ETYPE_UINT64:
+        case ETYPE_INT64:
+            this->data.i64 = e->getInt64();
+            break;
+        case ETYPE_FLOAT:
+            this->data.f = e->getFloat();
+            break;
+        case ETYPE_DOUBLE:
+            this->data.d = e->getDouble();
+            break;
+        case ETYPE_STRING:
+            return this->_setString((const char *)e->getRawBuffer(), 0, e->getRawBufferLength() - 1);
+        case ETYPE_BUFFER:
+            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "copy from another element u8a");
+            return this->copyFrom(e->getUint8Array(), e->getU8aLen());
+        case ETYPE_ARRAY:
+            return this->_setArray(e->itemType, e->data.buffer.p, e->data.buffer.bufferLength);
+        case ETYPE_FILE:
+            // source is shared, nothing is read
+            // 共享数据源，不读取任何数据
+            e->data.file.source->retain();
+            this->data.file = e->data.file;
+            this->copiedBuffer = true;
+            break;
+        case ETYPE_LIST:
+        case ETYPE_MAP:
+            // deep copy
+            // 深拷贝
+            if (!this->_setChildren(type))
+                return false;
+            for (auto it = e->getList()->begin(); it != e->getList()->end(); ++it)
+            {
+                this->data.list->push_back(new Element(*it));
+            }
+            return true;
+        default:
+            this->type = ETYPE_VOID;
+            return false;
+        }
+        ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "copy finished");
+        return true;
     }
 
-    inline bool operator<=(const String *str) const
+    /**
+     * @brief manually copy object by developer
+     * 开发者可以使用这两个函数手动从另一个对象或者缓存拷贝数据
+     *
+     * @param element another object
+     * 另一个对象
+     * @return true success 成功
+     * @return false failed 失败
+     */
+    inline bool copyFrom(Element element)
     {
-        return this->operator<=(str->c_str());
+        return this->copyFrom(&element);
     }
 
-    inline bool operator<=(const std::string &str) const
+    /**
+     * @brief copy data from uint8 array
+     * 从一个buffer拷贝数据
+     *
+     * @param buffer pointer of source buffer 源数组指针
+     * @param length length of data that will be copied 需要拷贝的长度
+     * @return true success 成功
+     * @return false failed 失败
+     */
+    bool copyFrom(uint8_t *buffer, uint32_t length)
     {
-        return this->operator<=(str.c_str());
+        this->clearBuffer();
+        return this->_copyBuffer(buffer, length, 0);
     }
 
-    inline bool operator<=(const std::string *str) const
+    /**
+     * @brief take over a buffer allocated by new uint8_t[], nothing will be copied
+     * the buffer will be freed by this object, caller must NOT delete it
+     * a string must end with '\0' and length includes '\0'
+     * 接管一个由 new uint8_t[] 分配的数组，不会拷贝任何数据
+     * 数组将由当前对象释放，调用者【不能】再删除它
+     * 字符串必须以'\0'结尾，长度包含'\0'
+     *
+     * @param buffer buffer on heap 堆上的数组
+     * @param length length of buffer 数组长度
+     * @param type ETYPE_BUFFER or ETYPE_STRING
+     * @return true success 成功
+     * @return false invalid arguments, buffer is NOT taken over 参数无效，数组没有被接管
+     */
+    bool adoptBuffer(uint8_t *buffer, uint32_t length, ElementType type = ETYPE_BUFFER)
     {
-        return this->operator<=(str->c_str());
+        if (!buffer || !length ||
+            (type != ETYPE_BUFFER && type != ETYPE_STRING) ||
+            (type == ETYPE_STRING && buffer[length - 1]))
+        {
+            return false;
+        }
+
+        this->reset(type);
+        this->err = E_ERROR_NO_ERROR;
+        this->data.buffer.p = buffer;
+        this->data.buffer.bufferLength = length;
+        this->copiedBuffer = true;
+        return true;
     }
 
-    inline bool operator<=(const Element &e) const
+    /**
+     * @brief take over a source created by new, payload stays in it and is read in chunks
+     * when encoding, so a payload larger than RAM could be sent as uint8 array
+     * the source will be released by this object and its copies, caller must NOT delete it
+     * 接管一个由new创建的数据源，数据保留在数据源中，编码时分块读取，
+     * 所以比内存更大的数据也可以作为二进制数组发送
+     * 数据源将由当前对象及其拷贝释放，调用者【不能】再删除它
+     *
+     * @param source source of payload 数据源
+     * @return false if source is nullptr 数据源为空指针时返回false
+     */
+    bool adoptFile(ElementFileSource *source)
     {
-        return this->compareElements(&e, true) || (*this) == e;
+        if (!source)
+            return false;
+
+        this->reset(ETYPE_FILE);
+        this->err = E_ERROR_NO_ERROR;
+        this->data.file.source = source;
+        this->data.file.length = source->length();
+        this->copiedBuffer = true;
+        return true;
     }
 
-    inline bool operator<=(const Element *e) const
+    /**
+     * @brief source of payload kept in a file
+     * 保存在文件中的数据的数据源
+     *
+     * @return nullptr if current object is not ETYPE_FILE 当前对象不是ETYPE_FILE时返回空指针
+     */
+    inline ElementFileSource *getFileSource() const
     {
-        return this->compareElements(e, true) || (*this) == (*e);
+        return this->type == ETYPE_FILE ? this->data.file.source : nullptr;
     }
 
-    //>=
+    /**
+     * @brief make current object an empty list or map, former data will be cleared
+     * 把当前对象设置为空的列表或映射，原有数据会被清除
+     *
+     * @return false heap full 堆内存不足
+     */
+    inline bool setList() { return this->_setChildren(ETYPE_LIST); }
+    inline bool setMap() { return this->_setChildren(ETYPE_MAP); }
 
-    inline bool operator>=(const uint8_t &n) const
+    /**
+     * @brief children of list, or keys and values one after another of map
+     * 列表的子元素，或者映射中依次排列的键和值
+     *
+     * @return nullptr if current object is not a list or map 当前对象不是列表或映射时返回空指针
+     */
+    inline Elements *getList() const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() >= n;
-#else
-        if (this->type == ETYPE_UINT8)
-        {
-            return this->data.u8 >= n;
-        }
-        return false;
-#endif
+        return (this->type == ETYPE_LIST || this->type == ETYPE_MAP) ? this->data.list : nullptr;
     }
 
-    inline bool operator>=(const int8_t &n) const
+    /**
+     * @brief number of items in list or entries in map
+     * 列表中元素的数量或映射中条目的数量
+     */
+    inline uint32_t size() const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() >= n;
-#else
-        if (this->type == ETYPE_INT8)
-        {
-            return this->data.i8 >= n;
-        }
-        return false;
-#endif
+        return this->getList() ? (this->type == ETYPE_MAP ? this->data.list->size() / 2 : this->data.list->size()) : 0;
     }
 
-    inline bool operator>=(const uint16_t &n) const
+    /**
+     * @brief item of list or value of map by index
+     * 按索引获取列表的元素或映射的值
+     *
+     * @return nullptr if out of range 越界时返回空指针
+     */
+    inline Element *at(uint32_t index) const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() >= n;
-#else
-        if (this->type == ETYPE_UINT16)
-        {
-            return this->data.u16 >= n;
-        }
-        return false;
-#endif
+        if (index >= this->size())
+            return nullptr;
+        return this->type == ETYPE_MAP ? this->data.list->at(index * 2 + 1) : this->data.list->at(index);
     }
 
-    inline bool operator>=(const int16_t &n) const
+    /**
+     * @brief key of map by index
+     * 按索引获取映射的键
+     */
+    inline Element *keyAt(uint32_t index) const
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() >= n;
-#else
-        if (this->type == ETYPE_INT16)
-        {
-            return this->data.i16 >= n;
-        }
-        return false;
-#endif
+        return (this->type == ETYPE_MAP && index < this->size()) ? this->data.list->at(index * 2) : nullptr;
     }
 
-    inline bool operator>=(const uint32_t &n) const
+    /**
+     * @brief append to list, pointer will be owned and deleted by list
+     * 追加到列表，指针由列表持有并负责删除
+     *
+     * @return false if current object is not a list, pointer is NOT taken over
+     * 当前对象不是列表时返回false，指针不会被接管
+     */
+    bool push(Element *e)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() >= n;
-#else
-        if (this->type == ETYPE_UINT32)
-        {
-            return this->data.u32 >= n;
-        }
-        return false;
-#endif
+        if (this->type != ETYPE_LIST || !e)
+            return false;
+        this->data.list->push_back(e);
+        return true;
     }
-
-#if CONFIG_IDF_TARGET_ESP32C3
-    inline bool operator>=(const int &n) const
+    inline bool push(const Element &e)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() >= n;
-#else
-        if (this->type == ETYPE_INT32)
-        {
-            return this->data.i32 >= n;
-        }
-        return false;
-#endif
+        return this->type == ETYPE_LIST && this->push(new Element(e));
     }
-#endif
-
-    inline bool operator>=(const int32_t &n) const
+    inline bool push(Element &&e)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() >= n;
-#else
-        if (this->type == ETYPE_INT32)
-        {
-            return this->data.i32 >= n;
-        }
-        return false;
-#endif
+        return this->type == ETYPE_LIST && this->push(new Element(std::move(e)));
     }
 
-    inline bool operator>=(const uint64_t &n) const
+    /**
+     * @brief size of one item of typed array
+     * 类型化数组中单个元素的大小
+     *
+     * @return 0 if type is not a number 类型不是数字时返回0
+     */
+    static uint8_t getItemSize(ElementType type)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() >= n;
-#else
-        if (this->type == ETYPE_UINT64)
+        switch (type)
         {
-            return this->data.u64 >= n;
+        case ETYPE_UINT8:
+        case ETYPE_INT8:
+            return 1;
+        case ETYPE_UINT16:
+        case ETYPE_INT16:
+            return 2;
+        case ETYPE_UINT32:
+        case ETYPE_INT32:
+        case ETYPE_FLOAT:
+            return 4;
+        case ETYPE_UINT64:
+        case ETYPE_INT64:
+        case ETYPE_DOUBLE:
+            return 8;
+        default:
+            return 0;
         }
-        return false;
-#endif
     }
 
-    inline bool operator>=(const int64_t &n) const
+    /**
+     * @brief make current object a typed array, items are copied,
+     * numbers of one type are stored one after another, thousands of samples cost one object
+     * 把当前对象设置为类型化数组，元素会被拷贝，
+     * 同一类型的数字依次存储，上千个采样值只需要一个对象
+     *
+     * @param itemType type of items, any number type 元素的类型，任意数字类型
+     * @param items items in little endian 小端序的元素
+     * @param count number of items 元素的数量
+     * @return false invalid type or heap full 类型无效或堆内存不足
+     */
+    inline bool setArray(ElementType itemType, const void *items, uint32_t count)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() >= n;
-#else
-        if (this->type == ETYPE_INT64)
-        {
-            return this->data.i64 >= n;
-        }
-        return false;
-#endif
+        return this->_setArray(itemType, (const uint8_t *)items, count * Element::getItemSize(itemType));
     }
-
-    inline bool operator>=(const float &n) const
+    template <class T>
+    inline typename ElementNumber::EnableArithmetic<T, bool>::type setArray(const T *items, uint32_t count)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() >= n;
-#else
-        if (this->type == ETYPE_FLOAT)
-        {
-            return this->data.f >= n;
-        }
-        return false;
-#endif
+        return this->setArray(ElementNumber::typeOf<T>(), items, count);
     }
 
-    inline bool operator>=(const double &n) const
+    /**
+     * @brief append items to typed array in one go, a void object becomes an array of T,
+     * storage is reallocated once per call, so append in batches rather than one by one
+     * 一次性向类型化数组追加多个元素，void对象会变成T类型的数组，
+     * 每次调用只重新分配一次内存，所以应当批量追加而不是逐个追加
+     *
+     * @return false if current object is not an array of T or heap full, array is unchanged
+     * 当前对象不是T类型的数组或堆内存不足时返回false，数组保持不变
+     */
+    template <class T>
+    typename ElementNumber::EnableArithmetic<T, bool>::type append(const T *items, uint32_t count)
     {
-#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() >= n;
-#else
-        if (this->type == ETYPE_DOUBLE)
-        {
-            return this->data.d >= n;
-        }
-        return false;
-#endif
-    }
-
-    inline bool operator>=(const char *str) const
-    {
-        if (!str || !strlen(str))
+        if (this->type == ETYPE_VOID && !this->setArray<T>(nullptr, 0))
             return false;
-#ifndef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
-        return this->getUniversalDouble() >= str[0];
-#else
-        if (this->type == ETYPE_STRING)
-        {
-            int32_t sizeA = this->data.buffer.bufferLength - 1;
-            int32_t sizeB = strlen(str);
-            return strncmp(this->c_str(), str, sizeA >= sizeB ? sizeA : sizeB) >= 0;
-        }
-        return false;
-#endif
-    }
-
-    inline bool operator>=(const String &str) const
-    {
-        return this->operator>=(str.c_str());
-    }
-
-    inline bool operator>=(const String *str) const
-    {
-        return this->operator>=(str->c_str());
+        if (this->type != ETYPE_ARRAY || this->itemType != ElementNumber::typeOf<T>() || (count && !items))
+            return false;
+        return this->_appendArray((const uint8_t *)items, count * sizeof(T));
     }
 
-    inline bool operator>=(const std::string &str) const
+    /**
+     * @brief zero-copy view of items of typed array
+     * 类型化数组元素的零拷贝视图
+     *
+     * @return empty view if current object is not an array of T 当前对象不是T类型的数组时返回空视图
+     */
+    template <class T>
+    inline ElementArrayView<T> getArray() const
     {
-        return this->operator>=(str.c_str());
+        return (this->type == ETYPE_ARRAY && this->itemType == ElementNumber::typeOf<T>())
+                   ? ElementArrayView<T>(this->data.buffer.p, this->data.buffer.bufferLength / sizeof(T))
+                   : ElementArrayView<T>();
     }
 
-    inline bool operator>=(const std::string *str) const
+    /**
+     * @brief call visitor with stored value as its concrete type, like std::visit,
+     * type is dispatched once by one switch, typed array is dispatched once more by item type
+     * visitor is called with one of:
+     * numbers as their own type, ElementVoid, ElementStringView, ElementBufferView,
+     * ElementArrayView<T>, ElementListView or ElementMapView
+     * all overloads must return same type, which is the type of visit
+     *
+     * 以存储的值的具体类型调用访问者，类似 std::visit，
+     * 类型只通过一个switch分派一次，类型化数组再按元素类型分派一次
+     * 访问者的参数为以下之一：
+     * 数字本身的类型、ElementVoid、ElementStringView、ElementBufferView、
+     * ElementArrayView<T>、ElementListView 或 ElementMapView
+     * 所有重载的返回类型必须相同，即visit的返回类型
+     *
+     * @example
+     * struct PayloadSize
+     * {
+     *     template <class T>
+     *     uint32_t operator()(const T &) const { return sizeof(T); } // numbers 数字
+     *     template <class T>
+     *     uint32_t operator()(ElementArrayView<T> a) const { return a.size() * sizeof(T); }
+     *     uint32_t operator()(ElementVoid) const { return 0; }
+     *     uint32_t operator()(ElementStringView s) const { return s.length(); }
+     *     uint32_t operator()(ElementBufferView b) const { return b.size(); }
+     *     uint32_t operator()(ElementListView l) const { return l.size(); }
+     *     uint32_t operator()(ElementMapView m) const { return m.size(); }
+     * };
+     * for (auto it = output->begin(); it != output->end(); ++it)
+     *     total += (*it)->visit(PayloadSize());
+     */
+    template <class Visitor>
+    auto visit(Visitor &&visitor) const -> decltype(visitor(ElementVoid()))
     {
-        return this->operator>=(str->c_str());
+        switch (this->type)
+        {
+        case ETYPE_UINT8:
+            return visitor(this->data.u8);
+        case ETYPE_INT8:
+            return visitor(this->data.i8);
+        case ETYPE_UINT16:
+            return visitor(this->data.u16);
+        case ETYPE_INT16:
+            return visitor(this->data.i16);
+        case ETYPE_UINT32:
+            return visitor(this->data.u32);
+        case ETYPE_INT32:
+            return visitor(this->data.i32);
+        case ETYPE_UINT64:
+            return visitor(this->data.u64);
+        case ETYPE_INT64:
+            return visitor(this->data.i64);
+        case ETYPE_FLOAT:
+            return visitor(this->data.f);
+        case ETYPE_DOUBLE:
+            return visitor(this->data.d);
+        case ETYPE_STRING:
+            return visitor(this->getStringView());
+        case ETYPE_BUFFER:
+            return visitor(ElementBufferView(this->data.buffer.p, this->data.buffer.bufferLength));
+        case ETYPE_ARRAY:
+            return this->_visitArray(visitor);
+        case ETYPE_LIST:
+            return visitor(ElementListView(this->data.list));
+        case ETYPE_MAP:
+            return visitor(ElementMapView(this->data.list));
+        default:
+            return visitor(ElementVoid());
+        }
     }
 
-    inline bool operator>=(const Element &e) const
+    /**
+     * @brief item type and number of items of typed array, ETYPE_VOID and 0 for other types
+     * 类型化数组的元素类型和元素数量，其他类型为 ETYPE_VOID 和0
+     */
+    inline ElementType getArrayType() const { return this->type == ETYPE_ARRAY ? this->itemType : ETYPE_VOID; }
+    inline uint32_t getArrayLength() const
     {
-        return this->compareElements(&e, false) || (*this) == e;
+        return this->type == ETYPE_ARRAY ? this->data.buffer.bufferLength / Element::getItemSize(this->itemType) : 0;
     }
 
-    inline bool operator>=(const Element *e) const
+    /**
+     * @brief reductions of typed array without knowing item type, sum is same as ElementArrayView::sum,
+     * min and max keep item type and are VOID for empty array
+     * 不需要知道元素类型的类型化数组归约，和与 ElementArrayView::sum 相同，
+     * 最小值和最大值保持元素类型，空数组时为VOID
+     *
+     * @return VOID if current object is not a typed array 当前对象不是类型化数组时返回VOID
+     */
+    inline Element arraySum() const { return this->_reduceArray(0); }
+    inline Element arrayMin() const { return this->_reduceArray(1); }
+    inline Element arrayMax() const { return this->_reduceArray(2); }
+    inline double arrayMean() const
     {
-        return this->compareElements(e, false) || (*this) == (*e);
+        uint32_t count = this->getArrayLength();
+        return count ? this->arraySum().getUniversalDouble() / count : 0;
     }
 
-    // basic math operators
-    // 基本数学符号重载
-
-    // +
-
-    uint8_t operator+(const uint8_t &n) const
-    {
-        return (uint8_t)(this->getUniversalDouble() + n);
-    }
-    int8_t operator+(const int8_t &n) const
+    /**
+     * @brief get value of map by key
+     * 按键获取映射的值
+     *
+     * @return nullptr if not found 找不到时返回空指针
+     */
+    Element *get(const char *key) const
     {
-        return (int8_t)(this->getUniversalDouble() + n);
+        if (this->type != ETYPE_MAP || !key)
+            return nullptr;
+        for (uint32_t i = 0; i < this->data.list->size(); i += 2)
+        {
+            if (!strcmp(this->data.list->at(i)->c_str(), key))
+                return this->data.list->at(i + 1);
+        }
+        return nullptr;
     }
 
-    uint16_t operator+(const uint16_t &n) const
-    {
-        return (uint16_t)(this->getUniversalDouble() + n);
-    }
-    int16_t operator+(const int16_t &n) const
+    /**
+     * @brief set value of map, former value of same key will be deleted
+     * pointer will be owned and deleted by map
+     * 设置映射的值，相同键的原有值会被删除
+     * 指针由映射持有并负责删除
+     *
+     * @return false if current object is not a map or key is empty, pointer is NOT taken over
+     * 当前对象不是映射或键为空时返回false，指针不会被接管
+     */
+    bool set(const char *key, Element *value)
     {
-        return (int16_t)(this->getUniversalDouble() + n);
-    }
+        if (this->type != ETYPE_MAP || !key || !strlen(key) || !value)
+            return false;
 
-    uint32_t operator+(const uint32_t &n) const
-    {
-        return (uint32_t)(this->getUniversalDouble() + n);
+        for (uint32_t i = 0; i < this->data.list->size(); i += 2)
+        {
+            if (!strcmp(this->data.list->at(i)->c_str(), key))
+            {
+                delete this->data.list->at(i + 1);
+                this->data.list->at(i + 1) = value;
+                return true;
+            }
+        }
+        this->data.list->push_back(new Element(key));
+        this->data.list->push_back(value);
+        return true;
     }
-#if CONFIG_IDF_TARGET_ESP32C3
-    int operator+(const int &n) const
+    inline bool set(const char *key, const Element &value)
     {
-        return (int)(this->getUniversalDouble() + n);
+        return this->type == ETYPE_MAP && key && strlen(key) && this->set(key, new Element(value));
     }
-#endif
-
-    int32_t operator+(const int32_t &n) const
+    inline bool set(const char *key, Element &&value)
     {
-        return (int32_t)(this->getUniversalDouble() + n);
+        return this->type == ETYPE_MAP && key && strlen(key) && this->set(key, new Element(std::move(value)));
     }
 
-    uint64_t operator+(const uint64_t &n) const
-    {
-        return (uint64_t)(this->getUniversalDouble() + n);
-    }
-    int64_t operator+(const int64_t &n) const
+    /**
+     * @brief total length of encoded children of list or map, excluding type mark and length
+     * 列表或映射所有子元素编码后的总长度，不包括类型标志和长度
+     */
+    uint32_t getChildrenOuterBufferLength(bool compact = false) const
     {
-        return (int64_t)(this->getUniversalDouble() + n);
+        if (!this->getList())
+            return 0;
+        uint32_t length = 0;
+        uint32_t step = this->type == ETYPE_MAP ? 2 : 1;
+        for (uint32_t i = 0; i + step <= this->data.list->size(); i += step)
+        {
+            length += this->_getEntryLength(i, compact);
+        }
+        return length;
     }
 
-    // becarefull using this, it will lose precision
-    // 小心使用这个函数，会丢失精度
-    float operator+(const float &n) const
+    /**
+     * @brief check current object equals to another or not
+     * 检查当前对象是否等于另一个对象
+     *
+     * @param obj another object; 另一个对象
+     * @return true
+     * @return false
+     */
+    bool equalsTo(const Element *obj) const
     {
-        return (float)(this->getUniversalDouble() + n);
-    }
+        auto typeA = this->type, typeB = obj->getType();
 
-    double operator+(const double &n) const
-    {
-        return (double)(this->getUniversalDouble() + n);
-    }
+        if (typeA != typeB)
+        {
+#ifdef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
+            // numbers of different types are compared by value,
+            // anything else of different types is unequal
+            // 不同类型的数字按数值比较，其他不同类型的数据不相等
+            if (typeA == ETYPE_VOID || typeB == ETYPE_VOID || typeA >= 9 || typeB >= 9)
+                return false;
 
-    // Element + Element
-    Element operator+(const Element &rvalue) const
-    {
-        Element tmp;
-        auto typeB = rvalue.getType();
+            uint64_t a = 0, b = 0;
+            uint8_t kind = this->_getNumberKey(&a);
+            if (kind != obj->_getNumberKey(&b))
+                return false;
 
-#ifdef CROSS_TYPE_CLACULATE
-        if (this->type < 9)
+            // non integral value is compared as double, so NaN is not equal to itself
+            // 非整数值按double比较，所以NaN不等于自身
+            return kind == 2 ? this->getUniversalDouble() == obj->getUniversalDouble() : a == b;
+#else
+            // return false if two elements have different type
+            // 如果两个对象所存储的数据类型不一样直接返回false
+            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "type unequaled, a type: %d, b type: %d", obj->getType(), this->type);
+            return false;
+#endif
+        }
+        else
         {
-            if (typeB < 9) // both numbers
+            if (this->type == ETYPE_BUFFER || this->type == ETYPE_STRING || this->type == ETYPE_ARRAY)
             {
-                int8_t direction = this->type < 0 || typeB < 0 ? -1 : 1;
-                ElementType newType = this->type > typeB ? this->type : typeB;
-                newType = (ElementType)((int8_t)newType * direction);
-
-                if (newType == 6 || newType == 7)
+                // return false if length is unequaled of two elements when they stored uint8 array
+                // 如果两个对象都存储了二进制数组但是长度不一样直接返回false
+                // ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "type: %d, lengthA: %u, lengthB: %u", obj->getBufferLength(), this->data.buffer.bufferLength);
+                if (obj->getRawBufferLength() != this->data.buffer.bufferLength || obj->getArrayType() != this->getArrayType())
                 {
-                    tmp = this->getUniversalDouble() + rvalue.getUniversalDouble();
+                    // ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "length not equal, length obj: %d, length this: %d\n string obj: [%s]\n string this: [%s]\n, ",
+                    //          obj->getBufferLength(),
+                    //          this->data.buffer.bufferLength,
+                    //          obj->c_str(),
+                    //          this->c_str());
+                    return false;
                 }
                 else
                 {
-                    tmp = this->getNumber() + rvalue.getNumber();
-                }
-            }
-            else // b isn't number
-            {
-                if (typeB == ETYPE_STRING)
-                {
-                    // b will add to tail of the string
-
-                    switch (this->type)
-                    {
-                    case ETYPE_UINT8:
-                    case ETYPE_INT8:
-                    case ETYPE_UINT16:
-                    case ETYPE_INT16:
-                    case ETYPE_UINT32:
-                    case ETYPE_INT32:
-                        tmp = String(this->data.i32) + rvalue.getString();
-                        break;
-                    case ETYPE_UINT64:
-                    case ETYPE_INT64:
-                    {
-                        char buf[32] = {0};
-                        sprintf(buf,
-                                (this->type == ETYPE_UINT64 ? "%llu" : "%ld"),
-                                (this->type == ETYPE_UINT64 ? this->data.u64 : this->data.i64));
-                        tmp = String(buf) + rvalue.getString();
-                    }
-                    break;
-                    case ETYPE_FLOAT:
-                    case ETYPE_DOUBLE:
-                        tmp = String(this->getUniversalDouble()) + rvalue.getString();
-                        break;
-                    case ETYPE_STRING:
-                        tmp = this->getString() + rvalue.getString();
-                        break;
-                    }
+                    // uint8 array may contain zero, compare all bytes
+                    // 二进制数组可能包含0，比较所有字节
+                    return !this->data.buffer.bufferLength ||
+                           !memcmp(obj->getRawBuffer(), this->getRawBuffer(), this->data.buffer.bufferLength);
                 }
-                // not support buffer add
             }
-        }
-        else // a isn't number
-        {
-            if (typeB < 9) // b is number, a isn't number
+            else if (this->type == ETYPE_LIST)
             {
-                if (this->type == ETYPE_STRING)
+                if (obj->size() != this->size())
+                    return false;
+                for (uint32_t i = 0; i < this->size(); ++i)
                 {
-                    switch (typeB)
-                    {
-                    case ETYPE_UINT8:
-                    case ETYPE_INT8:
-                    case ETYPE_UINT16:
-                    case ETYPE_INT16:
-                    case ETYPE_UINT32:
-                    case ETYPE_INT32:
-                        tmp = this->getString() + String(rvalue.getInt32());
-                        break;
-                    case ETYPE_UINT64:
-                    case ETYPE_INT64:
-                    {
-                        char buf[32] = {0};
-                        sprintf(buf,
-                                (typeB == ETYPE_UINT64 ? "%llu" : "%lld"),
-                                (typeB == ETYPE_UINT64 ? rvalue.getUint64() : rvalue.getInt64()));
-                        tmp = this->getString() + String(buf);
-                    }
-                    break;
-                    case ETYPE_FLOAT:
-                    case ETYPE_DOUBLE:
-                        tmp = this->getString() + String(rvalue.getUniversalDouble());
-                        break;
-                    }
-
-                    // not support buffer add
+                    if (!this->at(i)->equalsTo(obj->at(i)))
+                        return false;
                 }
+                return true;
             }
-            else // b isn't number, a ins't number
+            else if (this->type == ETYPE_MAP)
             {
-                if (typeB == ETYPE_STRING) // a is string, b is number
+                // order of keys doesn't matter
+                // 键的顺序无关
+                if (obj->size() != this->size())
+                    return false;
+                for (uint32_t i = 0; i < this->size(); ++i)
                 {
-                    // b will add to tail of the string
-
-                    tmp = this->getString() + rvalue.getString();
-
-                    // not support buffer add
+                    Element *value = obj->get(this->keyAt(i)->c_str());
+                    if (!value || !this->at(i)->equalsTo(value))
+                        return false;
                 }
+                return true;
             }
-        }
-
-#else
-        if (this->type == rvalue.getType())
-        {
-            if (this->type == ETYPE_STRING) // both strings
-            {
-                tmp = this->getString() + rvalue.getString();
-            }
-            if (this->type < 9 && typeB < 9)
+            else
             {
                 switch (this->type)
                 {
+                    // compare number if they both stored numner
+                    // 数字直接进行比较
                 case ETYPE_UINT8:
-                    tmp = this->data.u8 + rvalue.getUint8();
-                    break;
+                    return obj->getUint8() == this->data.u8;
                 case ETYPE_INT8:
-                    tmp = this->data.i8 + rvalue.getInt8();
-                    break;
+                    return obj->getInt8() == this->data.i8;
                 case ETYPE_UINT16:
-                    tmp = this->data.u16 + rvalue.getUint16();
-                    break;
+                    return obj->getUint16() == this->data.u16;
                 case ETYPE_INT16:
-                    tmp = this->data.i16 + rvalue.getInt16();
-                    break;
+                    return obj->getInt16() == this->data.i16;
                 case ETYPE_UINT32:
-                    tmp = this->data.u32 + rvalue.getUint32();
-                    break;
+                    return obj->getUint32() == this->data.u32;
                 case ETYPE_INT32:
-                    tmp = this->data.i32 + rvalue.getInt32();
-                    break;
+                    return obj->getInt32() == this->data.i32;
                 case ETYPE_UINT64:
-                    tmp = this->data.u64 + rvalue.getUint64();
-                    break;
+                    return obj->getUint64() == this->data.u64;
                 case ETYPE_INT64:
-                    tmp = this->data.i64 + rvalue.getInt64();
-                    break;
+                    return obj->getInt64() == this->data.i64;
                 case ETYPE_FLOAT:
-                    tmp = this->data.f + rvalue.getFloat();
-                    break;
+                    return obj->getFloat() == this->data.f;
                 case ETYPE_DOUBLE:
-                    tmp = this->data.d + rvalue.getDouble();
-                    break;
+                    return obj->getDouble() == this->data.d;
+                default:
+                    return false;
                 }
             }
         }
-#endif
-        return tmp;
+        return false;
     }
 
-    //-
-
-    uint8_t operator-(const uint8_t &n) const
-    {
-        return (uint8_t)(this->getUniversalDouble() - n);
-    }
-    int8_t operator-(const int8_t &n) const
+    /**
+     * @brief 32 bits FNV-1a, stable across builds and platforms
+     * 32位 FNV-1a，不同编译和平台下结果相同
+     */
+    static inline uint32_t hash(const uint8_t *data, uint32_t length, uint32_t seed = 2166136261u)
     {
-        return (int8_t)(this->getUniversalDouble() - n);
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            seed ^= data[i];
+            seed *= 16777619u;
+        }
+        return seed;
     }
 
-    uint16_t operator-(const uint16_t &n) const
-    {
-        return (uint16_t)(this->getUniversalDouble() - n);
-    }
-    int16_t operator-(const int16_t &n) const
+    /**
+     * @brief same as hash() of an Element holding this string, nothing is allocated
+     * 与存储此字符串的Element的hash()相同，不分配内存
+     */
+    static inline uint32_t hash(const char *str) { return ElementStringView(str).hash(); }
+    static inline uint32_t hash(const ElementStringView &view) { return view.hash(); }
+
+    /**
+     * @brief same as hash() of slice() holding these bytes, nothing is allocated
+     * 与持有这些字节的slice()的hash()相同，不分配内存
+     */
+    static inline uint32_t hash(const ElementBufferView &view)
     {
-        return (int16_t)(this->getUniversalDouble() - n);
+        return Element::hash(view.data(), view.size(), (view.size() ? ETYPE_BUFFER : ETYPE_VOID) + 2166136261u);
     }
 
-    uint32_t operator-(const uint32_t &n) const
+    /**
+     * @brief hash of stored data, consistent with equalsTo,
+     * numbers with same value have same hash whatever their type is,
+     * so it still works when ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON is defined
+     *
+     * 存储数据的哈希值，与 equalsTo 一致，
+     * 数值相同的数字无论类型是什么哈希值都相同，
+     * 所以定义了 ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON 时依然适用
+     */
+    uint32_t hash() const
     {
-        return (uint32_t)(this->getUniversalDouble() - n);
-    }
+        if (this->type != ETYPE_VOID && this->type < 9)
+        {
+            uint64_t key = 0;
+            uint8_t kind = this->_getNumberKey(&key);
+            return Element::hash((const uint8_t *)&key, sizeof(key), kind + 2166136261u);
+        }
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    int operator-(const int &n) const
-    {
-        return (int)(this->getUniversalDouble() - n);
-    }
-#endif
+        uint32_t seed = this->type + 2166136261u;
 
-    int32_t operator-(const int32_t &n) const
-    {
-        return (int32_t)(this->getUniversalDouble() - n);
-    }
+        if (this->type == ETYPE_STRING || this->type == ETYPE_BUFFER)
+            return Element::hash(this->data.buffer.p, this->data.buffer.bufferLength, seed);
 
-    uint64_t operator-(const uint64_t &n) const
-    {
-        return (uint64_t)(this->getUniversalDouble() - n);
-    }
-    int64_t operator-(const int64_t &n) const
-    {
-        return (int64_t)(this->getUniversalDouble() - n);
-    }
+        if (this->type == ETYPE_ARRAY)
+            return Element::hash(this->data.buffer.p, this->data.buffer.bufferLength, seed ^ ((uint8_t)this->itemType << 8));
 
-    // becarefull using this, it will lose precision
-    // 小心使用这个函数，会丢失精度
-    float operator-(const float &n) const
-    {
-        return (float)(this->getUniversalDouble() - n);
-    }
+        if (this->type == ETYPE_LIST)
+        {
+            // order matters
+            // 顺序相关
+            for (uint32_t i = 0; i < this->size(); ++i)
+            {
+                uint32_t h = this->at(i)->hash();
+                seed = Element::hash((const uint8_t *)&h, sizeof(h), seed);
+            }
+            return seed;
+        }
 
-    double operator-(const double &n) const
-    {
-        return (double)(this->getUniversalDouble() - n);
+        if (this->type == ETYPE_MAP)
+        {
+            // order of keys doesn't matter, entries are summed
+            // 键的顺序无关，所有条目相加
+            uint32_t sum = 0;
+            for (uint32_t i = 0; i < this->size(); ++i)
+            {
+                uint32_t h[2] = {this->keyAt(i)->hash(), this->at(i)->hash()};
+                sum += Element::hash((const uint8_t *)h, sizeof(h));
+            }
+            return Element::hash((const uint8_t *)&sum, sizeof(sum), seed);
+        }
+
+        return Element::hash(nullptr, 0, seed);
     }
 
-    // Element - Element
-    Element operator-(const Element &rvalue) const
+    /**
+     * @brief compare two elements
+     * 比较两个对象
+     *
+     * @param b pointer to another object; 另一个对象的指针
+     * @param lessThanB less than or greater than; 小于还是大于
+     * @return true
+     * @return false
+     */
+    bool compareElements(const Element *b, bool lessThanB) const
     {
-        Element tmp;
-        auto typeB = rvalue.getType();
+        auto typeA = this->type, typeB = b->getType();
 
-#ifdef CROSS_TYPE_CLACULATE
-        if (this->type < 9)
+        if (typeA < 9)
         {
-            if (typeB < 9) // both numbers
+            // current object stored number
+            if (typeB < 9)
             {
-                int8_t direction = this->type < 0 || typeB < 0 ? -1 : 1;
-                ElementType newType = this->type > typeB ? this->type : typeB;
-                newType = (ElementType)((int8_t)newType * direction);
+                // target object stored number
+                if (lessThanB)
+                    return this->getUniversalDouble() < b->getUniversalDouble();
+                else
+                    return this->getUniversalDouble() > b->getUniversalDouble();
+            }
+            else if (typeB == ETYPE_STRING || typeB == ETYPE_BUFFER)
+            {
+                // a is number, b is string or buffer
+                // compare first byte
 
-                if (newType == 6 || newType == 7)
-                {
-                    tmp = this->getUniversalDouble() - rvalue.getUniversalDouble();
-                }
+                if (lessThanB)
+                    return this->getUniversalDouble() < b->getRawBuffer()[0];
                 else
-                {
-                    tmp = this->getNumber() - rvalue.getNumber();
-                }
+                    return this->getUniversalDouble() > b->getRawBuffer()[0];
             }
-            else // b isn't number
+            else
             {
-                // a short string replace a long string(maybe) is not useful
+                ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "INVALID TYPE");
+                return false;
             }
         }
-        else // a isn't number
+        else
         {
-            if (typeB < 9) // b is number, a isn't number
+            // a NOT a number
+            if (typeA == ETYPE_BUFFER || typeA == ETYPE_STRING)
             {
-                if (this->type == ETYPE_STRING)
+                if (typeB < 9)
                 {
-                    tmp = this->getString();
-                    switch (typeB)
-                    {
-                    case ETYPE_UINT8:
-                    case ETYPE_INT8:
-                    case ETYPE_UINT16:
-                    case ETYPE_INT16:
-                    case ETYPE_UINT32:
-                    case ETYPE_INT32:
-                        tmp.replace(String(rvalue.getInt32()), "");
-                        break;
-                    case ETYPE_UINT64:
-                    case ETYPE_INT64:
+                    // b is a number
+                    if (lessThanB)
+                        return (this->data.buffer.p)[0] < b->getUniversalDouble();
+                    else
+                        return (this->data.buffer.p)[0] > b->getUniversalDouble();
+                }
+                else
+                {
+                    // b NOT a number
+                    if (typeB == ETYPE_BUFFER || typeB == ETYPE_STRING)
                     {
-                        char buf[32] = {0};
-                        sprintf(buf,
-                                (typeB == ETYPE_UINT64 ? "%llu" : "%ld"),
-                                (typeB == ETYPE_UINT64 ? rvalue.getUint64() : rvalue.getInt64()));
-                        tmp.replace(String(buf), "");
-                    }
-                    break;
-                    case ETYPE_FLOAT:
-                    case ETYPE_DOUBLE:
-                        tmp.replace(String(String(rvalue.getUniversalDouble())), "");
-                        break;
+                        if (lessThanB)
+                            return (this->data.buffer.p)[0] < b->getRawBuffer()[0];
+                        else
+                            return (this->data.buffer.p)[0] > b->getRawBuffer()[0];
                     }
-
-                    // not support buffer add
                 }
             }
-            else // b isn't number, a ins't number
+            else
             {
-                if (typeB == ETYPE_STRING) // a is string, b is number
-                {
-                    // b will add to tail of the string
+                ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "INVALID TYPE");
+                return false;
+            }
+        }
+        return false;
+    }
 
-                    tmp = this->getString();
-                    tmp.replace(rvalue.getString(), "");
+    /**
+     * @brief convert any types of number to double and return;
+     * it won't change object itself
+     *
+     * 转换所有类型的数字到双精度浮点，然后返回；
+     * 这不会修改对象自身
+     *
+     * @return double
+     */
+    inline double getUniversalDouble() const
+    {
+        return this->_toNumber().to<double>();
+    }
 
-                    // not support buffer add
-                }
-            }
+    // operators, almost all operators were overloaded
+    // 重载的运算符，几乎所有的运算符都已经被重载
+
+    // =
+    template <class T>
+    inline typename ElementNumber::Enable<T, T>::type operator=(const T &n)
+    {
+        this->_setNumber(ElementNumber::of(n), ElementNumber::typeOf<T>());
+        return n;
+    }
+
+    const char *operator=(const char *str)
+    {
+        this->_setString(str);
+        return str;
+    }
+
+    String operator=(const String &str)
+    {
+        this->_setString(str.c_str());
+        return str;
+    }
+
+    const String *operator=(const String *str)
+    {
+        this->_setString(str->c_str());
+        return str;
+    }
+
+    std::string operator=(const std::string &str)
+    {
+        this->_setString(str.c_str());
+        return str;
+    }
+
+    const std::string *operator=(const std::string *str)
+    {
+        this->_setString(str->c_str());
+        return str;
+    }
+
+    Element &operator=(const Element &e)
+    {
+        if (this != &e)
+        {
+            this->copyFrom((Element *)(&e));
         }
+        return *this;
+    }
 
-#else
-        if (this->type == rvalue.getType())
+    Element &operator=(Element &&e) noexcept
+    {
+        if (this == &e)
+            return *this;
+
+        // another object would be released by clearBuffer() if it is a child of current object,
+        // such as list = std::move(*list.at(0)), so move it out first then take over the local one
+        // 如果另一个对象是当前对象的子元素，它会被 clearBuffer() 释放，比如 list = std::move(*list.at(0))，
+        // 所以先把它移动出来，再接管这个局部对象
+        if (this->_contains(&e))
         {
-            if (this->type == ETYPE_STRING) // both strings
+            Element tmp(std::move(e));
+            this->clearBuffer();
+            this->_moveFrom(tmp);
+            return *this;
+        }
+
+        this->clearBuffer();
+        this->_moveFrom(e);
+        return *this;
+    }
+
+    const Element *operator=(const Element *e)
+    {
+        if (this != e)
+        {
+            this->copyFrom((Element *)e);
+        }
+        return e;
+    }
+
+    // ()
+
+    /**
+     * @brief set an uint8 array to element
+     *
+     * @param buffer pointer
+     * @param length length of buffer
+     * @return Element& self
+     */
+    Element &operator()(uint8_t *buffer, uint32_t length)
+    {
+        this->copyFrom(buffer, length);
+        return *this;
+    }
+
+    // ==
+
+    inline bool operator==(const char *str) const
+    {
+        uint32_t targetLen = strlen(str);
+        if (!targetLen)
+        {
+            if (!this->available())
             {
-                tmp = this->getString();
-                tmp.replace(rvalue.getString(), "");
+                return true;
             }
-            if (this->type < 9 && typeB < 9)
+            else if (this->type == ETYPE_STRING && (this->data.buffer.bufferLength - 1 <= 0))
             {
-                switch (this->type)
-                {
-                case ETYPE_UINT8:
-                    tmp = this->data.u8 - rvalue.getUint8();
-                    break;
-                case ETYPE_INT8:
-                    tmp = this->data.i8 - rvalue.getInt8();
-                    break;
-                case ETYPE_UINT16:
-                    tmp = this->data.u16 - rvalue.getUint16();
-                    break;
-                case ETYPE_INT16:
-                    tmp = this->data.i16 - rvalue.getInt16();
-                    break;
-                case ETYPE_UINT32:
-                    tmp = this->data.u32 - rvalue.getUint32();
-                    break;
-                case ETYPE_INT32:
-                    tmp = this->data.i32 - rvalue.getInt32();
-                    break;
-                case ETYPE_UINT64:
-                    tmp = this->data.u64 - rvalue.getUint64();
-                    break;
-                case ETYPE_INT64:
-                    tmp = this->data.i64 - rvalue.getInt64();
-                    break;
-                case ETYPE_FLOAT:
-                    tmp = this->data.f - rvalue.getFloat();
-                    break;
-                case ETYPE_DOUBLE:
-                    tmp = this->data.d - rvalue.getDouble();
-                    break;
-                }
+                return true;
+            }
+            else
+            {
+                return false;
             }
         }
-#endif
-        return tmp;
-    }
+        if (targetLen != (this->data.buffer.bufferLength - 1))
+        {
+            return false;
+        }
+        else
+        {
+            return !strncmp(str, this->c_str(), targetLen);
+        }
+    }
+
+    inline bool operator==(const String &str) const
+    {
+        return this->operator==(str.c_str());
+    }
+
+    inline bool operator==(const String *str) const
+    {
+        return this->operator==(str->c_str());
+    }
+
+    inline bool operator==(const std::string &str) const
+    {
+        return this->operator==(str.c_str());
+    }
+
+    inline bool operator==(const std::string *str) const
+    {
+        return this->operator==(str->c_str());
+    }
+
+    inline bool operator==(const ElementStringView &view) const
+    {
+        if (!this->available())
+            return view.empty();
+        return this->type == ETYPE_STRING && this->getStringView() == view;
+    }
+
+    inline bool operator==(const Element &obj) const
+    {
+        return obj.equalsTo(this);
+    }
+
+    inline bool operator==(const Element *obj) const
+    {
+        return obj->equalsTo(this);
+    }
+
+    /**
+     * @brief comparison with a number, see _compareNumber
+     * 与数字比较，见 _compareNumber
+     */
+    template <class T>
+    inline typename ElementNumber::Enable<T, bool>::type operator==(const T &n) const
+    {
+        return !this->_compareNumber(n);
+    }
+
+    // !=
+
+    inline bool operator!=(const Element &obj) const
+    {
+        return !obj.equalsTo(this);
+    }
+
+    inline bool operator!=(const Element *obj) const
+    {
+        return !obj->equalsTo(this);
+    }
+
+    template <class T>
+    inline typename ElementNumber::Enable<T, bool>::type operator!=(const T &n) const
+    {
+        return this->_compareNumber(n) != 0;
+    }
+
+    //<
+    template <class T>
+    inline typename ElementNumber::Enable<T, bool>::type operator<(const T &n) const
+    {
+        return this->_compareNumber(n) == -1;
+    }
+
+    inline bool operator<(const char *str) const
+    {
+        if (!str || !strlen(str))
+            return false;
+#ifndef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
+        return this->getUniversalDouble() < str[0];
+#else
+        if (this->type == ETYPE_STRING)
+        {
+            int32_t sizeA = this->data.buffer.bufferLength - 1;
+            int32_t sizeB = strlen(str);
+            return strncmp(this->c_str(), str, sizeA < sizeB ? sizeA : sizeB) < 0;
+        }
+        return false;
+#endif
+    }
+
+    inline bool operator<(const String &str) const
+    {
+        return this->operator<(str.c_str());
+    }
+
+    inline bool operator<(const String *str) const
+    {
+        return this->operator<(str->c_str());
+    }
+
+    inline bool operator<(const std::string &str) const
+    {
+        return this->operator<(str.c_str());
+    }
+
+    inline bool operator<(const std::string *str) const
+    {
+        return this->operator<(str->c_str());
+    }
+
+    inline bool operator<(const Element &e) const
+    {
+        return this->compareElements(&e, true);
+    }
+
+    inline bool operator<(const Element *e) const
+    {
+        return this->compareElements(e, true);
+    }
+
+    //>
+    template <class T>
+    inline typename ElementNumber::Enable<T, bool>::type operator>(const T &n) const
+    {
+        return this->_compareNumber(n) == 1;
+    }
+
+    inline bool operator>(const char *str) const
+    {
+        if (!str || !strlen(str))
+            return false;
+#ifndef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
+        return this->getUniversalDouble() > str[0];
+#else
+        if (this->type == ETYPE_STRING)
+        {
+            int32_t sizeA = this->data.buffer.bufferLength - 1;
+            int32_t sizeB = strlen(str);
+            return strncmp(this->c_str(), str, sizeA > sizeB ? sizeA : sizeB) > 0;
+        }
+        return false;
+#endif
+    }
+
+    inline bool operator>(const String &str) const
+    {
+        return this->operator>(str.c_str());
+    }
+
+    inline bool operator>(const String *str) const
+    {
+        return this->operator>(str->c_str());
+    }
+
+    inline bool operator>(const std::string &str) const
+    {
+        return this->operator>(str.c_str());
+    }
+
+    inline bool operator>(const std::string *str) const
+    {
+        return this->operator>(str->c_str());
+    }
+
+    inline bool operator>(const Element &e) const
+    {
+        return this->compareElements(&e, false);
+    }
+
+    inline bool operator>(const Element *e) const
+    {
+        return this->compareElements(e, false);
+    }
+
+    //<=
+
+    template <class T>
+    inline typename ElementNumber::Enable<T, bool>::type operator<=(const T &n) const
+    {
+        return (uint8_t)(this->_compareNumber(n) + 1) <= 1;
+    }
+
+    inline bool operator<=(const char *str) const
+    {
+        if (!str || !strlen(str))
+            return false;
+#ifndef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
+        return this->getUniversalDouble() <= str[0];
+#else
+        if (this->type == ETYPE_STRING)
+        {
+            int32_t sizeA = this->data.buffer.bufferLength - 1;
+            int32_t sizeB = strlen(str);
+            return strncmp(this->c_str(), str, sizeA <= sizeB ? sizeA : sizeB) <= 0;
+        }
+        return false;
+#endif
+    }
+
+    inline bool operator<=(const String &str) const
+    {
+        return this->operator<=(str.c_str());
+    }
+
+    inline bool operator<=(const String *str) const
+    {
+        return this->operator<=(str->c_str());
+    }
+
+    inline bool operator<=(const std::string &str) const
+    {
+        return this->operator<=(str.c_str());
+    }
+
+    inline bool operator<=(const std::string *str) const
+    {
+        return this->operator<=(str->c_str());
+    }
+
+    inline bool operator<=(const Element &e) const
+    {
+        return this->compareElements(&e, true) || (*this) == e;
+    }
+
+    inline bool operator<=(const Element *e) const
+    {
+        return this->compareElements(e, true) || (*this) == (*e);
+    }
+
+    //>=
+
+    template <class T>
+    inline typename ElementNumber::Enable<T, bool>::type operator>=(const T &n) const
+    {
+        return (uint8_t)this->_compareNumber(n) <= 1;
+    }
+
+    inline bool operator>=(const char *str) const
+    {
+        if (!str || !strlen(str))
+            return false;
+#ifndef ENABLE_ELEMENT_NUMBER_FUZZY_COMPARISON
+        return this->getUniversalDouble() >= str[0];
+#else
+        if (this->type == ETYPE_STRING)
+        {
+            int32_t sizeA = this->data.buffer.bufferLength - 1;
+            int32_t sizeB = strlen(str);
+            return strncmp(this->c_str(), str, sizeA >= sizeB ? sizeA : sizeB) >= 0;
+        }
+        return false;
+#endif
+    }
+
+    inline bool operator>=(const String &str) const
+    {
+        return this->operator>=(str.c_str());
+    }
+
+    inline bool operator>=(const String *str) const
+    {
+        return this->operator>=(str->c_str());
+    }
+
+    inline bool operator>=(const std::string &str) const
+    {
+        return this->operator>=(str.c_str());
+    }
+
+    inline bool operator>=(const std::string *str) const
+    {
+        return this->operator>=(str->c_str());
+    }
+
+    inline bool operator>=(const Element &e) const
+    {
+        return this->compareElements(&e, false) || (*this) == e;
+    }
+
+    inline bool operator>=(const Element *e) const
+    {
+        return this->compareElements(e, false) || (*this) == (*e);
+    }
+
+    // basic math operators
+    // 基本数学符号重载
+
+    // +
+
+    /**
+     * @brief number operation with a number, result has type of the number
+     * 与数字运算，结果为该数字的类型
+     */
+    template <class T>
+    inline typename ElementNumber::EnableArithmetic<T, T>::type operator+(const T &n) const
+    {
+        return this->_calculateWith(ElementNumber::ADD, n);
+    }
+
+    // Element + Element
+    Element operator+(const Element &rvalue) const
+    {
+        if (this->type < 9 && rvalue.type < 9)
+            return this->_calculate(ElementNumber::ADD, rvalue);
+
+        Element tmp;
+        auto typeB = rvalue.getType();
+
+#ifdef CROSS_TYPE_CLACULATE
+        if (this->type < 9)
+        {
+            if (typeB == ETYPE_STRING && this->type != ETYPE_VOID)
+            {
+                // b will add to tail of the string
+
+                char buf[ELEMENT_NUMBER_CHARS_SIZE];
+                this->toChars(buf);
+                tmp = String(buf) + rvalue.c_str();
+            }
+            // not support buffer add
+        }
+        else // a isn't number
+        {
+            if (typeB < 9) // b is number, a isn't number
+            {
+                if (this->type == ETYPE_STRING && typeB != ETYPE_VOID)
+                {
+                    char buf[ELEMENT_NUMBER_CHARS_SIZE];
+                    rvalue.toChars(buf);
+                    tmp = this->getString() + buf;
+
+                    // not support buffer add
+                }
+            }
+            else // b isn't number, a ins't number
+            {
+                if (typeB == ETYPE_STRING) // a is string, b is number
+                {
+                    // b will add to tail of the string
+
+                    tmp = this->getString() + rvalue.getString();
+
+                    // not support buffer add
+                }
+            }
+        }
+
+#else
+        if (this->type == rvalue.getType())
+        {
+            if (this->type == ETYPE_STRING) // both strings
+            {
+                tmp = this->getString() + rvalue.getString();
+            }
+        }
+#endif
+        return tmp;
+    }
+
+    //-
+
+    template <class T>
+    inline typename ElementNumber::EnableArithmetic<T, T>::type operator-(const T &n) const
+    {
+        return this->_calculateWith(ElementNumber::SUB, n);
+    }
+
+    // Element - Element
+    Element operator-(const Element &rvalue) const
+    {
+        if (this->type < 9 && rvalue.type < 9)
+            return this->_calculate(ElementNumber::SUB, rvalue);
+
+        Element tmp;
+        auto typeB = rvalue.getType();
+
+#ifdef CROSS_TYPE_CLACULATE
+        if (this->type < 9)
+        {
+            // a short string replace a long string(maybe) is not useful
+        }
+        else // a isn't number
+        {
+            if (typeB < 9) // b is number, a isn't number
+            {
+                if (this->type == ETYPE_STRING && typeB != ETYPE_VOID)
+                {
+                    char buf[ELEMENT_NUMBER_CHARS_SIZE];
+                    rvalue.toChars(buf);
+                    tmp = this->getString();
+                    tmp.replace(buf, "");
+
+                    // not support buffer add
+                }
+            }
+            else // b isn't number, a ins't number
+            {
+                if (typeB == ETYPE_STRING) // a is string, b is number
+                {
+                    // b will add to tail of the string
+
+                    tmp = this->getString();
+                    tmp.replace(rvalue.getString(), "");
+
+                    // not support buffer add
+                }
+            }
+        }
+
+#else
+        if (this->type == rvalue.getType())
+        {
+            if (this->type == ETYPE_STRING) // both strings
+            {
+                tmp = this->getString();
+                tmp.replace(rvalue.getString(), "");
+            }
+        }
+#endif
+        return tmp;
+    }
+
+    //*
+
+    template <class T>
+    inline typename ElementNumber::EnableArithmetic<T, T>::type operator*(const T &n) const
+    {
+        return this->_calculateWith(ElementNumber::MUL, n);
+    }
+
+    // Element * Element
+    Element operator*(const Element &rvalue) const
+    {
+        if (this->type < 9 && rvalue.type < 9)
+            return this->_calculate(ElementNumber::MUL, rvalue);
+
+        Element tmp;
+        auto typeB = rvalue.getType();
+
+#ifdef CROSS_TYPE_CLACULATE
+        if (this->type < 9)
+        {
+            if (typeB == ETYPE_STRING)
+            {
+                switch (this->type)
+                {
+                case ETYPE_UINT8:
+                case ETYPE_INT8:
+                case ETYPE_UINT16:
+                case ETYPE_INT16:
+                case ETYPE_UINT32:
+                case ETYPE_INT32:
+                case ETYPE_UINT64:
+                case ETYPE_INT64:
+                case ETYPE_FLOAT:
+                case ETYPE_DOUBLE:
+                    tmp = rvalue.getString();
+                    int64_t times = this->getNumber();
+                    for (int i = 0; i < times; ++i)
+                    {
+                        tmp = tmp.getString() + tmp.getString();
+                    }
+                    break;
+                }
+            }
+        }
+        else // a isn't number
+        {
+            if (typeB < 9) // b is number, a isn't number
+            {
+                if (this->type == ETYPE_STRING)
+                {
+                    switch (typeB)
+                    {
+                    case ETYPE_UINT8:
+                    case ETYPE_INT8:
+                    case ETYPE_UINT16:
+                    case ETYPE_INT16:
+                    case ETYPE_UINT32:
+                    case ETYPE_INT32:
+                    case ETYPE_UINT64:
+                    case ETYPE_INT64:
+                    case ETYPE_FLOAT:
+                    case ETYPE_DOUBLE:
+                        tmp = this->getString();
+                        int64_t times = rvalue.getNumber();
+                        String tmpStr = this->getString();
+                        for (int i = 0; i < times - 1; ++i)
+                        {
+                            tmp += tmpStr;
+                        }
+                        break;
+                    }
+
+                    // not support buffer add
+                }
+            }
+        }
+
+#endif
+        return tmp;
+    }
+
+    // /
+    template <class T>
+    inline typename ElementNumber::EnableArithmetic<T, T>::type operator/(const T &n) const
+    {
+        return this->_calculateWith(ElementNumber::DIV, n);
+    }
+
+    // Element / Element
+    Element operator/(const Element &rvalue) const
+    {
+        return this->_calculate(ElementNumber::DIV, rvalue);
+    }
+
+    // +=
+    /**
+     * @brief compound assignment with a number, see _assignNumber
+     * 与数字的复合赋值，见 _assignNumber
+     */
+    template <class T>
+    inline typename ElementNumber::EnableArithmetic<T, Element &>::type operator+=(const T &n)
+    {
+        return this->_assignNumber(ElementNumber::ADD, n);
+    }
+
+    Element &operator+=(const Element &e)
+    {
+        (*this) = (*this) + e;
+        return (*this);
+    }
+
+    Element &operator+=(const Element *e)
+    {
+        (*this) = (*this) + (*e);
+        return (*this);
+    }
+
+    Element &operator+=(const char *str)
+    {
+        if (strlen(str))
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                this->_setString((this->getString() + str).c_str());
+            }
+        }
+        return (*this);
+    }
+
+    const char *operator+=(const String &str)
+    {
+        if (str.length())
+        {
+            // if (this->type == ETYPE_STRING)
+            //{
+            // comment:
+            //  if Element a = ""; a.getType() == ETYPE_VOID
+            //  should modify to ETYPE_STRING
+            //  todo, in _setString
+            this->_setString((this->getString() + str).c_str());
+            //}
+        }
+        return this->c_str();
+    }
+
+    const char *operator+=(const std::string &str)
+    {
+        if (str.length())
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                this->_setString((this->getString() + str.c_str()).c_str());
+            }
+        }
+        return this->c_str();
+    }
+
+    const char *operator+=(const String *str)
+    {
+        if (str->length())
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                this->_setString((this->getString() + str->c_str()).c_str());
+            }
+        }
+        return this->c_str();
+    }
+
+    const char *operator+=(const std::string *str)
+    {
+        if (str->length())
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                this->_setString((this->getString() + str->c_str()).c_str());
+            }
+        }
+        return this->c_str();
+    }
+
+    // -=
+
+    template <class T>
+    inline typename ElementNumber::EnableArithmetic<T, Element &>::type operator-=(const T &n)
+    {
+        return this->_assignNumber(ElementNumber::SUB, n);
+    }
+
+    Element &operator-=(const Element &e)
+    {
+        (*this) = (*this) - e;
+        return (*this);
+    }
+
+    Element &operator-=(const Element *e)
+    {
+        (*this) = (*this) - (*e);
+        return (*this);
+    }
+
+    Element &operator-=(const char *str)
+    {
+        if (strlen(str))
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                String tmp = this->getString();
+                tmp.replace(str, "");
+                this->_setString(tmp.c_str());
+            }
+        }
+        return (*this);
+    }
+
+    const char *operator-=(const String &str)
+    {
+        if (str.length())
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                String tmp = this->getString();
+                tmp.replace(str, "");
+                this->_setString(tmp.c_str());
+            }
+        }
+        return this->c_str();
+    }
+
+    const char *operator-=(const std::string &str)
+    {
+        if (str.length())
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                String tmp = this->getString();
+                tmp.replace(str.c_str(), "");
+                this->_setString(tmp.c_str());
+            }
+        }
+        return this->c_str();
+    }
+
+    const char *operator-=(const String *str)
+    {
+        if (str->length())
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                String tmp = this->getString();
+                tmp.replace(str->c_str(), "");
+                this->_setString(tmp.c_str());
+            }
+        }
+        return this->c_str();
+    }
+
+    const char *operator-=(const std::string *str)
+    {
+        if (str->length())
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                String tmp = this->getString();
+                tmp.replace(str->c_str(), "");
+                this->_setString(tmp.c_str());
+            }
+        }
+        return this->c_str();
+    }
+
+    // *=
+
+    template <class T>
+    inline typename ElementNumber::EnableArithmetic<T, Element &>::type operator*=(const T &n)
+    {
+        return this->_assignNumber(ElementNumber::MUL, n);
+    }
+
+    Element &operator*=(const Element &e)
+    {
+        (*this) = (*this) * e;
+        return (*this);
+    }
+
+    Element &operator*=(const Element *e)
+    {
+        (*this) = (*this) * (*e);
+        return (*this);
+    }
+
+    // /=
+
+    template <class T>
+    inline typename ElementNumber::EnableArithmetic<T, Element &>::type operator/=(const T &n)
+    {
+#ifdef AUTO_EXTEND_DATA_RANGE
+        // result is always double
+        // 结果总是double
+        return this->_assignNumber(ElementNumber::DIV, (double)n);
+#else
+        return this->_assignNumber(ElementNumber::DIV, n);
+#endif
+    }
+
+    Element &operator/=(const Element &e)
+    {
+        (*this) = (*this) / e;
+        return (*this);
+    }
+
+    Element &operator/=(const Element *e)
+    {
+        (*this) = (*this) / (*e);
+        return (*this);
+    }
+
+    // ++
+
+
+    Element &operator++()
+    {
+        if (this->_isNumber())
+        {
+            this->_assignNumber(ElementNumber::ADD, ElementNumber::of(1), this->type);
+        }
+        else
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                this->_setString((this->getString() + this->getString()).c_str());
+            }
+        }
+        return (*this);
+    }
+
+    Element operator++(int)
+    {
+        Element tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    // --
+
+    Element &operator--()
+    {
+        if (this->_isNumber())
+        {
+            this->_assignNumber(ElementNumber::SUB, ElementNumber::of(1), this->type);
+        }
+        else
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                String tmp = this->getString();
+                uint32_t length = tmp.length();
+                if (length > 0)
+                {
+                    this->_setString(tmp.substring(1).c_str());
+                }
+            }
+        }
+        return (*this);
+    }
+
+    Element operator--(int)
+    {
+        Element tmp = *this;
+        --(*this);
+        return tmp;
+    }
+
+    // %
+
+    template <class T>
+    inline typename ElementNumber::EnableInteger<T, Element>::type operator%(const T &rvalue) const
+    {
+        Element tmp;
+        if (this->_isInteger())
+            tmp._setNumber(this->_calculateNumber(ElementNumber::MOD, ElementNumber::of(rvalue)),
+                           ElementNumber::typeOf<T>());
+        return tmp;
+    }
+
+    Element operator%(const Element &rvalue) const
+    {
+        return this->operator%((int32_t)rvalue.getNumber());
+    }
+
+    Element operator%(const Element *rvalue) const
+    {
+        return this->operator%((int32_t)rvalue->getNumber());
+    }
+
+    //%=
+
+    template <class T>
+    inline typename ElementNumber::EnableInteger<T, Element &>::type operator%=(const T &rvalue)
+    {
+        if (this->_isInteger())
+            this->_assignNumber(ElementNumber::MOD, rvalue);
+        return (*this);
+    }
+
+    Element &operator%=(const Element &rvalue)
+    {
+        return this->operator%=((int32_t)rvalue.getNumber());
+    }
+
+    Element &operator%=(const Element *rvalue)
+    {
+        return this->operator%=((int32_t)rvalue->getNumber());
+    }
+
+    // <<
+
+    inline Element operator<<(const uint8_t &rvalue) const
+    {
+        Element tmp;
+        if (this->_isInteger())
+        {
+            // truncated to type of current object by _setNumber
+            // 由 _setNumber 截断为当前对象的类型
+            ElementNumber n = this->_toNumber();
+            n.u <<= rvalue;
+            tmp._setNumber(n, this->type);
+        }
+        else
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                if (strlen(this->c_str()) >= rvalue)
+                {
+                    tmp = this->getString().substring(rvalue);
+                }
+            }
+        }
+        return tmp;
+    }
+
+    inline Element operator<<(const Element &rvalue) const
+    {
+        return this->operator<<(rvalue.getUint8());
+    }
+
+    inline Element operator<<(const Element *rvalue) const
+    {
+        return this->operator<<(rvalue->getUint8());
+    }
+
+    // >>
+
+    inline Element operator>>(const uint8_t &rvalue) const
+    {
+        Element tmp;
+        if (this->_isInteger())
+        {
+            // arithmetic shift for signed integers
+            // 有符号整数使用算术右移
+            ElementNumber n = this->_toNumber();
+            if (n.kind == ElementNumber::SIGNED)
+                n.i >>= rvalue;
+            else
+                n.u >>= rvalue;
+            tmp._setNumber(n, this->type);
+        }
+        else
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                if (strlen(this->c_str()) >= rvalue)
+                {
+                    String t = this->getString();
+                    tmp = t.substring(0, t.length() - rvalue);
+                }
+            }
+        }
+        return tmp;
+    }
+
+    inline Element operator>>(const Element &rvalue) const
+    {
+        return this->operator>>(rvalue.getUint8());
+    }
+
+    inline Element operator>>(const Element *rvalue) const
+    {
+        return this->operator>>(rvalue->getUint8());
+    }
+
+    // <<=
+
+    Element &operator<<=(const uint8_t &rvalue)
+    {
+        (*this) = this->operator<<(rvalue);
+        return (*this);
+    }
+    Element &operator<<=(const Element &rvalue)
+    {
+        (*this) = this->operator<<(rvalue.getUint8());
+        return (*this);
+    }
+    Element &operator<<=(const Element *rvalue)
+    {
+        (*this) = this->operator<<(rvalue->getUint8());
+        return (*this);
+    }
+
+    // >>=
+
+    Element &operator>>=(const uint8_t &rvalue)
+    {
+        (*this) = this->operator>>(rvalue);
+        return (*this);
+    }
+    Element &operator>>=(const Element &rvalue)
+    {
+        (*this) = this->operator>>(rvalue.getUint8());
+        return (*this);
+    }
+    Element &operator>>=(const Element *rvalue)
+    {
+        (*this) = this->operator>>(rvalue->getUint8());
+        return (*this);
+    }
+
+    // &
+
+    /**
+     * @brief universal bitwise and, result has type of current object
+     * @note result is void if current object is not an integer
+     *
+     * @attention check available before using it
+     *
+     * @param rvalue
+     * @return Element
+     */
+    inline Element operator&(const Element &rvalue) const
+    {
+        return this->_bitwise(ElementNumber::AND, rvalue);
+    }
+
+    // |
+
+    /**
+     * @brief universal bitwise or, result has type of current object
+     * @note result is void if current object is not an integer
+     *
+     * @attention check available before using it
+     *
+     * @param rvalue
+     * @return Element
+     */
+    inline Element operator|(const Element &rvalue) const
+    {
+        return this->_bitwise(ElementNumber::OR, rvalue);
+    }
+
+    // ~
+
+    /**
+     * @brief bitwise inversion
+     *
+     * @attention check available before using it
+     *
+     * @return Element
+     */
+    inline Element operator~() const
+    {
+        Element tmp;
+        if (this->_isInteger())
+        {
+            ElementNumber n = this->_toNumber();
+            n.u = ~n.u;
+            tmp._setNumber(n, this->type);
+        }
+        return tmp;
+    }
+
+    // ^
+
+    /**
+     * @brief universal xor, result has type of current object
+     * @note result is void if current object is not an integer
+     *
+     * @attention check available before using it
+     *
+     * @param rvalue
+     * @return Element
+     */
+    inline Element operator^(const Element &rvalue) const
+    {
+        return this->_bitwise(ElementNumber::XOR, rvalue);
+    }
+
+    // &&
+    template <class T>
+    inline typename ElementNumber::Enable<T, bool>::type operator&&(const T &rvalue) const
+    {
+        return !this->operator!() && rvalue;
+    }
+
+    inline bool operator&&(const Element &rvalue) const
+    {
+        uint32_t bLength = rvalue.getRawBufferLength();
+        ElementType bType = rvalue.getType();
+        return this->available() &&
+               (this->data.i64 ||
+                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
+               (rvalue.getInt64() ||
+                (bLength > (bType == ETYPE_STRING ? 1 : 0)));
+    }
+
+    // ||
+
+    template <class T>
+    inline typename ElementNumber::Enable<T, bool>::type operator||(const T &rvalue) const
+    {
+        return this->available() && (!this->operator!() || rvalue);
+    }
+
+    inline bool operator||(const Element &rvalue) const
+    {
+        uint32_t bLength = rvalue.getRawBufferLength();
+        ElementType bType = rvalue.getType();
+        return (this->available() &&
+                rvalue.available()) &&
+               (this->data.i64 || ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) ||
+                rvalue.getInt64() || ((bLength > (bType == ETYPE_STRING ? 1 : 0))));
+    }
+
+    // !
+
+    /**
+     * @brief logical not
+     *
+     * @attention this won't check available
+     *
+     * @return true
+     * @return false
+     */
+    inline bool operator!() const
+    {
+        if (this->available())
+        {
+            switch (this->type)
+            {
+            case ETYPE_UINT8:
+                return !this->data.u8;
+            case ETYPE_INT8:
+                return !this->data.i8;
+            case ETYPE_UINT16:
+                return !this->data.u16;
+            case ETYPE_INT16:
+                return !this->data.i16;
+            case ETYPE_UINT32:
+                return !this->data.u32;
+            case ETYPE_INT32:
+                return !this->data.i32;
+            case ETYPE_UINT64:
+                return !this->data.u64;
+            case ETYPE_INT64:
+                return !this->data.i64;
+            case ETYPE_FLOAT:
+                return this->data.f == 0;
+            case ETYPE_DOUBLE:
+                return this->data.d == 0;
+            case ETYPE_STRING:
+                return !((this->data.buffer.p)[0]);
+            case ETYPE_BUFFER:
+            case ETYPE_ARRAY:
+                return !this->data.buffer.bufferLength;
+            default:
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // []
+    /**
+     * @brief get uint8_t data from buffer or string
+     *
+     * @attention the return value is uint16_t, it doesn't mean
+     * data range from -32768 to 32767.
+     * return -2 means error, or it will return one byte data
+     *
+     * @note index from head if positive number given, or index from tail
+     *
+     * @param index index in int32_t
+     * @return int16_t
+     */
+    inline int16_t operator[](const int32_t &index) const
+    {
+        if (this->type == ETYPE_BUFFER || this->type == ETYPE_STRING)
+        {
+            if (index < this->data.buffer.bufferLength)
+            {
+                if (index > 0)
+                {
+                    return (this->data.buffer.p)[index];
+                }
+                else
+                {
+                    return (this->data.buffer.p)[this->data.buffer.bufferLength - index];
+                }
+            }
+        }
+        return -2;
+    }
+
+    /**
+     * @brief get uint8_t data from buffer or string
+     *
+     * @attention the return value is uint16_t, it doesn't mean
+     * data range from -32768 to 32767.
+     * return -2 means error, or it will return one byte data
+     *
+     * @note index from head if positive number given, or index from tail
+     *
+     * @param index index in Element
+     * @return int16_t
+     */
+    inline int16_t operator[](const Element &index) const
+    {
+        if (this->type == ETYPE_BUFFER || this->type == ETYPE_STRING)
+        {
+            if (index.available())
+            {
+                int32_t i = index.getInt32();
+                if (i < this->data.buffer.bufferLength)
+                {
+                    if (i > 0)
+                    {
+                        return (this->data.buffer.p)[i];
+                    }
+                    else
+                    {
+                        return (this->data.buffer.p)[this->data.buffer.bufferLength - i];
+                    }
+                }
+            }
+        }
+        return -2;
+    }
+
+    // &=
+
+    template <class T>
+    inline typename ElementNumber::EnableInteger<T, T>::type operator&=(const T &rvalue)
+    {
+        this->_assignNumber(ElementNumber::AND, rvalue);
+        return this->_toNumber().to<T>();
+    }
+    inline Element &operator&=(const Element &rvalue)
+    {
+        this->data.i64 &= rvalue.getInt64();
+        return *this;
+    }
+
+    // |=
+
+    template <class T>
+    inline typename ElementNumber::EnableInteger<T, T>::type operator|=(const T &rvalue)
+    {
+        this->_assignNumber(ElementNumber::OR, rvalue);
+        return this->_toNumber().to<T>();
+    }
+    inline Element &operator|=(const Element &rvalue)
+    {
+        this->data.i64 |= rvalue.getInt64();
+        return *this;
+    }
+
+    // ^=
+    template <class T>
+    inline typename ElementNumber::EnableInteger<T, T>::type operator^=(const T &rvalue)
+    {
+        this->_assignNumber(ElementNumber::XOR, rvalue);
+        return this->_toNumber().to<T>();
+    }
+    inline Element &operator^=(const Element &rvalue)
+    {
+        this->data.i64 ^= rvalue.getInt64();
+        return *this;
+    }
+
+    // operators
+
+    String replace(const char *target, const char *newContent)
+    {
+        if (this->type == ETYPE_STRING)
+        {
+            String tmp = this->getString();
+            tmp.replace(target, newContent);
+            this->_setString(tmp.c_str());
+            return tmp;
+        }
+        return "";
+    }
+
+    String replace(const String &target, const char *newContent)
+    {
+        return this->replace(target.c_str(), newContent);
+    }
+
+    inline const char *
+    c_str() const
+    {
+        if (this->type == ETYPE_STRING)
+            return (const char *)(this->data.buffer.p);
+        return "";
+    }
+
+    /**
+     * @brief view of stored characters, nothing is copied,
+     * bytes of uint8 array will be viewed directly(not hex),
+     * empty view if current object stored other type data
+     *
+     * 存储的字符的视图，不拷贝，
+     * 二进制数组会直接查看其字节(不是十六进制)，
+     * 存储其他类型时返回空视图
+     */
+    inline ElementStringView getStringView() const
+    {
+        if (this->type == ETYPE_STRING && this->data.buffer.p && this->data.buffer.bufferLength)
+            return ElementStringView((const char *)this->data.buffer.p, this->data.buffer.bufferLength - 1);
+        if (this->type == ETYPE_BUFFER)
+            return ElementStringView((const char *)this->data.buffer.p, this->data.buffer.bufferLength);
+        return ElementStringView();
+    }
+
+    /**
+     * @brief view of stored bytes, nothing is copied,
+     * characters of string without terminator, bytes of uint8 array or typed array,
+     * empty view if current object stored other type data
+     *
+     * 存储的字节的视图，不拷贝，
+     * 字符串为不含结束符的字符，二进制数组和类型化数组为其字节，
+     * 存储其他类型时返回空视图
+     */
+    inline ElementBufferView getBufferView() const
+    {
+        if (this->type == ETYPE_STRING && this->data.buffer.bufferLength)
+            return ElementBufferView(this->data.buffer.p, this->data.buffer.bufferLength - 1);
+        if (this->type == ETYPE_BUFFER || this->type == ETYPE_ARRAY)
+            return ElementBufferView(this->data.buffer.p, this->data.buffer.bufferLength);
+        return ElementBufferView();
+    }
+
+    /**
+     * @brief uint8 array referencing bytes [from, to) of stored string, uint8 array or typed array,
+     * nothing is copied or allocated, works with pack(), hash(), AES256_CBC() and
+     * sending by getRawBuffer() / getRawBufferLength() like any other uint8 array,
+     * the slice is invalid once current object is changed or released,
+     * copy of the slice is a real copy, void if range is empty
+     *
+     * 引用存储的字符串、二进制数组或类型化数组中 [from, to) 字节的二进制数组，
+     * 不拷贝也不分配内存，与其他二进制数组一样可用于 pack()、hash()、AES256_CBC() 以及
+     * 通过 getRawBuffer() / getRawBufferLength() 发送，
+     * 当前对象修改或释放后切片失效，拷贝切片会得到真正的拷贝，范围为空时返回void
+     *
+     * @example
+     * // forward an OTA block in 1KB frames without copying
+     * // 不拷贝，按1KB分帧转发OTA数据块
+     * for (uint32_t i = 0; i < block.getRawBufferLength(); i += 1024)
+     * {
+     *     Element part = block.slice(i, i + 1024);
+     *     client->send(part.getRawBuffer(), part.getRawBufferLength());
+     * }
+     *
+     * @param from first byte 第一个字节
+     * @param to end of range, clamped to length 范围结束位置，超出长度会被截断
+     */
+    Element slice(uint32_t from, uint32_t to = 0xffffffff) const
+    {
+        ElementBufferView view = this->getBufferView().slice(from, to);
+        Element part;
+        if (!view.empty())
+            part._setReference((uint8_t *)view.data(), view.size(), ETYPE_BUFFER);
+        return part;
+    }
+
+    /**
+     * @brief the following functions only work with string,
+     * return -2 if current object stored other type data, -1 if not found
+     *
+     * 下面的函数只对字符串有效，
+     * 存储其他类型数据时返回-2，未找到返回-1
+     */
+    inline int indexOf(const ElementStringView &target) const
+    {
+        return this->type == ETYPE_STRING ? this->getStringView().indexOf(target) : -2;
+    }
+    inline int indexOf(const char &target) const
+    {
+        return this->type == ETYPE_STRING ? this->getStringView().indexOf(target) : -2;
+    }
 
-    //*
+    inline int lastIndexOf(const ElementStringView &target) const
+    {
+        return this->type == ETYPE_STRING ? this->getStringView().lastIndexOf(target) : -2;
+    }
+    inline int lastIndexOf(const char &target) const
+    {
+        return this->type == ETYPE_STRING ? this->getStringView().lastIndexOf(target) : -2;
+    }
+
+    inline bool startsWith(const ElementStringView &prefix) const
+    {
+        return this->type == ETYPE_STRING && this->getStringView().startsWith(prefix);
+    }
+    inline bool endsWith(const ElementStringView &suffix) const
+    {
+        return this->type == ETYPE_STRING && this->getStringView().endsWith(suffix);
+    }
+
+    /**
+     * @brief deconstructor, it will clean buffer automatically
+     * 析构函数， 它会调用清理缓存的函数
+     */
+    ~Element()
+    {
+        // ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "object de, address: %x", this);
+
+        // clear buffer if buffer is copied from other places
+        // 如果buffer是从其他位置拷贝的就清除buffer
+        if (this->copiedBuffer)
+        {
+            this->clearBuffer();
+        }
+    }
+
+    /**
+     * @brief get current type of data that object stored
+     * 获取当前对象存储的数据类型
+     *
+     * @param isNumber will return NUMBER if give argument a true, if current object hold a number
+     * 参数传true如果当前对象存储了数字只会告诉你类型是NUMBER
+     *
+     * @return the data type that current object stored
+     * 当前对象中存储的数据的数据类型
+     */
+    ElementType getType(bool isNumber = false) const
+    {
+        return isNumber ? ((this->type < 9)
+                               ? ETYPE_NUMBER
+                               : this->type)
+                        : (this->type);
+    }
+
+    /**
+     * @brief get number
+     * 获取存储的数字
+     *
+     * @return stored number
+     */
+    inline uint8_t getUint8() const { return (uint8_t)this->data.u8; }
+    inline int8_t getInt8() const { return (uint8_t)this->data.i8; }
+    inline uint16_t getUint16() const { return (uint16_t)this->data.u16; }
+    inline int16_t getInt16() const { return (uint16_t)this->data.i16; }
+    inline uint32_t getUint32() const { return (uint32_t)this->data.u32; }
+    inline int32_t getInt32() const { return (uint32_t)this->data.i32; }
+    inline uint64_t getUint64() const { return this->data.u64; }
+    inline int64_t getInt64() const { return this->data.i64; }
+    inline float getFloat() const { return this->data.f; }
+    inline double getDouble() const { return this->data.d; }
+
+    /**
+     * @brief get string
+     * will return hex string if current object stored uint8 array(not string)
+     * you could remove it if you like
+     *
+     * 获取存储的字符串
+     * 如果当前对象存储的是一个二进制数组，则默认会返回它的十六进制字符串
+     * 不想要的话可以去掉
+     *
+     * @return stored string
+     */
+    inline String getString() const
+    {
+        // ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "get string");
+        return (this->type == ETYPE_STRING) ? (this->data.buffer.p ? (String((const char *)this->data.buffer.p)) : (String("")))
+                                            : ((this->type == ETYPE_BUFFER) ? (this->getHex()) : (String("")));
+    }
+
+    /**
+     * @brief the following two functions have same behavior when storing uint8 array
+     * but the first one will check type equals to uint8 array or not
+     * or it will return nullptr
+     *
+     * 下面这俩函数当 当前对象存储的是二进制数组的时候没有区别
+     * 但是第一个函数会检查对象存储的数据类型，不是二进制数组类型会返回空指针
+     * (其实是一开始字符串用String存的，所以有很多地方用了getUint8Array，后来才改成都用buffer存的，
+     * 但是这个我才不告诉你)
+     *
+     * payload shared with copies of this object is copied first by the non-const version,
+     * so it could be modified through the pointer, read through a const object to avoid the copy
+     * 非const版本会先拷贝与当前对象的拷贝共享的数据，所以可以通过指针修改数据，
+     * 只读取时通过const对象调用以避免拷贝
+     *
+     * @param outLen length of uint8 array stored in object 对象存储的二进制数组的长度
+     *
+     * @return stored uint8 array, nullptr if heap is full when copying shared payload
+     * 存储的二进制数组，拷贝共享数据时堆内存不足则返回空指针
+     */
+    inline const uint8_t *getUint8Array(uint32_t *outLen = nullptr) const
+    {
+        if (this->type == ETYPE_BUFFER)
+        {
+            if (outLen)
+                (*outLen) = this->data.buffer.bufferLength;
+            return this->data.buffer.p;
+        }
+        else
+        {
+            if (outLen)
+                (*outLen) = 0;
+            return nullptr;
+        }
+    }
+    inline uint8_t *getUint8Array(uint32_t *outLen = nullptr)
+    {
+        if (this->type == ETYPE_BUFFER && !this->_detachBuffer())
+        {
+            if (outLen)
+                (*outLen) = 0;
+            return nullptr;
+        }
+        return (uint8_t *)(((const Element *)this)->getUint8Array(outLen));
+    }
+
+    /**
+     * @brief convert data type in current object from String(hex format) to uint8 array
+     * will update buffer stored in current object
+     *
+     * 把当前对象存储的16进制字符串转换为二进制数组，更新当前对象的buffer
+     *
+     * @return true: 当前对象存储了格式正确的16进制字符串且转换无错误
+     * @return false: 当前对象存储了错误的16进制字符串或转换过程中存在错误
+     */
+    bool convertHexStringIntoUint8Array()
+    {
+        // check type and length 检查类型和长度
+        if (this->type != ETYPE_STRING || (!this->data.buffer.p) || (!this->data.buffer.bufferLength))
+            return false;
+
+        // get original length
+        // 获取原始长度
+        uint32_t originalLength = strlen((const char *)this->data.buffer.p);
+
+        // length after convert
+        // 转换后的长度
+        uint32_t len = originalLength / 2;
+
+        // convert in place, the length of hex string must be mutiple times of 2,
+        // nothing is changed if any character is not hex
+        // 原地转换，16进制字符串的长度必须是2的整数倍，
+        // 有任何非16进制字符时不做修改
+        if (!this->_detachBuffer() ||
+            !mycrypto::Hex::decode((const char *)this->data.buffer.p, originalLength, this->data.buffer.p))
+            return false;
+
+        // modify type 修改类型
+        this->type = ETYPE_BUFFER;
+
+        // modify length 修改长度
+        this->data.buffer.bufferLength = len;
+
+        return true;
+    }
+
+    /**
+     * @brief this function get raw buffer anyway
+     * 这个函数无论如何都会返回缓存的指针
+     *
+     * payload shared with copies of this object is copied first by the non-const version, same as getUint8Array
+     * 与 getUint8Array 相同，非const版本会先拷贝与当前对象的拷贝共享的数据
+     *
+     * @param outLen length of uint8 array stored in object 存储的数组的长度
+     *
+     * @return uint8 array 存储的数组
+     */
+    inline uint8_t *getRawBuffer(uint32_t *outLen = nullptr)
+    {
+        if (this->type != ETYPE_FILE && !this->_detachBuffer())
+        {
+            if (outLen)
+                (*outLen) = 0;
+            return nullptr;
+        }
+        return (uint8_t *)(((const Element *)this)->getRawBuffer(outLen));
+    }
+    inline const uint8_t *getRawBuffer(uint32_t *outLen = nullptr) const
+    {
+        // payload kept in a file is not in RAM
+        // 保存在文件中的数据不在内存中
+        if (this->type == ETYPE_FILE)
+        {
+            if (outLen)
+                (*outLen) = 0;
+            return nullptr;
+        }
+
+        if (outLen)
+            (*outLen) = this->data.buffer.bufferLength;
+
+        return (this->data.buffer.p);
+    }
+
+    /**
+     * @brief get length of uint8 array if current object stroed uint8 array
+     * will return 0 if object stored other type data
+     *
+     * 获取二进制数组的长度，当且仅当存储的数据类型是二进制数组的时候才返回长度，否则返回0
+     *
+     * @return length of uint8 array 存储的数组的长度
+     */
+    inline uint32_t getU8aLen() const { return this->type == ETYPE_BUFFER ? this->data.buffer.bufferLength : 0; }
+
+    /**
+     * @brief more simply way to get number, return int64_t
+     *
+     * 更方便的方式去获取存储的数字, 返回类型为int64_t
+     *
+     * @return stored number 存储的数字
+     */
+    inline int64_t getNumber() const
+    {
+        return this->_toNumber().to<int64_t>();
+    }
+
+    /**
+     * @brief directly set raw uint8 array, attention attached
+     * 直接设置/更改当前对象存储一个二进制数组, 请阅读注意事项
+     *
+     * @attention THIS FUNCTION WILL CLEAN BUFFER AUTOMATICALLY
+     * 这个函数会清理缓存(如果对象原来存储了二进制数组或者字符串，那就被清理了)
+     *
+     * @param data new uint8 array pointer 新的二进制数组指针
+     * @param length length of new uint8 array 新的二进制数组的长度
+     */
+    inline bool setUint8Array(uint8_t *data, uint64_t length)
+    {
+        if (!data || !length)
+        {
+            return false;
+        }
+        this->reset(ETYPE_BUFFER);
+        return this->_copyBuffer(data, length, 0);
+    }
+
+    /**
+     * @brief get hex string if this object stored raw uint8 array
+     * will return String if current object holds a string
+     * you could remove it if you like
+     *
+     * 获取当前对象中存储的二进制数组的十六进制字符串
+     * 如果存的就是个字符串就会直接返回这个字符串
+     * (其实是一开始调试的时候sha256直接存的十六进制字符串，后来才改成32字节二进制数组，
+     * 我肯定是不会告诉你这个的)
+     *
+     * @param lowerCase lower case or upper case of output hex string
+     * 16进制字符串的大小写
+     *
+     * @return hex string of uint8 array 二进制数组的16进制字符串
+     */
+    String getHex(bool lowerCase = true) const
+    {
+        if (this->type != ETYPE_BUFFER)
+        {
+            if (this->type == ETYPE_STRING)
+            {
+                // sometimes current object already stored a hex string, then return it directly
+                // you could delete this part if you like
+                // 有时候当前对象存储的已经是个16进制字符串就直接返回它
+                // 不想要这部分可以删除
+                return this->getString();
+            }
+            else
+            {
+                // return empty string when current object stored data is neither uint8 array or string
+                // 如果当前对象存储的既不是字节数组或字符串就返回空字符串
+                return String("");
+            }
+        }
 
-    uint8_t operator*(const uint8_t &n) const
-    {
-        return (uint8_t)(this->getUniversalDouble() * n);
-    }
-    int8_t operator*(const int8_t &n) const
-    {
-        return (int8_t)(this->getUniversalDouble() * n);
+        // genereate hex string with lookup table
+        // 使用查找表生成16进制字符串
+        return mycrypto::Hex::encode(this->data.buffer.p,
+                                     this->data.buffer.bufferLength,
+                                     lowerCase ? mycrypto::LOWER_CASE : mycrypto::UPPER_CASE);
     }
 
-    uint16_t operator*(const uint16_t &n) const
-    {
-        return (uint16_t)(this->getUniversalDouble() * n);
-    }
-    int16_t operator*(const int16_t &n) const
+    /**
+     * @brief length of output of getHex, without '\0'
+     * getHex 输出的长度，不包括'\0'
+     */
+    inline uint32_t getHexLength() const
     {
-        return (int16_t)(this->getUniversalDouble() * n);
+        if (this->type == ETYPE_BUFFER)
+            return this->data.buffer.bufferLength * 2;
+        if (this->type == ETYPE_STRING && this->data.buffer.p)
+            return strlen((const char *)this->data.buffer.p);
+        return 0;
     }
 
-    uint32_t operator*(const uint32_t &n) const
+    /**
+     * @brief same as above, but writes into a caller buffer, nothing is allocated
+     * 与上面相同，但写入调用者提供的缓冲区，不分配内存
+     *
+     * @param output at least getHexLength() + 1 bytes, ends with '\0'
+     * 至少 getHexLength() + 1 字节，以'\0'结尾
+     * @return uint32_t characters written, without '\0' 写入的字符数，不包括'\0'
+     */
+    uint32_t getHex(char *output, bool lowerCase = true) const
     {
-        return (uint32_t)(this->getUniversalDouble() * n);
-    }
+        uint32_t length = this->getHexLength();
+        if (!output)
+            return 0;
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    int operator*(const int &n) const
-    {
-        return (int)(this->getUniversalDouble() * n);
+        if (this->type == ETYPE_BUFFER)
+            mycrypto::Hex::encode(this->data.buffer.p,
+                                  this->data.buffer.bufferLength,
+                                  output,
+                                  lowerCase ? mycrypto::LOWER_CASE : mycrypto::UPPER_CASE);
+        else if (length)
+            memcpy(output, this->data.buffer.p, length + 1);
+        else
+            output[0] = 0;
+        return length;
     }
-#endif
 
-    int32_t operator*(const int32_t &n) const
+    /**
+     * @brief get length of raw buffer whether object stored string or uint8 array
+     * 直接获取原始buffer的长度
+     *
+     * @return length of raw uint8 array 缓存长度
+     */
+    uint32_t getRawBufferLength() const
     {
-        return (int32_t)(this->getUniversalDouble() * n);
+        return this->data.buffer.bufferLength;
     }
 
-    uint64_t operator*(const uint64_t &n) const
-    {
-        return (uint64_t)(this->getUniversalDouble() * n);
-    }
-    int64_t operator*(const int64_t &n) const
+    bool isStringAvailable() const { return this->type == ETYPE_STRING && this->data.buffer.bufferLength > 1; }
+
+    bool isBufferAvailable(uint32_t equalLength = 0) const
     {
-        return (int64_t)(this->getUniversalDouble() * n);
+        return this->type == ETYPE_BUFFER &&
+               this->data.buffer.p &&
+               (!equalLength ? this->data.buffer.bufferLength > 0 : this->data.buffer.bufferLength == equalLength);
     }
 
-    // becarefull using this, it will lose precision
-    // 小心使用这个函数，会丢失精度
-    float operator*(const float &n) const
+    /**
+     * @brief encode with Base64
+     * 用 Base64 编码
+     *
+     * @note this function only fits in buffer and string
+     * 仅字符串和二进制数组适用此函数
+     *
+     * @param replaceOrigin replace origin or not; 是否替换原有内容
+     * @return String Base64 encoded
+     */
+    String toBase64(bool replaceOrigin = false)
     {
-        return (float)(this->getUniversalDouble() * n);
+        String b64 = "";
+        if (this->type == ETYPE_STRING || this->type == ETYPE_BUFFER)
+        {
+            b64 = mycrypto::Base64::base64Encode(this->data.buffer.p,
+                                                 (this->type == ETYPE_STRING ? this->data.buffer.bufferLength - 1
+                                                                             : this->data.buffer.bufferLength));
+            if (replaceOrigin)
+            {
+                this->_setString(b64);
+            }
+        }
+        return b64;
     }
 
-    double operator*(const double &n) const
+    /**
+     * @brief deocde with Base64
+     * 用 Base64 解码
+     *
+     * @note this function only fits in string
+     * 仅字符串适用此函数
+     *
+     * @param replaceOrigin replace origin or not; 是否替换原有内容
+     * @return String Base64 decoded
+     */
+    String fromBase64(bool replaceOrigin = false)
     {
-        return (double)(this->getUniversalDouble() * n);
+        String db64 = "";
+        if (this->type == ETYPE_STRING)
+        {
+            db64 = mycrypto::Base64::base64Decode(this->getString());
+            if (replaceOrigin)
+            {
+                this->_setString(db64);
+            }
+        }
+        return db64;
     }
 
-    // Element * Element
-    Element operator*(const Element &rvalue) const
+    /**
+     * @brief calculate SHA256 of content
+     *
+     * @attention only string and buffer can do this process,
+     * otherwise will return null pointer.
+     * developer MUST call delete to the pointer after using it.
+     *
+     * 只有字符串和字节数组才能使用此函数，否则会返回空指针。
+     * 开发者【需要】自己手动 delete 以释放内存空间
+     *
+     * @return uint8_t* pointer to result, 32 bytes long; 指向结果数组的指针，32字节
+     */
+    uint8_t *SHA256()
     {
-        Element tmp;
-        auto typeB = rvalue.getType();
-
-#ifdef CROSS_TYPE_CLACULATE
-        if (this->type < 9)
+        if (this->type == ETYPE_STRING || this->type == ETYPE_BUFFER)
         {
-            if (typeB < 9) // both numbers
-            {
-                int8_t direction = this->type < 0 || typeB < 0 ? -1 : 1;
-                ElementType newType = this->type > typeB ? this->type : typeB;
-                newType = (ElementType)((int8_t)newType * direction);
 
-                if (newType == 6 || newType == 7)
-                {
-                    tmp = this->getUniversalDouble() * rvalue.getUniversalDouble();
-                }
-                else
-                {
-                    tmp = this->getNumber() * rvalue.getNumber();
-                }
-            }
-            else // b isn't number, a is number
+            uint8_t *buf = nullptr;
+
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+            try
             {
-                if (typeB == ETYPE_STRING)
-                {
-                    switch (this->type)
-                    {
-                    case ETYPE_UINT8:
-                    case ETYPE_INT8:
-                    case ETYPE_UINT16:
-                    case ETYPE_INT16:
-                    case ETYPE_UINT32:
-                    case ETYPE_INT32:
-                    case ETYPE_UINT64:
-                    case ETYPE_INT64:
-                    case ETYPE_FLOAT:
-                    case ETYPE_DOUBLE:
-                        tmp = rvalue.getString();
-                        int64_t times = this->getNumber();
-                        for (int i = 0; i < times; ++i)
-                        {
-                            tmp = tmp.getString() + tmp.getString();
-                        }
-                        break;
-                    }
-                }
+                buf = new uint8_t[32];
             }
-        }
-        else // a isn't number
-        {
-            if (typeB < 9) // b is number, a isn't number
+            catch (const std::bad_alloc &e)
             {
-                if (this->type == ETYPE_STRING)
-                {
-                    switch (typeB)
-                    {
-                    case ETYPE_UINT8:
-                    case ETYPE_INT8:
-                    case ETYPE_UINT16:
-                    case ETYPE_INT16:
-                    case ETYPE_UINT32:
-                    case ETYPE_INT32:
-                    case ETYPE_UINT64:
-                    case ETYPE_INT64:
-                    case ETYPE_FLOAT:
-                    case ETYPE_DOUBLE:
-                        tmp = this->getString();
-                        int64_t times = rvalue.getNumber();
-                        String tmpStr = this->getString();
-                        for (int i = 0; i < times - 1; ++i)
-                        {
-                            tmp += tmpStr;
-                        }
-                        break;
-                    }
+                // do nothing
+            }
+#else
+            buf = new (std::nothrow) uint8_t[32];
+#endif
 
-                    // not support buffer add
-                }
+            if (!buf)
+            {
+                return buf;
             }
+            bzero(buf, 32);
+
+            mycrypto::SHA::sha256((this->type == ETYPE_STRING ? (uint8_t *)(this->c_str()) : (this->data.buffer.p)),
+                                  this->type == ETYPE_STRING ? this->data.buffer.bufferLength - 1 : this->data.buffer.bufferLength, buf);
+
+            return buf;
         }
+        return nullptr;
+    }
 
-#else
-        if (this->type == rvalue.getType())
+    /**
+     * @brief get SHA256 of content in hex string format;
+     * 获取内容的SHA256, 16进制字符串格式
+     *
+     * @attention will return empty string if type of content are not string and buffer
+     * 如果内容不是字符串和二进制数组会返回空字符串
+     *
+     * @param replaceOrigin will replace origin if set to true
+     * 如果参数为true则会直接替换掉原本的内容
+     *
+     * @return String SHA256 hex string
+     */
+    String getSHA256HexString(bool replaceOrigin = false)
+    {
+        String hash = "";
+        if (this->type == ETYPE_STRING || this->type == ETYPE_BUFFER)
         {
-            if (this->type < 9 && typeB < 9)
+            hash = mycrypto::SHA::sha256(
+                this->data.buffer.p,
+                this->type == ETYPE_STRING ? this->data.buffer.bufferLength - 1 : this->data.buffer.bufferLength);
+
+            if (hash.length() && replaceOrigin)
             {
-                switch (this->type)
-                {
-                case ETYPE_UINT8:
-                    tmp = this->data.u8 * rvalue.getUint8();
-                    break;
-                case ETYPE_INT8:
-                    tmp = this->data.i8 * rvalue.getInt8();
-                    break;
-                case ETYPE_UINT16:
-                    tmp = this->data.u16 * rvalue.getUint16();
-                    break;
-                case ETYPE_INT16:
-                    tmp = this->data.i16 * rvalue.getInt16();
-                    break;
-                case ETYPE_UINT32:
-                    tmp = this->data.u32 * rvalue.getUint32();
-                    break;
-                case ETYPE_INT32:
-                    tmp = this->data.i32 * rvalue.getInt32();
-                    break;
-                case ETYPE_UINT64:
-                    tmp = this->data.u64 * rvalue.getUint64();
-                    break;
-                case ETYPE_INT64:
-                    tmp = this->data.i64 * rvalue.getInt64();
-                    break;
-                case ETYPE_FLOAT:
-                    tmp = this->data.f * rvalue.getFloat();
-                    break;
-                case ETYPE_DOUBLE:
-                    tmp = this->data.d * rvalue.getDouble();
-                    break;
-                }
+                this->_setString(hash);
             }
         }
-#endif
-        return tmp;
-    }
 
-    // /
-    uint8_t operator/(const uint8_t &n) const
-    {
-        return (uint8_t)(this->getUniversalDouble() / n);
-    }
-    int8_t operator/(const int8_t &n) const
-    {
-        return (int8_t)(this->getUniversalDouble() / n);
+        return hash;
+    }
+
+    /**
+     * @brief encrypt content with AES-256-CBC
+     * 用AES 256 CBC 加密数据
+     *
+     * @note only string and buffer fit in this function
+     * 只有字符串和二进制数组适用此函数
+     *
+     * @param key key, 32 bytes; 密匙, 32字节
+     * @param iv iv 16 bytes; 初始化向量, 16字节
+     *
+     * @return true success; 成功
+     * @return false failed; 失败
+     */
+    bool AES256_CBC(const char *key, const char *iv)
+    {
+        if ((!strlen(key) || !strlen(iv)) && (this->type == ETYPE_BUFFER || this->type == ETYPE_STRING))
+        {
+            return false;
+        }
+
+        uint32_t outLen = 0;
+
+        uint8_t *cipher = mycrypto::AES::aes256CBCEncrypt(
+            (const uint8_t *)key,
+            (const uint8_t *)iv,
+            this->data.buffer.p,
+            (this->type == ETYPE_STRING ? this->data.buffer.bufferLength - 1 : this->data.buffer.bufferLength),
+            &outLen);
+
+        if (!outLen && !cipher)
+        {
+            return false;
+        }
+
+        // take over cipher without copying
+        // 直接接管密文，不再拷贝
+        return this->adoptBuffer(cipher, outLen);
     }
 
-    uint16_t operator/(const uint16_t &n) const
-    {
-        return (uint16_t)(this->getUniversalDouble() / n);
-    }
-    int16_t operator/(const int16_t &n) const
+    /**
+     * @brief encode with AES-256-CBC and replace origin with hex string
+     * 用AES-256-CBC加密，然后替换原有内容为加密结果的16进制字符串
+     *
+     * @param key key, 32 bytes; 密匙, 32字节
+     * @param iv iv 16 bytes; 初始化向量, 16字节
+     *
+     * @return true success; 成功
+     * @return false failed; 失败
+     */
+    bool toAES256CBCHexString(const char *key, const char *iv)
     {
-        return (int16_t)(this->getUniversalDouble() / n);
+        if (!this->AES256_CBC(key, iv))
+        {
+            return false;
+        }
+        return this->_setString(this->getHex());
     }
 
-    uint32_t operator/(const uint32_t &n) const
+    /**
+     * @brief encode with AES-256-CBC and replace origin with base64
+     * 用AES-256-CBC加密，然后替换原有内容为加密结果的base64编码
+     *
+     * @param key key, 32 bytes; 密匙, 32字节
+     * @param iv iv 16 bytes; 初始化向量, 16字节
+     *
+     * @return true success; 成功
+     * @return false failed; 失败
+     */
+    bool toAES256CBCBase64(const char *key, const char *iv)
     {
-        return (uint32_t)(this->getUniversalDouble() / n);
+        if (!this->AES256_CBC(key, iv))
+        {
+            return false;
+        }
+        return this->_setString(this->toBase64(true));
     }
-
-#if CONFIG_IDF_TARGET_ESP32C3
-    int operator/(const int &n) const
+    /**
+     * @brief
+     * clear buffer
+     * 清理缓存的函数
+     */
+    void clearBuffer()
     {
-        return (int)(this->getUniversalDouble() / n);
+        // ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "buffer length: %lu", this->data.buffer.bufferLength);
+        // numbers own nothing on heap, releasing is kept out of line so that
+        // destructor and assignment of numbers stay small enough to be inlined
+        // 数字不持有堆内存，释放部分放在单独的函数中，使数字的析构和赋值足够小以便内联
+        if (this->type >= ETYPE_STRING)
+            this->_releaseBuffer();
+        this->sharedBuffer = false;
+        bzero(&(this->data), sizeof(ElementData));
     }
-#endif
 
-    int32_t operator/(const int32_t &n) const
+    /**
+     * @brief this function could use same object to change its original data type to another
+     * it will clean all buffer(if exists)
+     * 这个函数用于给当前对象赋值另一种类型的数据
+     * 如果当前对象存储了字符串或者拷贝模式的二进制数组
+     * 那么就会清理掉缓存
+     *
+     * @param type new type 新的类型
+     */
+    void reset(ElementType type)
     {
-        return (int32_t)(this->getUniversalDouble() / n);
-    }
+        this->clearBuffer();
 
-    uint64_t operator/(const uint64_t &n) const
-    {
-        return (uint64_t)(this->getUniversalDouble() / n);
-    }
-    int64_t operator/(const int64_t &n) const
-    {
-        return (int64_t)(this->getUniversalDouble() / n);
+        // set current type to given type
+        // 设定当前类型为给定的类型
+        this->type = type;
     }
 
-    double operator/(const double &n) const
+#ifdef ARRAY_BUFFER_DEBUG_ON
+    char *debugShow() const
     {
-        return (double)(this->getUniversalDouble() / n);
+        char *buf = new char[1024];
+        bzero(buf, 1024);
+        switch (this->type)
+        {
+        case ETYPE_UINT8:
+        case ETYPE_INT8:
+        case ETYPE_UINT16:
+        case ETYPE_INT16:
+        case ETYPE_UINT32:
+        case ETYPE_INT32:
+        case ETYPE_FLOAT:
+        case ETYPE_UINT64:
+        case ETYPE_INT64:
+        case ETYPE_DOUBLE:
+            buf[this->toChars(buf, 6)] = '\n';
+            break;
+        case ETYPE_STRING:
+            sprintf(buf, "%s\n", this->c_str());
+            break;
+        case ETYPE_BUFFER:
+            sprintf(buf, "[buffer length: %lu\n0x", this->data.buffer.bufferLength);
+            for (int i = 0; i < this->data.buffer.bufferLength; ++i)
+            {
+                sprintf(buf + (i * 2), "%02x", (this->data.buffer.p)[i]);
+            }
+            sprintf(buf + (this->data.buffer.bufferLength * 2), "\n]");
+        }
+        return buf;
     }
+#endif
 
-    // Element / Element
-    Element operator/(const Element &rvalue) const
+    /**
+     * @brief length of this object after encoding, including type mark
+     * 当前对象编码后的长度，包括类型标志
+     *
+     * @param compact length in compact mode 紧凑模式下的长度
+     */
+    uint32_t getOuterBufferLength(bool compact = false) const
     {
-        Element tmp;
-        auto typeB = rvalue.getType();
+        if (this->type == ETYPE_LIST || this->type == ETYPE_MAP)
+        {
+            if (!this->data.list)
+                return 0;
+            uint32_t length = this->getChildrenOuterBufferLength(compact);
+            return 1 + (compact ? ArrayBufferVarint::length(length) : 4) + length;
+        }
 
-        if (this->type == rvalue.getType())
+        if (compact)
         {
-            if (this->type < 9 && typeB < 9)
+            switch (this->type)
             {
-                switch (this->type)
-                {
-                case ETYPE_UINT8:
-                    tmp = (uint8_t)(this->data.u8 / rvalue.getUint8());
-                    break;
-                case ETYPE_INT8:
-                    tmp = (int8_t)(this->data.i8 / rvalue.getInt8());
-                    break;
-                case ETYPE_UINT16:
-                    tmp = (uint16_t)(this->data.u16 / rvalue.getUint16());
-                    break;
-                case ETYPE_INT16:
-                    tmp = (int16_t)(this->data.i16 / rvalue.getInt16());
-                    break;
-                case ETYPE_UINT32:
-                    tmp = (uint32_t)(this->data.u32 / rvalue.getUint32());
-                    break;
-                case ETYPE_INT32:
-                    tmp = (int32_t)(this->data.i32 / rvalue.getInt32());
-                    break;
-                case ETYPE_UINT64:
-                    tmp = (uint64_t)(this->data.u64 / rvalue.getUint64());
-                    break;
-                case ETYPE_INT64:
-                    tmp = (int64_t)(this->data.i64 / rvalue.getInt64());
-                    break;
-                case ETYPE_FLOAT:
-                    tmp = (float)(this->data.f / rvalue.getFloat());
-                    break;
-                case ETYPE_DOUBLE:
-                    tmp = (double)(this->data.d / rvalue.getDouble());
-                    break;
-                }
+            case ETYPE_UINT8:
+            case ETYPE_INT8:
+            case ETYPE_UINT16:
+            case ETYPE_INT16:
+            case ETYPE_UINT32:
+            case ETYPE_INT32:
+            case ETYPE_UINT64:
+            case ETYPE_INT64:
+                return 1 + ArrayBufferVarint::length(ArrayBufferVarint::fromData(this->data, this->type));
+            case ETYPE_STRING:
+            case ETYPE_BUFFER:
+                return 1 + ArrayBufferVarint::length(this->data.buffer.bufferLength) + this->data.buffer.bufferLength;
+            case ETYPE_FILE:
+                return 1 + ArrayBufferVarint::length(this->data.file.length) + this->data.file.length;
+            case ETYPE_ARRAY:
+                return 2 + ArrayBufferVarint::length(this->data.buffer.bufferLength + 1) + this->data.buffer.bufferLength;
+            default:
+                break;
             }
         }
 
-        return tmp;
-    }
-
-    // +=
-    Element &operator+=(const uint8_t &n)
-    {
-        (*this) = (uint8_t)((*this) + n);
-        return *this;
-    }
-    Element &operator+=(const int8_t &n)
-    {
-        (*this) = (int8_t)((*this) + n);
-        return *this;
-    }
-    Element &operator+=(const uint16_t &n)
-    {
-        (*this) = (uint16_t)((*this) + n);
-        return *this;
-    }
-    Element &operator+=(const int16_t &n)
-    {
-        (*this) = (int16_t)((*this) + n);
-        return *this;
-    }
-    Element &operator+=(const uint32_t &n)
-    {
-        (*this) = (uint32_t)((*this) + n);
-        return *this;
-    }
-
-#if CONFIG_IDF_TARGET_ESP32C3
-    Element &operator+=(const int &n)
-    {
-        (*this) = (int)((*this) + n);
-        return *this;
+        switch (this->type)
+        {
+        case ETYPE_UINT8:
+        case ETYPE_INT8:
+            return 2;
+        case ETYPE_UINT16:
+        case ETYPE_INT16:
+            return 3;
+        case ETYPE_UINT32:
+        case ETYPE_INT32:
+        case ETYPE_FLOAT:
+            return 5;
+        case ETYPE_UINT64:
+        case ETYPE_INT64:
+        case ETYPE_DOUBLE:
+            return 9;
+        case ETYPE_STRING:
+        case ETYPE_BUFFER:
+            return this->data.buffer.bufferLength + 5;
+        case ETYPE_FILE:
+            return this->data.file.length + 5;
+        case ETYPE_ARRAY:
+            // item type leads payload
+            // 元素类型位于数据开头
+            return this->data.buffer.bufferLength + 6;
+        default:
+            return 0;
+        }
     }
-#endif
 
-    Element &operator+=(const int32_t &n)
-    {
-        (*this) = (int32_t)((*this) + n);
-        return *this;
-    }
-    Element &operator+=(const uint64_t &n)
-    {
-        (*this) = (uint64_t)((*this) + n);
-        return *this;
-    }
-    Element &operator+=(const int64_t &n)
-    {
-        (*this) = (int64_t)((*this) + n);
-        return *this;
-    }
-    Element &operator+=(const double &n)
-    {
-        (*this) = (double)((*this) + n);
-        return *this;
-    }
-    Element &operator+=(const float &n)
+    /**
+     * @brief encode this object into buffer
+     * 把当前对象编码到数组中
+     *
+     * @param buffer output, must have getOuterBufferLength(compact) bytes available
+     * 输出，需要有 getOuterBufferLength(compact) 个字节可用
+     * @param offset offset in output, moved to end of this field 输出中的偏移量，会移动到此字段之后
+     * @param compact encode in compact mode 使用紧凑模式编码
+     */
+    bool pack(uint8_t *buffer, uint32_t *offset, bool compact = false) const
     {
-        return this->operator+=((double)n);
-    }
+        uint32_t bufferLength = this->getOuterBufferLength();
 
-    Element &operator+=(const Element &e)
-    {
-        (*this) = (*this) + e;
-        return (*this);
-    }
+        if (!bufferLength)
+            return false;
 
-    Element &operator+=(const Element *e)
-    {
-        (*this) = (*this) + (*e);
-        return (*this);
-    }
+        uint32_t dataLen = 0;
+        uint64_t c = 0;
 
-    Element &operator+=(const char *str)
-    {
-        if (strlen(str))
+        if (this->type == ETYPE_FILE)
         {
-            if (this->type == ETYPE_STRING)
+            // encoded as uint8 array, payload is read straight into output
+            // 编码为二进制数组，数据直接读取到输出中
+            dataLen = this->data.file.length;
+            buffer[(*offset)++] = (uint8_t)ETYPE_BUFFER;
+            if (compact)
             {
-                this->_setString((this->getString() + str).c_str());
+                (*offset) += ArrayBufferVarint::write(buffer + (*offset), dataLen);
+            }
+            else
+            {
+                memcpy(buffer + (*offset), (&(dataLen)), 4);
+                (*offset) += 4;
+            }
+            bool read = this->data.file.source->read(0, buffer + (*offset), dataLen);
+            if (!read)
+            {
+                ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "read file failed, length: %u", dataLen);
+                bzero(buffer + (*offset), dataLen);
             }
+            (*offset) += dataLen;
+            return read;
         }
-        return (*this);
-    }
 
-    const char *operator+=(const String &str)
-    {
-        if (str.length())
-        {
-            // if (this->type == ETYPE_STRING)
-            //{
-            // comment:
-            //  if Element a = ""; a.getType() == ETYPE_VOID
-            //  should modify to ETYPE_STRING
-            //  todo, in _setString
-            this->_setString((this->getString() + str).c_str());
-            //}
-        }
-        return this->c_str();
-    }
+        buffer[(*offset)] = (uint8_t)this->type;
+        ++(*offset); // skip mark
 
-    const char *operator+=(const std::string &str)
-    {
-        if (str.length())
+        if (this->type == ETYPE_LIST || this->type == ETYPE_MAP)
         {
-            if (this->type == ETYPE_STRING)
+            dataLen = this->getChildrenOuterBufferLength(compact);
+            if (compact)
             {
-                this->_setString((this->getString() + str.c_str()).c_str());
+                (*offset) += ArrayBufferVarint::write(buffer + (*offset), dataLen);
+            }
+            else
+            {
+                memcpy(buffer + (*offset), (&(dataLen)), 4);
+                (*offset) += 4;
             }
-        }
-        return this->c_str();
-    }
 
-    const char *operator+=(const String *str)
-    {
-        if (str->length())
-        {
-            if (this->type == ETYPE_STRING)
+            uint32_t step = this->type == ETYPE_MAP ? 2 : 1;
+            for (uint32_t i = 0; i + step <= this->data.list->size(); i += step)
             {
-                this->_setString((this->getString() + str->c_str()).c_str());
+                if (!this->_getEntryLength(i, compact))
+                    continue;
+                this->data.list->at(i)->pack(buffer, offset, compact);
+                if (step == 2)
+                    this->data.list->at(i + 1)->pack(buffer, offset, compact);
             }
+            return true;
         }
-        return this->c_str();
-    }
 
-    const char *operator+=(const std::string *str)
-    {
-        if (str->length())
+        if (compact)
         {
-            if (this->type == ETYPE_STRING)
+            switch (this->type)
             {
-                this->_setString((this->getString() + str->c_str()).c_str());
+            case ETYPE_STRING:
+            case ETYPE_BUFFER:
+                dataLen = this->data.buffer.bufferLength;
+                (*offset) += ArrayBufferVarint::write(buffer + (*offset), dataLen);
+                memcpy(buffer + (*offset), this->data.buffer.p, dataLen);
+                (*offset) += dataLen;
+                return true;
+            case ETYPE_ARRAY:
+                dataLen = this->data.buffer.bufferLength;
+                (*offset) += ArrayBufferVarint::write(buffer + (*offset), dataLen + 1);
+                buffer[(*offset)++] = (uint8_t)this->itemType;
+                if (dataLen)
+                    memcpy(buffer + (*offset), this->data.buffer.p, dataLen);
+                (*offset) += dataLen;
+                return true;
+            case ETYPE_FLOAT:
+            case ETYPE_DOUBLE:
+                // same as normal mode
+                // 与普通模式相同
+                break;
+            default:
+                (*offset) += ArrayBufferVarint::write(buffer + (*offset), ArrayBufferVarint::fromData(this->data, this->type));
+                return true;
             }
         }
-        return this->c_str();
-    }
 
-    // -=
+        switch (this->type)
+        {
+        case ETYPE_UINT8:
+        case ETYPE_INT8:
+            memcpy(buffer + (*offset), (&(this->data.u8)), 1);
+            (*offset) += 1;
+            break;
+        case ETYPE_UINT16:
+        case ETYPE_INT16:
+            memcpy(buffer + (*offset), (&(this->data.u16)), 2);
+            (*offset) += 2;
+            break;
+        case ETYPE_UINT32:
+        case ETYPE_INT32:
+            memcpy(buffer + (*offset), (&(this->data.u32)), 4);
+            (*offset) += 4;
+            break;
+        case ETYPE_FLOAT:
+            memcpy(buffer + (*offset), (&(this->data.f)), 4);
+            (*offset) += 4;
+            break;
+        case ETYPE_UINT64:
+        case ETYPE_INT64:
+            memcpy(buffer + (*offset), (&(this->data.u64)), 8);
+            (*offset) += 8;
+            break;
+        case ETYPE_DOUBLE:
+            memcpy(buffer + (*offset), (&(this->data.d)), 8);
+            (*offset) += 8;
+            break;
+        case ETYPE_STRING:
+        case ETYPE_BUFFER:
+            dataLen = this->data.buffer.bufferLength;
+            memcpy(buffer + (*offset), (&(dataLen)), 4);
+            (*offset) += 4;
+            memcpy(buffer + (*offset), this->data.buffer.p, dataLen);
+            (*offset) += dataLen;
+            break;
+        case ETYPE_ARRAY:
+            dataLen = this->data.buffer.bufferLength + 1;
+            memcpy(buffer + (*offset), (&(dataLen)), 4);
+            (*offset) += 4;
+            buffer[(*offset)++] = (uint8_t)this->itemType;
+            if (--dataLen)
+                memcpy(buffer + (*offset), this->data.buffer.p, dataLen);
+            (*offset) += dataLen;
+            break;
+        }
 
-    Element &operator-=(const uint8_t &n)
-    {
-        (*this) = (uint8_t)((*this) - n);
-        return *this;
-    }
-    Element &operator-=(const int8_t &n)
-    {
-        (*this) = (int8_t)((*this) - n);
-        return *this;
-    }
-    Element &operator-=(const uint16_t &n)
-    {
-        (*this) = (uint16_t)((*this) - n);
-        return *this;
-    }
-    Element &operator-=(const int16_t &n)
-    {
-        (*this) = (int16_t)((*this) - n);
-        return *this;
-    }
-    Element &operator-=(const uint32_t &n)
-    {
-        (*this) = (uint32_t)((*this) - n);
-        return *this;
+        return true;
     }
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    Element &operator-=(const int &n)
+    /**
+     * @brief decode one field from buffer
+     * 从数组中解码一个字段
+     *
+     * @param buffer source buffer 源数组
+     * @param offset offset of type mark 类型标志的偏移量
+     * @param length total length of source buffer 源数组的总长度
+     * @param compact buffer is in compact mode 源数组使用紧凑模式
+     * @param depth nesting depth of this field, used internally 此字段的嵌套深度，内部使用
+     * @return int32_t length of whole field, -2 if data is malformed
+     * 整个字段的长度，数据格式错误时返回-2
+     */
+    int32_t setFromOuterBuffer(uint8_t *buffer, uint32_t offset, uint32_t length, bool compact = false, uint8_t depth = 0)
     {
-        (*this) = (int)((*this) - n);
-        return *this;
-    }
-#endif
+        if (!buffer || offset >= length)
+            return -2;
 
-    Element &operator-=(const int32_t &n)
-    {
-        (*this) = (int32_t)((*this) - n);
-        return *this;
-    }
-    Element &operator-=(const uint64_t &n)
-    {
-        (*this) = (uint64_t)((*this) - n);
-        return *this;
-    }
-    Element &operator-=(const int64_t &n)
-    {
-        (*this) = (int64_t)((*this) - n);
-        return *this;
-    }
-    Element &operator-=(const double &n)
-    {
-        (*this) = (double)((*this) - n);
-        return *this;
-    }
-    Element &operator-=(const float &n)
-    {
-        return this->operator-=((double)n);
-    }
+        if (compact)
+            return this->_setFromCompactBuffer(buffer, offset, length, depth);
 
-    Element &operator-=(const Element &e)
-    {
-        (*this) = (*this) - e;
-        return (*this);
-    }
+        // bytes after type mark
+        // 类型标志之后的字节数
+        uint32_t available = length - offset - 1;
 
-    Element &operator-=(const Element *e)
-    {
-        (*this) = (*this) - (*e);
-        return (*this);
-    }
+        int8_t mark = (int8_t)buffer[offset++];
 
-    Element &operator-=(const char *str)
-    {
-        if (strlen(str))
-        {
-            if (this->type == ETYPE_STRING)
-            {
-                String tmp = this->getString();
-                tmp.replace(str, "");
-                this->_setString(tmp.c_str());
-            }
-        }
-        return (*this);
-    }
+        // reset clears former buffer and zeroes data
+        // reset 会清理原有缓存并将数据置零
+        this->reset((ElementType)mark);
 
-    const char *operator-=(const String &str)
-    {
-        if (str.length())
+        uint32_t dataLen = 0;
+
+        switch (mark)
         {
-            if (this->type == ETYPE_STRING)
+        case ETYPE_UINT8:
+        case ETYPE_INT8:
+            dataLen = 1;
+            break;
+        case ETYPE_UINT16:
+        case ETYPE_INT16:
+            dataLen = 2;
+            break;
+        case ETYPE_UINT32:
+        case ETYPE_INT32:
+        case ETYPE_FLOAT:
+            dataLen = 4;
+            break;
+        case ETYPE_UINT64:
+        case ETYPE_INT64:
+        case ETYPE_DOUBLE:
+            dataLen = 8;
+            break;
+        case ETYPE_STRING:
+        case ETYPE_BUFFER:
+        case ETYPE_LIST:
+        case ETYPE_MAP:
+        case ETYPE_ARRAY:
+            if (available < 4)
+                break;
+            memcpy(&dataLen, buffer + offset, 4);
+
+            // declared length must stay inside source, string on wire always carries a trailing '\0'
+            // 声明的长度不能超出源数组，传输中的字符串总是带有结尾的'\0'
+            if (dataLen > available - 4 ||
+                (mark == ETYPE_STRING && (!dataLen || buffer[offset + 4 + dataLen - 1])))
+                break;
+
+            if (mark == ETYPE_LIST || mark == ETYPE_MAP)
             {
-                String tmp = this->getString();
-                tmp.replace(str, "");
-                this->_setString(tmp.c_str());
+                if (!this->_setChildrenFromBuffer(buffer, offset + 4, dataLen, (ElementType)mark, false, depth))
+                    break;
             }
-        }
-        return this->c_str();
-    }
-
-    const char *operator-=(const std::string &str)
-    {
-        if (str.length())
-        {
-            if (this->type == ETYPE_STRING)
+            else if (mark == ETYPE_ARRAY)
             {
-                String tmp = this->getString();
-                tmp.replace(str.c_str(), "");
-                this->_setString(tmp.c_str());
+                // payload starts with item type
+                // 数据以元素类型开头
+                if (!dataLen || !this->_setArray((ElementType)buffer[offset + 4], buffer + offset + 5, dataLen - 1))
+                    break;
             }
-        }
-        return this->c_str();
-    }
-
-    const char *operator-=(const String *str)
-    {
-        if (str->length())
-        {
-            if (this->type == ETYPE_STRING)
+            else if (!this->_copyBuffer(buffer, dataLen, offset + 4, (ElementType)mark))
             {
-                String tmp = this->getString();
-                tmp.replace(str->c_str(), "");
-                this->_setString(tmp.c_str());
+                return -2;
             }
+            return dataLen + 5;
         }
-        return this->c_str();
-    }
 
-    const char *operator-=(const std::string *str)
-    {
-        if (str->length())
+        // numbers, little endian, same layout as union
+        // 数字，小端序，与联合体的内存布局相同
+        if (dataLen && mark < 9 && dataLen <= available)
         {
-            if (this->type == ETYPE_STRING)
-            {
-                String tmp = this->getString();
-                tmp.replace(str->c_str(), "");
-                this->_setString(tmp.c_str());
-            }
+            memcpy(&(this->data), buffer + offset, dataLen);
+            return dataLen + 1;
         }
-        return this->c_str();
-    }
-
-    // *=
 
-    Element &operator*=(const uint8_t &n)
-    {
-        (*this) = (uint8_t)((*this) * n);
-        return *this;
-    }
-    Element &operator*=(const int8_t &n)
-    {
-        (*this) = (int8_t)((*this) * n);
-        return *this;
-    }
-    Element &operator*=(const uint16_t &n)
-    {
-        (*this) = (uint16_t)((*this) * n);
-        return *this;
-    }
-    Element &operator*=(const int16_t &n)
-    {
-        (*this) = (int16_t)((*this) * n);
-        return *this;
-    }
-    Element &operator*=(const uint32_t &n)
-    {
-        (*this) = (uint32_t)((*this) * n);
-        return *this;
+        // unknown mark, including ARRAY_BUFFER_COMPACT_MARK
+        // 未知的类型标志，包括 ARRAY_BUFFER_COMPACT_MARK
+        this->type = ETYPE_VOID;
+        return -2;
     }
+};
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    Element &operator*=(const int &n)
-    {
-        (*this) = (int)((*this) * n);
-        return *this;
-    }
-#endif
+/**
+ * @brief hash functor of Element for unordered containers,
+ * accepts Element, pointer of Element, c string and string view
+ * Element 在无序容器中使用的哈希函数对象，
+ * 接受 Element、Element 指针、c字符串和字符串视图
+ *
+ * @example
+ * std::unordered_map<const Element *, uint32_t, ElementHash, ElementEqual> index;
+ */
+struct ElementHash
+{
+    // heterogeneous lookup in C++20, with C++11 look up by a stack Element,
+    // short key is stored in its inline buffer, nothing is allocated
+    // C++20 中可以异构查找，C++11 中用栈上的Element查找，
+    // 短的键存储在内部缓冲区中，不分配内存
+    typedef void is_transparent;
+
+    inline size_t operator()(const Element &e) const { return e.hash(); }
+    inline size_t operator()(const Element *e) const { return e ? e->hash() : 0; }
+    inline size_t operator()(const char *str) const { return Element::hash(str); }
+    inline size_t operator()(const ElementStringView &view) const { return view.hash(); }
+};
 
-    Element &operator*=(const int32_t &n)
-    {
-        (*this) = (int32_t)((*this) * n);
-        return *this;
-    }
-    Element &operator*=(const uint64_t &n)
-    {
-        (*this) = (uint64_t)((*this) * n);
-        return *this;
-    }
-    Element &operator*=(const int64_t &n)
-    {
-        (*this) = (int64_t)((*this) * n);
-        return *this;
-    }
-    Element &operator*=(const double &n)
-    {
-        (*this) = (double)((*this) * n);
-        return *this;
-    }
-    Element &operator*=(const float &n)
-    {
-        return this->operator*=((double)n);
-    }
-    Element &operator*=(const Element &e)
-    {
-        (*this) = (*this) * e;
-        return (*this);
-    }
+/**
+ * @brief equality functor matching ElementHash
+ * 与 ElementHash 对应的相等比较函数对象
+ */
+struct ElementEqual
+{
+    typedef void is_transparent;
 
-    Element &operator*=(const Element *e)
+    inline bool operator()(const Element &a, const Element &b) const { return a.equalsTo(&b); }
+    inline bool operator()(const Element *a, const Element *b) const
     {
-        (*this) = (*this) * (*e);
-        return (*this);
+        return a == b || (a && b && a->equalsTo(b));
     }
+    inline bool operator()(const Element *a, const char *b) const { return a && (*a) == (b ? b : ""); }
+    inline bool operator()(const char *a, const Element *b) const { return (*this)(b, a); }
+    inline bool operator()(const Element &a, const char *b) const { return (*this)(&a, b); }
+    inline bool operator()(const char *a, const Element &b) const { return (*this)(&b, a); }
+    inline bool operator()(const Element *a, const ElementStringView &b) const { return a && (*a) == b; }
+    inline bool operator()(const ElementStringView &a, const Element *b) const { return (*this)(b, a); }
+};
 
-    // /=
-
-    Element &operator/=(const uint8_t &n)
+namespace std
+{
+    template <>
+    struct hash<Element>
     {
-#ifdef AUTO_EXTEND_DATA_RANGE
-        (*this) = (double)(this->getUniversalDouble() / (double)n);
-#else
+        inline size_t operator()(const Element &e) const { return e.hash(); }
+    };
 
-        (*this) = (uint8_t)((*this) / n);
-#endif
-        return *this;
-    }
-    Element &operator/=(const int8_t &n)
+    template <>
+    struct hash<ElementStringView>
     {
-#ifdef AUTO_EXTEND_DATA_RANGE
-        (*this) = (double)(this->getUniversalDouble() / (double)n);
-#else
-
-        (*this) = (int8_t)((*this) / n);
+        inline size_t operator()(const ElementStringView &view) const { return view.hash(); }
+    };
+}
+
+#ifndef ELEMENT_LIST_INLINE_CAPACITY
+// number of Elements stored inside ElementList itself, most messages have 4 to 11 fields,
+// list with more fields moves to heap
+// ElementList 内部直接存放的元素数量，大多数消息有4到11个字段，
+// 字段更多的列表会移动到堆上
+#define ELEMENT_LIST_INLINE_CAPACITY 12
 #endif
-        return *this;
-    }
 
-    Element &operator/=(const uint16_t &n)
-    {
-#ifdef AUTO_EXTEND_DATA_RANGE
-        (*this) = (double)(this->getUniversalDouble() / (double)n);
-#else
+/**
+ * @brief container owns Elements and stores them by value one after another,
+ * first ELEMENT_LIST_INLINE_CAPACITY Elements live inside the list without heap memory,
+ * Elements are destroyed with the list, no delete loop is needed,
+ * at(i) returns pointer as Elements does, so code written for Elements * works as is
+ *
+ * 按值连续存放并拥有元素的容器，
+ * 前 ELEMENT_LIST_INLINE_CAPACITY 个元素直接存放在列表内部，不使用堆内存，
+ * 元素随列表一起销毁，不需要循环delete，
+ * at(i) 与 Elements 一样返回指针，所以为 Elements * 编写的代码可以直接使用
+ *
+ * @attention pointers and references to Elements are invalid after list grows, moves or clears
+ * 列表扩容、移动或清空后，指向元素的指针和引用都会失效
+ *
+ * @example
+ * ElementList response;
+ * response.emplace_back(CMD_LOG);
+ * response.emplace_back("hello");
+ * writer.write(&response);
+ */
+class ElementList
+{
+private:
+    typename std::aligned_storage<sizeof(Element), alignof(Element)>::type storage[ELEMENT_LIST_INLINE_CAPACITY];
+    Element *items;
+    uint32_t count = 0;
+    uint32_t reserved = ELEMENT_LIST_INLINE_CAPACITY;
 
-        (*this) = (uint16_t)((*this) / n);
-#endif
-        return *this;
-    }
-    Element &operator/=(const int16_t &n)
+    inline bool _isInline() const { return this->items == (const Element *)(this->storage); }
+
+    Element *_allocate(uint32_t capacity)
     {
-#ifdef AUTO_EXTEND_DATA_RANGE
-        (*this) = (double)(this->getUniversalDouble() / (double)n);
+        uint8_t *raw = nullptr;
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+        try
+        {
+            raw = new uint8_t[capacity * sizeof(Element)];
+        }
+        catch (const std::bad_alloc &e)
+        {
+            raw = nullptr;
+        }
 #else
-
-        (*this) = (int16_t)((*this) / n);
+        raw = new (std::nothrow) uint8_t[capacity * sizeof(Element)];
 #endif
-        return *this;
+        if (!raw)
+            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "element list allocate failed, capacity: %u", capacity);
+        return (Element *)raw;
     }
 
-    Element &operator/=(const uint32_t &n)
+    void _moveTo(Element *items, uint32_t capacity)
     {
-#ifdef AUTO_EXTEND_DATA_RANGE
-        (*this) = (double)(this->getUniversalDouble() / (double)n);
-#else
-
-        (*this) = (uint32_t)((*this) / n);
-#endif
-        return *this;
+        for (uint32_t i = 0; i < this->count; ++i)
+        {
+            new (items + i) Element(std::move(this->items[i]));
+            this->items[i].~Element();
+        }
+        if (!this->_isInline())
+            delete[] (uint8_t *)(this->items);
+        this->items = items;
+        this->reserved = capacity;
     }
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    Element &operator/=(const int &n)
+    void _release()
     {
-#ifdef AUTO_EXTEND_DATA_RANGE
-        (*this) = (double)(this->getUniversalDouble() / (double)n);
-#else
-
-        (*this) = (int)((*this) / n);
-#endif
-        return *this;
+        this->clear();
+        if (!this->_isInline())
+            delete[] (uint8_t *)(this->items);
+        this->items = (Element *)(this->storage);
+        this->reserved = ELEMENT_LIST_INLINE_CAPACITY;
     }
-#endif
 
-    Element &operator/=(const int32_t &n)
-    {
-#ifdef AUTO_EXTEND_DATA_RANGE
-        (*this) = (double)(this->getUniversalDouble() / (double)n);
-#else
+public:
+    ElementList() : items((Element *)(this->storage)) {}
 
-        (*this) = (int32_t)((*this) / n);
-#endif
-        return *this;
+    ElementList(std::initializer_list<Element> list) : ElementList()
+    {
+        this->reserve(list.size());
+        for (const auto &i : list)
+            this->push_back(i);
     }
 
-    Element &operator/=(const uint64_t &n)
-    {
-#ifdef AUTO_EXTEND_DATA_RANGE
-        (*this) = (double)(this->getUniversalDouble() / (double)n);
-#else
+    ElementList(const ElementList &list) : ElementList() { (*this) = list; }
 
-        (*this) = (uint64_t)((*this) / n);
-#endif
-        return *this;
-    }
-    Element &operator/=(const int64_t &n)
-    {
-#ifdef AUTO_EXTEND_DATA_RANGE
-        (*this) = (double)(this->getUniversalDouble() / (double)n);
-#else
+    ElementList(ElementList &&list) noexcept : ElementList() { (*this) = std::move(list); }
 
-        (*this) = (int64_t)((*this) / n);
-#endif
-        return *this;
-    }
+    ~ElementList() { this->_release(); }
 
-    Element &operator/=(const Element &e)
+    ElementList &operator=(const ElementList &list)
     {
-        (*this) = (*this) / e;
-        return (*this);
+        if (this != &list)
+        {
+            this->clear();
+            this->reserve(list.count);
+            for (uint32_t i = 0; i < list.count; ++i)
+                this->push_back(list.items[i]);
+        }
+        return *this;
     }
 
-    Element &operator/=(const Element *e)
+    ElementList &operator=(ElementList &&list) noexcept
     {
-        (*this) = (*this) / (*e);
-        return (*this);
-    }
-
-    // ++
-
+        if (this == &list)
+            return *this;
 
-    Element &operator++()
-    {
-        if (this->type < 9)
+        this->_release();
+        if (list._isInline())
         {
-            if (this->type == ETYPE_FLOAT)
-            {
-                this->data.f += 1.0;
-            }
-            else if (this->type == ETYPE_DOUBLE)
-            {
-                this->data.d += 1.0;
-            }
-            else
-            {
-                switch(this->type){
-                    case ETYPE_UINT8:
-                        ++this->data.u8;
-                        break;
-                    case ETYPE_INT8:
-                        ++this->data.i8;
-                        break;
-                    case ETYPE_UINT16:
-                        ++this->data.u16;
-                        break;
-                    case ETYPE_INT16:
-                        ++this->data.i16;
-                        break;
-                    case ETYPE_UINT32:
-                        ++this->data.u32;
-                        break;
-                    case ETYPE_INT32:
-                        ++this->data.i32;
-                        break;
-                    case ETYPE_UINT64:
-                        ++this->data.u64;
-                        break;
-                    case ETYPE_INT64:
-                        ++this->data.i64;
-                        break;
-                }
-            }
+            // inline Elements are moved one by one
+            // 内部存放的元素逐个移动
+            for (uint32_t i = 0; i < list.count; ++i)
+                new (this->items + i) Element(std::move(list.items[i]));
+            this->count = list.count;
+            list.clear();
         }
         else
         {
-            if (this->type == ETYPE_STRING)
-            {
-                this->_setString((this->getString() + this->getString()).c_str());
-            }
+            // heap storage is taken over
+            // 直接接管堆上的存储空间
+            this->items = list.items;
+            this->count = list.count;
+            this->reserved = list.reserved;
+            list.items = (Element *)(list.storage);
+            list.count = 0;
+            list.reserved = ELEMENT_LIST_INLINE_CAPACITY;
         }
-        return (*this);
+        return *this;
     }
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    Element operator++(int)
+    inline uint32_t size() const { return this->count; }
+    inline bool empty() const { return !this->count; }
+    inline uint32_t capacity() const { return this->reserved; }
+
+    /**
+     * @brief make room for capacity Elements with at most one allocation
+     * 预留可以存放capacity个元素的空间，最多分配一次内存
+     *
+     * @return false if heap full, list is not changed 堆内存不足时返回false，列表不变
+     */
+    bool reserve(uint32_t capacity)
     {
-        Element tmp = *this;
-        this->operator++();
-        return tmp;
+        if (capacity <= this->reserved)
+            return true;
+        Element *items = this->_allocate(capacity);
+        if (!items)
+            return false;
+        this->_moveTo(items, capacity);
+        return true;
     }
-#else
-    Element operator++(int)
+
+    /**
+     * @brief construct an Element at the end, arguments are same as constructors of Element
+     * 在末尾构造一个元素，参数与Element的构造函数相同
+     *
+     * @return new Element, nullptr if heap full 新的元素，堆内存不足时返回空指针
+     */
+    template <class... Args>
+    Element *emplace_back(Args &&...args)
     {
-        Element tmp = *this;
-        ++(*this);
-        return tmp;
+        if (this->count < this->reserved)
+            return new (this->items + this->count++) Element(std::forward<Args>(args)...);
+
+        // new Element is constructed before others are moved, arguments may refer to them
+        // 先构造新元素再移动已有元素，参数可能引用了它们
+        uint32_t capacity = this->reserved * 2;
+        Element *items = this->_allocate(capacity);
+        if (!items)
+            return nullptr;
+        new (items + this->count) Element(std::forward<Args>(args)...);
+        this->_moveTo(items, capacity);
+        return this->items + this->count++;
     }
-#endif
 
-    // --
+    inline bool push_back(const Element &e) { return this->emplace_back(e) != nullptr; }
+    inline bool push_back(Element &&e) { return this->emplace_back(std::move(e)) != nullptr; }
 
-    Element &operator--()
+    // list owns its Elements by value, push_back(new Element(...)) would leak
+    // 列表按值拥有元素，push_back(new Element(...)) 会造成内存泄漏
+    void push_back(Element *e) = delete;
+    void push_back(const Element *e) = delete;
+
+    void pop_back()
     {
-        if (this->type < 9)
-        {
-            if (this->type == ETYPE_FLOAT)
-            {
-                this->data.f -= 1.0;
-            }
-            else if (this->type == ETYPE_DOUBLE)
-            {
-                this->data.d -= 1.0;
-            }
-            else
-            {
-                switch(this->type){
-                    case ETYPE_UINT8:
-                        --this->data.u8;
-                        break;
-                    case ETYPE_INT8:
-                        --this->data.i8;
-                        break;
-                    case ETYPE_UINT16:
-                        --this->data.u16;
-                        break;
-                    case ETYPE_INT16:
-                        --this->data.i16;
-                        break;
-                    case ETYPE_UINT32:
-                        --this->data.u32;
-                        break;
-                    case ETYPE_INT32:
-                        --this->data.i32;
-                        break;
-                    case ETYPE_UINT64:
-                        --this->data.u64;
-                        break;
-                    case ETYPE_INT64:
-                        --this->data.i64;
-                        break;
-                }
-            }
-        }
-        else
-        {
-            if (this->type == ETYPE_STRING)
-            {
-                String tmp = this->getString();
-                uint32_t length = tmp.length();
-                if (length > 0)
-                {
-                    this->_setString(tmp.substring(1).c_str());
-                }
-            }
-        }
-        return (*this);
+        if (this->count)
+            this->items[--this->count].~Element();
     }
 
-    Element operator--(int)
+    /**
+     * @brief destroy all Elements, heap storage is kept for reuse
+     * 销毁所有元素，堆上的存储空间保留以便复用
+     */
+    void clear()
     {
-        Element tmp = *this;
-        --(*this);
-        return tmp;
+        while (this->count)
+            this->items[--this->count].~Element();
     }
 
-    // %
+    inline Element &operator[](uint32_t index) { return this->items[index]; }
+    inline const Element &operator[](uint32_t index) const { return this->items[index]; }
+
+    /**
+     * @brief same as Elements::at, returns pointer of Element
+     * 与 Elements::at 相同，返回Element指针
+     *
+     * @return nullptr if index out of range 索引越界时返回空指针
+     */
+    inline Element *at(uint32_t index) { return index < this->count ? this->items + index : nullptr; }
+    inline const Element *at(uint32_t index) const { return index < this->count ? this->items + index : nullptr; }
+
+    inline Element &front() { return this->items[0]; }
+    inline const Element &front() const { return this->items[0]; }
+    inline Element &back() { return this->items[this->count - 1]; }
+    inline const Element &back() const { return this->items[this->count - 1]; }
+
+    inline Element *data() { return this->items; }
+    inline const Element *data() const { return this->items; }
+    inline Element *begin() { return this->items; }
+    inline const Element *begin() const { return this->items; }
+    inline Element *end() { return this->items + this->count; }
+    inline const Element *end() const { return this->items + this->count; }
+};
+
+typedef std::function<void(uint8_t *output, uint64_t length, bool *isBufferDeleted)> createArrayBufferCallback;
+typedef std::function<void(Elements *output)> decodeArrayBufferCallback;
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    Element operator%(const int &rvalue) const
+/**
+ * @brief
+ * this class is a static class
+ * 这是个静态类
+ */
+class ArrayBuffer
+{
+public:
+    static uint8_t *createArrayBuffer(std::initializer_list<Element> list, uint32_t *outLen)
     {
-        Element tmp;
-        if (this->type < 9 && this->type != ETYPE_FLOAT && this->type != ETYPE_DOUBLE)
+        (*outLen) = 0;
+
+        if (!list.size())
+            return nullptr;
+
+        uint32_t bufferLength = 0;
+
+        for (const auto &i : list)
+            bufferLength += i.getOuterBufferLength();
+
+        if (!bufferLength)
+            return nullptr;
+
+        uint8_t *buf = nullptr;
+
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+        try
         {
-            tmp = (int)(this->data.i64 % rvalue);
+            buf = new uint8_t[bufferLength];
         }
-        return tmp;
-    }
-#endif
-
-    Element operator%(const int32_t &rvalue) const
-    {
-        Element tmp;
-        if (this->type < 9 && this->type != ETYPE_FLOAT && this->type != ETYPE_DOUBLE)
+        catch (const std::bad_alloc &e)
         {
-            tmp = (int32_t)(this->data.i64 % rvalue);
+            // do nothing
         }
-        return tmp;
-    }
-
-    Element operator%(const Element &rvalue) const
-    {
-        return this->operator%((int32_t)rvalue.getNumber());
-    }
+#else
+        buf = new (std::nothrow) uint8_t[bufferLength];
+#endif
 
-    Element operator%(const Element *rvalue) const
-    {
-        return this->operator%((int32_t)rvalue->getNumber());
-    }
+        if (!buf)
+            return buf;
 
-    //%=
+        (*outLen) = bufferLength;
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    Element &operator%=(const int &rvalue)
-    {
-        Element result = (*this) % rvalue;
-        if (result.available())
+        uint32_t offset = 0;
+
+        for (const auto &i : list)
         {
-            this->reset(ETYPE_INT32);
-            this->data.i32 = result.getInt32();
+            if (!i.pack(buf, &offset))
+            {
+                delete buf;
+                return nullptr;
+            }
         }
-        return (*this);
+
+        return buf;
     }
-#endif
 
-    Element &operator%=(const int32_t &rvalue)
+    /**
+     * @brief this function will create an uint8 array using a vector provided
+     * 这个函数会使用你提供的vector构造一个二进制数组
+     *
+     * @param elements a vector contains pointers of class Element 一个装有Element对象指针的容器
+     *
+     * @param outLen length of output uint8 array 输出的二进制数组的长度
+     *
+     * @return generated pointer to buffer 生成的二进制数组指针
+     */
+    static uint8_t *createArrayBuffer(Elements *elements,
+                                      uint32_t *outLen)
     {
-        Element result = (*this) % rvalue;
-        if (result.available())
+        (*outLen) = 0;
+        // check vector size
+        // 检查容器大小
+        if (elements->size() <= 0)
         {
-            this->reset(ETYPE_INT32);
-            this->data.i32 = result.getInt32();
+            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "empty container");
+            return nullptr;
         }
-        return (*this);
-    }
 
-    Element &operator%=(const Element &rvalue)
-    {
-        return this->operator%=((int32_t)rvalue.getNumber());
-    }
+        // declare the length of output
+        // 声明输出二进制数组的大小
+        uint32_t bufferLength = 0;
 
-    Element &operator%=(const Element *rvalue)
-    {
-        return this->operator%=((int32_t)rvalue->getNumber());
-    }
+        // calculate buffer length
+        // 计算需要的缓冲区的长度
+        for (auto it = elements->begin(); it != elements->end(); ++it)
+        {
+            bufferLength += (*it)->getOuterBufferLength();
+        }
 
-    // <<
+        // allocate buffer
+        // 分配内存
+        uint8_t *buf = nullptr; // new (std::nothrow) uint8_t[bufferLength];
 
-    inline Element operator<<(const uint8_t &rvalue) const
-    {
-        Element tmp;
-        if (this->type < 9 && this->type != ETYPE_FLOAT && this->type != ETYPE_DOUBLE)
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+        try
         {
-            switch (this->type)
-            {
-            case ETYPE_UINT8:
-                tmp = (uint8_t)(this->data.u8 << rvalue);
-                break;
-            case ETYPE_INT8:
-                tmp = (int8_t)(this->data.i8 << rvalue);
-                break;
-            case ETYPE_UINT16:
-                tmp = (uint16_t)(this->data.u16 << rvalue);
-                break;
-            case ETYPE_INT16:
-                tmp = (int16_t)(this->data.i16 << rvalue);
-                break;
-            case ETYPE_UINT32:
-                tmp = (uint32_t)(this->data.u32 << rvalue);
-                break;
-            case ETYPE_INT32:
-                tmp = (int32_t)(this->data.i32 << rvalue);
-                break;
-            case ETYPE_UINT64:
-                tmp = (uint64_t)(this->data.u64 << rvalue);
-                break;
-            case ETYPE_INT64:
-                tmp = (int64_t)(this->data.i64 << rvalue);
-                break;
-            default:
-                break;
-            }
+            buf = new uint8_t[bufferLength];
         }
-        else
+        catch (const std::bad_alloc &e)
         {
-            if (this->type == ETYPE_STRING)
-            {
-                if (strlen(this->c_str()) >= rvalue)
-                {
-                    tmp = this->getString().substring(rvalue);
-                }
-            }
+            // do nothing
         }
-        return tmp;
-    }
+#else
+        buf = new (std::nothrow) uint8_t[bufferLength];
+#endif
 
-    inline Element operator<<(const Element &rvalue) const
-    {
-        return this->operator<<(rvalue.getUint8());
-    }
+        if (!buf)
+        {
+            // will return null pointer if memory allocate failed
+            // 如果内存分配失败将返回空指针
+            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "memory allocate failed, buffer length: % llu", bufferLength);
+            return nullptr;
+        }
+        // bzero(buf, bufferLength);
 
-    inline Element operator<<(const Element *rvalue) const
-    {
-        return this->operator<<(rvalue->getUint8());
-    }
+        // start to fill data
+        // 从这里开始装填数据
 
-    // >>
+        uint32_t offset = 0;
 
-    inline Element operator>>(const uint8_t &rvalue) const
-    {
-        Element tmp;
-        if (this->type < 9 && this->type != ETYPE_FLOAT && this->type != ETYPE_DOUBLE)
-        {
-            switch (this->type)
-            {
-            case ETYPE_UINT8:
-                tmp = (uint8_t)(this->data.u8 >> rvalue);
-                break;
-            case ETYPE_INT8:
-                tmp = (int8_t)(this->data.i8 >> rvalue);
-                break;
-            case ETYPE_UINT16:
-                tmp = (uint16_t)(this->data.u16 >> rvalue);
-                break;
-            case ETYPE_INT16:
-                tmp = (int16_t)(this->data.i16 >> rvalue);
-                break;
-            case ETYPE_UINT32:
-                tmp = (uint32_t)(this->data.u32 >> rvalue);
-                break;
-            case ETYPE_INT32:
-                tmp = (int32_t)(this->data.i32 >> rvalue);
-                break;
-            case ETYPE_UINT64:
-                tmp = (uint64_t)(this->data.u64 >> rvalue);
-                break;
-            case ETYPE_INT64:
-                tmp = (int64_t)(this->data.i64 >> rvalue);
-                break;
-            default:
-                break;
-            }
-        }
-        else
+        for (auto it = elements->begin(); it != elements->end(); ++it)
         {
-            if (this->type == ETYPE_STRING)
+            // empty element is skipped, only reading a file could fail here
+            // 跳过空元素，这里只有读取文件可能失败
+            if (!(*it)->pack(buf, &offset) && (*it)->getOuterBufferLength())
             {
-                if (strlen(this->c_str()) >= rvalue)
-                {
-                    String t = this->getString();
-                    tmp = t.substring(0, t.length() - rvalue);
-                }
+                delete buf;
+                return nullptr;
             }
         }
-        return tmp;
-    }
-
-    inline Element operator>>(const Element &rvalue) const
-    {
-        return this->operator>>(rvalue.getUint8());
-    }
-
-    inline Element operator>>(const Element *rvalue) const
-    {
-        return this->operator>>(rvalue->getUint8());
-    }
-
-    // <<=
-
-    Element &operator<<=(const uint8_t &rvalue)
-    {
-        (*this) = this->operator<<(rvalue);
-        return (*this);
-    }
-    Element &operator<<=(const Element &rvalue)
-    {
-        (*this) = this->operator<<(rvalue.getUint8());
-        return (*this);
-    }
-    Element &operator<<=(const Element *rvalue)
-    {
-        (*this) = this->operator<<(rvalue->getUint8());
-        return (*this);
-    }
 
-    // >>=
+        // set output length
+        // 设置输出数组的长度
+        (*outLen) = bufferLength;
 
-    Element &operator>>=(const uint8_t &rvalue)
-    {
-        (*this) = this->operator>>(rvalue);
-        return (*this);
-    }
-    Element &operator>>=(const Element &rvalue)
-    {
-        (*this) = this->operator>>(rvalue.getUint8());
-        return (*this);
-    }
-    Element &operator>>=(const Element *rvalue)
-    {
-        (*this) = this->operator>>(rvalue->getUint8());
-        return (*this);
+        // return pointer of uint8 array
+        // 返回数组指针
+        return buf;
     }
 
-    // &
+    /**
+     * @brief same as above, Elements are stored by value in ElementList
+     * 与上面的功能相同，元素按值存放在 ElementList 中
+     */
+    static uint8_t *createArrayBuffer(const ElementList *elements, uint32_t *outLen);
 
     /**
-     * @brief universal bitwise and
-     * @note float and double also do bitwise and
+     * @brief same as above, but integers and lengths are encoded as varint, output is smaller
+     * output starts with ARRAY_BUFFER_COMPACT_MARK, decodeArrayBuffer detects it automatically
+     * this is opt-in, web side(ab.js) doesn't support it
      *
-     * @attention check available before using it
+     * 与上面的功能相同，但是整数和长度使用变长编码，输出更小
+     * 输出以 ARRAY_BUFFER_COMPACT_MARK 开头，decodeArrayBuffer 会自动识别
+     * 需要主动使用，网页端(ab.js)不支持此模式
      *
-     * @param rvalue
-     * @return Element
+     * @param elements a vector contains pointers of class Element 一个装有Element对象指针的容器
+     * @param outLen length of output uint8 array 输出的二进制数组的长度
+     *
+     * @return generated pointer to buffer 生成的二进制数组指针
      */
-    inline Element operator&(const Element &rvalue) const
+    static uint8_t *createCompactArrayBuffer(Elements *elements, uint32_t *outLen)
     {
-        if (!this->available() || !rvalue.available())
-            return Element();
+        (*outLen) = 0;
 
-        switch (this->type)
+        if (!elements || !elements->size())
         {
-        case ETYPE_UINT8:
-            return Element((uint8_t)(this->data.u8 & rvalue.getUint8()));
-        case ETYPE_INT8:
-            return Element((int8_t)(this->data.i8 & rvalue.getInt8()));
-        case ETYPE_UINT16:
-            return Element((uint16_t)(this->data.u16 & rvalue.getUint16()));
-        case ETYPE_INT16:
-            return Element((int16_t)(this->data.i16 & rvalue.getInt16()));
-        case ETYPE_UINT32:
-            return Element((uint32_t)(this->data.u32 & rvalue.getUint32()));
-        case ETYPE_INT32:
-#if CONFIG_IDF_TARGET_ESP32C3
-            return Element((int)(this->data.i32 & rvalue.getInt32()));
+            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "empty container");
+            return nullptr;
+        }
+
+        uint32_t bufferLength = 1;
+        for (auto it = elements->begin(); it != elements->end(); ++it)
+        {
+            bufferLength += (*it)->getOuterBufferLength(true);
+        }
+
+        if (bufferLength == 1)
+            return nullptr;
+
+        uint8_t *buf = nullptr;
+
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+        try
+        {
+            buf = new uint8_t[bufferLength];
+        }
+        catch (const std::bad_alloc &e)
+        {
+            // do nothing
+        }
 #else
-            return Element((int32_t)(this->data.i32 & rvalue.getInt32()));
+        buf = new (std::nothrow) uint8_t[bufferLength];
 #endif
-        case ETYPE_UINT64:
-            return Element((uint64_t)(this->data.u64 & rvalue.getUint64()));
-        case ETYPE_INT64:
-            return Element((int64_t)(this->data.i64 & rvalue.getInt64()));
-        default:
-            break;
+
+        if (!buf)
+        {
+            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "memory allocate failed, buffer length: % llu", bufferLength);
+            return nullptr;
         }
-        return Element();
-    }
-
-    // |
 
-    /**
-     * @brief universal bitwise or
-     * @note float and double also do bitwise or
-     *
-     * @attention check available before using it
-     *
-     * @param rvalue
-     * @return Element
-     */
-    inline Element operator|(const Element &rvalue) const
-    {
-        if (!this->available() || !rvalue.available())
-            return Element();
+        buf[0] = ARRAY_BUFFER_COMPACT_MARK;
+        uint32_t offset = 1;
 
-        switch (this->type)
+        for (auto it = elements->begin(); it != elements->end(); ++it)
         {
-        case ETYPE_UINT8:
-            return Element((uint8_t)(this->data.u8 | rvalue.getUint8()));
-        case ETYPE_INT8:
-            return Element((int8_t)(this->data.i8 | rvalue.getInt8()));
-        case ETYPE_UINT16:
-            return Element((uint16_t)(this->data.u16 | rvalue.getUint16()));
-        case ETYPE_INT16:
-            return Element((int16_t)(this->data.i16 | rvalue.getInt16()));
-        case ETYPE_UINT32:
-            return Element((uint32_t)(this->data.u32 | rvalue.getUint32()));
-        case ETYPE_INT32:
-#if CONFIG_IDF_TARGET_ESP32C3
-            return Element((int)(this->data.i32 | rvalue.getInt32()));
-#else
-            return Element((int32_t)(this->data.i32 | rvalue.getInt32()));
-#endif
-        case ETYPE_UINT64:
-            return Element((uint64_t)(this->data.u64 | rvalue.getUint64()));
-        case ETYPE_INT64:
-            return Element((int64_t)(this->data.i64 | rvalue.getInt64()));
-        default:
-            break;
+            if (!(*it)->pack(buf, &offset, true) && (*it)->getOuterBufferLength())
+            {
+                delete buf;
+                return nullptr;
+            }
         }
-        return Element();
-    }
 
-    // ~
+        (*outLen) = bufferLength;
+        return buf;
+    }
 
     /**
-     * @brief bitwise inversion
+     * @brief same as above, but output starts with ARRAY_BUFFER_CHECKED_MARK and ends with CRC32 of
+     * everything before, decodeArrayBuffer and ArrayBufferView verify it before reading any field,
+     * so corrupted data is rejected even if it is still well formed
      *
-     * @attention check available before using it
+     * 与上面的功能相同，但是输出以 ARRAY_BUFFER_CHECKED_MARK 开头，以之前所有字节的CRC32结尾，
+     * decodeArrayBuffer 和 ArrayBufferView 在读取任何字段之前都会先校验它，
+     * 所以即使损坏的数据格式依然正确也会被拒绝
      *
-     * @return Element
+     * @param elements a vector contains pointers of class Element 一个装有Element对象指针的容器
+     * @param outLen length of output uint8 array 输出的二进制数组的长度
+     * @param compact fields are in compact mode 字段使用紧凑模式
+     *
+     * @return generated pointer to buffer 生成的二进制数组指针
      */
-    inline Element operator~() const
-    {
-        switch (this->type)
-        {
-        case ETYPE_UINT8:
-            return Element((uint8_t)(~(this->data.i64)));
-        case ETYPE_INT8:
-            return Element((int8_t)(~(this->data.i64)));
-        case ETYPE_UINT16:
-            return Element((uint16_t)(~(this->data.i64)));
-        case ETYPE_INT16:
-            return Element((int16_t)(~(this->data.i64)));
-        case ETYPE_UINT32:
-            return Element((uint32_t)(~(this->data.i64)));
-        case ETYPE_INT32:
-#if CONFIG_IDF_TARGET_ESP32C3
-            return Element((int)(~(this->data.i64)));
-#else
-            return Element((int32_t)(~(this->data.i64)));
-#endif
-        case ETYPE_UINT64:
-            return Element((uint64_t)(~(this->data.i64)));
-        case ETYPE_INT64:
-            return Element((int64_t)(~(this->data.i64)));
-        default:
-            break;
-        }
-        return Element();
-    }
-
-    // ^
+    static uint8_t *createCheckedArrayBuffer(Elements *elements, uint32_t *outLen, bool compact = false);
 
     /**
-     * @brief universal xor
-     * @note float and double also do xor
+     * @brief encode keys and values one after another sorted by key, with an offset table ahead,
+     * so ArrayBufferSortedView finds a key by binary search in encoded bytes without decoding the rest,
+     * decodeArrayBuffer and ArrayBufferView read it as keys and values as usual
      *
-     * @attention check available before using it
+     * 按键排序依次编码键和值，前面带有偏移量表，
+     * 所以 ArrayBufferSortedView 可以在编码后的数据中二分查找键，不需要解码其他部分，
+     * decodeArrayBuffer 和 ArrayBufferView 依然把它当作依次排列的键和值读取
      *
-     * @param rvalue
-     * @return Element
+     * @param elements keys(string) and values one after another, entries with empty value are skipped,
+     * first one wins if key is duplicated
+     * 依次排列的键(字符串)和值，值为空的条目会被跳过，键重复时第一个有效
+     * @param outLen length of output uint8 array 输出的二进制数组的长度
+     *
+     * @return nullptr if any key is not a string or nothing to encode 任何键不是字符串或没有可编码的内容时返回空指针
      */
-    inline Element operator^(const Element &rvalue) const
+    static uint8_t *createSortedArrayBuffer(Elements *elements, uint32_t *outLen)
     {
-        if (!this->available() || !rvalue.available())
-            return Element();
+        (*outLen) = 0;
 
-        switch (this->type)
+        if (!elements || !elements->size() || elements->size() % 2)
+            return nullptr;
+
+        // entries sorted by key, stable so the first of duplicated keys stays ahead
+        // 按键排序的条目，使用稳定排序所以重复的键中第一个排在前面
+        std::vector<uint32_t> entries;
+        entries.reserve(elements->size() / 2);
+        for (uint32_t i = 0; i < elements->size(); i += 2)
         {
-        case ETYPE_UINT8:
-            return Element((uint8_t)(this->data.u8 ^ rvalue.getUint8()));
-        case ETYPE_INT8:
-            return Element((int8_t)(this->data.i8 ^ rvalue.getInt8()));
-        case ETYPE_UINT16:
-            return Element((uint16_t)(this->data.u16 ^ rvalue.getUint16()));
-        case ETYPE_INT16:
-            return Element((int16_t)(this->data.i16 ^ rvalue.getInt16()));
-        case ETYPE_UINT32:
-            return Element((uint32_t)(this->data.u32 ^ rvalue.getUint32()));
-        case ETYPE_INT32:
-#if CONFIG_IDF_TARGET_ESP32C3
-            return Element((int)(this->data.i32 ^ rvalue.getInt32()));
-#else
+            if (elements->at(i)->getType() != ETYPE_STRING)
+                return nullptr;
+            if (elements->at(i + 1)->getOuterBufferLength())
+                entries.push_back(i);
+        }
+
+        std::stable_sort(entries.begin(), entries.end(),
+                         [elements](uint32_t a, uint32_t b)
+                         { return strcmp(elements->at(a)->c_str(), elements->at(b)->c_str()) < 0; });
+        entries.erase(std::unique(entries.begin(), entries.end(),
+                                  [elements](uint32_t a, uint32_t b)
+                                  { return !strcmp(elements->at(a)->c_str(), elements->at(b)->c_str()); }),
+                      entries.end());
+
+        if (!entries.size())
+            return nullptr;
+
+        uint32_t fieldsLength = 0;
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+            fieldsLength += elements->at(*it)->getOuterBufferLength() + elements->at(*it + 1)->getOuterBufferLength();
+
+        uint8_t width = fieldsLength <= 0xffff ? 2 : 4;
+        uint32_t count = entries.size();
+        uint32_t headerLength = 6 + count * width;
+        uint32_t bufferLength = headerLength + fieldsLength;
+        uint8_t *buf = nullptr;
 
-            return Element((int32_t)(this->data.i32 ^ rvalue.getInt32()));
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+        try
+        {
+            buf = new uint8_t[bufferLength];
+        }
+        catch (const std::bad_alloc &e)
+        {
+            // do nothing
+        }
+#else
+        buf = new (std::nothrow) uint8_t[bufferLength];
 #endif
-        case ETYPE_UINT64:
-            return Element((uint64_t)(this->data.u64 ^ rvalue.getUint64()));
-        case ETYPE_INT64:
-            return Element((int64_t)(this->data.i64 ^ rvalue.getInt64()));
-        default:
-            break;
+
+        if (!buf)
+        {
+            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "memory allocate failed, buffer length: % llu", bufferLength);
+            return nullptr;
         }
-        return Element();
-    }
 
-    // &&
-    inline bool operator&&(const bool &rvalue) const
-    {
-        return this->available() &&
-               (this->data.i64 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               rvalue;
-    }
+        buf[0] = ARRAY_BUFFER_SORTED_MARK;
+        memcpy(buf + 1, &count, 4);
+        buf[5] = width;
 
-    inline bool operator&&(const uint8_t &rvalue) const
-    {
-        return this->available() &&
-               (this->data.u8 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               rvalue;
-    }
+        uint32_t offset = headerLength;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            // offsets are little endian, the low bytes come first
+            // 偏移量是小端序，低位字节在前
+            uint32_t fieldOffset = offset - headerLength;
+            memcpy(buf + 6 + i * width, &fieldOffset, width);
+            elements->at(entries[i])->pack(buf, &offset);
+            elements->at(entries[i] + 1)->pack(buf, &offset);
+        }
 
-    inline bool operator&&(const int8_t &rvalue) const
-    {
-        return this->available() &&
-               (this->data.i8 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               rvalue;
+        (*outLen) = bufferLength;
+        return buf;
     }
 
-    inline bool operator&&(const uint16_t &rvalue) const
+    /**
+     * @brief length of mark, header and offset table of a buffer starts with ARRAY_BUFFER_SORTED_MARK
+     * 以 ARRAY_BUFFER_SORTED_MARK 开头的数组的标志、头部和偏移量表的长度
+     *
+     * @return 0 if mark is missing or offset table runs past the end 没有标志或偏移量表超出末尾时返回0
+     */
+    static uint32_t getSortedHeaderLength(const uint8_t *data, uint32_t length)
     {
-        return this->available() &&
-               (this->data.u16 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               rvalue;
-    }
+        if (!data || length < 6 || data[0] != ARRAY_BUFFER_SORTED_MARK)
+            return 0;
 
-    inline bool operator&&(const int16_t &rvalue) const
-    {
-        return this->available() &&
-               (this->data.i16 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               rvalue;
+        uint32_t count = 0;
+        memcpy(&count, data + 1, 4);
+        uint8_t width = data[5];
+        if ((width != 2 && width != 4) || count > (length - 6) / width)
+            return 0;
+        return 6 + count * width;
     }
 
-    inline bool operator&&(const uint32_t &rvalue) const
+    /**
+     * @brief check CRC32 trailer of a buffer starts with ARRAY_BUFFER_CHECKED_MARK
+     * 校验以 ARRAY_BUFFER_CHECKED_MARK 开头的数组结尾的CRC32
+     *
+     * @return false if mark is missing, buffer is too short or checksum mismatches
+     * 没有标志、数组太短或校验值不匹配时返回false
+     */
+    static bool verifyChecksum(const uint8_t *data, uint32_t length)
     {
-        return this->available() &&
-               (this->data.u32 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               rvalue;
-    }
+        // mark, at least one byte of fields and trailer
+        // 标志、至少一个字节的字段和结尾的校验值
+        if (!data || length < 6 || data[0] != ARRAY_BUFFER_CHECKED_MARK)
+            return false;
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    inline bool operator&&(const int &rvalue) const
-    {
-        return this->available() &&
-               (this->data.i32 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               rvalue;
+        uint32_t crc = 0;
+        memcpy(&crc, data + length - 4, 4);
+        return crc == mycrypto::CRC32::checksum(data, length - 4);
     }
-#endif
 
-    inline bool operator&&(const int32_t &rvalue) const
+    /**
+     * @brief this function does same thing as bellow, but it accept a callback in argument
+     * it will clear memory after callback had been called
+     *
+     * 跟上面那个功能一样，但是回调函数使用完成之后会自动清理缓存
+     *
+     * @param elements a vector contains pointers of Element 一个装有Element指针的容器
+     *
+     * @param callback callback for accept output 接收结果的回调函数
+     */
+    static void createArrayBuffer(Elements *elements,
+                                  createArrayBufferCallback callback)
     {
-        return this->available() &&
-               (this->data.i32 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               rvalue;
-    }
+        // this mark could be set by user, then user could delete output manually
+        // but this is not recommended
+        // 这个标志可以在回调函数中由用户手动设置，这样在需要更多内存的场景可以立即清除内存
+        // 但是不推荐这样做，因为你可能将此标志设为true，但是忘记delete
+        bool isBufferDeleted = false;
 
-    inline bool operator&&(const uint64_t &rvalue) const
-    {
-        return this->available() &&
-               (this->data.u64 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               rvalue;
-    }
+        // declare a variable for generate function input
+        // 声明生成函数所需要传入的长度变量
+        uint32_t outLen = 0;
 
-    inline bool operator&&(const int64_t &rvalue) const
-    {
-        return this->available() &&
-               (this->data.i64 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               rvalue;
-    }
+        // generate buffer
+        // 生成数组
+        uint8_t *buf = ArrayBuffer::createArrayBuffer(elements, &outLen);
 
-    inline bool operator&&(const float &rvalue) const
-    {
-        return this->available() &&
-               (this->data.f != 0 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               rvalue;
-    }
+        if (!buf || !outLen)
+        {
+            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "empty buffer");
+        }
 
-    inline bool operator&&(const double rvalue) const
-    {
-        return this->available() &&
-               (this->data.d != 0 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               rvalue;
-    }
+        // output pointer and length wheather buffer is empty or not
+        // so you should check pointer and length in callback
+        // 不论是否生成成功都会返回指针，所以回调函数需要检查指针和长度
+        callback(buf, outLen, &isBufferDeleted);
 
-    inline bool operator&&(const Element &rvalue) const
-    {
-        uint32_t bLength = rvalue.getRawBufferLength();
-        ElementType bType = rvalue.getType();
-        return this->available() &&
-               (this->data.i64 ||
-                (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) &&
-               (rvalue.getInt64() ||
-                (bLength > (bType == ETYPE_STRING ? 1 : 0)));
+        if (!isBufferDeleted)
+        {
+            // if user do nothing with buffer, delete it
+            // 如果用户没有手动清理缓存就清理掉它
+            delete buf;
+        }
     }
 
-    // ||
+    /**
+     * @brief this function will generate a vector to hold data using a uint8 array buffer provided
+     * 这个函数可以根据你提供的二进制数组生成一个vector，里面存储了各种类型的数据
+     *
+     * @param data uint8 array 二进制数组
+     * @param length length of uint8 array 二进制数组的长度
+     * @param onlyCopyPointer will NOT copy original data(if type is uint8 array), ONLY copy pointer if this set to true
+     * 如果设置为true，则生成的Element如果类型为二进制数组，则 [仅拷贝] 数组指针，而 [不拷贝] 原始数据
+     *
+     * @return a vector contains pointers of Element 一个装有Element指针的vector容器
+     */
+    static std::vector<Element *> *decodeArrayBuffer(uint8_t *data,
+                                                     uint32_t length,
+                                                     bool onlyCopyPointer = false);
 
-    inline bool operator||(const bool &rvalue) const
-    {
-        return this->available() && (this->data.i64 ||
-                                     (this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0)) || rvalue);
-    }
+    /**
+     * @brief same as above, but all Elements, the container and payload bytes come from arena,
+     * they are released by ElementArena::reset(), do NOT delete them
+     * 与上面的功能相同，但是所有元素、容器和数据都来自arena，
+     * 它们由 ElementArena::reset() 释放，[不要] delete它们
+     *
+     * @param data uint8 array 二进制数组
+     * @param length length of uint8 array 二进制数组的长度
+     * @param arena arena for this message, falls back to heap if nullptr 当前消息的arena，为空指针时使用堆内存
+     *
+     * @return nullptr if data is malformed or arena is full 数据格式错误或arena内存不足时返回空指针
+     */
+    static Elements *decodeArrayBuffer(uint8_t *data, uint32_t length, ElementArena *arena);
+
+    /**
+     * @brief same as above, but Elements are placed in output by value, nothing to delete
+     * 与上面的功能相同，但元素按值存放在output中，不需要delete
+     *
+     * @param data uint8 array 二进制数组
+     * @param length length of uint8 array 二进制数组的长度
+     * @param output Elements are appended after existing ones 元素追加在已有元素之后
+     * @param arena payload bytes are copied into arena if provided, output must be cleared before ElementArena::reset()
+     * 如果提供了arena，数据会拷贝到arena中，ElementArena::reset() 之前需要先清空output
+     *
+     * @return false if data is malformed or heap full, output is not changed
+     * 数据格式错误或内存不足时返回false，output不变
+     */
+    static bool decodeArrayBuffer(uint8_t *data, uint32_t length, ElementList *output, ElementArena *arena = nullptr);
 
-    inline bool operator||(const uint8_t &rvalue) const
+    /**
+     * @brief same as createArrayBuffer(Elements *, uint32_t *), but output comes from arena,
+     * do NOT delete it
+     * 与 createArrayBuffer(Elements *, uint32_t *) 相同，但输出来自arena，[不要] delete它
+     */
+    static uint8_t *createArrayBuffer(Elements *elements, uint32_t *outLen, ElementArena *arena);
+
+    /**
+     * @brief same as bellow
+     * 跟上面那个带回调函数的功能一样
+     *
+     * @param callback callback for accept output 接收结果的回调函数
+     * @param data uint8 array 二进制数组
+     * @param length length of uint8 array 二进制数组的长度
+     */
+    static void decodeArrayBuffer(decodeArrayBufferCallback callback,
+                                  uint8_t *data,
+                                  uint32_t length)
     {
-        return this->available() && (this->data.u8 ||
-                                     ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) || rvalue);
-    }
+        // check pointer and length
+        // 检查指针和长度
+        if (!data || !length)
+        {
+            callback(nullptr);
+            return;
+        }
 
-    bool operator||(const int8_t &rvalue) const
-    {
-        return this->available() && (this->data.i8 || ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) || rvalue);
-    }
+        // decode buffer if data valid
+        // 如果数据符合要求则开始反序列过程
+        std::vector<Element *> *output = ArrayBuffer::decodeArrayBuffer(data, length);
 
-    inline bool operator||(const uint16_t &rvalue) const
-    {
-        return this->available() && (this->data.u16 || ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) || rvalue);
-    }
+        // call callback
+        // 调用回调函数
+        callback(output);
 
-    inline bool operator||(const int16_t &rvalue) const
-    {
-        return this->available() && (this->data.i16 || ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) || rvalue);
-    }
+        if (output)
+        {
+            // delete elements
+            // 删除对象
+            for (uint32_t i = 0; i < output->size(); ++i)
+            {
+                delete output->at(i);
+            }
 
-    inline bool operator||(const uint32_t &rvalue) const
-    {
-        return this->available() && (this->data.u32 || ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) || rvalue);
+            // clean
+            // 清理
+            output->clear();
+            std::vector<Element *>().swap(*(output));
+            delete output;
+        }
     }
+};
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    inline bool operator||(const int &rvalue) const
-    {
-        return this->available() && (this->data.i32 || ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) || rvalue);
-    }
+#ifndef ARRAY_BUFFER_VIEW_INDEX_CAPACITY
+// number of field offsets cached by ArrayBufferView for O(1) random access,
+// fields beyond this index are reached by walking from the last cached one
+// ArrayBufferView 缓存的字段偏移量数量，用于O(1)随机访问
+// 超出此索引的字段会从最后一个缓存的位置向后遍历
+#define ARRAY_BUFFER_VIEW_INDEX_CAPACITY 16
 #endif
 
-    inline bool operator||(const int32_t &rvalue) const
-    {
-        return this->available() && (this->data.i32 || ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) || rvalue);
-    }
-
-    inline bool operator||(const uint64_t &rvalue) const
-    {
-        return this->available() && (this->data.u64 || ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) || rvalue);
-    }
-
-    inline bool operator||(const int64_t &rvalue) const
-    {
-        return this->available() && (this->data.i64 || ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) || rvalue);
-    }
+class ArrayBufferView;
 
-    inline bool operator||(const float &rvalue) const
-    {
-        return this->available() && (this->data.f != 0 || ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) || rvalue);
-    }
+/**
+ * @brief non-owning view of a single field inside an encoded buffer
+ * numbers are read straight from the source, string and uint8 array are exposed as pointer + length
+ * the source buffer must outlive the view
+ *
+ * 编码后的二进制数组中单个字段的只读视图，不持有数据
+ * 数字直接从源数组读取，字符串和二进制数组以指针+长度的形式提供
+ * 源数组的生命周期必须长于视图
+ */
+class ElementView
+{
+private:
+    /**
+     * @brief data type of this field
+     * 字段的数据类型
+     */
+    ElementType type = ETYPE_VOID;
 
-    inline bool operator||(const double rvalue) const
-    {
-        return this->available() && (this->data.d != 0 || ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) || rvalue);
-    }
+    /**
+     * @brief pointer to type mark of this field in source buffer
+     * 指向源数组中此字段类型标志的指针
+     */
+    const uint8_t *field = nullptr;
 
-    inline bool operator||(const Element &rvalue) const
-    {
-        uint32_t bLength = rvalue.getRawBufferLength();
-        ElementType bType = rvalue.getType();
-        return (this->available() &&
-                rvalue.available()) &&
-               (this->data.i64 || ((this->data.buffer.bufferLength > (this->type == ETYPE_STRING ? 1 : 0))) ||
-                rvalue.getInt64() || ((bLength > (bType == ETYPE_STRING ? 1 : 0))));
-    }
+    /**
+     * @brief pointer to payload, length of payload
+     * 指向数据的指针和数据的长度
+     */
+    const uint8_t *p = nullptr;
+    uint32_t length = 0;
 
-    // !
+    /**
+     * @brief field is in compact mode, payload of integer is a varint
+     * 字段使用紧凑模式，整数的数据是变长编码
+     */
+    bool compact = false;
 
     /**
-     * @brief logical not
-     *
-     * @attention this won't check available
-     *
-     * @return true
-     * @return false
+     * @brief load number into a zeroed union, same layout as Element
+     * 把数字读取到一个置零的联合体中，与Element的内存布局相同
      */
-    inline bool operator!() const
+    inline ElementData _load() const
     {
-        if (this->available())
+        ElementData d;
+        bzero((uint8_t *)&d, sizeof(ElementData));
+        if (this->compact && this->type != ETYPE_FLOAT && this->type != ETYPE_DOUBLE)
         {
-            switch (this->type)
+            // varint was validated when parsing
+            // 变长编码在解析时已校验
+            uint64_t n = 0;
+            if (this->type < 9 && this->p &&
+                ArrayBufferVarint::read(this->p, this->length, &n) > 0)
             {
-            case ETYPE_UINT8:
-                return !this->data.u8;
-            case ETYPE_INT8:
-                return !this->data.i8;
-            case ETYPE_UINT16:
-                return !this->data.u16;
-            case ETYPE_INT16:
-                return !this->data.i16;
-            case ETYPE_UINT32:
-                return !this->data.u32;
-            case ETYPE_INT32:
-                return !this->data.i32;
-            case ETYPE_UINT64:
-                return !this->data.u64;
-            case ETYPE_INT64:
-                return !this->data.i64;
-            case ETYPE_FLOAT:
-                return this->data.f == 0;
-            case ETYPE_DOUBLE:
-                return this->data.d == 0;
-            case ETYPE_STRING:
-                return !((this->data.buffer.p)[0]);
-            case ETYPE_BUFFER:
-                return !this->data.buffer.bufferLength;
-            default:
-                return false;
+                ArrayBufferVarint::toData(n, this->type, &d);
             }
         }
-        return true;
+        else if (this->type < 9 && this->p && this->length <= sizeof(ElementData))
+        {
+            memcpy(&d, this->p, this->length);
+        }
+        return d;
     }
 
-    // []
     /**
-     * @brief get uint8_t data from buffer or string
-     *
-     * @attention the return value is uint16_t, it doesn't mean
-     * data range from -32768 to 32767.
-     * return -2 means error, or it will return one byte data
-     *
-     * @note index from head if positive number given, or index from tail
-     *
-     * @param index index in int32_t
-     * @return int16_t
+     * @brief payload of typed array is item type and whole items
+     * 类型化数组的数据是元素类型和完整的元素
      */
-    inline int16_t operator[](const int32_t &index) const
+    static inline bool _isArrayPayload(const uint8_t *payload, uint32_t length)
     {
-        if (this->type == ETYPE_BUFFER || this->type == ETYPE_STRING)
+        uint8_t size = length ? Element::getItemSize((ElementType)payload[0]) : 0;
+        return size && !((length - 1) % size);
+    }
+
+    /**
+     * @brief validate children of list or map, keys of map must be strings
+     * 校验列表或映射的子元素，映射的键必须是字符串
+     */
+    bool _validateChildren(const uint8_t *buffer, uint32_t length, ElementType type, bool compact, uint8_t depth) const
+    {
+        if (depth >= ARRAY_BUFFER_MAX_DEPTH)
+            return false;
+
+        ElementView e;
+        uint32_t offset = 0, count = 0;
+
+        while (offset < length)
         {
-            if (index < this->data.buffer.bufferLength)
-            {
-                if (index > 0)
-                {
-                    return (this->data.buffer.p)[index];
-                }
-                else
-                {
-                    return (this->data.buffer.p)[this->data.buffer.bufferLength - index];
-                }
-            }
+            int32_t used = e.setFromOuterBuffer(buffer, offset, length, compact, depth + 1);
+            if (used < 0 || (type == ETYPE_MAP && !(count % 2) && e.getType() != ETYPE_STRING))
+                return false;
+            offset += used;
+            ++count;
         }
-        return -2;
+        return type != ETYPE_MAP || !(count % 2);
     }
 
+public:
+    inline ElementView() {}
+
     /**
-     * @brief get uint8_t data from buffer or string
+     * @brief parse one field from buffer, nothing will be copied
+     * 从数组中解析出一个字段，不会拷贝任何数据
      *
-     * @attention the return value is uint16_t, it doesn't mean
-     * data range from -32768 to 32767.
-     * return -2 means error, or it will return one byte data
-     *
-     * @note index from head if positive number given, or index from tail
-     *
-     * @param index index in Element
-     * @return int16_t
+     * @param buffer source buffer 源数组
+     * @param offset offset of type mark 类型标志的偏移量
+     * @param length total length of source buffer 源数组的总长度
+     * @param compact buffer is in compact mode 源数组使用紧凑模式
+     * @param depth nesting depth of this field, used internally 此字段的嵌套深度，内部使用
+     * @return int32_t length of whole field, -2 if data is malformed
+     * 整个字段的长度，数据格式错误时返回-2
      */
-    inline int16_t operator[](const Element &index) const
+    int32_t setFromOuterBuffer(const uint8_t *buffer, uint32_t offset, uint32_t length, bool compact = false, uint8_t depth = 0)
     {
-        if (this->type == ETYPE_BUFFER || this->type == ETYPE_STRING)
+        this->type = ETYPE_VOID;
+        this->field = this->p = nullptr;
+        this->length = 0;
+        this->compact = compact;
+
+        if (!buffer || offset >= length)
+            return -2;
+
+        uint32_t available = length - offset - 1;
+        uint32_t dataLen = 0;
+        int8_t mark = (int8_t)buffer[offset];
+
+        if (compact && mark != ETYPE_FLOAT && mark != ETYPE_DOUBLE)
         {
-            if (index.available())
+            uint64_t n = 0;
+            int32_t used = ArrayBufferVarint::read(buffer + offset + 1, available, &n);
+            if (used < 0)
+                return -2;
+
+            if (mark == ETYPE_STRING || mark == ETYPE_BUFFER || mark == ETYPE_LIST || mark == ETYPE_MAP ||
+                mark == ETYPE_ARRAY)
             {
-                int32_t i = index.getInt32();
-                if (i < this->data.buffer.bufferLength)
-                {
-                    if (i > 0)
-                    {
-                        return (this->data.buffer.p)[i];
-                    }
-                    else
-                    {
-                        return (this->data.buffer.p)[this->data.buffer.bufferLength - i];
-                    }
-                }
+                if (n > available - used ||
+                    (mark == ETYPE_STRING && (!n || buffer[offset + used + n])) ||
+                    (mark == ETYPE_ARRAY && !ElementView::_isArrayPayload(buffer + offset + 1 + used, n)) ||
+                    ((mark == ETYPE_LIST || mark == ETYPE_MAP) &&
+                     !this->_validateChildren(buffer + offset + 1 + used, n, (ElementType)mark, true, depth)))
+                    return -2;
+
+                this->type = (ElementType)mark;
+                this->field = buffer + offset;
+                this->p = buffer + offset + 1 + used;
+                this->length = n;
+                return (int32_t)(1 + used + n);
             }
+
+            // integer must fit in its type
+            // 整数必须在其类型的范围内
+            ElementData d;
+            bzero((uint8_t *)&d, sizeof(ElementData));
+            if (!ArrayBufferVarint::toData(n, (ElementType)mark, &d))
+                return -2;
+
+            this->type = (ElementType)mark;
+            this->field = buffer + offset;
+            this->p = buffer + offset + 1;
+            this->length = used;
+            return 1 + used;
         }
-        return -2;
-    }
 
-    // &=
+        switch (mark)
+        {
+        case ETYPE_UINT8:
+        case ETYPE_INT8:
+            dataLen = 1;
+            break;
+        case ETYPE_UINT16:
+        case ETYPE_INT16:
+            dataLen = 2;
+            break;
+        case ETYPE_UINT32:
+        case ETYPE_INT32:
+        case ETYPE_FLOAT:
+            dataLen = 4;
+            break;
+        case ETYPE_UINT64:
+        case ETYPE_INT64:
+        case ETYPE_DOUBLE:
+            dataLen = 8;
+            break;
+        case ETYPE_STRING:
+        case ETYPE_BUFFER:
+        case ETYPE_LIST:
+        case ETYPE_MAP:
+        case ETYPE_ARRAY:
+            if (available < 4)
+                return -2;
+            memcpy(&dataLen, buffer + offset + 1, 4);
+            available -= 4;
+
+            // string on wire always carries a trailing '\0'
+            // 传输中的字符串总是带有结尾的'\0'
+            if (dataLen > available ||
+                (mark == ETYPE_STRING && (!dataLen || buffer[offset + 5 + dataLen - 1])) ||
+                (mark == ETYPE_ARRAY && !ElementView::_isArrayPayload(buffer + offset + 5, dataLen)) ||
+                ((mark == ETYPE_LIST || mark == ETYPE_MAP) &&
+                 !this->_validateChildren(buffer + offset + 5, dataLen, (ElementType)mark, false, depth)))
+                return -2;
+
+            this->type = (ElementType)mark;
+            this->field = buffer + offset;
+            this->p = buffer + offset + 5;
+            this->length = dataLen;
+            return dataLen + 5;
+        default:
+            return -2;
+        }
 
-    inline uint8_t operator&=(const uint8_t &rvalue)
-    {
-        this->reset(ETYPE_UINT8);
-        this->data.u8 &= rvalue;
-        return this->data.u8;
-    }
-    inline int8_t operator&=(const int8_t &rvalue)
-    {
-        this->reset(ETYPE_INT8);
-        this->data.i8 &= rvalue;
-        return this->data.i8;
-    }
-    inline uint16_t operator&=(const uint16_t &rvalue)
-    {
-        this->reset(ETYPE_UINT16);
-        this->data.u16 &= rvalue;
-        return this->data.u16;
-    }
-    inline int16_t operator&=(const int16_t &rvalue)
-    {
-        this->reset(ETYPE_INT16);
-        this->data.i16 &= rvalue;
-        return this->data.i16;
-    }
-    inline uint32_t operator&=(const uint32_t &rvalue)
-    {
-        this->reset(ETYPE_UINT32);
-        this->data.u32 &= rvalue;
-        return this->data.u32;
-    }
+        if (dataLen > available)
+            return -2;
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    inline int operator&=(const int &rvalue)
-    {
-        this->reset(ETYPE_INT32);
-        this->data.i32 &= rvalue;
-        return this->data.i32;
+        this->type = (ElementType)mark;
+        this->field = buffer + offset;
+        this->p = buffer + offset + 1;
+        this->length = dataLen;
+        return dataLen + 1;
     }
-#endif
 
-    inline int32_t operator&=(const int32_t &rvalue)
-    {
-        this->reset(ETYPE_INT32);
-        this->data.i32 &= rvalue;
-        return this->data.i32;
-    }
-    inline uint64_t operator&=(const uint64_t &rvalue)
-    {
-        this->reset(ETYPE_UINT64);
-        this->data.u64 &= rvalue;
-        return this->data.u64;
-    }
-    inline int64_t operator&=(const int64_t &rvalue)
-    {
-        this->reset(ETYPE_INT64);
-        this->data.i64 &= rvalue;
-        return this->data.i64;
-    }
-    inline Element &operator&=(const Element &rvalue)
+    /**
+     * @brief same as Element::getType
+     * 与 Element::getType 相同
+     */
+    inline ElementType getType(bool isNumber = false) const
     {
-        this->data.i64 &= rvalue.getInt64();
-        return *this;
+        return isNumber ? ((this->type < 9)
+                               ? ETYPE_NUMBER
+                               : this->type)
+                        : (this->type);
     }
 
-    // |=
+    /**
+     * @brief get number, read from source buffer directly
+     * 获取数字，直接从源数组读取
+     */
+    inline uint8_t getUint8() const { return this->_load().u8; }
+    inline int8_t getInt8() const { return this->_load().i8; }
+    inline uint16_t getUint16() const { return this->_load().u16; }
+    inline int16_t getInt16() const { return this->_load().i16; }
+    inline uint32_t getUint32() const { return this->_load().u32; }
+    inline int32_t getInt32() const { return this->_load().i32; }
+    inline uint64_t getUint64() const { return this->_load().u64; }
+    inline int64_t getInt64() const { return this->_load().i64; }
+    inline float getFloat() const { return this->_load().f; }
+    inline double getDouble() const { return this->_load().d; }
 
-    inline uint8_t operator|=(const uint8_t &rvalue)
-    {
-        this->reset(ETYPE_UINT8);
-        this->data.u8 |= rvalue;
-        return this->data.u8;
-    }
-    inline int8_t operator|=(const int8_t &rvalue)
-    {
-        this->reset(ETYPE_INT8);
-        this->data.i8 |= rvalue;
-        return this->data.i8;
-    }
-    inline uint16_t operator|=(const uint16_t &rvalue)
-    {
-        this->reset(ETYPE_UINT16);
-        this->data.u16 |= rvalue;
-        return this->data.u16;
-    }
-    inline int16_t operator|=(const int16_t &rvalue)
-    {
-        this->reset(ETYPE_INT16);
-        this->data.i16 |= rvalue;
-        return this->data.i16;
-    }
-    inline uint32_t operator|=(const uint32_t &rvalue)
+    /**
+     * @brief same as Element::getNumber
+     * 与 Element::getNumber 相同
+     */
+    int64_t getNumber() const
     {
-        this->reset(ETYPE_UINT32);
-        this->data.u32 |= rvalue;
-        return this->data.u32;
+        ElementData d = this->_load();
+        switch (this->type)
+        {
+        case ETYPE_UINT8:
+            return (int64_t)d.u8;
+        case ETYPE_INT8:
+            return (int64_t)d.i8;
+        case ETYPE_UINT16:
+            return (int64_t)d.u16;
+        case ETYPE_INT16:
+            return (int64_t)d.i16;
+        case ETYPE_UINT32:
+            return (int64_t)d.u32;
+        case ETYPE_INT32:
+            return (int64_t)d.i32;
+        case ETYPE_UINT64:
+            return (int64_t)d.u64;
+        case ETYPE_INT64:
+            return (int64_t)d.i64;
+        case ETYPE_FLOAT:
+            return (int64_t)d.f;
+        case ETYPE_DOUBLE:
+            return (int64_t)d.d;
+        default:
+            return 0;
+        }
     }
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    inline int operator|=(const int &rvalue)
+    /**
+     * @brief same as Element::getUniversalDouble
+     * 与 Element::getUniversalDouble 相同
+     */
+    double getUniversalDouble() const
     {
-        this->reset(ETYPE_INT32);
-        this->data.i32 |= rvalue;
-        return this->data.i32;
+        ElementData d = this->_load();
+        switch (this->type)
+        {
+        case ETYPE_FLOAT:
+            return d.f;
+        case ETYPE_DOUBLE:
+            return d.d;
+        case ETYPE_UINT64:
+            return d.u64;
+        case ETYPE_INT64:
+            return d.i64;
+        default:
+            return (double)this->getNumber();
+        }
     }
-#endif
 
-    inline int32_t operator|=(const int32_t &rvalue)
-    {
-        this->reset(ETYPE_INT32);
-        this->data.i32 |= rvalue;
-        return this->data.i32;
-    }
-    inline uint64_t operator|=(const uint64_t &rvalue)
-    {
-        this->reset(ETYPE_UINT64);
-        this->data.u64 |= rvalue;
-        return this->data.u64;
-    }
-    inline int64_t operator|=(const int64_t &rvalue)
+    /**
+     * @brief get c string, pointer into source buffer
+     * 获取c字符串，指向源数组内部
+     *
+     * @return empty string if this field is not a string
+     * 如果字段不是字符串则返回空字符串
+     */
+    inline const char *c_str() const
     {
-        this->reset(ETYPE_INT64);
-        this->data.i64 |= rvalue;
-        return this->data.i64;
+        return this->type == ETYPE_STRING ? (const char *)this->p : "";
     }
-    inline Element &operator|=(const Element &rvalue)
+
+    /**
+     * @brief length of string without '\0'
+     * 字符串的长度，不包括'\0'
+     */
+    inline uint32_t getStringLength() const
     {
-        this->data.i64 |= rvalue.getInt64();
-        return *this;
+        return this->type == ETYPE_STRING ? this->length - 1 : 0;
     }
 
-    // ^=
-    inline uint8_t operator^=(const uint8_t &rvalue)
+    /**
+     * @brief this will allocate a String, use c_str if possible
+     * 这个函数会构造一个String，尽量使用 c_str
+     */
+    inline String getString() const
     {
-        this->reset(ETYPE_UINT8);
-        this->data.u8 ^= rvalue;
-        return this->data.u8;
+        return this->type == ETYPE_STRING ? String(this->c_str()) : String("");
     }
-    inline int8_t operator^=(const int8_t &rvalue)
+
+    /**
+     * @brief same as Element::getUint8Array, only for uint8 array
+     * 与 Element::getUint8Array 相同，仅适用于二进制数组
+     */
+    inline const uint8_t *getUint8Array(uint32_t *outLen = nullptr) const
     {
-        this->reset(ETYPE_INT8);
-        this->data.i8 ^= rvalue;
-        return this->data.i8;
+        if (outLen)
+            (*outLen) = this->type == ETYPE_BUFFER ? this->length : 0;
+        return this->type == ETYPE_BUFFER ? this->p : nullptr;
     }
-    inline uint16_t operator^=(const uint16_t &rvalue)
+
+    /**
+     * @brief get payload pointer anyway
+     * 无论如何都返回数据指针
+     */
+    inline const uint8_t *getRawBuffer(uint32_t *outLen = nullptr) const
     {
-        this->reset(ETYPE_UINT16);
-        this->data.u16 ^= rvalue;
-        return this->data.u16;
+        if (outLen)
+            (*outLen) = this->length;
+        return this->p;
     }
-    inline int16_t operator^=(const int16_t &rvalue)
+
+    inline uint32_t getRawBufferLength() const { return this->length; }
+
+    /**
+     * @brief pointer to this field in source buffer, starts with type mark
+     * 指向源数组中此字段的指针，以类型标志开头
+     */
+    inline const uint8_t *getOuterBuffer() const { return this->field; }
+
+    /**
+     * @brief length of this field on wire, including type mark
+     * 此字段在传输格式中的长度，包括类型标志
+     */
+    inline uint32_t getOuterBufferLength() const
     {
-        this->reset(ETYPE_INT16);
-        this->data.i16 ^= rvalue;
-        return this->data.i16;
+        return this->type == ETYPE_VOID ? 0 : (this->p - this->field) + this->length;
     }
-    inline uint32_t operator^=(const uint32_t &rvalue)
+
+    /**
+     * @brief field comes from a buffer in compact mode
+     * 字段来自紧凑模式的数组
+     */
+    inline bool isCompact() const { return this->compact; }
+
+    /**
+     * @brief children of list, or keys and values one after another of map, read in place
+     * 列表的子元素，或者映射中依次排列的键和值，直接在源数组上读取
+     *
+     * @return an invalid view if this field is not a list or map 字段不是列表或映射时返回无效的视图
+     */
+    inline ArrayBufferView getList() const;
+
+    /**
+     * @brief get value of map by key
+     * 按键获取映射的值
+     *
+     * @return a VOID view if not found or malformed 找不到或格式错误时返回VOID类型的视图
+     */
+    ElementView get(const char *key) const
     {
-        this->reset(ETYPE_UINT32);
-        this->data.u32 ^= rvalue;
-        return this->data.u32;
+        ElementView k, v;
+        if (this->type != ETYPE_MAP || !key)
+            return v;
+
+        uint32_t offset = 0;
+        while (offset < this->length)
+        {
+            int32_t keyLength = k.setFromOuterBuffer(this->p, offset, this->length, this->compact, 1);
+            if (keyLength < 0)
+                return ElementView();
+            offset += keyLength;
+
+            int32_t valueLength = v.setFromOuterBuffer(this->p, offset, this->length, this->compact, 1);
+            if (valueLength < 0)
+                return ElementView();
+            offset += valueLength;
+
+            if (!strcmp(k.c_str(), key))
+                return v;
+        }
+        return ElementView();
     }
 
-#if CONFIG_IDF_TARGET_ESP32C3
-    inline int operator^=(const int &rvalue)
+    inline bool isStringAvailable() const { return this->type == ETYPE_STRING && this->length > 1; }
+
+    inline bool isBufferAvailable(uint32_t equalLength = 0) const
     {
-        this->reset(ETYPE_INT32);
-        this->data.i32 ^= rvalue;
-        return this->data.i32;
+        return this->type == ETYPE_BUFFER &&
+               (!equalLength ? this->length > 0 : this->length == equalLength);
     }
-#endif
 
-    inline int32_t operator^=(const int32_t &rvalue)
+    /**
+     * @brief same as Element::getArray, items are read in place from source buffer
+     * 与 Element::getArray 相同，元素直接从源数组读取
+     */
+    template <class T>
+    inline ElementArrayView<T> getArray() const
     {
-        this->reset(ETYPE_INT32);
-        this->data.i32 ^= rvalue;
-        return this->data.i32;
+        return this->getArrayType() == ElementNumber::typeOf<T>()
+                   ? ElementArrayView<T>(this->p + 1, (this->length - 1) / sizeof(T))
+                   : ElementArrayView<T>();
     }
-    inline uint64_t operator^=(const uint64_t &rvalue)
+
+    inline ElementType getArrayType() const
     {
-        this->reset(ETYPE_UINT64);
-        this->data.u64 ^= rvalue;
-        return this->data.u64;
+        return this->type == ETYPE_ARRAY ? (ElementType)this->p[0] : ETYPE_VOID;
     }
-    inline int64_t operator^=(const int64_t &rvalue)
+    inline uint32_t getArrayLength() const
     {
-        this->reset(ETYPE_INT64);
-        this->data.i64 ^= rvalue;
-        return this->data.i64;
+        return this->type == ETYPE_ARRAY ? (this->length - 1) / Element::getItemSize((ElementType)this->p[0]) : 0;
     }
-    inline Element &operator^=(const Element &rvalue)
+
+    /**
+     * @brief make an owning copy in an Element
+     * 拷贝到一个 Element 中
+     *
+     * @return true success 成功
+     */
+    inline bool copyTo(Element *e) const
     {
-        this->data.i64 ^= rvalue.getInt64();
-        return *this;
+        if (!e || this->type == ETYPE_VOID)
+            return false;
+        return e->setFromOuterBuffer((uint8_t *)this->field, 0, this->getOuterBufferLength(), this->compact) > 0;
     }
+};
 
-    // operators
+/**
+ * @brief non-owning reader of an encoded buffer, walks the wire format in place
+ * the whole buffer is validated once on construction, so every field access after that is bounds-safe
+ * nothing is allocated, the source buffer must outlive the view
+ *
+ * 编码后二进制数组的只读视图，直接在原数组上遍历
+ * 构造时会对整个数组进行一次校验，之后所有字段访问都是安全的
+ * 不分配任何内存，源数组的生命周期必须长于视图
+ */
+class ArrayBufferView
+{
+private:
+    const uint8_t *data = nullptr;
+    uint32_t length = 0;
 
-    String replace(const char *target, const char *newContent)
+    /**
+     * @brief number of fields, 0 if buffer is malformed
+     * 字段数量，数组格式错误时为0
+     */
+    uint32_t count = 0;
+
+    bool valid = false;
+
+    /**
+     * @brief buffer is in compact mode, fields start after the mark
+     * 数组使用紧凑模式，字段从标志之后开始
+     */
+    bool compact = false;
+    uint32_t start = 0;
+
+    /**
+     * @brief cached offsets of first N fields
+     * 前N个字段的偏移量缓存
+     */
+    uint32_t offsets[ARRAY_BUFFER_VIEW_INDEX_CAPACITY];
+
+    /**
+     * @brief validate fields from start and cache their offsets
+     * 从起始位置校验字段并缓存偏移量
+     */
+    void _index()
     {
-        if (this->type == ETYPE_STRING)
+        if (!this->data)
+            return;
+
+        uint32_t offset = this->start;
+        ElementView e;
+
+        while (offset < this->length)
         {
-            String tmp = this->getString();
-            tmp.replace(target, newContent);
-            this->_setString(tmp.c_str());
-            return tmp;
+            int32_t fieldLength = e.setFromOuterBuffer(this->data, offset, this->length, this->compact);
+            if (fieldLength < 0)
+            {
+                ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "malformed buffer at offset: %u", offset);
+                this->count = 0;
+                return;
+            }
+            if (this->count < ARRAY_BUFFER_VIEW_INDEX_CAPACITY)
+                this->offsets[this->count] = offset;
+            offset += fieldLength;
+            ++this->count;
         }
-        return "";
-    }
 
-    String replace(const String &target, const char *newContent)
-    {
-        return this->replace(target.c_str(), newContent);
+        this->valid = this->count > 0;
     }
 
-    inline const char *
-    c_str() const
+public:
+    /**
+     * @brief forward cursor over fields
+     * 字段的前向游标
+     */
+    class Cursor
     {
-        if (this->type == ETYPE_STRING)
-            return (const char *)(this->data.buffer.p);
-        return "";
-    }
+    private:
+        const ArrayBufferView *view;
+        uint32_t offset;
+        ElementView current;
 
-    inline int indexOf(const String &target) const
-    {
-        if (this->type == ETYPE_STRING)
-            return this->getString().indexOf(target);
-        return -2;
-    }
-    inline int indexOf(const char &target) const
+    public:
+        Cursor(const ArrayBufferView *view, uint32_t offset) : view(view), offset(offset)
+        {
+            if (this->offset < this->view->length)
+                this->current.setFromOuterBuffer(this->view->data, this->offset, this->view->length, this->view->compact);
+        }
+        inline const ElementView &operator*() const { return this->current; }
+        inline const ElementView *operator->() const { return &(this->current); }
+        inline Cursor &operator++()
+        {
+            this->offset += this->current.getOuterBufferLength();
+            if (this->offset < this->view->length)
+                this->current.setFromOuterBuffer(this->view->data, this->offset, this->view->length, this->view->compact);
+            return *this;
+        }
+        inline bool operator!=(const Cursor &other) const { return this->offset != other.offset; }
+        inline bool operator==(const Cursor &other) const { return this->offset == other.offset; }
+    };
+
+    /**
+     * @brief validate buffer and index fields
+     * 校验数组并建立字段索引
+     *
+     * @param data encoded buffer 编码后的二进制数组
+     * @param length length of buffer 数组长度
+     */
+    ArrayBufferView(const uint8_t *data, uint32_t length) : data(data), length(length)
     {
-        if (this->type == ETYPE_STRING)
-            for (uint32_t i = 0; i < this->data.buffer.bufferLength; ++i)
-                if (target == (this->data.buffer.p)[i])
-                    return i;
+        if (!data || !length)
+            return;
 
-        return -2;
-    }
+        // checksum is verified before any field is read, trailer is not part of fields
+        // 在读取任何字段之前校验CRC32，结尾的校验值不属于字段
+        if (data[0] == ARRAY_BUFFER_CHECKED_MARK)
+        {
+            if (!ArrayBuffer::verifyChecksum(data, length))
+            {
+                ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "checksum mismatch");
+                return;
+            }
+            this->length -= 4;
+            this->start = 1;
+        }
 
-    inline int lastIndexOf(const String &target) const
-    {
-        if (this->type == ETYPE_STRING)
-            return this->getString().lastIndexOf(target);
-        return -2;
+        // fields of sorted map are in normal mode, offset table is skipped
+        // 排序映射的字段使用普通模式，跳过偏移量表
+        if (data[this->start] == ARRAY_BUFFER_SORTED_MARK)
+        {
+            uint32_t headerLength = ArrayBuffer::getSortedHeaderLength(data + this->start, this->length - this->start);
+            if (!headerLength)
+                return;
+            this->start += headerLength;
+            this->_index();
+            return;
+        }
+
+        this->compact = data[this->start] == ARRAY_BUFFER_COMPACT_MARK;
+        this->start += this->compact ? 1 : 0;
+        this->_index();
     }
-    inline int lastIndexOf(const char &target) const
+
+    /**
+     * @brief view over payload of a list or map, which has no compact mark ahead
+     * 列表或映射的数据的视图，数据前面没有紧凑模式的标志
+     *
+     * @param compact payload is in compact mode 数据使用紧凑模式
+     */
+    ArrayBufferView(const uint8_t *data, uint32_t length, bool compact)
+        : data(data), length(length), compact(compact)
     {
-        if (this->type == ETYPE_STRING)
-            for (uint32_t i = this->data.buffer.bufferLength - 1; i >= 0; --i)
-                if (target == (this->data.buffer.p)[i])
-                    return i;
-        return -2;
+        this->_index();
     }
 
     /**
-     * @brief deconstructor, it will clean buffer automatically
-     * 析构函数， 它会调用清理缓存的函数
+     * @brief buffer is well formed and not empty
+     * 数组格式正确且不为空
      */
-    ~Element()
+    inline bool isValid() const { return this->valid; }
+
+    inline uint32_t size() const { return this->count; }
+
+    inline bool isCompact() const { return this->compact; }
+
+    /**
+     * @brief offset of first field and end of last field in source buffer, marks and trailer are excluded
+     * 第一个字段在源数组中的偏移量和最后一个字段的结尾，不包括标志和结尾的校验值
+     */
+    inline uint32_t getFieldsOffset() const { return this->start; }
+    inline uint32_t getFieldsEnd() const { return this->length; }
+
+    /**
+     * @brief get field by index, returns a VOID view if out of range
+     * 按索引获取字段，越界时返回VOID类型的视图
+     */
+    ElementView at(uint32_t index) const
     {
-        // ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "object de, address: %x", this);
+        ElementView e;
+        if (index >= this->count)
+            return e;
 
-        // clear buffer if buffer is copied from other places
-        // 如果buffer是从其他位置拷贝的就清除buffer
-        if (this->copiedBuffer)
+        uint32_t i = index < ARRAY_BUFFER_VIEW_INDEX_CAPACITY ? index : ARRAY_BUFFER_VIEW_INDEX_CAPACITY - 1;
+        uint32_t offset = this->offsets[i];
+
+        for (;;)
         {
-            this->clearBuffer();
+            offset += e.setFromOuterBuffer(this->data, offset, this->length, this->compact);
+            if (i == index)
+                break;
+            ++i;
         }
+        return e;
     }
 
+    inline ElementView operator[](uint32_t index) const { return this->at(index); }
+
+    inline Cursor begin() const { return Cursor(this, this->start); }
+    inline Cursor end() const { return Cursor(this, this->valid ? this->length : this->start); }
+};
+
+/**
+ * @brief lookup in a buffer made by ArrayBuffer::createSortedArrayBuffer, binary search on offset table,
+ * only the header is checked on construction, each probed key and the value found are checked when read,
+ * so a lookup touches O(log n) fields and nothing else, the buffer may be memory mapped flash
+ * nothing is allocated, the source buffer must outlive the view
+ *
+ * 在 ArrayBuffer::createSortedArrayBuffer 生成的数组中查找，对偏移量表进行二分查找，
+ * 构造时只校验头部，每个被查看的键和找到的值在读取时校验，
+ * 所以一次查找只访问 O(log n) 个字段，数组可以是映射到内存中的flash
+ * 不分配任何内存，源数组的生命周期必须长于视图
+ *
+ * @example
+ * ArrayBufferSortedView config(blob, blobLength);
+ * uint16_t port = config.get("websocketPort").getUint16();
+ */
+class ArrayBufferSortedView
+{
+private:
     /**
-     * @brief get current type of data that object stored
-     * 获取当前对象存储的数据类型
-     *
-     * @param isNumber will return NUMBER if give argument a true, if current object hold a number
-     * 参数传true如果当前对象存储了数字只会告诉你类型是NUMBER
-     *
-     * @return the data type that current object stored
-     * 当前对象中存储的数据的数据类型
+     * @brief first field, offsets count from here
+     * 第一个字段，偏移量从这里开始计算
      */
-    ElementType getType(bool isNumber = false) const
+    const uint8_t *data = nullptr;
+    uint32_t length = 0;
+
+    const uint8_t *offsets = nullptr;
+    uint32_t count = 0;
+    uint8_t width = 0;
+
+    inline uint32_t _offset(uint32_t index) const
     {
-        return isNumber ? ((this->type < 9)
-                               ? ETYPE_NUMBER
-                               : this->type)
-                        : (this->type);
+        uint32_t offset = 0;
+        memcpy(&offset, this->offsets + index * this->width, this->width);
+        return offset;
+    }
+
+public:
+    ArrayBufferSortedView(const uint8_t *data, uint32_t length)
+    {
+        uint32_t headerLength = ArrayBuffer::getSortedHeaderLength(data, length);
+        if (!headerLength)
+            return;
+
+        memcpy(&(this->count), data + 1, 4);
+        this->width = data[5];
+        this->offsets = data + 6;
+        this->data = data + headerLength;
+        this->length = length - headerLength;
     }
 
     /**
-     * @brief get number
-     * 获取存储的数字
-     *
-     * @return stored number
+     * @brief header and offset table are well formed
+     * 头部和偏移量表格式正确
      */
-    inline uint8_t getUint8() const { return (uint8_t)this->data.u8; }
-    inline int8_t getInt8() const { return (uint8_t)this->data.i8; }
-    inline uint16_t getUint16() const { return (uint16_t)this->data.u16; }
-    inline int16_t getInt16() const { return (uint16_t)this->data.i16; }
-    inline uint32_t getUint32() const { return (uint32_t)this->data.u32; }
-    inline int32_t getInt32() const { return (uint32_t)this->data.i32; }
-    inline uint64_t getUint64() const { return this->data.u64; }
-    inline int64_t getInt64() const { return this->data.i64; }
-    inline float getFloat() const { return this->data.f; }
-    inline double getDouble() const { return this->data.d; }
+    inline bool isValid() const { return this->offsets != nullptr; }
+
+    inline uint32_t size() const { return this->count; }
 
     /**
-     * @brief get string
-     * will return hex string if current object stored uint8 array(not string)
-     * you could remove it if you like
-     *
-     * 获取存储的字符串
-     * 如果当前对象存储的是一个二进制数组，则默认会返回它的十六进制字符串
-     * 不想要的话可以去掉
+     * @brief key and value of an entry by index, keys are in ascending order
+     * 按索引获取条目的键和值，键按升序排列
      *
-     * @return stored string
+     * @return a VOID view if out of range or malformed 越界或格式错误时返回VOID类型的视图
      */
-    inline String getString() const
+    ElementView keyAt(uint32_t index) const
     {
-        // ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "get string");
-        return (this->type == ETYPE_STRING) ? (this->data.buffer.p ? (String((const char *)this->data.buffer.p)) : (String("")))
-                                            : ((this->type == ETYPE_BUFFER) ? (this->getHex()) : (String("")));
+        ElementView k;
+        if (index >= this->count || k.setFromOuterBuffer(this->data, this->_offset(index), this->length) < 0 ||
+            k.getType() != ETYPE_STRING)
+            return ElementView();
+        return k;
     }
 
-    /**
-     * @brief the following two functions have same behavior when storing uint8 array
-     * but the first one will check type equals to uint8 array or not
-     * or it will return nullptr
-     *
-     * 下面这俩函数当 当前对象存储的是二进制数组的时候没有区别
-     * 但是第一个函数会检查对象存储的数据类型，不是二进制数组类型会返回空指针
-     * (其实是一开始字符串用String存的，所以有很多地方用了getUint8Array，后来才改成都用buffer存的，
-     * 但是这个我才不告诉你)
-     *
-     * @param outLen length of uint8 array stored in object 对象存储的二进制数组的长度
+    ElementView at(uint32_t index) const
+    {
+        ElementView k, v;
+        if (index >= this->count)
+            return v;
+        uint32_t offset = this->_offset(index);
+        int32_t used = k.setFromOuterBuffer(this->data, offset, this->length);
+        if (used < 0 || v.setFromOuterBuffer(this->data, offset + used, this->length) < 0)
+            return ElementView();
+        return v;
+    }
+
+    /**
+     * @brief get value by key
+     * 按键获取值
      *
-     * @return stored uint8 array 存储的二进制数组
+     * @return a VOID view if not found or malformed 找不到或格式错误时返回VOID类型的视图
      */
-    inline uint8_t *getUint8Array(uint32_t *outLen = nullptr) const
+    ElementView get(const char *key) const
     {
-        if (this->type == ETYPE_BUFFER)
-        {
-            if (outLen)
-                (*outLen) = this->data.buffer.bufferLength;
-            return (uint8_t *)(this->data.buffer.p);
-        }
-        else
+        if (!key)
+            return ElementView();
+
+        uint32_t low = 0, high = this->count;
+        while (low < high)
         {
-            if (outLen)
-                (*outLen) = 0;
-            return nullptr;
+            uint32_t middle = low + (high - low) / 2;
+            ElementView k = this->keyAt(middle);
+            if (k.getType() != ETYPE_STRING)
+                return ElementView();
+
+            int c = strcmp(k.c_str(), key);
+            if (!c)
+                return this->at(middle);
+            if (c < 0)
+                low = middle + 1;
+            else
+                high = middle;
         }
+        return ElementView();
     }
+};
+
+inline ArrayBufferView ElementView::getList() const
+{
+    if (this->type != ETYPE_LIST && this->type != ETYPE_MAP)
+        return ArrayBufferView(nullptr, 0, false);
+    return ArrayBufferView(this->p, this->length, this->compact);
+}
+
+#ifndef ARRAY_BUFFER_WRITER_STAGING_SIZE
+// staging buffer of ArrayBufferWriter, small fields are merged here before
+// being handed to sink, payloads larger than this go to sink directly
+// ArrayBufferWriter 的暂存缓冲区，较小的字段会先合并到这里再交给输出端
+// 比它大的数据会直接交给输出端
+#define ARRAY_BUFFER_WRITER_STAGING_SIZE 64
+#endif
+
+#ifndef ARRAY_BUFFER_WRITER_FILE_CHUNK_SIZE
+// payload of ETYPE_FILE Element is read part by part into a buffer of this size on stack,
+// so any length of it is written with constant memory
+// ETYPE_FILE 类型Element的数据分段读取到栈上这个大小的缓冲区中，
+// 所以任意长度的数据都只使用固定大小的内存写入
+#define ARRAY_BUFFER_WRITER_FILE_CHUNK_SIZE 256
+#endif
+
+/**
+ * @brief sink of ArrayBufferWriter, return false to stop writing
+ * ArrayBufferWriter 的输出端，返回false会停止写入
+ */
+typedef std::function<bool(const uint8_t *data, uint32_t length)> ArrayBufferSink;
+
+/**
+ * @brief streaming encoder, produces same bytes as ArrayBuffer::createArrayBuffer
+ * but emits fields into a sink instead of allocating the whole message,
+ * peak RAM is bounded by the staging buffer
+ *
+ * 流式编码器，输出与 ArrayBuffer::createArrayBuffer 完全相同
+ * 但是会把字段写入输出端，而不是分配整个消息的内存
+ * 内存峰值仅为暂存缓冲区的大小
+ */
+class ArrayBufferWriter
+{
+private:
+    ArrayBufferSink sink = nullptr;
+
+    uint8_t staging[ARRAY_BUFFER_WRITER_STAGING_SIZE];
 
     /**
-     * @brief convert data type in current object from String(hex format) to uint8 array
-     * will update buffer stored in current object
-     *
-     * 把当前对象存储的16进制字符串转换为二进制数组，更新当前对象的buffer
-     *
-     * @return true: 当前对象存储了格式正确的16进制字符串且转换无错误
-     * @return false: 当前对象存储了错误的16进制字符串或转换过程中存在错误
+     * @brief bytes in staging buffer
+     * 暂存缓冲区中的字节数
      */
-    bool convertHexStringIntoUint8Array()
-    {
-        // check type and length 检查类型和长度
-        if (this->type != ETYPE_STRING || (!this->data.buffer.p) || (!this->data.buffer.bufferLength))
-            return false;
+    uint32_t used = 0;
 
-        // get original length
-        // 获取原始长度
-        uint32_t originalLength = this->getString().length();
+    /**
+     * @brief bytes already handed to sink
+     * 已经交给输出端的字节数
+     */
+    uint64_t written = 0;
+
+    bool error = false;
+
+    /**
+     * @brief write in compact mode, mark is written before first field
+     * 使用紧凑模式写入，标志会在第一个字段之前写入
+     */
+    bool compact = false;
+    bool headerPending = false;
+
+    /**
+     * @brief CRC32 trailer is written by finish, crc covers every byte emitted before it
+     * CRC32结尾由 finish 写入，crc 覆盖之前写出的所有字节
+     */
+    bool checked = false;
+    uint32_t crc = 0;
 
-        // the length of hex string must be mutiple times of 2
-        // 16进制字符串的长度必须是2的整数倍
-        if (originalLength % 2)
+    inline bool _writeHeader()
+    {
+        if (!this->headerPending)
+            return true;
+        this->headerPending = false;
+        uint8_t marks[2];
+        uint32_t length = 0;
+        if (this->checked)
+            marks[length++] = ARRAY_BUFFER_CHECKED_MARK;
+        if (this->compact)
+            marks[length++] = ARRAY_BUFFER_COMPACT_MARK;
+        return this->_emit(marks, length);
+    }
+
+    bool _emit(const uint8_t *data, uint32_t length)
+    {
+        if (this->error)
             return false;
 
-        // length after convert
-        // 转换后的长度
-        uint32_t len = originalLength / 2;
+        if (this->checked)
+            this->crc = mycrypto::CRC32::update(this->crc, data, length);
+
+        if (this->used + length <= ARRAY_BUFFER_WRITER_STAGING_SIZE)
+        {
+            memcpy(this->staging + this->used, data, length);
+            this->used += length;
+            return true;
+        }
 
-        int tmp = 0;
+        if (!this->_flushStaging())
+            return false;
 
-        // start converting
-        // 开始转换
-        for (uint32_t i = 0, k = 0; i < originalLength; i += 2)
+        if (length <= ARRAY_BUFFER_WRITER_STAGING_SIZE)
         {
-            sscanf((const char *)((this->data.buffer.p) + i), "%02x", &tmp);
-            (this->data.buffer.p)[k] = (uint8_t)tmp;
-            ++k;
+            memcpy(this->staging, data, length);
+            this->used = length;
+            return true;
         }
 
-        // modify type 修改类型
-        this->type = ETYPE_BUFFER;
+        // large payload goes to sink directly, no copy
+        // 大块数据直接交给输出端，不拷贝
+        if (!this->sink(data, length))
+        {
+            this->error = true;
+            return false;
+        }
+        this->written += length;
+        return true;
+    }
 
-        // modify length 修改长度
-        this->data.buffer.bufferLength = len;
+    bool _flushStaging()
+    {
+        if (this->error)
+            return false;
 
+        if (this->used)
+        {
+            if (!this->sink(this->staging, this->used))
+            {
+                this->error = true;
+                return false;
+            }
+            this->written += this->used;
+            this->used = 0;
+        }
         return true;
     }
 
+public:
     /**
-     * @brief this function get raw buffer anyway
-     * 这个函数无论如何都会返回缓存的指针
-     *
-     * @param outLen length of uint8 array stored in object 存储的数组的长度
-     *
-     * @return uint8 array 存储的数组
+     * @param sink where encoded bytes go 编码后的数据的去向
+     * @param compact same output as ArrayBuffer::createCompactArrayBuffer
+     * 输出与 ArrayBuffer::createCompactArrayBuffer 相同
+     * @param checked same output as ArrayBuffer::createCheckedArrayBuffer, trailer is written by finish
+     * 输出与 ArrayBuffer::createCheckedArrayBuffer 相同，结尾的校验值由 finish 写入
      */
-    inline uint8_t *getRawBuffer(uint32_t *outLen = nullptr) const
+    ArrayBufferWriter(ArrayBufferSink sink, bool compact = false, bool checked = false)
+        : sink(sink), compact(compact), headerPending(compact || checked), checked(checked)
     {
-        if (outLen)
-            (*outLen) = this->data.buffer.bufferLength;
-
-        return (this->data.buffer.p);
+        if (!this->sink)
+            this->error = true;
     }
 
     /**
-     * @brief get length of uint8 array if current object stroed uint8 array
-     * will return 0 if object stored other type data
-     *
-     * 获取二进制数组的长度，当且仅当存储的数据类型是二进制数组的时候才返回长度，否则返回0
-     *
-     * @return length of uint8 array 存储的数组的长度
+     * @brief message is finished automatically
+     * 析构时会自动结束消息
      */
-    inline uint32_t getU8aLen() const { return this->type == ETYPE_BUFFER ? this->data.buffer.bufferLength : 0; }
+    ~ArrayBufferWriter() { this->finish(); }
 
     /**
-     * @brief more simply way to get number, return int64_t
-     *
-     * 更方便的方式去获取存储的数字, 返回类型为int64_t
+     * @brief encode one element
+     * 编码一个元素
      *
-     * @return stored number 存储的数字
+     * @return false if element is empty or sink failed 元素为空或输出端失败时返回false
      */
-    inline int64_t getNumber() const
+    bool write(const Element &e)
     {
-        if (this->type < 9)
+        // type mark and a varint takes 11 bytes at most
+        // 类型标志加变长编码最多11个字节
+        uint8_t header[11];
+        uint32_t offset = 0;
+
+        if (!e.getOuterBufferLength() || !this->_writeHeader())
+            return false;
+
+        if (e.getType() == ETYPE_LIST || e.getType() == ETYPE_MAP)
         {
-            switch (this->type)
+            // children are written one by one, nothing is encoded ahead
+            // 子元素逐个写入，不会预先编码
+            if (!this->writeHeader(e.getType(), e.getChildrenOuterBufferLength(this->compact)))
+                return false;
+
+            const Elements *children = e.getList();
+            uint32_t step = e.getType() == ETYPE_MAP ? 2 : 1;
+            for (uint32_t i = 0; i + step <= children->size(); i += step)
             {
-            case ETYPE_UINT8:
-                return (int64_t)this->data.u8;
-            case ETYPE_INT8:
-                return (int64_t)this->data.i8;
-            case ETYPE_UINT16:
-                return (int64_t)this->data.u16;
-            case ETYPE_INT16:
-                return (int64_t)this->data.i16;
-            case ETYPE_UINT32:
-                return (int64_t)this->data.u32;
-            case ETYPE_INT32:
-                return (int64_t)this->data.i32;
-            case ETYPE_UINT64:
-                return (int64_t)this->data.u64;
-            case ETYPE_INT64:
-                return (int64_t)this->data.i64;
-            case ETYPE_FLOAT:
-                return (int64_t)this->data.f;
-            case ETYPE_DOUBLE:
-                return (int64_t)this->data.d;
+                // skipped as Element::pack does
+                // 与 Element::pack 一样跳过
+                if (!children->at(i)->getOuterBufferLength(this->compact) ||
+                    (step == 2 && !children->at(i + 1)->getOuterBufferLength(this->compact)))
+                    continue;
+                if (!this->write(children->at(i)) || (step == 2 && !this->write(children->at(i + 1))))
+                    return false;
             }
+            return true;
         }
-        return 0;
-    }
 
-    /**
-     * @brief directly set raw uint8 array, attention attached
-     * 直接设置/更改当前对象存储一个二进制数组, 请阅读注意事项
-     *
-     * @attention THIS FUNCTION WILL CLEAN BUFFER AUTOMATICALLY
-     * 这个函数会清理缓存(如果对象原来存储了二进制数组或者字符串，那就被清理了)
-     *
-     * @param data new uint8 array pointer 新的二进制数组指针
-     * @param length length of new uint8 array 新的二进制数组的长度
-     */
-    inline bool setUint8Array(uint8_t *data, uint64_t length)
-    {
-        if (!data || !length)
+        if (e.getType() == ETYPE_FILE)
         {
-            return false;
+            // written as uint8 array, payload is streamed from source
+            // 作为二进制数组写入，数据从数据源流式读取
+            uint32_t length = e.getRawBufferLength();
+            if (!this->writeHeader(ETYPE_BUFFER, length))
+                return false;
+
+            uint8_t chunk[ARRAY_BUFFER_WRITER_FILE_CHUNK_SIZE];
+            for (uint32_t done = 0; done < length;)
+            {
+                uint32_t part = length - done < ARRAY_BUFFER_WRITER_FILE_CHUNK_SIZE ? length - done : ARRAY_BUFFER_WRITER_FILE_CHUNK_SIZE;
+                if (!e.getFileSource()->read(done, chunk, part))
+                {
+                    ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "read file failed, offset: %u", done);
+                    this->error = true;
+                    return false;
+                }
+                if (!this->_emit(chunk, part))
+                    return false;
+                done += part;
+            }
+            return true;
         }
-        this->reset(ETYPE_BUFFER);
-        return this->_copyBuffer(data, length, 0);
-    }
 
-    /**
-     * @brief get hex string if this object stored raw uint8 array
-     * will return String if current object holds a string
-     * you could remove it if you like
-     *
-     * 获取当前对象中存储的二进制数组的十六进制字符串
-     * 如果存的就是个字符串就会直接返回这个字符串
-     * (其实是一开始调试的时候sha256直接存的十六进制字符串，后来才改成32字节二进制数组，
-     * 我肯定是不会告诉你这个的)
-     *
-     * @param lowerCase lower case or upper case of output hex string
-     * 16进制字符串的大小写
-     *
-     * @return hex string of uint8 array 二进制数组的16进制字符串
-     */
-    String getHex(bool lowerCase = true) const
-    {
-        if (this->type != ETYPE_BUFFER)
+        if (e.getType() == ETYPE_STRING || e.getType() == ETYPE_BUFFER || e.getType() == ETYPE_ARRAY)
         {
-            if (this->type == ETYPE_STRING)
+            uint32_t length = 0;
+            const uint8_t *p = e.getRawBuffer(&length);
+
+            // item type leads payload of typed array
+            // 元素类型位于类型化数组的数据开头
+            uint32_t extra = e.getType() == ETYPE_ARRAY ? 1 : 0;
+            header[0] = (uint8_t)e.getType();
+            if (this->compact)
             {
-                // sometimes current object already stored a hex string, then return it directly
-                // you could delete this part if you like
-                // 有时候当前对象存储的已经是个16进制字符串就直接返回它
-                // 不想要这部分可以删除
-                return this->getString();
+                offset = 1 + ArrayBufferVarint::write(header + 1, length + extra);
             }
             else
             {
-                // return empty string when current object stored data is neither uint8 array or string
-                // 如果当前对象存储的既不是字节数组或字符串就返回空字符串
-                return String("");
+                uint32_t outerLength = length + extra;
+                memcpy(header + 1, &outerLength, 4);
+                offset = 5;
             }
+            if (extra)
+                header[offset++] = (uint8_t)e.getArrayType();
+            return this->_emit(header, offset) && (!length || this->_emit(p, length));
         }
 
-        // define return length( length of uint8 array * 2 + 1('\0'))
-        // 定义返回长度(字节数组的长度 * 2 + 1('\0'))
-        uint32_t length = (this->data.buffer.bufferLength * 2) + 1;
+        if (!e.pack(header, &offset, this->compact))
+            return false;
 
-        // define buffer 定义buffer
-        // attention: this buffer is decleared and defined in stack
-        // so you shouldn't convert a large uint8 array
-        // 注意: 这个缓存声明定义在栈，所以不要转换巨大的字节数组
-        char buf[length] = {0};
+        return this->_emit(header, offset);
+    }
 
-        // format 格式
-        char hexCase[5] = {'%', '0', '2', 'x', '\0'};
+    inline bool write(const Element *e) { return e ? this->write(*e) : false; }
 
-        if (!lowerCase)
+    bool write(const Elements *elements)
+    {
+        if (!elements)
+            return false;
+        for (auto it = elements->begin(); it != elements->end(); ++it)
         {
-            hexCase[3] = 'X';
+            // empty element is skipped as createArrayBuffer does
+            // 与 createArrayBuffer 一样跳过空元素
+            if ((*it)->getOuterBufferLength() && !this->write(*it))
+                return false;
         }
+        return true;
+    }
 
-        // genereate hex string
-        // 生成16进制字符串
-        for (uint32_t i = 0; i < this->data.buffer.bufferLength; i++)
+    bool write(const ElementList *elements)
+    {
+        if (!elements)
+            return false;
+        for (const Element &e : *elements)
         {
-            sprintf(buf + (i * 2), hexCase, (this->data.buffer.p)[i]);
+            if (e.getOuterBufferLength() && !this->write(e))
+                return false;
         }
+        return true;
+    }
 
-        return String(buf);
+    bool write(std::initializer_list<Element> list)
+    {
+        for (const auto &i : list)
+        {
+            if (i.getOuterBufferLength() && !this->write(i))
+                return false;
+        }
+        return true;
     }
 
     /**
-     * @brief get length of raw buffer whether object stored string or uint8 array
-     * 直接获取原始buffer的长度
-     *
-     * @return length of raw uint8 array 缓存长度
+     * @brief copy a field from another buffer without decoding
+     * field in different mode is decoded and encoded again
+     * 不解码，直接转发另一个数组中的字段
+     * 模式不同的字段会被解码后重新编码
      */
-    uint32_t getRawBufferLength() const
+    inline bool write(const ElementView &e)
     {
-        return this->data.buffer.bufferLength;
-    }
+        if (!e.getOuterBufferLength())
+            return false;
 
-    bool isStringAvailable() const { return this->type == ETYPE_STRING && this->data.buffer.bufferLength > 1; }
+        if (e.isCompact() != this->compact)
+        {
+            Element element;
+            return e.copyTo(&element) && this->write(element);
+        }
 
-    bool isBufferAvailable(uint32_t equalLength = 0) const
-    {
-        return this->type == ETYPE_BUFFER &&
-               this->data.buffer.p &&
-               (!equalLength ? this->data.buffer.bufferLength > 0 : this->data.buffer.bufferLength == equalLength);
+        return this->_writeHeader() && this->_emit(e.getOuterBuffer(), e.getOuterBufferLength());
     }
 
     /**
-     * @brief encode with Base64
-     * 用 Base64 编码
-     *
-     * @note this function only fits in buffer and string
-     * 仅字符串和二进制数组适用此函数
+     * @brief write type mark and length of a string, uint8 array, list, map or typed array,
+     * its payload must be written right after this by other calls,
+     * payload of typed array starts with item type
+     * 写入字符串、二进制数组、列表、映射或类型化数组的类型标志和长度，
+     * 其数据必须紧接着通过其他调用写入，
+     * 类型化数组的数据以元素类型开头
      *
-     * @param replaceOrigin replace origin or not; 是否替换原有内容
-     * @return String Base64 encoded
+     * @param type type of field 字段类型
+     * @param length length of payload 数据的长度
      */
-    String toBase64(bool replaceOrigin = false)
+    bool writeHeader(ElementType type, uint32_t length)
     {
-        String b64 = "";
-        if (this->type == ETYPE_STRING || this->type == ETYPE_BUFFER)
+        if (type != ETYPE_STRING && type != ETYPE_BUFFER && type != ETYPE_LIST && type != ETYPE_MAP &&
+            type != ETYPE_ARRAY)
+            return false;
+
+        if (!this->_writeHeader())
+            return false;
+
+        uint8_t header[6];
+        uint32_t offset = 1;
+        header[0] = (uint8_t)type;
+        if (this->compact)
         {
-            b64 = mycrypto::Base64::base64Encode(this->data.buffer.p,
-                                                 (this->type == ETYPE_STRING ? this->data.buffer.bufferLength - 1
-                                                                             : this->data.buffer.bufferLength));
-            if (replaceOrigin)
-            {
-                this->_setString(b64);
-            }
+            offset += ArrayBufferVarint::write(header + 1, length);
         }
-        return b64;
+        else
+        {
+            memcpy(header + 1, &length, 4);
+            offset += 4;
+        }
+        return this->_emit(header, offset);
     }
 
     /**
-     * @brief deocde with Base64
-     * 用 Base64 解码
-     *
-     * @note this function only fits in string
-     * 仅字符串适用此函数
+     * @brief write payload right after writeHeader, raw bytes without any mark
+     * 在 writeHeader 之后写入数据，原始字节，不带任何标志
+     */
+    inline bool writePayload(const uint8_t *data, uint32_t length)
+    {
+        return !length || (data && this->_emit(data, length));
+    }
+
+    /**
+     * @brief write a number without an Element, same bytes as Element::pack of that number
+     * 不通过Element直接写入数字，与该数字的 Element::pack 输出相同
      *
-     * @param replaceOrigin replace origin or not; 是否替换原有内容
-     * @return String Base64 decoded
+     * @param type any number type 任意数字类型
+     * @param d value, read as type 数值，按类型读取
      */
-    String fromBase64(bool replaceOrigin = false)
+    bool writeNumber(ElementType type, const ElementData &d)
     {
-        String db64 = "";
-        if (this->type == ETYPE_STRING)
+        uint8_t size = Element::getItemSize(type);
+        if (!size || !this->_writeHeader())
+            return false;
+
+        // type mark and a varint takes 11 bytes at most
+        // 类型标志加变长编码最多11个字节
+        uint8_t field[11];
+        uint32_t offset = 1;
+        field[0] = (uint8_t)type;
+        if (this->compact && type != ETYPE_FLOAT && type != ETYPE_DOUBLE)
+        {
+            offset += ArrayBufferVarint::write(field + 1, ArrayBufferVarint::fromData(d, type));
+        }
+        else
         {
-            db64 = mycrypto::Base64::base64Decode(this->getString());
-            if (replaceOrigin)
-            {
-                this->_setString(db64);
-            }
+            memcpy(field + 1, &d, size);
+            offset += size;
         }
-        return db64;
+        return this->_emit(field, offset);
     }
 
     /**
-     * @brief calculate SHA256 of content
-     *
-     * @attention only string and buffer can do this process,
-     * otherwise will return null pointer.
-     * developer MUST call delete to the pointer after using it.
+     * @brief hand all staged bytes to sink
+     * 把暂存的数据全部交给输出端
      *
-     * 只有字符串和字节数组才能使用此函数，否则会返回空指针。
-     * 开发者【需要】自己手动 delete 以释放内存空间
+     * @return false if any error happened 发生过错误时返回false
+     */
+    inline bool flush() { return this->_flushStaging(); }
+
+    /**
+     * @brief end of message, CRC32 trailer is written if checked, then everything is flushed,
+     * nothing should be written after this
+     * 结束消息，如果需要校验则写入CRC32结尾，然后写出所有数据，
+     * 之后不应再写入任何内容
      *
-     * @return uint8_t* pointer to result, 32 bytes long; 指向结果数组的指针，32字节
+     * @return false if any error happened 发生过错误时返回false
      */
-    uint8_t *SHA256()
+    bool finish()
     {
-        if (this->type == ETYPE_STRING || this->type == ETYPE_BUFFER)
+        if (this->checked && !this->headerPending)
         {
+            uint8_t trailer[4];
+            memcpy(trailer, &(this->crc), 4);
+            this->checked = false;
+            if (!this->_emit(trailer, 4))
+                return false;
+        }
+        return this->flush();
+    }
 
-            uint8_t *buf = nullptr;
+    inline bool hasError() const { return this->error; }
 
-#ifdef CONFIG_IDF_TARGET_ESP32C3
-            try
-            {
-                buf = new uint8_t[32];
-            }
-            catch (const std::bad_alloc &e)
-            {
-                // do nothing
-            }
-#else
-            buf = new (std::nothrow) uint8_t[32];
-#endif
+    inline bool isCompact() const { return this->compact; }
 
-            if (!buf)
-            {
-                return buf;
-            }
-            bzero(buf, 32);
+    /**
+     * @brief total bytes encoded so far, including staged ones
+     * 目前为止编码的总字节数，包括暂存的
+     */
+    inline uint64_t length() const { return this->written + this->used; }
 
-            mycrypto::SHA::sha256((this->type == ETYPE_STRING ? (uint8_t *)(this->c_str()) : (this->data.buffer.p)),
-                                  this->type == ETYPE_STRING ? this->data.buffer.bufferLength - 1 : this->data.buffer.bufferLength, buf);
+    /**
+     * @brief length of encoded output, for sinks need length ahead such as websocket frame
+     * 计算编码后的长度，用于需要预先知道长度的输出端，比如websocket数据帧
+     */
+    static uint32_t getOuterBufferLength(const Elements *elements, bool compact = false)
+    {
+        uint32_t length = 0;
+        if (elements)
+            for (auto it = elements->begin(); it != elements->end(); ++it)
+                length += (*it)->getOuterBufferLength(compact);
+        return (compact && length) ? length + 1 : length;
+    }
 
-            return buf;
-        }
-        return nullptr;
+    static uint32_t getOuterBufferLength(const ElementList *elements, bool compact = false)
+    {
+        uint32_t length = 0;
+        if (elements)
+            for (const Element &e : *elements)
+                length += e.getOuterBufferLength(compact);
+        return (compact && length) ? length + 1 : length;
+    }
+
+    static uint32_t getOuterBufferLength(std::initializer_list<Element> list, bool compact = false)
+    {
+        uint32_t length = 0;
+        for (const auto &i : list)
+            length += i.getOuterBufferLength(compact);
+        return (compact && length) ? length + 1 : length;
     }
 
     /**
-     * @brief get SHA256 of content in hex string format;
-     * 获取内容的SHA256, 16进制字符串格式
-     *
-     * @attention will return empty string if type of content are not string and buffer
-     * 如果内容不是字符串和二进制数组会返回空字符串
-     *
-     * @param replaceOrigin will replace origin if set to true
-     * 如果参数为true则会直接替换掉原本的内容
+     * @brief sink writes into a caller owned buffer, fails when full
+     * 写入调用者提供的固定缓冲区，写满时失败
      *
-     * @return String SHA256 hex string
+     * @param buffer output buffer 输出缓冲区
+     * @param capacity capacity of buffer 缓冲区容量
+     * @param offset bytes written, should be initialized by caller 已写入字节数，需由调用者初始化
      */
-    String getSHA256HexString(bool replaceOrigin = false)
+    static ArrayBufferSink toBuffer(uint8_t *buffer, uint32_t capacity, uint32_t *offset)
     {
-        String hash = "";
-        if (this->type == ETYPE_STRING || this->type == ETYPE_BUFFER)
+        return [buffer, capacity, offset](const uint8_t *data, uint32_t length) -> bool
         {
-            hash = mycrypto::SHA::sha256(
-                this->data.buffer.p,
-                this->type == ETYPE_STRING ? this->data.buffer.bufferLength - 1 : this->data.buffer.bufferLength);
-
-            if (hash.length() && replaceOrigin)
-            {
-                this->_setString(hash);
-            }
-        }
-
-        return hash;
+            if (!buffer || (*offset) + length > capacity)
+                return false;
+            memcpy(buffer + (*offset), data, length);
+            (*offset) += length;
+            return true;
+        };
     }
 
     /**
-     * @brief encrypt content with AES-256-CBC
-     * 用AES 256 CBC 加密数据
-     *
-     * @note only string and buffer fit in this function
-     * 只有字符串和二进制数组适用此函数
-     *
-     * @param key key, 32 bytes; 密匙, 32字节
-     * @param iv iv 16 bytes; 初始化向量, 16字节
-     *
-     * @return true success; 成功
-     * @return false failed; 失败
+     * @brief sink appends into a growing buffer
+     * 追加写入可增长的缓冲区
      */
-    bool AES256_CBC(const char *key, const char *iv)
+    static ArrayBufferSink toVector(std::vector<uint8_t> *output)
     {
-        if ((!strlen(key) || !strlen(iv)) && (this->type == ETYPE_BUFFER || this->type == ETYPE_STRING))
+        return [output](const uint8_t *data, uint32_t length) -> bool
         {
-            return false;
-        }
+            output->insert(output->end(), data, data + length);
+            return true;
+        };
+    }
+};
 
-        uint32_t outLen = 0;
+/**
+ * @brief field tags of ArrayBufferSchema, used in place of a plain type
+ * ArrayBufferSchema 的字段标记，用于代替普通类型
+ *
+ * plain numbers such as uint8_t require exactly the same type mark,
+ * ArrayBufferNumber<T> accepts any number and converts it to T, for numbers sent by javascript,
+ * String copies the string, const char * points into source,
+ * ArrayBufferBuffer<N> is an uint8 array of exactly N bytes, any length if N is 0,
+ * ArrayBufferSkip accepts anything and decodes nothing, it can't be encoded
+ *
+ * 普通数字类型比如 uint8_t 要求类型标志完全一致，
+ * ArrayBufferNumber<T> 接受任意数字并转换为T，用于javascript发来的数字，
+ * String 会拷贝字符串，const char * 指向源数据，
+ * ArrayBufferBuffer<N> 是正好N个字节的二进制数组，N为0时不限长度，
+ * ArrayBufferSkip 接受任意类型且不解码，不能用于编码
+ */
+template <class T>
+struct ArrayBufferNumber
+{
+};
 
-        uint8_t *cipher = mycrypto::AES::aes256CBCEncrypt(
-            (const uint8_t *)key,
-            (const uint8_t *)iv,
-            this->data.buffer.p,
-            (this->type == ETYPE_STRING ? this->data.buffer.bufferLength - 1 : this->data.buffer.bufferLength),
-            &outLen);
+template <uint32_t N = 0>
+struct ArrayBufferBuffer
+{
+};
 
-        if (!outLen && !cipher)
-        {
+struct ArrayBufferSkip
+{
+};
+
+/**
+ * @brief value of ArrayBufferBuffer field, points into source, nothing is copied
+ * ArrayBufferBuffer 字段的值，指向源数据，不拷贝
+ */
+struct ArrayBufferBytes
+{
+    const uint8_t *data;
+    uint32_t length;
+};
+
+/**
+ * @brief how a field is checked, read and written
+ * e is an Element or an ElementView, they have same getters
+ * length is outer length in normal mode, minimum one if not fixed
+ *
+ * 字段的校验、读取和写入方式
+ * e 是 Element 或 ElementView，两者的读取函数相同
+ * length 是普通模式下的外部长度，长度不固定时为最小长度
+ */
+template <class T>
+struct ArrayBufferSchemaField;
+
+#define ARRAY_BUFFER_SCHEMA_NUMBER(T, TYPE, GETTER)                                 \
+    template <>                                                                     \
+    struct ArrayBufferSchemaField<T>                                                \
+    {                                                                               \
+        typedef T Value;                                                            \
+        static constexpr bool fixed = true;                                         \
+        static constexpr uint32_t length = 1 + sizeof(T);                           \
+        template <class E>                                                          \
+        static inline bool check(const E &e) { return e.getType() == TYPE; }        \
+        template <class E>                                                          \
+        static inline Value get(const E &e) { return e.GETTER(); }                  \
+        static inline uint32_t getOuterBufferLength(const Value &v, bool compact)   \
+        {                                                                           \
+            Element e;                                                              \
+            e = v;                                                                  \
+            return e.getOuterBufferLength(compact);                                 \
+        }                                                                           \
+        static inline bool write(ArrayBufferWriter *writer, const Value &v)         \
+        {                                                                           \
+            Element e;                                                              \
+            e = v;                                                                  \
+            return writer->write(e);                                                \
+        }                                                                           \
+    };
+
+ARRAY_BUFFER_SCHEMA_NUMBER(uint8_t, ETYPE_UINT8, getUint8)
+ARRAY_BUFFER_SCHEMA_NUMBER(int8_t, ETYPE_INT8, getInt8)
+ARRAY_BUFFER_SCHEMA_NUMBER(uint16_t, ETYPE_UINT16, getUint16)
+ARRAY_BUFFER_SCHEMA_NUMBER(int16_t, ETYPE_INT16, getInt16)
+ARRAY_BUFFER_SCHEMA_NUMBER(uint32_t, ETYPE_UINT32, getUint32)
+ARRAY_BUFFER_SCHEMA_NUMBER(int32_t, ETYPE_INT32, getInt32)
+ARRAY_BUFFER_SCHEMA_NUMBER(uint64_t, ETYPE_UINT64, getUint64)
+ARRAY_BUFFER_SCHEMA_NUMBER(int64_t, ETYPE_INT64, getInt64)
+ARRAY_BUFFER_SCHEMA_NUMBER(float, ETYPE_FLOAT, getFloat)
+ARRAY_BUFFER_SCHEMA_NUMBER(double, ETYPE_DOUBLE, getDouble)
+
+#undef ARRAY_BUFFER_SCHEMA_NUMBER
+
+template <class T>
+struct ArrayBufferSchemaField<ArrayBufferNumber<T>>
+{
+    typedef T Value;
+    static constexpr bool fixed = true;
+    static constexpr uint32_t length = 1 + sizeof(T);
+    template <class E>
+    static inline bool check(const E &e) { return e.getType(true) == ETYPE_NUMBER; }
+    template <class E>
+    static inline Value get(const E &e)
+    {
+        return std::is_floating_point<T>::value ? (T)e.getUniversalDouble() : (T)e.getNumber();
+    }
+    static inline uint32_t getOuterBufferLength(const Value &v, bool compact)
+    {
+        return ArrayBufferSchemaField<T>::getOuterBufferLength(v, compact);
+    }
+    static inline bool write(ArrayBufferWriter *writer, const Value &v)
+    {
+        return ArrayBufferSchemaField<T>::write(writer, v);
+    }
+};
+
+template <>
+struct ArrayBufferSchemaField<const char *>
+{
+    typedef const char *Value;
+    static constexpr bool fixed = false;
+    static constexpr uint32_t length = 6;
+    template <class E>
+    static inline bool check(const E &e) { return e.getType() == ETYPE_STRING; }
+    template <class E>
+    static inline Value get(const E &e)
+    {
+        const char *s = e.c_str();
+        return s ? s : "";
+    }
+    static inline uint32_t getOuterBufferLength(const Value &v, bool compact)
+    {
+        uint32_t n = (v ? strlen(v) : 0) + 1;
+        return 1 + (compact ? ArrayBufferVarint::length(n) : 4) + n;
+    }
+    static inline bool write(ArrayBufferWriter *writer, const Value &v)
+    {
+        const char *s = v ? v : "";
+        uint32_t n = strlen(s) + 1;
+        return writer->writeHeader(ETYPE_STRING, n) && writer->writePayload((const uint8_t *)s, n);
+    }
+};
+
+template <>
+struct ArrayBufferSchemaField<String>
+{
+    typedef String Value;
+    static constexpr bool fixed = false;
+    static constexpr uint32_t length = 6;
+    template <class E>
+    static inline bool check(const E &e) { return e.getType() == ETYPE_STRING; }
+    template <class E>
+    static inline Value get(const E &e) { return String(ArrayBufferSchemaField<const char *>::get(e)); }
+    static inline uint32_t getOuterBufferLength(const Value &v, bool compact)
+    {
+        return ArrayBufferSchemaField<const char *>::getOuterBufferLength(v.c_str(), compact);
+    }
+    static inline bool write(ArrayBufferWriter *writer, const Value &v)
+    {
+        return ArrayBufferSchemaField<const char *>::write(writer, v.c_str());
+    }
+};
+
+template <uint32_t N>
+struct ArrayBufferSchemaField<ArrayBufferBuffer<N>>
+{
+    typedef ArrayBufferBytes Value;
+    static constexpr bool fixed = N > 0;
+    static constexpr uint32_t length = 5 + N;
+    template <class E>
+    static inline bool check(const E &e)
+    {
+        return e.getType() == ETYPE_BUFFER && (!N || e.getRawBufferLength() == N);
+    }
+    template <class E>
+    static inline Value get(const E &e)
+    {
+        Value v;
+        v.data = e.getRawBuffer(&(v.length));
+        return v;
+    }
+    static inline uint32_t getOuterBufferLength(const Value &v, bool compact)
+    {
+        return 1 + (compact ? ArrayBufferVarint::length(v.length) : 4) + v.length;
+    }
+    static inline bool write(ArrayBufferWriter *writer, const Value &v)
+    {
+        if ((N && v.length != N) || (v.length && !v.data))
             return false;
-        }
+        return writer->writeHeader(ETYPE_BUFFER, v.length) && writer->writePayload(v.data, v.length);
+    }
+};
 
-        this->_copyBuffer(cipher, outLen);
-        delete cipher;
-        cipher = nullptr;
+template <>
+struct ArrayBufferSchemaField<ArrayBufferSkip>
+{
+    typedef ArrayBufferSkip Value;
+    static constexpr bool fixed = false;
+    static constexpr uint32_t length = 1;
+    template <class E>
+    static inline bool check(const E &e) { return e.getType() != ETYPE_VOID; }
+    template <class E>
+    static inline Value get(const E &) { return Value(); }
+    static inline uint32_t getOuterBufferLength(const Value &, bool) { return 0; }
+    static inline bool write(ArrayBufferWriter *, const Value &) { return false; }
+};
 
-        return true;
+/**
+ * @brief walks fields of schema at compile time, used internally
+ * 在编译期遍历结构的字段，内部使用
+ */
+template <uint32_t I, class... Ts>
+struct _ArrayBufferSchemaStep;
+
+template <uint32_t I>
+struct _ArrayBufferSchemaStep<I>
+{
+    static constexpr uint32_t length = 0;
+    static constexpr bool fixed = true;
+
+    static inline bool validate(const ArrayBufferView &view) { return true; }
+    static inline bool validate(const Elements *elements) { return true; }
+    template <class Values>
+    static inline void decode(const ArrayBufferView &view, Values *values) {}
+    template <class Values>
+    static inline void decode(const Elements *elements, Values *values) {}
+    template <class Values>
+    static inline uint32_t getOuterBufferLength(const Values &values, bool compact) { return 0; }
+    template <class Values>
+    static inline bool write(ArrayBufferWriter *writer, const Values &values) { return true; }
+};
+
+template <uint32_t I, class T, class... Ts>
+struct _ArrayBufferSchemaStep<I, T, Ts...>
+{
+    typedef ArrayBufferSchemaField<T> Field;
+    typedef _ArrayBufferSchemaStep<I + 1, Ts...> Next;
+
+    static constexpr uint32_t length = Field::length + Next::length;
+    static constexpr bool fixed = Field::fixed && Next::fixed;
+
+    static inline bool validate(const ArrayBufferView &view)
+    {
+        return Field::check(view.at(I)) && Next::validate(view);
     }
+    static inline bool validate(const Elements *elements)
+    {
+        return Field::check(*(elements->at(I))) && Next::validate(elements);
+    }
+    template <class Values>
+    static inline void decode(const ArrayBufferView &view, Values *values)
+    {
+        std::get<I>(*values) = Field::get(view.at(I));
+        Next::decode(view, values);
+    }
+    template <class Values>
+    static inline void decode(const Elements *elements, Values *values)
+    {
+        std::get<I>(*values) = Field::get(*(elements->at(I)));
+        Next::decode(elements, values);
+    }
+    template <class Values>
+    static inline uint32_t getOuterBufferLength(const Values &values, bool compact)
+    {
+        return Field::getOuterBufferLength(std::get<I>(values), compact) + Next::getOuterBufferLength(values, compact);
+    }
+    template <class Values>
+    static inline bool write(ArrayBufferWriter *writer, const Values &values)
+    {
+        return Field::write(writer, std::get<I>(values)) && Next::write(writer, values);
+    }
+};
+
+/**
+ * @brief layout of a message known at compile time,
+ * checks type of every field in one call and decodes or encodes without Elements
+ * values are stored in a std::tuple, use std::get<OFFSET_...>(values) to access a field
+ *
+ * 编译期确定的消息格式，
+ * 一次调用校验所有字段的类型，编码和解码都不需要 Elements
+ * 值存放在 std::tuple 中，用 std::get<OFFSET_...>(values) 访问字段
+ *
+ * @example
+ * typedef ArrayBufferSchema<uint8_t, ArrayBufferBuffer<32>, ArrayBufferNumber<uint32_t>> Request;
+ * Request::Values values(CMD_OTA_BLOCK, ArrayBufferBytes{id, 32}, index);
+ * Request::write(&writer, values);
+ */
+template <class... Ts>
+class ArrayBufferSchema
+{
+private:
+    typedef _ArrayBufferSchemaStep<0, Ts...> Steps;
+
+public:
+    typedef std::tuple<typename ArrayBufferSchemaField<Ts>::Value...> Values;
 
     /**
-     * @brief encode with AES-256-CBC and replace origin with hex string
-     * 用AES-256-CBC加密，然后替换原有内容为加密结果的16进制字符串
-     *
-     * @param key key, 32 bytes; 密匙, 32字节
-     * @param iv iv 16 bytes; 初始化向量, 16字节
+     * @brief number of fields
+     * 字段数量
+     */
+    static constexpr uint32_t size = sizeof...(Ts);
+
+    /**
+     * @brief every field has fixed length in normal mode
+     * 普通模式下所有字段长度固定
+     */
+    static constexpr bool isFixed = Steps::fixed;
+
+    /**
+     * @brief encoded length in normal mode, minimum length if not fixed
+     * 普通模式下编码后的长度，长度不固定时为最小长度
+     */
+    static constexpr uint32_t fixedLength = Steps::length;
+
+    /**
+     * @brief check count and type of fields
+     * 校验字段数量和类型
      *
-     * @return true success; 成功
-     * @return false failed; 失败
+     * @param allowTrailing fields after schema are allowed and not checked 允许结构之后还有字段，且不校验
      */
-    bool toAES256CBCHexString(const char *key, const char *iv)
+    static inline bool validate(const ArrayBufferView &view, bool allowTrailing = false)
     {
-        if (!this->AES256_CBC(key, iv))
-        {
-            return false;
-        }
-        return this->_setString(this->getHex());
+        return view.isValid() &&
+               (allowTrailing ? view.size() >= size : view.size() == size) &&
+               Steps::validate(view);
+    }
+
+    static inline bool validate(const Elements *elements, bool allowTrailing = false)
+    {
+        return elements &&
+               (allowTrailing ? elements->size() >= size : elements->size() == size) &&
+               Steps::validate(elements);
     }
 
     /**
-     * @brief encode with AES-256-CBC and replace origin with base64
-     * 用AES-256-CBC加密，然后替换原有内容为加密结果的base64编码
-     *
-     * @param key key, 32 bytes; 密匙, 32字节
-     * @param iv iv 16 bytes; 初始化向量, 16字节
+     * @brief validate and decode, strings and buffers point into source unless decoded as String
+     * 校验并解码，除非解码为String，否则字符串和二进制数组都指向源数据
      *
-     * @return true success; 成功
-     * @return false failed; 失败
+     * @return false if validation failed, values are not touched
+     * 校验失败返回false，不修改values
      */
-    bool toAES256CBCBase64(const char *key, const char *iv)
+    static inline bool decode(const ArrayBufferView &view, Values *values, bool allowTrailing = false)
     {
-        if (!this->AES256_CBC(key, iv))
-        {
+        if (!values || !validate(view, allowTrailing))
             return false;
-        }
-        return this->_setString(this->toBase64(true));
+        Steps::decode(view, values);
+        return true;
+    }
+
+    static inline bool decode(const Elements *elements, Values *values, bool allowTrailing = false)
+    {
+        if (!values || !validate(elements, allowTrailing))
+            return false;
+        Steps::decode(elements, values);
+        return true;
     }
+
     /**
-     * @brief
-     * clear buffer
-     * 清理缓存的函数
+     * @brief length of encoded output
+     * 编码后的长度
      */
-    void clearBuffer()
+    static inline uint32_t getOuterBufferLength(const Values &values, bool compact = false)
     {
-        // ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "buffer length: %lu", this->data.buffer.bufferLength);
-        if ((this->type == ETYPE_STRING || this->type == ETYPE_BUFFER) &&
-            this->data.buffer.p &&
-            this->data.buffer.bufferLength)
-        {
-
-            // clear length 归零长度
-            // this->data.buffer.bufferLength = 0;
-
-            // clear buffer 清除buffer
-            delete this->data.buffer.p;
-
-            // reset pointer 重置指针
-            // this->data.buffer.p = nullptr;
-        }
-        bzero(&(this->data), sizeof(ElementData));
+        return Steps::getOuterBufferLength(values, compact) + (compact ? 1 : 0);
     }
 
     /**
-     * @brief this function could use same object to change its original data type to another
-     * it will clean all buffer(if exists)
-     * 这个函数用于给当前对象赋值另一种类型的数据
-     * 如果当前对象存储了字符串或者拷贝模式的二进制数组
-     * 那么就会清理掉缓存
-     *
-     * @param type new type 新的类型
+     * @brief encode all fields into writer
+     * 把所有字段编码进写入器
      */
-    void reset(ElementType type)
+    static inline bool write(ArrayBufferWriter *writer, const Values &values)
     {
-        this->clearBuffer();
-
-        // set current type to given type
-        // 设定当前类型为给定的类型
-        this->type = type;
+        return writer && Steps::write(writer, values);
     }
 
-#ifdef ARRAY_BUFFER_DEBUG_ON
-    char *debugShow() const
+    /**
+     * @brief encode into a caller owned buffer, such as one on stack
+     * 编码到调用者提供的缓冲区中，比如栈上的数组
+     *
+     * @return uint32_t length of output, 0 if failed 输出长度，失败时为0
+     */
+    static uint32_t createArrayBuffer(const Values &values, uint8_t *buffer, uint32_t capacity, bool compact = false)
     {
-        char *buf = new char[1024];
-        bzero(buf, 1024);
-        switch (this->type)
+        uint32_t offset = 0;
         {
-        case ETYPE_UINT8:
-        case ETYPE_INT8:
-        case ETYPE_UINT16:
-        case ETYPE_INT16:
-        case ETYPE_UINT32:
-        case ETYPE_INT32:
-        case ETYPE_FLOAT:
-        case ETYPE_UINT64:
-        case ETYPE_INT64:
-        case ETYPE_DOUBLE:
-            sprintf(buf, "%llf\n", this->getUniversalDouble());
-            break;
-        case ETYPE_STRING:
-            sprintf(buf, "%s\n", this->c_str());
-            break;
-        case ETYPE_BUFFER:
-            sprintf(buf, "[buffer length: %lu\n0x", this->data.buffer.bufferLength);
-            for (int i = 0; i < this->data.buffer.bufferLength; ++i)
-            {
-                sprintf(buf + (i * 2), "%02x", (this->data.buffer.p)[i]);
-            }
-            sprintf(buf + (this->data.buffer.bufferLength * 2), "\n]");
+            ArrayBufferWriter writer(ArrayBufferWriter::toBuffer(buffer, capacity, &offset), compact);
+            if (!write(&writer, values) || !writer.flush())
+                return 0;
         }
-        return buf;
+        return offset;
     }
+};
+
+#ifndef ELEMENT_ARENA_BLOCK_SIZE
+// default size of a single block of ElementArena, bigger request gets its own block
+// ElementArena 单个内存块的默认大小，更大的请求会单独分配一个块
+#define ELEMENT_ARENA_BLOCK_SIZE 1024
 #endif
 
-    uint32_t getOuterBufferLength() const
-    {
-        switch (this->type)
-        {
-        case ETYPE_UINT8:
-        case ETYPE_INT8:
-            return 2;
-        case ETYPE_UINT16:
-        case ETYPE_INT16:
-            return 3;
-        case ETYPE_UINT32:
-        case ETYPE_INT32:
-        case ETYPE_FLOAT:
-            return 5;
-        case ETYPE_UINT64:
-        case ETYPE_INT64:
-        case ETYPE_DOUBLE:
-            return 9;
-        case ETYPE_STRING:
-        case ETYPE_BUFFER:
-            return this->data.buffer.bufferLength + 5;
-        default:
-            return 0;
-        }
-    }
+#ifndef ELEMENT_ARENA_ALIGNMENT
+// alignment of every allocation of ElementArena, same as malloc
+// ElementArena 每次分配的对齐字节数，与malloc相同
+#define ELEMENT_ARENA_ALIGNMENT alignof(std::max_align_t)
+#endif
 
-    bool pack(uint8_t *buffer, uint32_t *offset) const
+/**
+ * @brief bump allocator for lifetime of a single message
+ * Elements, containers and payload bytes are placed one after another in a chain of blocks,
+ * all of them are released at once by reset(), the first block is kept for next message
+ *
+ * 用于单条消息生命周期的线性分配器
+ * 元素、容器和数据依次存放在一串内存块中，调用 reset() 会一次性全部释放，第一个内存块会保留给下一条消息使用
+ *
+ * @attention objects from arena must NOT be deleted, and must NOT be used after reset()
+ * 从arena中创建的对象 [不能] 被delete，在 reset() 之后也 [不能] 再使用
+ */
+class ElementArena
+{
+private:
+    /**
+     * @brief header of block, data follows from the next aligned address
+     * 内存块头，数据从其后下一个对齐的地址开始
+     */
+    typedef struct Block
     {
-        uint32_t bufferLength = this->getOuterBufferLength();
+        Block *next;
+        uint8_t *data;
+        uint32_t capacity;
+        uint32_t used;
+    } Block;
 
-        if (!bufferLength)
-            return false;
+    /**
+     * @brief record of objects need destructor called when reset
+     * 记录在 reset 时需要调用析构函数的对象
+     */
+    typedef struct Node
+    {
+        Node *next;
+        Element *element;
+        Elements *elements;
+    } Node;
 
-        uint32_t dataLen = 0;
-        uint64_t c = 0;
+    Block *blocks = nullptr;
+    Block *current = nullptr;
+    Node *nodes = nullptr;
+    uint32_t blockSize = ELEMENT_ARENA_BLOCK_SIZE;
 
-        buffer[(*offset)] = (uint8_t)this->type;
-        ++(*offset); // skip mark
+    static uint32_t _align(uint32_t length)
+    {
+        return (length + ELEMENT_ARENA_ALIGNMENT - 1) & ~((uint32_t)ELEMENT_ARENA_ALIGNMENT - 1);
+    }
 
-        switch (this->type)
+    Block *_newBlock(uint32_t capacity)
+    {
+        // header is not a multiple of alignment on every target, and heap may only align to 4 bytes,
+        // so spare bytes are reserved to move data start to next aligned address
+        // 内存块头的长度不一定是对齐字节数的整数倍，堆内存也可能只按4字节对齐，
+        // 所以多分配一些字节用于把数据起始地址移动到下一个对齐的地址
+        uint32_t length = sizeof(Block) + ELEMENT_ARENA_ALIGNMENT - 1 + capacity;
+        uint8_t *raw = nullptr;
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+        try
         {
-        case ETYPE_UINT8:
-        case ETYPE_INT8:
-            memcpy(buffer + (*offset), (&(this->data.u8)), 1);
-            (*offset) += 1;
-            break;
-        case ETYPE_UINT16:
-        case ETYPE_INT16:
-            memcpy(buffer + (*offset), (&(this->data.u16)), 2);
-            (*offset) += 2;
-            break;
-        case ETYPE_UINT32:
-        case ETYPE_INT32:
-            memcpy(buffer + (*offset), (&(this->data.u32)), 4);
-            (*offset) += 4;
-            break;
-        case ETYPE_FLOAT:
-            memcpy(buffer + (*offset), (&(this->data.f)), 4);
-            (*offset) += 4;
-            break;
-        case ETYPE_UINT64:
-        case ETYPE_INT64:
-            memcpy(buffer + (*offset), (&(this->data.u64)), 8);
-            (*offset) += 8;
-            break;
-        case ETYPE_DOUBLE:
-            memcpy(buffer + (*offset), (&(this->data.d)), 8);
-            (*offset) += 8;
-            break;
-        case ETYPE_STRING:
-        case ETYPE_BUFFER:
-            dataLen = this->data.buffer.bufferLength;
-            memcpy(buffer + (*offset), (&(dataLen)), 4);
-            (*offset) += 4;
-            memcpy(buffer + (*offset), this->data.buffer.p, dataLen);
-            (*offset) += dataLen;
-            break;
+            raw = new uint8_t[length];
         }
-
-        return true;
+        catch (const std::bad_alloc &e)
+        {
+            raw = nullptr;
+        }
+#else
+        raw = new (std::nothrow) uint8_t[length];
+#endif
+        if (!raw)
+        {
+            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "arena block allocate failed, length: %u", capacity);
+            return nullptr;
+        }
+        Block *block = (Block *)raw;
+        block->next = nullptr;
+        block->data = (uint8_t *)(((uintptr_t)(raw + sizeof(Block)) + ELEMENT_ARENA_ALIGNMENT - 1) &
+                                  ~((uintptr_t)ELEMENT_ARENA_ALIGNMENT - 1));
+        block->capacity = capacity;
+        block->used = 0;
+        return block;
     }
 
-    int32_t setFromOuterBuffer(uint8_t *buffer, uint32_t offset, uint32_t length)
+    void _freeBlocks(Block *block)
     {
-        if (!buffer)
-            return -2;
+        while (block)
+        {
+            Block *next = block->next;
+            delete[] (uint8_t *)block;
+            block = next;
+        }
+    }
 
-        if (length < 2)
-            return -2;
+    bool _track(Element *element, Elements *elements)
+    {
+        Node *node = (Node *)this->allocate(sizeof(Node));
+        if (!node)
+            return false;
+        node->next = this->nodes;
+        node->element = element;
+        node->elements = elements;
+        this->nodes = node;
+        return true;
+    }
 
-        int8_t mark = (int8_t)buffer[offset++];
+public:
+    /**
+     * @param blockSize size of a single block 单个内存块的大小
+     */
+    ElementArena(uint32_t blockSize = ELEMENT_ARENA_BLOCK_SIZE) : blockSize(blockSize) {}
 
-        uint8_t *internalBuffer = (uint8_t *)(&(this->data));
+    ElementArena(const ElementArena &) = delete;
+    ElementArena &operator=(const ElementArena &) = delete;
 
-        bzero(internalBuffer, sizeof(ElementData));
+    ~ElementArena()
+    {
+        this->reset();
+        this->_freeBlocks(this->blocks);
+    }
 
-        this->reset((ElementType)mark);
+    /**
+     * @brief get raw memory from arena
+     * 从arena中获取原始内存
+     *
+     * @param length length in bytes 字节长度
+     * @return nullptr if heap full 堆内存不足时返回空指针
+     */
+    void *allocate(uint32_t length)
+    {
+        // keep every allocation aligned as malloc does, for Element(8 bytes union) and any other type
+        // 保持每次分配都与malloc一样对齐，满足Element(8字节联合体)以及其他任何类型的要求
+        length = _align(length);
 
-        uint32_t dataLen;
+        // find a block has enough space, blocks after current are empty after reset
+        // 找到一个有足够空间的块，current之后的块在reset之后都是空的
+        while (this->current && this->current->capacity - this->current->used < length)
+        {
+            if (!this->current->next)
+                break;
+            this->current = this->current->next;
+        }
 
-        switch (mark)
+        if (!this->current || this->current->capacity - this->current->used < length)
         {
-        case ETYPE_UINT8:
-        case ETYPE_INT8:
-            memcpy(&(this->data.u8), buffer + offset, 1);
-            return 2;
-        case ETYPE_UINT16:
-        case ETYPE_INT16:
-            memcpy(&(this->data.u16), buffer + offset, 2);
-            return 3;
-        case ETYPE_UINT32:
-        case ETYPE_INT32:
-            memcpy(&(this->data.u32), buffer + offset, 4);
-            return 5;
-        case ETYPE_FLOAT:
-            memcpy(&(this->data.f), buffer + offset, 4);
-            return 5;
-        case ETYPE_UINT64:
-        case ETYPE_INT64:
-            memcpy(&(this->data.u64), buffer + offset, 8);
-            return 9;
-        case ETYPE_DOUBLE:
-            memcpy(&(this->data.d), buffer + offset, 8);
-            return 9;
-        case ETYPE_STRING:
-            memcpy(&dataLen, buffer + offset, 4);
-            this->_copyBuffer(buffer, dataLen, offset + 4, ETYPE_STRING);
-            return dataLen + 5;
-        case ETYPE_BUFFER:
-            memcpy(&dataLen, buffer + offset, 4);
-            this->_copyBuffer(buffer, dataLen, offset + 4, ETYPE_BUFFER);
-            return dataLen + 5;
+            Block *block = this->_newBlock(length > this->blockSize ? length : this->blockSize);
+            if (!block)
+                return nullptr;
+
+            if (this->current)
+            {
+                block->next = this->current->next;
+                this->current->next = block;
+            }
+            else
+            {
+                this->blocks = block;
+            }
+            this->current = block;
         }
 
-        return dataLen;
+        void *p = this->current->data + this->current->used;
+        this->current->used += length;
+        return p;
     }
-};
-
-typedef std::vector<Element *> Elements;
-typedef std::function<void(uint8_t *output, uint64_t length, bool *isBufferDeleted)> createArrayBufferCallback;
-typedef std::function<void(Elements *output)> decodeArrayBufferCallback;
 
-/**
- * @brief
- * this class is a static class
- * 这是个静态类
- */
-class ArrayBuffer
-{
-public:
-    static uint8_t *createArrayBuffer(std::initializer_list<Element> list, uint32_t *outLen)
+    /**
+     * @brief copy bytes into arena
+     * 把数据拷贝到arena中
+     */
+    uint8_t *copy(const uint8_t *data, uint32_t length)
     {
-        (*outLen) = 0;
+        uint8_t *p = (uint8_t *)this->allocate(length);
+        if (p && length)
+            memcpy(p, data, length);
+        return p;
+    }
 
-        if (!list.size())
+    /**
+     * @brief create an Element in arena, arguments are same as constructors of Element
+     * 在arena中创建一个Element，参数与Element的构造函数相同
+     */
+    template <class... Args>
+    Element *create(Args &&...args)
+    {
+        void *p = this->allocate(sizeof(Element));
+        if (!p)
             return nullptr;
-
-        uint32_t bufferLength = 0;
-
-        for (const auto &i : list)
-            bufferLength += i.getOuterBufferLength();
-
-        if (!bufferLength)
+        Element *e = new (p) Element(std::forward<Args>(args)...);
+        if (!this->_track(e, nullptr))
+        {
+            e->~Element();
             return nullptr;
+        }
+        return e;
+    }
 
-        uint8_t *buf = nullptr;
+    /**
+     * @brief create an Element from a field, payload bytes are copied into arena too
+     * 根据字段创建Element，数据也拷贝到arena中
+     */
+    Element *createFrom(const ElementView &view)
+    {
+        Element *e = this->create();
+        return (e && this->assign(e, view)) ? e : nullptr;
+    }
 
-#ifdef CONFIG_IDF_TARGET_ESP32C3
-        try
+    /**
+     * @brief set an empty Element from a field, payload bytes are copied into arena,
+     * such as an Element in ElementList
+     * 根据字段设置一个空的Element，数据拷贝到arena中，比如 ElementList 中的元素
+     *
+     * @return false if arena is full arena内存不足时返回false
+     */
+    bool assign(Element *e, const ElementView &view)
+    {
+        if (view.getType() == ETYPE_STRING || view.getType() == ETYPE_BUFFER)
         {
-            buf = new uint8_t[bufferLength];
+            uint8_t *p = this->copy(view.getRawBuffer(), view.getRawBufferLength());
+            if (!p)
+                return false;
+            e->_setReference(p, view.getRawBufferLength(), view.getType());
+            return true;
         }
-        catch (const std::bad_alloc &e)
+
+        if (view.getType() == ETYPE_ARRAY)
         {
-            // do nothing
+            // items are copied to an aligned address in arena without item type
+            // 元素不带元素类型拷贝到arena中对齐的地址
+            uint8_t *p = this->copy(view.getRawBuffer() + 1, view.getRawBufferLength() - 1);
+            if (!p)
+                return false;
+            e->_setReference(p, view.getRawBufferLength() - 1, ETYPE_ARRAY);
+            e->itemType = view.getArrayType();
+            return true;
         }
-#else
-        buf = new (std::nothrow) uint8_t[bufferLength];
-#endif
-
-        if (!buf)
-            return buf;
-
-        (*outLen) = bufferLength;
 
-        uint32_t offset = 0;
-
-        for (const auto &i : list)
+        if (view.getType() == ETYPE_LIST || view.getType() == ETYPE_MAP)
         {
-            if (!i.pack(buf, &offset))
+            // children are placed in arena too
+            // 子元素也放在arena中
+            ArrayBufferView list = view.getList();
+            Elements *children = this->createElements(list.size());
+            if (!children)
+                return false;
+            for (ArrayBufferView::Cursor it = list.begin(); it != list.end(); ++it)
             {
-                delete buf;
-                return nullptr;
+                Element *child = this->createFrom(*it);
+                if (!child)
+                    return false;
+                children->push_back(child);
             }
+            e->_setChildrenReference(children, view.getType());
+            return true;
         }
 
-        return buf;
+        return view.copyTo(e);
     }
 
     /**
-     * @brief this function will create an uint8 array using a vector provided
-     * 这个函数会使用你提供的vector构造一个二进制数组
-     *
-     * @param elements a vector contains pointers of class Element 一个装有Element对象指针的容器
-     *
-     * @param outLen length of output uint8 array 输出的二进制数组的长度
+     * @brief create a container in arena with capacity reserved exactly
+     * 在arena中创建一个容器，精确预留容量
      *
-     * @return generated pointer to buffer 生成的二进制数组指针
+     * @note storage of std::vector still comes from heap, reserved once
+     * std::vector 的存储空间仍然来自堆，只分配一次
      */
-    static uint8_t *createArrayBuffer(Elements *elements,
-                                      uint32_t *outLen)
+    Elements *createElements(uint32_t capacity)
     {
-        (*outLen) = 0;
-        // check vector size
-        // 检查容器大小
-        if (elements->size() <= 0)
+        void *p = this->allocate(sizeof(Elements));
+        if (!p)
+            return nullptr;
+        Elements *elements = new (p) Elements();
+        if (!this->_track(nullptr, elements))
         {
-            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "empty container");
+            elements->~Elements();
             return nullptr;
         }
+        if (capacity)
+            elements->reserve(capacity);
+        return elements;
+    }
 
-        // declare the length of output
-        // 声明输出二进制数组的大小
-        uint32_t bufferLength = 0;
-
-        // calculate buffer length
-        // 计算需要的缓冲区的长度
-        for (auto it = elements->begin(); it != elements->end(); ++it)
+    /**
+     * @brief destroy all objects and rewind, only the first block is kept if it has default size,
+     * so a single large message doesn't hold its memory forever
+     * 销毁所有对象并回到起点，只保留默认大小的第一个内存块，避免单条大消息的内存一直被占用
+     */
+    void reset()
+    {
+        while (this->nodes)
         {
-            bufferLength += (*it)->getOuterBufferLength();
+            Node *next = this->nodes->next;
+            if (this->nodes->element)
+                this->nodes->element->~Element();
+            if (this->nodes->elements)
+                this->nodes->elements->~Elements();
+            this->nodes = next;
         }
 
-        // allocate buffer
-        // 分配内存
-        uint8_t *buf = nullptr; // new (std::nothrow) uint8_t[bufferLength];
-
-#ifdef CONFIG_IDF_TARGET_ESP32C3
-        try
-        {
-            buf = new uint8_t[bufferLength];
-        }
-        catch (const std::bad_alloc &e)
+        if (this->blocks && this->blocks->capacity == this->blockSize)
         {
-            // do nothing
+            this->_freeBlocks(this->blocks->next);
+            this->blocks->next = nullptr;
+            this->blocks->used = 0;
         }
-#else
-        buf = new (std::nothrow) uint8_t[bufferLength];
-#endif
-
-        if (!buf)
+        else
         {
-            // will return null pointer if memory allocate failed
-            // 如果内存分配失败将返回空指针
-            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "memory allocate failed, buffer length: % llu", bufferLength);
-            return nullptr;
+            this->_freeBlocks(this->blocks);
+            this->blocks = nullptr;
         }
-        // bzero(buf, bufferLength);
-
-        // start to fill data
-        // 从这里开始装填数据
-
-        uint32_t offset = 0;
-
-        // set output length
-        // 设置输出数组的长度
-        (*outLen) = bufferLength;
 
-        for (auto it = elements->begin(); it != elements->end(); ++it)
-        {
-            (*it)->pack(buf, &offset);
-        }
+        this->current = this->blocks;
+    }
 
-        // return pointer of uint8 array
-        // 返回数组指针
-        return buf;
+    /**
+     * @brief bytes used since last reset
+     * 上次重置后使用的字节数
+     */
+    uint32_t getUsed() const
+    {
+        uint32_t used = 0;
+        for (Block *block = this->blocks; block; block = block->next)
+            used += block->used;
+        return used;
     }
 
     /**
-     * @brief this function does same thing as bellow, but it accept a callback in argument
-     * it will clear memory after callback had been called
-     *
-     * 跟上面那个功能一样，但是回调函数使用完成之后会自动清理缓存
-     *
-     * @param elements a vector contains pointers of Element 一个装有Element指针的容器
-     *
-     * @param callback callback for accept output 接收结果的回调函数
+     * @brief bytes of all blocks
+     * 所有内存块的总字节数
      */
-    static void createArrayBuffer(Elements *elements,
-                                  createArrayBufferCallback callback)
+    uint32_t getCapacity() const
     {
-        // this mark could be set by user, then user could delete output manually
-        // but this is not recommended
-        // 这个标志可以在回调函数中由用户手动设置，这样在需要更多内存的场景可以立即清除内存
-        // 但是不推荐这样做，因为你可能将此标志设为true，但是忘记delete
-        bool isBufferDeleted = false;
+        uint32_t capacity = 0;
+        for (Block *block = this->blocks; block; block = block->next)
+            capacity += block->capacity;
+        return capacity;
+    }
+};
 
-        // declare a variable for generate function input
-        // 声明生成函数所需要传入的长度变量
-        uint32_t outLen = 0;
+inline std::vector<Element *> *ArrayBuffer::decodeArrayBuffer(uint8_t *data, uint32_t length, bool onlyCopyPointer)
+{
+    // check pointer and length
+    // return null pointer if got invalid inputs
+    // 检查指针和输入长度
+    // 如果不符合要求则返回空指针
+    if (!data || !length)
+    {
+        ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "empty buffer or zero length when decoding array buffer");
+        return nullptr;
+    }
 
-        // generate buffer
-        // 生成数组
-        uint8_t *buf = ArrayBuffer::createArrayBuffer(elements, &outLen);
+    // validate all lengths and count fields in one scan, nothing is allocated,
+    // malformed buffer is rejected here
+    // 先扫描一遍校验所有长度并统计字段数量，不分配任何内存，
+    // 格式错误的数组在这里就会被拒绝
+    ArrayBufferView view(data, length);
+    if (!view.isValid())
+    {
+        ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "error when decoding");
+        return nullptr;
+    }
 
-        if (!buf || !outLen)
-        {
-            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "empty buffer");
-        }
+    // declare and define container for output, reserved exactly once
+    // 声明定义用于存放输出的容器，只预留一次
+    std::vector<Element *> *output = new std::vector<Element *>();
+    output->reserve(view.size());
 
-        // output pointer and length wheather buffer is empty or not
-        // so you should check pointer and length in callback
-        // 不论是否生成成功都会返回指针，所以回调函数需要检查指针和长度
-        callback(buf, outLen, &isBufferDeleted);
+    // offset in source buffer, marks and trailer are skipped
+    // 源数组的偏移量，跳过标志和结尾的校验值
+    uint32_t offset = view.getFieldsOffset();
+    length = view.getFieldsEnd();
 
-        if (!isBufferDeleted)
+    // mark if there is error
+    // 指示过程中是否存在错误
+    bool error = false;
+
+    // start generating Elements
+    // 开始生成元素
+    for (uint32_t i = 0; i < view.size(); ++i)
+    {
+        Element *e = new Element();
+        int32_t singleOffset = e->setFromOuterBuffer(data, offset, length, view.isCompact());
+
+        output->push_back(e);
+
+        // data is validated, only running out of heap fails here
+        // 数据已校验，这里只有内存不足会失败
+        if (singleOffset < 0)
         {
-            // if user do nothing with buffer, delete it
-            // 如果用户没有手动清理缓存就清理掉它
-            delete buf;
+            error = true;
+            break;
         }
+        offset += singleOffset;
     }
 
-    /**
-     * @brief this function will generate a vector to hold data using a uint8 array buffer provided
-     * 这个函数可以根据你提供的二进制数组生成一个vector，里面存储了各种类型的数据
-     *
-     * @param data uint8 array 二进制数组
-     * @param length length of uint8 array 二进制数组的长度
-     * @param onlyCopyPointer will NOT copy original data(if type is uint8 array), ONLY copy pointer if this set to true
-     * 如果设置为true，则生成的Element如果类型为二进制数组，则 [仅拷贝] 数组指针，而 [不拷贝] 原始数据
-     *
-     * @return a vector contains pointers of Element 一个装有Element指针的vector容器
-     */
-    static std::vector<Element *> *decodeArrayBuffer(uint8_t *data,
-                                                     uint32_t length,
-                                                     bool onlyCopyPointer = false)
+    if (error)
     {
-        // check pointer and length
-        // return null pointer if got invalid inputs
-        // 检查指针和输入长度
-        // 如果不符合要求则返回空指针
-        if (!data || !length)
+        // if error detected will remove all elements and make clean, and return null pointer
+        // 如果过程中发生了错误会清除掉所有的元素和容器，返回空指针
+        for (
+            std::vector<Element *>::iterator it = output->begin();
+            it != output->end();
+            ++it)
         {
-            ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "empty buffer or zero length when decoding array buffer");
-            return nullptr;
+            delete (*it);
         }
+        delete output;
+        return nullptr;
+    }
+    return output;
+}
 
-        // declare and define container for output
-        // 声明定义用于存放输出的容器
-        std::vector<Element *> *output = new std::vector<Element *>();
+inline Elements *ArrayBuffer::decodeArrayBuffer(uint8_t *data, uint32_t length, ElementArena *arena)
+{
+    if (!arena)
+        return ArrayBuffer::decodeArrayBuffer(data, length);
 
-        // offset in source buffer
-        // 源数组的偏移量
-        uint32_t offset = 0;
+    // validate and count fields first, so container is reserved exactly once
+    // 先校验并统计字段数量，这样容器只需要预留一次
+    ArrayBufferView view(data, length);
+    if (!view.isValid())
+    {
+        ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "error when decoding");
+        return nullptr;
+    }
 
-        // mark if there is error
-        // 指示过程中是否存在错误
-        bool error = false;
+    Elements *output = arena->createElements(view.size());
+    if (!output)
+        return nullptr;
 
-        // start generating Elements
-        // 开始生成元素
-        while (offset < length)
-        {
-            if (error)
-            {
-                // jump out while if error detected
-                // 有错误检测到时立即退出
-                ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "error when decoding");
-                break;
-            }
+    for (ArrayBufferView::Cursor it = view.begin(); it != view.end(); ++it)
+    {
+        Element *e = arena->createFrom(*it);
+        if (!e)
+            return nullptr;
+        output->push_back(e);
+    }
+    return output;
+}
 
-            Element *e = new Element();
-            int32_t singleOffset = e->setFromOuterBuffer(data, offset, length);
+inline bool ArrayBuffer::decodeArrayBuffer(uint8_t *data, uint32_t length, ElementList *output, ElementArena *arena)
+{
+    if (!output)
+        return false;
 
-            output->push_back(e);
-            offset += singleOffset;
+    // validate and count fields first, so list grows at most once
+    // 先校验并统计字段数量，这样列表最多扩容一次
+    ArrayBufferView view(data, length);
+    if (!view.isValid())
+    {
+        ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "error when decoding");
+        return false;
+    }
 
-            error = singleOffset < 0;
-        }
+    uint32_t start = output->size();
+    if (!output->reserve(start + view.size()))
+        return false;
 
-        if (error)
+    for (ArrayBufferView::Cursor it = view.begin(); it != view.end(); ++it)
+    {
+        Element *e = output->emplace_back();
+        if (!e || !(arena ? arena->assign(e, *it) : (*it).copyTo(e)))
         {
-            // if error detected will remove all elements and make clean, and return null pointer
-            // 如果过程中发生了错误会清除掉所有的元素和容器，返回空指针
-            for (
-                std::vector<Element *>::iterator it = output->begin();
-                it != output->end();
-                ++it)
-            {
-                delete (*it);
-            }
-            delete output;
-            return nullptr;
+            while (output->size() > start)
+                output->pop_back();
+            return false;
         }
-        return output;
     }
+    return true;
+}
 
-    /**
-     * @brief same as bellow
-     * 跟上面那个带回调函数的功能一样
-     *
-     * @param callback callback for accept output 接收结果的回调函数
-     * @param data uint8 array 二进制数组
-     * @param length length of uint8 array 二进制数组的长度
-     */
-    static void decodeArrayBuffer(decodeArrayBufferCallback callback,
-                                  uint8_t *data,
-                                  uint32_t length)
+inline uint8_t *ArrayBuffer::createArrayBuffer(const ElementList *elements, uint32_t *outLen)
+{
+    (*outLen) = 0;
+
+    uint32_t bufferLength = ArrayBufferWriter::getOuterBufferLength(elements);
+    if (!bufferLength)
+        return nullptr;
+
+    uint8_t *buf = nullptr;
+
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+    try
     {
-        // check pointer and length
-        // 检查指针和长度
-        if (!data || !length)
+        buf = new uint8_t[bufferLength];
+    }
+    catch (const std::bad_alloc &e)
+    {
+        // do nothing
+    }
+#else
+    buf = new (std::nothrow) uint8_t[bufferLength];
+#endif
+
+    if (!buf)
+    {
+        ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "memory allocate failed, buffer length: % llu", bufferLength);
+        return nullptr;
+    }
+
+    uint32_t offset = 0;
+    for (const Element &e : *elements)
+    {
+        // empty element is skipped, only reading a file could fail here
+        // 跳过空元素，这里只有读取文件可能失败
+        if (!e.pack(buf, &offset) && e.getOuterBufferLength())
         {
-            callback(nullptr);
-            return;
+            delete[] buf;
+            return nullptr;
         }
+    }
 
-        // decode buffer if data valid
-        // 如果数据符合要求则开始反序列过程
-        std::vector<Element *> *output = ArrayBuffer::decodeArrayBuffer(data, length);
+    (*outLen) = bufferLength;
+    return buf;
+}
 
-        // call callback
-        // 调用回调函数
-        callback(output);
+inline uint8_t *ArrayBuffer::createArrayBuffer(Elements *elements, uint32_t *outLen, ElementArena *arena)
+{
+    if (!arena)
+        return ArrayBuffer::createArrayBuffer(elements, outLen);
 
-        if (output)
-        {
-            // delete elements
-            // 删除对象
-            for (uint32_t i = 0; i < output->size(); ++i)
-            {
-                delete output->at(i);
-            }
+    (*outLen) = 0;
 
-            // clean
-            // 清理
-            output->clear();
-            std::vector<Element *>().swap(*(output));
-            delete output;
+    uint32_t bufferLength = ArrayBufferWriter::getOuterBufferLength(elements);
+    if (!bufferLength)
+        return nullptr;
+
+    uint8_t *buf = (uint8_t *)arena->allocate(bufferLength);
+    if (!buf)
+        return nullptr;
+
+    uint32_t offset = 0;
+    for (auto it = elements->begin(); it != elements->end(); ++it)
+    {
+        if (!(*it)->pack(buf, &offset) && (*it)->getOuterBufferLength())
+            return nullptr;
+    }
+
+    (*outLen) = bufferLength;
+    return buf;
+}
+
+inline uint8_t *ArrayBuffer::createCheckedArrayBuffer(Elements *elements, uint32_t *outLen, bool compact)
+{
+    (*outLen) = 0;
+
+    uint32_t fieldsLength = ArrayBufferWriter::getOuterBufferLength(elements, compact);
+    if (!fieldsLength)
+        return nullptr;
+
+    // mark, fields and trailer
+    // 标志、字段和结尾的校验值
+    uint32_t bufferLength = 1 + fieldsLength + 4;
+    uint8_t *buf = nullptr;
+
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+    try
+    {
+        buf = new uint8_t[bufferLength];
+    }
+    catch (const std::bad_alloc &e)
+    {
+        // do nothing
+    }
+#else
+    buf = new (std::nothrow) uint8_t[bufferLength];
+#endif
+
+    if (!buf)
+    {
+        ESP_LOGD(ARRAY_BUFFER_DEBUG_HEADER, "memory allocate failed, buffer length: % llu", bufferLength);
+        return nullptr;
+    }
+
+    uint32_t offset = 0;
+    buf[offset++] = ARRAY_BUFFER_CHECKED_MARK;
+    if (compact)
+        buf[offset++] = ARRAY_BUFFER_COMPACT_MARK;
+
+    for (auto it = elements->begin(); it != elements->end(); ++it)
+    {
+        if (!(*it)->pack(buf, &offset, compact) && (*it)->getOuterBufferLength())
+        {
+            delete[] buf;
+            return nullptr;
         }
     }
-};
+
+    uint32_t crc = mycrypto::CRC32::checksum(buf, offset);
+    memcpy(buf + offset, &crc, 4);
+
+    (*outLen) = bufferLength;
+    return buf;
+}
 
 #endif
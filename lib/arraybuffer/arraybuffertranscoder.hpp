@@ -0,0 +1,829 @@
+/**
+ * @file arraybuffertranscoder.hpp
+ * @author Vida Wang (support@vida.wang)
+ * @brief Streaming conversion between the ArrayBuffer format and MessagePack or CBOR,
+    for servers passing device messages to tools which don't know our format.
+
+    Fields are read in place from the source and written to the output one by one,
+    no Element is created and no copy of the whole message is made.
+
+    A message becomes one array of its fields:
+
+    ArrayBuffer                 MessagePack                 CBOR
+    integer                     int, smallest form          major type 0 or 1, smallest form
+    float / double              float 32 / float 64         float 32 / float 64
+    string                      str, without '\0'           text string, without '\0'
+    uint8 array                 bin                         byte string
+    list                        array                       array
+    map                         map                         map
+    typed array                 array of numbers            typed array tag of RFC 8746, little endian
+
+    The other way, integers get smallest type like Element::setNumber, booleans become uint8 0 or 1,
+    half float of CBOR becomes float, tags of CBOR other than typed arrays are ignored,
+    nil, ext and indefinite length are not supported.
+
+
+    在ArrayBuffer格式与MessagePack或CBOR之间进行流式转换，
+    用于服务器把设备的消息交给不了解此格式的工具。
+
+    字段直接在源数据上读取并逐个写入输出，不创建Element，也不拷贝整个消息。
+
+    一条消息转换为由其字段组成的一个数组，对应关系见上表。
+
+    反方向转换时，整数与 Element::setNumber 一样使用最小的类型，布尔值转换为uint8的0或1，
+    CBOR的半精度浮点数转换为float，忽略类型化数组以外的CBOR标签，
+    不支持nil、ext和不定长度。
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef ARRAY_BUFFER_TRANSCODER_H_
+#define ARRAY_BUFFER_TRANSCODER_H_
+
+#include <arraybuffer.hpp>
+
+/**
+ * @brief converter between ArrayBuffer and MessagePack / CBOR, nothing but a staging buffer on stack is used,
+ * output is incomplete when false is returned, like ArrayBufferWriter with a failed sink
+ *
+ * ArrayBuffer与MessagePack / CBOR之间的转换，除了栈上的暂存缓冲区外不使用其他内存，
+ * 返回false时输出不完整，与输出端失败的 ArrayBufferWriter 相同
+ *
+ * @example
+ * std::vector<uint8_t> packed;
+ * ArrayBufferTranscoder::toMessagePack(buffer, length, ArrayBufferWriter::toVector(&packed));
+ *
+ * std::vector<uint8_t> restored;
+ * ArrayBufferWriter writer(ArrayBufferWriter::toVector(&restored));
+ * ArrayBufferTranscoder::fromMessagePack(packed.data(), packed.size(), &writer);
+ * writer.finish();
+ */
+class ArrayBufferTranscoder
+{
+public:
+    typedef enum
+    {
+        MESSAGE_PACK,
+        CBOR
+    } Format;
+
+    /**
+     * @brief convert an encoded buffer, compact, checked and sorted buffers are accepted
+     * 转换编码后的数组，支持紧凑模式、带校验和排序的数组
+     *
+     * @param data encoded buffer 编码后的二进制数组
+     * @param length length of buffer 数组长度
+     * @param sink where converted bytes go 转换后的数据的去向
+     * @return false if buffer is malformed or sink failed 数组格式错误或输出端失败时返回false
+     */
+    static bool encode(Format format, const uint8_t *data, uint32_t length, ArrayBufferSink sink)
+    {
+        ArrayBufferView view(data, length);
+        if (!view.isValid() || !sink)
+            return false;
+
+        _Output output(format, sink);
+        return output.head(_ARRAY, view.size()) &&
+               ArrayBufferTranscoder::_encodeFields(&output, view) &&
+               output.flush();
+    }
+
+    static inline bool toMessagePack(const uint8_t *data, uint32_t length, ArrayBufferSink sink)
+    {
+        return ArrayBufferTranscoder::encode(MESSAGE_PACK, data, length, sink);
+    }
+
+    static inline bool toCBOR(const uint8_t *data, uint32_t length, ArrayBufferSink sink)
+    {
+        return ArrayBufferTranscoder::encode(CBOR, data, length, sink);
+    }
+
+    /**
+     * @brief convert an array into fields of a message, mode of output is decided by writer,
+     * lengths of lists and maps are measured ahead, so nested data is read once per level
+     * 把一个数组转换为消息的字段，输出的模式由writer决定，
+     * 列表和映射的长度需要预先计算，所以嵌套的数据每一层都会读取一次
+     *
+     * @param data MessagePack or CBOR data, an array at top MessagePack或CBOR数据，最外层是数组
+     * @param length length of data 数据长度
+     * @param writer output, not finished by this 输出，不会在此结束
+     * @return false if data is malformed, not supported or writer failed
+     * 数据格式错误、不支持或writer失败时返回false
+     */
+    static bool decode(Format format, const uint8_t *data, uint32_t length, ArrayBufferWriter *writer)
+    {
+        _Item top;
+        int32_t used = ArrayBufferTranscoder::_read(format, data, length, 0, &top);
+        if (used < 0 || top.kind != _ARRAY || !writer)
+            return false;
+
+        int64_t offset = used;
+        for (uint64_t i = 0; i < top.n && offset >= 0; ++i)
+            offset = ArrayBufferTranscoder::_decode(format, data, length, offset, writer, 0);
+
+        return offset == length && !writer->hasError();
+    }
+
+    static inline bool fromMessagePack(const uint8_t *data, uint32_t length, ArrayBufferWriter *writer)
+    {
+        return ArrayBufferTranscoder::decode(MESSAGE_PACK, data, length, writer);
+    }
+
+    static inline bool fromCBOR(const uint8_t *data, uint32_t length, ArrayBufferWriter *writer)
+    {
+        return ArrayBufferTranscoder::decode(CBOR, data, length, writer);
+    }
+
+private:
+    /**
+     * @brief kinds of items, first ones are major types of CBOR
+     * 数据项的种类，前几个是CBOR的主类型
+     */
+    typedef enum
+    {
+        _UNSIGNED = 0,
+        _NEGATIVE = 1,
+        _BYTES = 2,
+        _TEXT = 3,
+        _ARRAY = 4,
+        _MAP = 5,
+        _TAG = 6,
+        _NUMBER,
+        _TYPED
+    } _Kind;
+
+    /**
+     * @brief header of one MessagePack or CBOR item
+     * 一个MessagePack或CBOR数据项的头部
+     */
+    struct _Item
+    {
+        _Kind kind = _NUMBER;
+
+        /**
+         * @brief length of bytes, text and typed array, count of array and map
+         * 字节串、文本和类型化数组的长度，数组和映射的元素数量
+         */
+        uint64_t n = 0;
+
+        /**
+         * @brief number in smallest type, or item type of typed array
+         * 使用最小类型的数字，或者类型化数组的元素类型
+         */
+        ElementType type = ETYPE_VOID;
+        ElementData value;
+    };
+
+    /**
+     * @brief staged output, small heads are merged before being handed to sink
+     * 带暂存的输出，较小的头部会合并后再交给输出端
+     */
+    class _Output
+    {
+    private:
+        Format format;
+        ArrayBufferSink sink;
+        uint8_t staging[ARRAY_BUFFER_WRITER_STAGING_SIZE];
+        uint32_t used = 0;
+
+        /**
+         * @brief mark followed by n in big endian
+         * 标志后跟大端序的n
+         */
+        inline bool _prefix(uint8_t mark, uint64_t n, uint8_t width)
+        {
+            uint8_t head[9];
+            head[0] = mark;
+            ArrayBufferTranscoder::_putBig(head + 1, n, width);
+            return this->emit(head, width + 1);
+        }
+
+    public:
+        _Output(Format format, ArrayBufferSink sink) : format(format), sink(sink) {}
+
+        inline bool isCBOR() const { return this->format == CBOR; }
+
+        bool emit(const uint8_t *data, uint32_t length)
+        {
+            if (this->used + length <= ARRAY_BUFFER_WRITER_STAGING_SIZE)
+            {
+                memcpy(this->staging + this->used, data, length);
+                this->used += length;
+                return true;
+            }
+            if (!this->flush())
+                return false;
+            if (length <= ARRAY_BUFFER_WRITER_STAGING_SIZE)
+            {
+                memcpy(this->staging, data, length);
+                this->used = length;
+                return true;
+            }
+
+            // large payload goes to sink directly, no copy
+            // 大块数据直接交给输出端，不拷贝
+            return this->sink(data, length);
+        }
+
+        bool flush()
+        {
+            if (this->used && !this->sink(this->staging, this->used))
+                return false;
+            this->used = 0;
+            return true;
+        }
+
+        /**
+         * @brief head of an item in smallest form, n is value of unsigned, -1 - value of negative,
+         * length of bytes and text, count of array and map, or number of tag
+         * 使用最小形式的数据项头部，n为无符号数的值、负数的 -1 - 值、字节串和文本的长度、
+         * 数组和映射的元素数量或标签号
+         */
+        bool head(_Kind kind, uint64_t n)
+        {
+            uint8_t width = n <= 0xff ? 1 : (n <= 0xffff ? 2 : (n <= 0xffffffffull ? 4 : 8));
+            uint8_t size = width == 1 ? 0 : (width == 2 ? 1 : (width == 4 ? 2 : 3));
+
+            if (this->format == CBOR)
+            {
+                uint8_t major = (uint8_t)kind << 5;
+                if (n < 24)
+                {
+                    major |= (uint8_t)n;
+                    return this->emit(&major, 1);
+                }
+                return this->_prefix(major | (24 + size), n, width);
+            }
+
+            switch (kind)
+            {
+            case _UNSIGNED:
+                if (n < 0x80)
+                    return this->_prefix((uint8_t)n, 0, 0);
+                return this->_prefix(0xcc + size, n, width);
+            case _NEGATIVE:
+            {
+                int64_t v = -1 - (int64_t)n;
+                if (v >= -32)
+                    return this->_prefix((uint8_t)v, 0, 0);
+                width = v >= -128 ? 1 : (v >= -32768 ? 2 : (v >= -2147483647ll - 1 ? 4 : 8));
+                size = width == 1 ? 0 : (width == 2 ? 1 : (width == 4 ? 2 : 3));
+                return this->_prefix(0xd0 + size, (uint64_t)v, width);
+            }
+            case _BYTES:
+                return size < 3 ? this->_prefix(0xc4 + size, n, width) : false;
+            case _TEXT:
+                if (n < 32)
+                    return this->_prefix(0xa0 | (uint8_t)n, 0, 0);
+                return size < 3 ? this->_prefix(0xd9 + size, n, width) : false;
+            case _ARRAY:
+            case _MAP:
+                if (n < 16)
+                    return this->_prefix((kind == _ARRAY ? 0x90 : 0x80) | (uint8_t)n, 0, 0);
+                width = width < 2 ? 2 : width;
+                return width < 8 ? this->_prefix((kind == _ARRAY ? 0xdc : 0xde) + (width == 4), n, width) : false;
+            default:
+                return false;
+            }
+        }
+
+        bool number(const ElementNumber &n, bool single)
+        {
+            if (n.kind == ElementNumber::FLOATING)
+            {
+                uint8_t mark = this->format == CBOR ? (single ? 0xfa : 0xfb) : (single ? 0xca : 0xcb);
+                if (single)
+                {
+                    float f = (float)n.d;
+                    uint32_t bits = 0;
+                    memcpy(&bits, &f, 4);
+                    return this->_prefix(mark, bits, 4);
+                }
+                uint64_t bits = 0;
+                memcpy(&bits, &(n.d), 8);
+                return this->_prefix(mark, bits, 8);
+            }
+            if (n.kind == ElementNumber::SIGNED && n.i < 0)
+                return this->head(_NEGATIVE, (uint64_t)(-1 - n.i));
+            return this->head(_UNSIGNED, n.u);
+        }
+    };
+
+    static inline void _putBig(uint8_t *p, uint64_t n, uint8_t width)
+    {
+        for (uint8_t i = 0; i < width; ++i)
+            p[i] = (uint8_t)(n >> (8 * (width - 1 - i)));
+    }
+
+    static inline uint64_t _getBig(const uint8_t *p, uint8_t width)
+    {
+        uint64_t n = 0;
+        for (uint8_t i = 0; i < width; ++i)
+            n = (n << 8) | p[i];
+        return n;
+    }
+
+    /**
+     * @brief tag of RFC 8746 for little endian typed array, 0 if not supported
+     * RFC 8746 中小端序类型化数组的标签，不支持时为0
+     */
+    static uint8_t _getTag(ElementType type)
+    {
+        switch (type)
+        {
+        case ETYPE_UINT8:
+            return 64;
+        case ETYPE_UINT16:
+            return 69;
+        case ETYPE_UINT32:
+            return 70;
+        case ETYPE_UINT64:
+            return 71;
+        case ETYPE_INT8:
+            return 72;
+        case ETYPE_INT16:
+            return 77;
+        case ETYPE_INT32:
+            return 78;
+        case ETYPE_INT64:
+            return 79;
+        case ETYPE_FLOAT:
+            return 85;
+        case ETYPE_DOUBLE:
+            return 86;
+        default:
+            return 0;
+        }
+    }
+
+    static ElementType _getTagType(uint64_t tag)
+    {
+        // uint8 clamped is read as uint8
+        // 限幅的uint8按uint8读取
+        if (tag == 68)
+            return ETYPE_UINT8;
+        const ElementType types[] = {ETYPE_UINT8, ETYPE_UINT16, ETYPE_UINT32, ETYPE_UINT64,
+                                     ETYPE_INT8, ETYPE_INT16, ETYPE_INT32, ETYPE_INT64,
+                                     ETYPE_FLOAT, ETYPE_DOUBLE};
+        for (uint8_t i = 0; i < sizeof(types) / sizeof(types[0]); ++i)
+            if (ArrayBufferTranscoder::_getTag(types[i]) == tag)
+                return types[i];
+        return ETYPE_VOID;
+    }
+
+    static bool _encodeFields(_Output *output, const ArrayBufferView &view)
+    {
+        for (auto it = view.begin(); it != view.end(); ++it)
+            if (!ArrayBufferTranscoder::_encodeField(output, *it))
+                return false;
+        return true;
+    }
+
+    static bool _encodeField(_Output *output, const ElementView &e)
+    {
+        ElementType type = e.getType();
+
+        if (type < 9)
+        {
+            // raw bytes of number at lowest bytes of union
+            // 数字的原始字节位于联合体的低字节
+            ElementData d;
+            d.u64 = e.getUint64();
+            return output->number(ElementNumber::from(d, type), type == ETYPE_FLOAT);
+        }
+
+        if (type == ETYPE_STRING)
+            return output->head(_TEXT, e.getStringLength()) &&
+                   output->emit((const uint8_t *)e.c_str(), e.getStringLength());
+
+        if (type == ETYPE_BUFFER)
+            return output->head(_BYTES, e.getRawBufferLength()) &&
+                   output->emit(e.getRawBuffer(), e.getRawBufferLength());
+
+        if (type == ETYPE_LIST || type == ETYPE_MAP)
+        {
+            ArrayBufferView children = e.getList();
+            return output->head(type == ETYPE_LIST ? _ARRAY : _MAP, type == ETYPE_LIST ? children.size() : children.size() / 2) &&
+                   ArrayBufferTranscoder::_encodeFields(output, children);
+        }
+
+        if (type != ETYPE_ARRAY)
+            return false;
+
+        // payload of typed array is item type and items
+        // 类型化数组的数据是元素类型和元素
+        ElementType itemType = e.getArrayType();
+        const uint8_t *items = e.getRawBuffer() + 1;
+        uint32_t length = e.getRawBufferLength() - 1;
+
+        if (output->isCBOR())
+            return output->head(_TAG, ArrayBufferTranscoder::_getTag(itemType)) &&
+                   output->head(_BYTES, length) &&
+                   output->emit(items, length);
+
+        uint8_t size = Element::getItemSize(itemType);
+        if (!output->head(_ARRAY, length / size))
+            return false;
+        for (uint32_t i = 0; i < length; i += size)
+        {
+            ElementData d;
+            memcpy(&d, items + i, size);
+            if (!output->number(ElementNumber::from(d, itemType), itemType == ETYPE_FLOAT))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief put an integer into item with smallest type
+     * 以最小的类型把整数放入数据项
+     */
+    static void _setInteger(_Item *item, const ElementNumber &n)
+    {
+        item->kind = _NUMBER;
+        if (n.kind == ElementNumber::SIGNED && n.i < 0)
+            item->type = n.i >= -128 ? ETYPE_INT8 : (n.i >= -32768 ? ETYPE_INT16 : (n.i >= -2147483647ll - 1 ? ETYPE_INT32 : ETYPE_INT64));
+        else
+            item->type = n.u <= 0xff ? ETYPE_UINT8 : (n.u <= 0xffff ? ETYPE_UINT16 : (n.u <= 0xffffffffull ? ETYPE_UINT32 : ETYPE_UINT64));
+        n.store(&(item->value), item->type);
+    }
+
+    static void _setFloating(_Item *item, double d, bool single)
+    {
+        item->kind = _NUMBER;
+        item->type = single ? ETYPE_FLOAT : ETYPE_DOUBLE;
+        item->value.u64 = 0;
+        if (single)
+            item->value.f = (float)d;
+        else
+            item->value.d = d;
+    }
+
+    /**
+     * @brief read head of one MessagePack item
+     * 读取一个MessagePack数据项的头部
+     *
+     * @return length of head, -1 if malformed or not supported 头部的长度，格式错误或不支持时返回-1
+     */
+    static int32_t _readMessagePack(const uint8_t *data, uint32_t length, uint32_t offset, _Item *item)
+    {
+        uint8_t mark = data[offset];
+        uint32_t available = length - offset - 1;
+        const uint8_t *p = data + offset + 1;
+        uint8_t width = 0;
+
+        if (mark < 0x80 || mark >= 0xe0)
+        {
+            ArrayBufferTranscoder::_setInteger(item, ElementNumber::of((int8_t)mark));
+            return 1;
+        }
+        if (mark < 0xa0)
+        {
+            item->kind = mark < 0x90 ? _MAP : _ARRAY;
+            item->n = mark & 0x0f;
+            return 1;
+        }
+        if (mark < 0xc0)
+        {
+            item->kind = _TEXT;
+            item->n = mark & 0x1f;
+            return 1;
+        }
+
+        switch (mark)
+        {
+        case 0xc2:
+        case 0xc3:
+            ArrayBufferTranscoder::_setInteger(item, ElementNumber::of((uint8_t)(mark == 0xc3)));
+            return 1;
+        case 0xc4:
+        case 0xc5:
+        case 0xc6:
+            item->kind = _BYTES;
+            width = 1 << (mark - 0xc4);
+            break;
+        case 0xca:
+        case 0xcb:
+        {
+            width = mark == 0xca ? 4 : 8;
+            if (available < width)
+                return -1;
+            uint64_t bits = ArrayBufferTranscoder::_getBig(p, width);
+            float f;
+            double d;
+            memcpy(&f, &bits, 4);
+            memcpy(&d, &bits, 8);
+            ArrayBufferTranscoder::_setFloating(item, width == 4 ? f : d, width == 4);
+            return width + 1;
+        }
+        case 0xcc:
+        case 0xcd:
+        case 0xce:
+        case 0xcf:
+        case 0xd0:
+        case 0xd1:
+        case 0xd2:
+        case 0xd3:
+        {
+            width = 1 << ((mark - 0xcc) & 3);
+            if (available < width)
+                return -1;
+            uint64_t n = ArrayBufferTranscoder::_getBig(p, width);
+            if (mark >= 0xd0)
+            {
+                // sign extended from width
+                // 按宽度进行符号扩展
+                uint8_t shift = 64 - 8 * width;
+                ArrayBufferTranscoder::_setInteger(item, ElementNumber::of((int64_t)(n << shift) >> shift));
+            }
+            else
+            {
+                ArrayBufferTranscoder::_setInteger(item, ElementNumber::of(n));
+            }
+            return width + 1;
+        }
+        case 0xd9:
+        case 0xda:
+        case 0xdb:
+            item->kind = _TEXT;
+            width = 1 << (mark - 0xd9);
+            break;
+        case 0xdc:
+        case 0xdd:
+            item->kind = _ARRAY;
+            width = mark == 0xdc ? 2 : 4;
+            break;
+        case 0xde:
+        case 0xdf:
+            item->kind = _MAP;
+            width = mark == 0xde ? 2 : 4;
+            break;
+        default:
+            // nil, ext and reserved
+            // nil、ext和保留的标志
+            return -1;
+        }
+
+        if (available < width)
+            return -1;
+        item->n = ArrayBufferTranscoder::_getBig(p, width);
+        return width + 1;
+    }
+
+    /**
+     * @brief read head of one CBOR item, tags before it are read together
+     * 读取一个CBOR数据项的头部，其前面的标签会一同读取
+     *
+     * @return length of head, -1 if malformed or not supported 头部的长度，格式错误或不支持时返回-1
+     */
+    static int32_t _readCBOR(const uint8_t *data, uint32_t length, uint32_t offset, _Item *item)
+    {
+        uint32_t start = offset;
+        ElementType tagType = ETYPE_VOID;
+
+        for (;;)
+        {
+            if (offset >= length)
+                return -1;
+
+            uint8_t major = data[offset] >> 5;
+            uint8_t info = data[offset] & 0x1f;
+            uint32_t available = length - offset - 1;
+            uint8_t width = info < 24 ? 0 : (info < 28 ? 1 << (info - 24) : 0xff);
+
+            // indefinite length and reserved
+            // 不定长度和保留值
+            if (width == 0xff || available < width)
+                return -1;
+
+            uint64_t n = width ? ArrayBufferTranscoder::_getBig(data + offset + 1, width) : info;
+            offset += width + 1;
+
+            switch (major)
+            {
+            case _UNSIGNED:
+                ArrayBufferTranscoder::_setInteger(item, ElementNumber::of(n));
+                break;
+            case _NEGATIVE:
+                if (n > 0x7fffffffffffffffull)
+                    return -1;
+                ArrayBufferTranscoder::_setInteger(item, ElementNumber::of(-1 - (int64_t)n));
+                break;
+            case _BYTES:
+            case _TEXT:
+            case _ARRAY:
+            case _MAP:
+                item->kind = (_Kind)major;
+                item->n = n;
+                break;
+            case _TAG:
+                // only the tag right before a byte string matters
+                // 只有紧挨着字节串的标签有意义
+                tagType = ArrayBufferTranscoder::_getTagType(n);
+                continue;
+            default:
+                if (info == 20 || info == 21)
+                {
+                    ArrayBufferTranscoder::_setInteger(item, ElementNumber::of((uint8_t)(info == 21)));
+                }
+                else if (info == 25)
+                {
+                    // half float, exact in float
+                    // 半精度浮点数，可以用float精确表示
+                    uint32_t mantissa = n & 0x3ff, exponent = (n >> 10) & 0x1f;
+                    double d = exponent == 31 ? (mantissa ? NAN : INFINITY)
+                                              : ldexp((double)(exponent ? mantissa + 1024 : mantissa), (exponent ? exponent : 1) - 25);
+                    ArrayBufferTranscoder::_setFloating(item, (n & 0x8000) ? -d : d, true);
+                }
+                else if (info == 26 || info == 27)
+                {
+                    float f;
+                    double d;
+                    memcpy(&f, &n, 4);
+                    memcpy(&d, &n, 8);
+                    ArrayBufferTranscoder::_setFloating(item, info == 26 ? f : d, info == 26);
+                }
+                else
+                {
+                    // null, undefined and other simple values
+                    // null、undefined和其他简单值
+                    return -1;
+                }
+                break;
+            }
+
+            if (major == _BYTES && tagType != ETYPE_VOID)
+            {
+                if (n % Element::getItemSize(tagType))
+                    return -1;
+                item->kind = _TYPED;
+                item->type = tagType;
+            }
+            return offset - start;
+        }
+    }
+
+    static int32_t _read(Format format, const uint8_t *data, uint32_t length, uint32_t offset, _Item *item)
+    {
+        if (!data || offset >= length)
+            return -1;
+
+        int32_t used = format == CBOR ? ArrayBufferTranscoder::_readCBOR(data, length, offset, item)
+                                      : ArrayBufferTranscoder::_readMessagePack(data, length, offset, item);
+
+        // payload must be in data
+        // 数据必须在范围内
+        if (used > 0 && (item->kind == _BYTES || item->kind == _TEXT || item->kind == _TYPED) &&
+            item->n > length - offset - used)
+            return -1;
+        return used;
+    }
+
+    /**
+     * @brief length of a string, uint8 array, list, map or typed array on wire
+     * 字符串、二进制数组、列表、映射或类型化数组在传输格式中的长度
+     */
+    static inline uint64_t _getOuterLength(uint64_t payload, bool compact)
+    {
+        return (compact ? 1 + ArrayBufferVarint::length(payload) : 5) + payload;
+    }
+
+    /**
+     * @brief measure length of one item in ArrayBuffer format, item is checked as well
+     * 计算一个数据项在ArrayBuffer格式中的长度，同时检查数据项
+     *
+     * @return offset after item, -1 if malformed or not supported 数据项之后的偏移量，格式错误或不支持时返回-1
+     */
+    static int64_t _measure(Format format, const uint8_t *data, uint32_t length, uint32_t offset,
+                            bool compact, uint8_t depth, uint64_t *outer, _Kind *kind)
+    {
+        _Item item;
+        int32_t used = ArrayBufferTranscoder::_read(format, data, length, offset, &item);
+        if (used < 0)
+            return -1;
+        offset += used;
+        *kind = item.kind;
+
+        switch (item.kind)
+        {
+        case _NUMBER:
+            *outer = 1 + ((compact && item.type != ETYPE_FLOAT && item.type != ETYPE_DOUBLE)
+                              ? ArrayBufferVarint::length(ArrayBufferVarint::fromData(item.value, item.type))
+                              : Element::getItemSize(item.type));
+            return offset;
+        case _TEXT:
+        case _TYPED:
+            // terminator of string or item type of typed array
+            // 字符串的结束符或类型化数组的元素类型
+            *outer = ArrayBufferTranscoder::_getOuterLength(item.n + 1, compact);
+            return offset + item.n;
+        case _BYTES:
+            *outer = ArrayBufferTranscoder::_getOuterLength(item.n, compact);
+            return offset + item.n;
+        default:
+            break;
+        }
+
+        uint64_t payload = 0;
+        int64_t next = ArrayBufferTranscoder::_measureChildren(format, data, length, offset, item, compact, depth, &payload);
+        *outer = ArrayBufferTranscoder::_getOuterLength(payload, compact);
+        return next;
+    }
+
+    /**
+     * @brief measure total length of children of an array or map in ArrayBuffer format
+     * 计算数组或映射的子元素在ArrayBuffer格式中的总长度
+     *
+     * @param offset offset of first child 第一个子元素的偏移量
+     * @return offset after children, -1 if malformed or not supported 子元素之后的偏移量，格式错误或不支持时返回-1
+     */
+    static int64_t _measureChildren(Format format, const uint8_t *data, uint32_t length, uint32_t offset,
+                                    const _Item &item, bool compact, uint8_t depth, uint64_t *payload)
+    {
+        if (depth >= ARRAY_BUFFER_MAX_DEPTH)
+            return -1;
+
+        uint64_t count = item.kind == _MAP ? item.n * 2 : item.n;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            uint64_t child = 0;
+            _Kind childKind;
+            int64_t next = ArrayBufferTranscoder::_measure(format, data, length, offset, compact, depth + 1, &child, &childKind);
+
+            // keys of map must be strings
+            // 映射的键必须是字符串
+            if (next < 0 || (item.kind == _MAP && !(i % 2) && childKind != _TEXT))
+                return -1;
+            offset = next;
+            (*payload) += child;
+            if ((*payload) > 0xffffffffull)
+                return -1;
+        }
+        return offset;
+    }
+
+    /**
+     * @brief convert one item and write it
+     * 转换并写入一个数据项
+     *
+     * @return offset after item, -1 if malformed, not supported or writer failed
+     * 数据项之后的偏移量，格式错误、不支持或writer失败时返回-1
+     */
+    static int64_t _decode(Format format, const uint8_t *data, uint32_t length, uint32_t offset,
+                           ArrayBufferWriter *writer, uint8_t depth)
+    {
+        _Item item;
+        int32_t used = ArrayBufferTranscoder::_read(format, data, length, offset, &item);
+        if (used < 0)
+            return -1;
+        offset += used;
+
+        switch (item.kind)
+        {
+        case _NUMBER:
+            return writer->writeNumber(item.type, item.value) ? offset : -1;
+        case _TEXT:
+        {
+            uint8_t terminator = 0;
+            return (writer->writeHeader(ETYPE_STRING, item.n + 1) &&
+                    writer->writePayload(data + offset, item.n) &&
+                    writer->writePayload(&terminator, 1))
+                       ? offset + item.n
+                       : -1;
+        }
+        case _BYTES:
+            return (writer->writeHeader(ETYPE_BUFFER, item.n) &&
+                    writer->writePayload(data + offset, item.n))
+                       ? offset + item.n
+                       : -1;
+        case _TYPED:
+        {
+            uint8_t itemType = (uint8_t)item.type;
+            return (writer->writeHeader(ETYPE_ARRAY, item.n + 1) &&
+                    writer->writePayload(&itemType, 1) &&
+                    writer->writePayload(data + offset, item.n))
+                       ? offset + item.n
+                       : -1;
+        }
+        default:
+            break;
+        }
+
+        // children are measured ahead for length of payload
+        // 预先计算子元素的长度作为数据的长度
+        uint64_t payload = 0;
+        if (ArrayBufferTranscoder::_measureChildren(format, data, length, offset, item, writer->isCompact(), depth, &payload) < 0 ||
+            !writer->writeHeader(item.kind == _MAP ? ETYPE_MAP : ETYPE_LIST, payload))
+            return -1;
+
+        uint64_t count = item.kind == _MAP ? item.n * 2 : item.n;
+        int64_t next = offset;
+        for (uint64_t i = 0; i < count && next >= 0; ++i)
+            next = ArrayBufferTranscoder::_decode(format, data, length, next, writer, depth + 1);
+        return next;
+    }
+};
+
+#endif
@@ -151,10 +151,11 @@ void GlobalManager::syncTime(uint64_t t)
 void GlobalManager::buildProvidersBuffer(bool buildAll)
 {
     ESP_LOGD(SYSTEM_DEBUG_HEADER, "Building provider bufffer");
-    std::vector<Element *> providerBufferContainer;
 
-    uint8_t *providerBuffer = nullptr;
-    uint32_t providerOutLen = 0;
+    // every provider is a nested uint8 array, written in place without intermediate buffers
+    // 每个provider是一个嵌套的二进制数组，直接写入，不创建中间buffer
+    uint32_t length = 0;
+    uint32_t count = 0;
 
     for (
         std::vector<Provider *>::iterator it = this->providers->begin();
@@ -168,41 +169,65 @@ void GlobalManager::buildProvidersBuffer(bool buildAll)
             continue;
         }
 
-        providerBuffer = (*it)->getBuffer(&providerOutLen);
-        if (providerBuffer && providerBuffer)
-        {
-            providerBufferContainer.push_back(new Element(providerBuffer, providerOutLen));
-            delete providerBuffer;
-            providerBuffer = nullptr;
-        }
+        length += 5 + (*it)->getOuterBufferLength();
+        ++count;
     }
 
-    ESP_LOGD(SYSTEM_DEBUG_HEADER, "Providers buffer container had been built, length: %d", providerBufferContainer.size());
+    ESP_LOGD(SYSTEM_DEBUG_HEADER, "Providers counted: %d, length: %d", count, length);
 
-    if (providerBufferContainer.size())
+    if (!count)
     {
-        if (this->bufferProviders)
-        {
-            delete this->bufferProviders;
-        }
-
-        this->isProviderBufferShrank = buildAll ? false : true;
+        ESP_LOGD(SYSTEM_DEBUG_HEADER, "None provier provide nickname");
+        return;
+    }
 
-        this->bufferProviders = ArrayBuffer::createArrayBuffer(&providerBufferContainer, &(this->bufferProvidersLength));
+    uint8_t *buffer = new (std::nothrow) uint8_t[length];
+    if (!buffer)
+    {
+        ESP_LOGD(SYSTEM_DEBUG_HEADER, "memory allocate failed");
+        return;
+    }
 
-        ESP_LOGD(SYSTEM_DEBUG_HEADER, "Providers buffer had been built");
+    uint32_t offset = 0;
+    bool success = true;
+    {
+        ArrayBufferWriter writer(ArrayBufferWriter::toBuffer(buffer, length, &offset));
 
-        for (uint32_t i = 0; i < providerBufferContainer.size(); ++i)
+        for (
+            std::vector<Provider *>::iterator it = this->providers->begin();
+            it != this->providers->end() && success;
+            ++it)
         {
-            delete providerBufferContainer.at(i);
+            if (!buildAll && (*it)->isBuiltIn)
+            {
+                continue;
+            }
+            success = (*it)->write(&writer);
         }
 
-        ESP_LOGD(SYSTEM_DEBUG_HEADER, "Providers buffer container cache had been removed");
+        success = success && writer.flush() && offset == length;
     }
-    else
+
+    if (!success)
     {
-        ESP_LOGD(SYSTEM_DEBUG_HEADER, "None provier provide nickname");
+        ESP_LOGD(SYSTEM_DEBUG_HEADER, "Providers buffer build failed");
+        delete[] buffer;
+        return;
+    }
+
+    // copied once into a shared payload, so each response holding it copies nothing
+    // 拷贝一次到共享的数据中，之后每个包含它的响应都不再拷贝
+    bool copied = this->bufferProviders.copyFrom(buffer, length);
+    delete[] buffer;
+    if (!copied)
+    {
+        ESP_LOGD(SYSTEM_DEBUG_HEADER, "memory allocate failed");
+        return;
     }
+
+    this->isProviderBufferShrank = buildAll ? false : true;
+
+    ESP_LOGD(SYSTEM_DEBUG_HEADER, "Providers buffer had been built");
 }
 
 void GlobalManager::buildUsersBuffer()
@@ -335,7 +360,7 @@ void GlobalManager::markNewFirmwareIsValid()
 
 void GlobalManager::executeCommand(
     std::vector<Element *> *output,
-    std::vector<Element *> *response)
+    ElementList *response)
 {
     /*
         1 == esp32 id
@@ -349,21 +374,21 @@ void GlobalManager::executeCommand(
     */
     bool isAdmin = false;
 
-    if ((output->size() == 7 || output->size() == 6) &&
-        output->at(4)->getType() == ETYPE_BUFFER &&
-        output->at(4)->getRawBufferLength() == SHA_LENGTH &&
+    if (output->size() <= ExecuteCommandSchema::size + 1 &&
+        ExecuteCommandSchema::validate(output, true) &&
         this->authorize(output->at(4), output->at(3), &isAdmin))
     {
         ESP_LOGD(SYSTEM_DEBUG_HEADER, "authorized");
 
         Element *result = nullptr;
-        ProviderArguments arguments = nullptr;
+        ElementList arguments;
+        bool decoded = false;
 
         // fill response
-        response->push_back(new Element(CMD_LOG));
-        response->push_back(new Element(this->getUniversalID().getRawBuffer(), 32));
-        response->push_back(new Element(output->at(2)->getString()));
-        response->push_back(new Element("unavailable"));
+        response->emplace_back(CMD_LOG);
+        response->emplace_back((uint8_t *)this->getUniversalID().getRawBuffer(), 32);
+        response->emplace_back(output->at(2));
+        response->emplace_back("unavailable");
 
         int providerIndex = -2;
 
@@ -408,30 +433,32 @@ void GlobalManager::executeCommand(
 
                 if (aesOutLen && buffer)
                 {
-                    arguments = ArrayBuffer::decodeArrayBuffer(buffer, aesOutLen);
+                    decoded = ArrayBuffer::decodeArrayBuffer(buffer, aesOutLen, &arguments, &(this->messageArena));
                     delete buffer;
                 }
             }
             else
             {
-                arguments = ArrayBuffer::decodeArrayBuffer(output->at(6)->getUint8Array(),
-                                                           output->at(6)->getRawBufferLength());
+                decoded = ArrayBuffer::decodeArrayBuffer(output->at(6)->getUint8Array(),
+                                                         output->at(6)->getRawBufferLength(),
+                                                         &arguments,
+                                                         &(this->messageArena));
             }
         }
         else
         {
-            arguments = new std::vector<Element *>();
+            decoded = true;
         }
 
-        // run callback
-        result = this->providers->at(providerIndex)->cb(arguments);
-
-        // clean
-        for (uint32_t i = 0; i < arguments->size(); ++i)
+        if (!decoded)
         {
-            delete arguments->at(i);
+            ESP_LOGD(SYSTEM_DEBUG_HEADER, "invalid arguments");
+            return;
         }
-        delete arguments;
+
+        // run callback
+        // arguments are destroyed on return, their payload bytes live in message arena
+        result = this->providers->at(providerIndex)->cb(&arguments);
 
         // fill result
         if (result)
@@ -452,16 +479,16 @@ void GlobalManager::executeCommand(
 
                         if (aesOutLen && encryptedBuffer)
                         {
-                            response->at(3)->copyFrom(encryptedBuffer, aesOutLen);
-                            response->push_back(new Element(0x10));
-                            delete encryptedBuffer;
+                            // response takes over cipher, no copy
+                            response->at(3)->adoptBuffer(encryptedBuffer, aesOutLen);
+                            response->emplace_back(0x10);
                         }
+                        delete buffer;
                     }
                     else
                     {
-                        response->at(3)->copyFrom(buffer, outLen);
+                        response->at(3)->adoptBuffer(buffer, outLen);
                     }
-                    delete buffer;
                 }
                 else
                 {
@@ -497,8 +524,19 @@ void GlobalManager::routeDataToWebsocketHandler(uint8_t *data,
         return;
     }
 
-    // decode buffer and call message handler
-    std::vector<Element *> *output = ArrayBuffer::decodeArrayBuffer(data, length);
+    // decode buffer into message arena and call message handler
+    // frame is validated in place before decoding, malformed data will be dropped
+    // all elements of this message are released at once after handled
+    // 把数据解码到消息arena中，解码之前会先原地校验数据帧，格式错误的数据直接丢弃
+    // 消息处理完成后，所有元素一次性释放
+    std::vector<Element *> *output = ArrayBuffer::decodeArrayBuffer(data, length, &(this->messageArena));
+
+    if (!output)
+    {
+        ESP_LOGD(SYSTEM_DEBUG_HEADER, "malformed frame dropped");
+        this->messageArena.reset();
+        return;
+    }
 
     //  call handler
     if (!client)
@@ -510,13 +548,7 @@ void GlobalManager::routeDataToWebsocketHandler(uint8_t *data,
         this->internalLocalMsgHandler(client, event, data, length, output);
     }
 
-    for (std::vector<Element *>::iterator it = output->begin();
-         it != output->end();
-         ++it)
-    {
-        delete (*it);
-    }
-    delete output;
+    this->messageArena.reset();
 }
 
 void GlobalManager::connectWifi()
@@ -620,8 +652,8 @@ void GlobalManager::internalLocalMsgHandler(
     // get command
     uint8_t command = output->at(0)->getUint8();
 
-    // response container
-    std::vector<Element *> *response = new std::vector<Element *>();
+    // response container, fields are stored by value
+    ElementList response;
 
     switch (command)
     {
@@ -639,7 +671,6 @@ void GlobalManager::internalLocalMsgHandler(
             if (lengthOfOutput != 10)
             {
                 ESP_LOGD(SYSTEM_DEBUG_HEADER, "invalid length of arguments");
-                delete response;
                 return;
             }
 
@@ -647,14 +678,14 @@ void GlobalManager::internalLocalMsgHandler(
 
             // nickname
             if (output->at(1)->getType() == ETYPE_STRING)
-                (*(db)("nickname")) = output->at(1)->getString();
+                (*(db)("nickname")) = output->at(1);
             // db->update("nickname", output->at(1)->getString());
 
             // wifi information
             if (output->at(2)->getType() == ETYPE_STRING && output->at(3)->getType() == ETYPE_STRING)
             {
-                (*(db)("wifiSSID")) = output->at(2)->getString();
-                (*(db)("wifiPwd")) = output->at(3)->getString();
+                (*(db)("wifiSSID")) = output->at(2);
+                (*(db)("wifiPwd")) = output->at(3);
             }
 
             // for remote management (admin)
@@ -666,22 +697,22 @@ void GlobalManager::internalLocalMsgHandler(
 
             // websocket information(remote)
             if (output->at(6)->getType() == ETYPE_STRING)
-                (*(db)("websocketDomain")) = output->at(6)->getString();
+                (*(db)("websocketDomain")) = output->at(6);
 
             if (output->at(7)->getType(true) == ETYPE_NUMBER)
                 (*(db)("websocketPort")) = (uint16_t)(output->at(7)->getNumber());
 
             if (output->at(8)->getType() == ETYPE_STRING)
-                (*(db)("websocketPath")) = output->at(8)->getString();
+                (*(db)("websocketPath")) = output->at(8);
 
             if (output->at(9)->getType() == ETYPE_STRING)
-                (*db("token")) = output->at(9)->getString();
+                (*db("token")) = output->at(9);
 
             // write to flash
             db.flush();
 
             // give response to client
-            response->push_back(new Element(CMD_AP_SET_BASIC_INFORMATION));
+            response.emplace_back(CMD_AP_SET_BASIC_INFORMATION);
 
             break;
         }
@@ -689,7 +720,7 @@ void GlobalManager::internalLocalMsgHandler(
         // reboot
         {
             // response
-            response->push_back(new Element(CMD_AP_DELAY_REBOOT));
+            response.emplace_back(CMD_AP_DELAY_REBOOT);
 
             // db->update("rebootReason", "ap manual reboot");
             (*(db)("rebootReason")) = "ap manual reboot";
@@ -713,7 +744,7 @@ void GlobalManager::internalLocalMsgHandler(
     case CMD_AP_ROLLBACK:
         // rollback
         {
-            response->push_back(new Element(CMD_AP_ROLLBACK));
+            response.emplace_back(CMD_AP_ROLLBACK);
 
             // db->update("rebootReason", "ap rollback");
             (*(db)("rebootReason")) = "ap rollback";
@@ -730,7 +761,7 @@ void GlobalManager::internalLocalMsgHandler(
     case CMD_AP_DEEPSLEEP:
         // deepsleep
         {
-            response->push_back(new Element(CMD_AP_DEEPSLEEP));
+            response.emplace_back(CMD_AP_DEEPSLEEP);
 
             // manual deepsleep
             setTimeout(
@@ -760,24 +791,24 @@ void GlobalManager::internalLocalMsgHandler(
             }
 
             // store wifi info
-            (*(db)("wifiSSID")) = output->at(1)->getString();
-            (*(db)("wifiPwd")) = output->at(2)->getString();
+            (*(db)("wifiSSID")) = output->at(1);
+            (*(db)("wifiPwd")) = output->at(2);
             // db->update("wifiSSID", output->at(1)->getString().c_str());
             // db->update("wifiPwd", output->at(2)->getString().c_str());
             db.flush();
 
             // fill reponse
-            response->push_back(new Element(CMD_AP_CONNECT_WIFI));
+            response.emplace_back(CMD_AP_CONNECT_WIFI);
 
             this->connectWifi();
 
             if ( != WL_CONNECTED)
             {
-                response->push_back(new Element(CMD_AP_WIFI_UNAVAILABLE));
+                response.emplace_back(CMD_AP_WIFI_UNAVAILABLE);
             }
             else
             {
-                response->push_back(new Element(CMD_AP_WIFI_CONNECTED));
+                response.emplace_back(CMD_AP_WIFI_CONNECTED);
             }
 
             break;
@@ -787,28 +818,11 @@ void GlobalManager::internalLocalMsgHandler(
         break;
     }
 
-    if (response->size())
+    if (response.size())
     {
-        // create buffer and send it if response container isn't empty
-        ArrayBuffer::createArrayBuffer(
-            response,
-            [client, response](uint8_t *buffer, uint64_t length, bool *deleted)
-            {
-                // send buffer
-                client->send(buffer, length);
-
-                // delete objs
-                for (std::vector<Element *>::iterator it = response->begin();
-                     it != response->end();
-                     ++it)
-                {
-                    delete (*it);
-                }
-            });
+        // encode and send it if response container isn't empty
+        this->sendElements(client, &response);
     }
-
-    // delete container
-    delete response;
 }
 
 void GlobalManager::internalRemoteMsgHandler(
@@ -865,8 +879,8 @@ void GlobalManager::internalRemoteMsgHandler(
         }
     }
 
-    // create response container
-    std::vector<Element *> *response = new std::vector<Element *>();
+    // create response container, fields are stored by value
+    ElementList response;
 
     switch (command)
     {
@@ -915,17 +929,17 @@ void GlobalManager::internalRemoteMsgHandler(
                         String token = db("token")->getString();
                         if (token.length())
                         {
-                            response->push_back(new Element(CMD_REGISTER_OR_ROLE_AUTHORIZE));
+                            response.emplace_back(CMD_REGISTER_OR_ROLE_AUTHORIZE);
                             uint64_t t = globalTime->getTime();
-                            char time[24] = {0};
-                            sprintf(time, "%llu", t);
+                            char time[ELEMENT_NUMBER_CHARS_SIZE];
+                            ElementNumber::of(t).toChars(time);
                             String hash = token + time;
                             hash = mycrypto::SHA::sha256(hash);
-                            Element *eHash = new Element(hash);
-                            if (eHash->convertHexStringIntoUint8Array())
+                            Element eHash(hash);
+                            if (eHash.convertHexStringIntoUint8Array())
                             {
-                                response->push_back(new Element(t));
-                                response->push_back(eHash);
+                                response.emplace_back(t);
+                                response.push_back(std::move(eHash));
                             }
                             else
                             {
@@ -951,9 +965,7 @@ void GlobalManager::internalRemoteMsgHandler(
         */
         {
             // check data
-            if (output->size() == 6 &&
-                output->at(OFFSET_START_OTA_ADMIN)->getType() == ETYPE_STRING &&
-                output->at(OFFSET_START_OTA_HASH)->getType() == ETYPE_BUFFER)
+            if (OTAStartSchema::validate(output))
             {
                 // authorize user
                 ESP_LOGD(SYSTEM_DEBUG_HEADER, "user authrozied");
@@ -975,16 +987,16 @@ void GlobalManager::internalRemoteMsgHandler(
                             output, // input arguments
 
                             // start failed callback
-                            [this, response, output](int code)
+                            [this, &response, output](int code)
                             {
                                 ESP_LOGD(SYSTEM_DEBUG_HEADER, "OTA update start failed");
                                 // 1 == board id, string
                                 // 2 == web client id, string
                                 // 3 == log, string
-                                response->push_back(new Element(CMD_LOG));
-                                response->push_back(new Element(this->getUniversalID().getRawBuffer(), 32));
-                                response->push_back(new Element(output->at(1)->getString()));
-                                response->push_back(new Element("ota start failed"));
+                                response.emplace_back(CMD_LOG);
+                                response.emplace_back((uint8_t *)this->getUniversalID().getRawBuffer(), 32);
+                                response.emplace_back(output->at(1));
+                                response.emplace_back("ota start failed");
                                 delete this->ota;
                             },
 
@@ -1000,10 +1012,10 @@ void GlobalManager::internalRemoteMsgHandler(
 
                         // give a response to administrator
                         // using log channel
-                        response->push_back(new Element(CMD_LOG));
-                        response->push_back(new Element(this->getUniversalID().getRawBuffer(), 32));
-                        response->push_back(new Element(output->at(1)->getString()));
-                        response->push_back(new Element("OTA Update Started"));
+                        response.emplace_back(CMD_LOG);
+                        response.emplace_back((uint8_t *)this->getUniversalID().getRawBuffer(), 32);
+                        response.emplace_back(output->at(1));
+                        response.emplace_back("OTA Update Started");
 
                         // record start time
                         global->otaStartTime = millis();
@@ -1041,14 +1053,14 @@ void GlobalManager::internalRemoteMsgHandler(
                 // role authorized
                 // send basic information
                 // back command is 0xfa
-                this->getFindDeviceBuffer(output->at(1)->getString().c_str(), response, isAdmin);
+                this->getFindDeviceBuffer(output->at(1)->getString().c_str(), &response, isAdmin);
 
                 if (msgShouldConfirm)
                 {
-                    uint64_t originalCmd = response->at(0)->getUint64();
+                    uint64_t originalCmd = response.at(0)->getUint64();
                     originalCmd |= msgID; // attach msg id
                     originalCmd |= CMD_CONFIRM;
-                    response->at(0)->setNumber(originalCmd, ETYPE_UINT64);
+                    response.at(0)->setNumber(originalCmd, ETYPE_UINT64);
                 }
             }
 
@@ -1058,13 +1070,13 @@ void GlobalManager::internalRemoteMsgHandler(
     case CMD_EXECUTE_COMMAND:
         // execute command
         {
-            this->executeCommand(output, response);
+            this->executeCommand(output, &response);
             if (msgShouldConfirm)
             {
-                uint64_t originalCmd = response->at(0)->getUint64();
+                uint64_t originalCmd = response.at(0)->getUint64();
                 originalCmd |= msgID; // attach msg id
                 originalCmd |= CMD_CONFIRM;
-                response->at(0)->setNumber(originalCmd, ETYPE_UINT64);
+                response.at(0)->setNumber(originalCmd, ETYPE_UINT64);
             }
             break;
         }
@@ -1077,59 +1089,69 @@ void GlobalManager::internalRemoteMsgHandler(
     }
 
     // create buffer and send it if response container isn't empty
-    if (response->size())
+    if (response.size())
     {
-        // create buffer
-        uint32_t outLen = 0;
-        uint8_t *buffer = ArrayBuffer::createArrayBuffer(response, &outLen);
-
-        if (buffer && outLen)
-        {
-            // send buffer
-            this->websocketClient->send(buffer, outLen);
-
-            // clear buffer
-            delete buffer;
-        }
-
-        // delete elements
-        for (std::vector<Element *>::iterator it = response->begin();
-             it != response->end();
-             ++it)
-        {
-            delete (*it);
-        }
+        // encode and send
+        this->sendElements(this->websocketClient, &response);
     }
-    // delete container
-    delete response;
 }
 
 bool GlobalManager::sendMessageToClient(const Element &msg)
 {
     if (this->isWifiConnected && this->websocketClient && this->websocketClient->connected())
     {
-        uint32_t outLen = 0;
+        Elements container = {&(this->eLogCommand), &(this->UniversalID), &(this->eAdminIDStr), const_cast<Element *>(&msg)};
 
-        uint8_t *buffer = ArrayBuffer::createArrayBuffer(
-            {this->eLogCommand, this->UniversalID, this->eAdminIDStr, msg}, &outLen);
+        // Serial.println("message sent");
+        return this->sendElements(this->websocketClient, &container);
+    }
+    return false;
+}
+
+template <class T>
+bool GlobalManager::_sendElements(myWebSocket::WebSocketClient *client, const T *elements)
+{
+    // frame header needs total length ahead
+    uint32_t outLen = ArrayBufferWriter::getOuterBufferLength(elements);
 
-        if (outLen && buffer)
+    if (!client || !outLen || !client->beginFrame(myWebSocket::TYPE_BIN, outLen))
+    {
+        return false;
+    }
+
+    ArrayBufferWriter writer(
+        [client](const uint8_t *data, uint32_t length) -> bool
         {
-            this->websocketClient->send(buffer, outLen);
-            delete buffer;
-            // Serial.println("message sent");
-            return true;
-        }
+            return client->writeFrame(data, length) == length;
+        });
+
+    // frame header is already sent, a short frame would break every frame after it
+    // 帧头已经发出，不完整的数据帧会破坏之后所有的数据帧
+    if (!writer.write(elements) || !writer.flush())
+    {
+        ESP_LOGD(SYSTEM_DEBUG_HEADER, "frame not finished, connection dropped");
+        client->abortFrame();
+        return false;
     }
-    return false;
+    return true;
+}
+
+bool GlobalManager::sendElements(myWebSocket::WebSocketClient *client, Elements *elements)
+{
+    return this->_sendElements(client, elements);
+}
+
+bool GlobalManager::sendElements(myWebSocket::WebSocketClient *client, ElementList *elements)
+{
+    return this->_sendElements(client, elements);
 }
 
 OneTimeAuthorization *GlobalManager::generateOneTimeAuthorization()
 {
     OneTimeAuthorization *authorization = new OneTimeAuthorization();
     authorization->time = globalTime->getTime();
-    char time[24] = {0};
-    sprintf(time, "%llu", authorization->time);
+    char time[ELEMENT_NUMBER_CHARS_SIZE];
+    ElementNumber::of(authorization->time).toChars(time);
     String hash = this->userName.getHex() + this->password.getHex() + time;
 // #ifdef CONFIG_IDF_TARGET_ESP32C3
 //     try
@@ -1206,21 +1228,8 @@ bool GlobalManager::_sendBundle(String frinedID, T command, uint16_t providerID,
         delete authorize;
     }
 
-    // prepare generate buffer
-    uint32_t outLen = 0;
-
-    // generate buffer
-    uint8_t *buffer = ArrayBuffer::createArrayBuffer(request, &outLen);
-
-    // check buffer
-    if (buffer && outLen)
-    {
-        // send buffer to remote server
-        this->websocketClient->send(buffer, outLen);
-
-        // remove buffer
-        delete buffer;
-    }
+    // encode and send to remote server
+    this->sendElements(this->websocketClient, request);
 
     // do clean process with container
     for (uint32_t i = 0; i < request->size(); ++i)
@@ -1239,8 +1248,8 @@ void GlobalManager::buildRegisterBuffer()
          (this->isNewFirmwareBoot ? 0x01 : 0x00), // if after ota updated
          ((this->usersBuffer &&
            this->lengthOfUsersBuffer)
-              ? (new Element(this->usersBuffer, this->lengthOfUsersBuffer))
-              : (new Element(0x00)))},
+              ? (Element(this->usersBuffer, this->lengthOfUsersBuffer, false))
+              : (Element(0x00)))},
         &(this->lengthOfRegisterBuffer));
 }
 
@@ -1324,7 +1333,10 @@ void GlobalManager::loadWebsocketInformation()
 
     if (db("websocketPort")->getType() == ETYPE_STRING)
     {
-        (*db("websocketPort")) = (uint16_t)(db("websocketPort")->getString().toInt());
+        ElementNumber port;
+        const char *str = db("websocketPort")->c_str();
+        ElementNumber::fromChars(str, strlen(str), &port);
+        (*db("websocketPort")) = port.to<uint16_t>();
         db.flush();
     }
 
@@ -1413,8 +1425,8 @@ void GlobalManager::initializeBasicInformation()
         Element userNameOfAdmin(PRESET_ADMIN_USERNAME);
         Element userPasswordOfAdmin(PRESET_ADMIN_PASSWORD);
 
-        if (userNameOfAdmin.getString().length() == 64 &&
-            userPasswordOfAdmin.getString().length() == 64)
+        if (userNameOfAdmin.getStringView().length() == 64 &&
+            userPasswordOfAdmin.getStringView().length() == 64)
         {
             ESP_LOGD(SYSTEM_DEBUG_HEADER, "preset admin info loaded");
             if (userNameOfAdmin.convertHexStringIntoUint8Array() &&
@@ -1445,7 +1457,7 @@ void GlobalManager::initializeBasicInformation()
     {
         // mark if there wifi information in flash
         this->isWiFiInfoOK =
-            db("wifiSSID")->getString().length() && db("wifiPwd")->getString().length();
+            db("wifiSSID")->getStringView().length() && db("wifiPwd")->getStringView().length();
 
         this->isWiFiInfoOK = this->isWiFiInfoOK ? 0xffu : 0;
 
@@ -1590,7 +1602,9 @@ void GlobalManager::initializeBasicInformation()
             }
 
             char buffer[128] = {0};
-            sprintf(buffer, "%s, %llu", strReason.c_str(), global->systemPowerOnTime);
+            char time[ELEMENT_NUMBER_CHARS_SIZE];
+            ElementNumber::of(global->systemPowerOnTime).toChars(time);
+            sprintf(buffer, "%s, %s", strReason.c_str(), time);
 
             return new Element(buffer);
         },
@@ -1604,7 +1618,7 @@ void GlobalManager::initializeBasicInformation()
             if (!arguments->size())
                 return new Element(PI_INVALID_LENGTH_OF_ARGUMENTS);
 
-            if ((arguments->at(0)->getType() != ETYPE_STRING) || (!arguments->at(0)->getString().length()))
+            if ((arguments->at(0)->getType() != ETYPE_STRING) || (!arguments->at(0)->getStringView().length()))
                 return new Element(PI_INVALID_ARGUMENT);
 
             *db("token") = arguments->at(0);
@@ -1628,17 +1642,16 @@ void GlobalManager::initializeBasicInformation()
                 return new Element(PI_INVALID_TYPE_OF_ARGUMENT);
             }
 
-            if ((!arguments->at(0)->getString().length()))
+            if ((!arguments->at(0)->getStringView().length()))
             {
                 return new Element(PI_INVALID_LENGTH_OF_ARGUMENT);
             }
 
             uint8_t userNameHash[32] = {0};
-            mycrypto::SHA::sha256((uint8_t *)arguments->at(0)->getString().c_str(),
-                                  arguments->at(0)->getString().length(),
-                                  userNameHash);
+            ElementStringView userName = arguments->at(0)->getStringView();
+            mycrypto::SHA::sha256((uint8_t *)userName.data(), userName.length(), userNameHash);
             Element *eUserName = new Element(userNameHash, 32);
-            if (!arguments->at(1)->getString().length())
+            if (!arguments->at(1)->getStringView().length())
             {
                 *(dbUser(eUserName)) = "";
                 dbUser.flush();
@@ -1646,9 +1659,8 @@ void GlobalManager::initializeBasicInformation()
             }
             uint8_t passwordHash[32] = {0};
 
-            mycrypto::SHA::sha256((uint8_t *)arguments->at(1)->getString().c_str(),
-                                  arguments->at(1)->getString().length(),
-                                  passwordHash);
+            ElementStringView password = arguments->at(1)->getStringView();
+            mycrypto::SHA::sha256((uint8_t *)password.data(), password.length(), passwordHash);
 
             Element *ePassword = new Element(passwordHash, 32);
 
@@ -1720,7 +1732,7 @@ void GlobalManager::initializeBasicInformation()
             if (!arguments->at(0)->available())
                 return new Element(PI_INVALID_ARGUMENT);
 
-            if (!arguments->at(0)->getString().length())
+            if (!arguments->at(0)->getStringView().length())
                 return new Element(PI_INVALID_ARGUMENT);
 
             (*db(arguments->at(0))) = "";
@@ -1877,16 +1889,16 @@ void GlobalManager::initializeBasicInformation()
             Element *value = new Element(PI_INVALID_SSID_PROVIDED);
             if (!arguments->size())
                 return value;
-            if (!arguments->at(0)->getType() == ETYPE_STRING || !arguments->at(0)->getString().length())
+            if (arguments->at(0)->getType() != ETYPE_STRING || !arguments->at(0)->getStringView().length())
                 return value;
 
             delete value;
 
-            *(db("wifiSSID")) = arguments->at(0)->getString();
+            *(db("wifiSSID")) = arguments->at(0);
             db.flush();
 
             char a[64]{0};
-            sprintf(a, PI_NEW_SSID_OR_PASSWORD_HAS_BEEN_SET, "SSID", arguments->at(0)->getString().c_str());
+            sprintf(a, PI_NEW_SSID_OR_PASSWORD_HAS_BEEN_SET, "SSID", arguments->at(0)->c_str());
 
             return new Element(a);
         },
@@ -1899,21 +1911,21 @@ void GlobalManager::initializeBasicInformation()
             Element *value = new Element(PI_INVALID_WIFI_PASSWORD);
             if (!arguments->size())
                 return value;
-            if (!arguments->at(0)->getType() == ETYPE_STRING || !arguments->at(0)->getString().length())
+            if (arguments->at(0)->getType() != ETYPE_STRING || !arguments->at(0)->getStringView().length())
                 return value;
-            if (arguments->at(0)->getString().length() < 8)
+            if (arguments->at(0)->getStringView().length() < 8)
                 return value;
 
             delete value;
 
-            *(db("wifiPwd")) = arguments->at(0)->getString();
+            *(db("wifiPwd")) = arguments->at(0);
             db.flush();
 
             char a[64] = {0};
 #ifdef ENGLISH_VERSION
-            sprintf(a, PI_NEW_SSID_OR_PASSWORD_HAS_BEEN_SET, " password", arguments->at(0)->getString().c_str());
+            sprintf(a, PI_NEW_SSID_OR_PASSWORD_HAS_BEEN_SET, " password", arguments->at(0)->c_str());
 #else
-            sprintf(a, PI_NEW_SSID_OR_PASSWORD_HAS_BEEN_SET, "密码", arguments->at(0)->getString().c_str());
+            sprintf(a, PI_NEW_SSID_OR_PASSWORD_HAS_BEEN_SET, "密码", arguments->at(0)->c_str());
 #endif
 
             return new Element(a);
@@ -2202,7 +2214,7 @@ void GlobalManager::loop()
 
 void GlobalManager::getFindDeviceBuffer(
     const char *userID,
-    Elements *response,
+    ElementList *response,
     bool isAdmin)
 {
     /*
@@ -2248,17 +2260,17 @@ void GlobalManager::getFindDeviceBuffer(
         extraInfo |= (uint8_t)(32);
     }
 
-    response->push_back(new Element(CMD_FIND_DEVICE_RESPONSE));                            // response to find device 0xaf
-    response->push_back(new Element(userID));                                              // web client id
-    response->push_back(new Element((uint16_t)(ESP.getCpuFreqMHz())));                     // cpu freq
-    response->push_back(new Element(extraInfo));                                           // extra info
-    response->push_back(new Element(globalTime->getTime()));                               // current timestamp
-    response->push_back(new Element((uint32_t)(ESP.getFreeHeap())));                       // free heap
-    response->push_back(new Element(this->nickname.getString().c_str()));                  // nickname of this board
-    response->push_back(new Element(this->UniversalID.getHex().c_str()));                  // id of this board
-    response->push_back(new Element(SYSTEM_VERSION));                                      // current structure version
-    response->push_back(new Element(String(APP_VERSION) + String(FIRMWARE_COMPILE_TIME))); // app version & compile time
-    response->push_back(new Element(this->bufferProviders, this->bufferProvidersLength));  // providers buffer
+    response->emplace_back(CMD_FIND_DEVICE_RESPONSE);                            // response to find device 0xaf
+    response->emplace_back(userID);                                              // web client id
+    response->emplace_back((uint16_t)(ESP.getCpuFreqMHz()));                     // cpu freq
+    response->emplace_back(extraInfo);                                           // extra info
+    response->emplace_back(globalTime->getTime());                               // current timestamp
+    response->emplace_back((uint32_t)(ESP.getFreeHeap()));                       // free heap
+    response->emplace_back(this->nickname.getString().c_str());                  // nickname of this board
+    response->emplace_back(this->UniversalID.getHex().c_str());                  // id of this board
+    response->emplace_back(SYSTEM_VERSION);                                      // current structure version
+    response->emplace_back(String(APP_VERSION) + String(FIRMWARE_COMPILE_TIME)); // app version & compile time
+    response->emplace_back(this->bufferProviders);                               // providers buffer
 }
 
 void GlobalManager::resetWifiInfo()
@@ -2345,27 +2357,37 @@ bool GlobalManager::authorize(
 
     // convert digital time into string
     // 将时间戳格式化为字符串
-    char tmp[24] = {0};
-    sprintf(tmp, "%llu", t);
-    String time(tmp);
-
-    // combine user name(sha256 hex string) and password(sha256 hex string) and time(string)
-    // 组合字段
-    String hash = this->userName.getHex() + this->password.getHex() + time;
+    char time[ELEMENT_NUMBER_CHARS_SIZE];
+    uint32_t timeLength = ElementNumber::of(t).toChars(time);
 
     // container for sha result
     // 用于存放数字摘要的容器
     uint8_t localHash[SHA_LENGTH];
 
+    // combine user name(sha256 hex string) and password(sha256 hex string) and time(string)
+    // on stack and get digest, no String is generated
+    // 在栈上组合字段并计算摘要，不生成String
+    auto digest = [&time, timeLength, &localHash](const Element *name, const Element *password)
+    {
+        uint32_t nameLength = name->getHexLength();
+        char hash[nameLength + password->getHexLength() + timeLength + 1];
+        name->getHex(hash);
+        uint32_t length = nameLength + password->getHex(hash + nameLength);
+        memcpy(hash + length, time, timeLength + 1);
+        length += timeLength;
+
 #ifdef ENABLE_SHA1_AUTHORIZATION
-    // calc sha1
-    // 计算sha1
-    mycrypto::SHA::sha1((uint8_t *)hash.c_str(), hash.length(), localHash);
+        // calc sha1
+        // 计算sha1
+        mycrypto::SHA::sha1((uint8_t *)hash, length, localHash);
 #else
-    // calc sha256
-    // 计算sha256
-    mycrypto::SHA::sha256((uint8_t *)hash.c_str(), hash.length(), localHash);
+        // calc sha256
+        // 计算sha256
+        mycrypto::SHA::sha256((uint8_t *)hash, length, localHash);
 #endif
+    };
+
+    digest(&(this->userName), &(this->password));
 
     // get pointer of remote hash
     // 获取远程hash的指针便于操作
@@ -2403,15 +2425,7 @@ bool GlobalManager::authorize(
             it != users->end();
             ++it)
         {
-            hash = (*it)->key->getHex() + (*it)->value->getHex() + time;
-
-#ifdef ENABLE_SHA1_AUTHORIZATION
-            // calc sha1
-            mycrypto::SHA::sha1((uint8_t *)hash.c_str(), hash.length(), localHash);
-#else
-            // calc sha256
-            mycrypto::SHA::sha256((uint8_t *)hash.c_str(), hash.length(), localHash);
-#endif
+            digest((*it)->key, (*it)->value);
             Element x(buf, SHA_LENGTH, false);
             Element y(localHash, SHA_LENGTH, false);
             if (x == y)
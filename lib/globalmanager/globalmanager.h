@@ -47,6 +47,12 @@ typedef struct
     uint8_t *hash = nullptr;
 } OneTimeAuthorization;
 
+// execute command: command, esp32 id, web client id, timestamp, hash, provider id,
+// followed by an optional uint8 array of arguments
+// 执行命令: 命令，esp32 id，web客户端id，时间戳，哈希，provider id，
+// 后面可能还有一个参数的二进制数组
+typedef ArrayBufferSchema<ArrayBufferSkip, ArrayBufferSkip, ArrayBufferSkip, uint64_t, ArrayBufferBuffer<SHA_LENGTH>, ArrayBufferNumber<uint64_t>> ExecuteCommandSchema;
+
 typedef enum : uint32_t
 {
     GT_START_AP = 0b1,
@@ -387,7 +393,7 @@ private:
      *
      * @param response response 响应
      */
-    void executeCommand(Elements *output, Elements *response);
+    void executeCommand(Elements *output, ElementList *response);
 
     /**
      * @brief fill response with basic information of current device
@@ -397,7 +403,14 @@ private:
      * @param response response 响应
      * @param isAdmin has administrator privileges or not 是否具有管理员权限
      */
-    void getFindDeviceBuffer(const char *userID, Elements *response, bool isAdmin);
+    void getFindDeviceBuffer(const char *userID, ElementList *response, bool isAdmin);
+
+    /**
+     * @brief elements of incoming message are decoded into this arena,
+     * and released at once after message handled
+     * 收到的消息会被解码到这个arena中，消息处理完成后一次性释放
+     */
+    ElementArena messageArena;
 
     /**
      * @brief cotainer of providers
@@ -405,6 +418,22 @@ private:
      */
     std::vector<Provider *> *providers = new std::vector<Provider *>();
 
+    /**
+     * @brief encode elements straight into a websocket frame, the whole message
+     * will never be held in RAM
+     * 把元素直接编码进websocket数据帧，整个消息不会同时存在于内存中
+     *
+     * @param client websocket client websocket客户端
+     * @param elements elements to send 需要发送的元素
+     * @return true success 成功
+     * @return false failed 失败
+     */
+    bool sendElements(myWebSocket::WebSocketClient *client, Elements *elements);
+    bool sendElements(myWebSocket::WebSocketClient *client, ElementList *elements);
+
+    template <class T>
+    bool _sendElements(myWebSocket::WebSocketClient *client, const T *elements);
+
     /**
      * @brief send command to another device
      * 发送命令给另一个设备
@@ -646,16 +675,10 @@ const char* serverIndex = R"(<!DOCTYPE html><html><head> <title>Abc</title> <met
     uint64_t lastTimeAdminOnline = 0;
 
     /**
-     * @brief buffer of all providers
-     * 全部provider的缓存
-     */
-    uint8_t *bufferProviders = nullptr;
-
-    /**
-     * @brief buffer length of all providers
-     * 全部provider的缓存的长度
+     * @brief buffer of all providers, payload is shared by responses holding it
+     * 全部provider的缓存，数据由包含它的响应共享
      */
-    uint32_t bufferProvidersLength = 0;
+    Element bufferProviders;
 
     /**
      * @brief set wifi connection status
@@ -484,30 +484,18 @@ namespace mycrypto
         // call sha
         sha(data, length, output, type);
 
-        // to store formated hex string
-        char hex[9];
-        bzero(hex, 9);
-
-        // return value
-        String res = "";
-
-        // format
-        char format[] = "%08x";
-
-        // case
-        if (hexCase == UPPER_CASE)
+        // words are printed big endian
+        uint8_t digest[32];
+        for (int i = 0; i < shaLen; i++)
         {
-            format[3] = 'X';
+            digest[i * 4] = (uint8_t)(output[i] >> 24);
+            digest[i * 4 + 1] = (uint8_t)(output[i] >> 16);
+            digest[i * 4 + 2] = (uint8_t)(output[i] >> 8);
+            digest[i * 4 + 3] = (uint8_t)(output[i]);
         }
 
         // convert result into hex string
-        for (int i = 0; i < shaLen; i++)
-        {
-            sprintf(hex, format, output[i]);
-            res += hex;
-            bzero(hex, 9);
-        }
-        return res;
+        return Hex::encode(digest, shaLen * 4, hexCase);
     }
 
     void SHA::convertU32ToU8(uint8_t *data, uint64_t length, uint8_t *output, SHAType type)
@@ -1472,15 +1460,7 @@ namespace mycrypto
             return "invalid input data";
         }
 
-        String output = "";
-        char t[3];
-        t[2] = 0;
-
-        for (uint32_t i = 0; i < outLen; ++i)
-        {
-            sprintf(t, "%02x", buffer[i]);
-            output += t;
-        }
+        String output = Hex::encode(buffer, outLen);
 
         delete buffer;
 
@@ -1523,10 +1503,9 @@ namespace mycrypto
             return "allocate memory failed";
         }
 
-        for (uint32_t i = 0, j = 0; j < bufferLength; i += 2)
+        if (!Hex::decode(cipher.c_str(), cipher.length(), encryptedBuffer))
         {
-            sscanf(cipher.substring(i, i + 2).c_str(), "%02x", (encryptedBuffer + j));
-            ++j;
+            return "invalid hex string";
         }
 
         uint32_t outLen = 0;
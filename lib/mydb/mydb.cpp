@@ -52,11 +52,16 @@ void MyDB::buildContainer(std::vector<Element *> *list)
         {
             u->value = new Element();
             this->container->push_back(u);
+            this->index.emplace(u->key, this->container->size() - 1);
             break;
         }
         u->value = (*it);
         ++it;
         this->container->push_back(u);
+
+        // first one wins if key is duplicated
+        // 键重复时第一个有效
+        this->index.emplace(u->key, this->container->size() - 1);
     }
 }
 
@@ -64,6 +69,7 @@ bool MyDB::begin()
 {
     ESP_LOGD(MYDB_DEBUG_HEADER, "mydb begining, db name: [%s]", this->name.c_str());
     this->container = new std::vector<Unit *>();
+    this->index.clear();
     this->loaded = true;
 
     std::vector<Element *> *list = nullptr;
@@ -96,9 +102,13 @@ bool MyDB::begin()
     }
 
     // no error
+    // units take over decoded elements, so they stay on heap
     this->buildContainer(list);
-    list->clear();
-    delete list;
+    if (list)
+    {
+        list->clear();
+        delete list;
+    }
     return true;
 }
 
@@ -112,6 +122,17 @@ bool MyDB::makeBackup()
         uint8_t *buffer = MyFS::readFile(mainFileName.c_str(), &outLen);
         if (outLen)
         {
+            // a corrupted main file must not replace a good backup,
+            // files written before checksum was added have no mark and are copied as before
+            // 损坏的主文件不能覆盖完好的备份，
+            // 加入校验值之前写入的文件没有标志，依然照常拷贝
+            if (buffer && buffer[0] == ARRAY_BUFFER_CHECKED_MARK &&
+                !ArrayBuffer::verifyChecksum(buffer, outLen))
+            {
+                ESP_LOGD(MYDB_DEBUG_HEADER, "main file corrupted, backup kept");
+                delete buffer;
+                return false;
+            }
             if (buffer)
             {
                 MyFS::writeFile(backupName.c_str(), buffer, outLen);
@@ -164,27 +185,63 @@ bool MyDB::flush()
     {
         ESP_LOGD(MYDB_DEBUG_HEADER, "unable to create backup");
     }
-    uint8_t *buffer = nullptr;
+    if (!this->container || !this->container->size())
+        return false;
+
+    // encoded length, also used to skip truncating file when nothing to write
+    // 编码后的长度，没有数据可写时也不会清空文件
     uint32_t outLen = 0;
+    for (std::vector<Unit *>::iterator it = this->container->begin(); it != this->container->end(); ++it)
+    {
+        if ((*it)->key->available() && (*it)->value->available())
+        {
+            outLen += (*it)->key->getOuterBufferLength() + (*it)->value->getOuterBufferLength();
+        }
+    }
 
-    this->dump(&buffer, &outLen);
-    ESP_LOGD(MYDB_DEBUG_HEADER, "dump buffer created, length: %llu", outLen);
+    if (!outLen)
+        return false;
 
-    if (outLen)
+    File file = MyFS::openFile((this->name + ".db").c_str(), FILE_WRITE);
+    if (!file)
     {
-        if (buffer)
+        ESP_LOGD(MYDB_DEBUG_HEADER, "unable to flush");
+        return false;
+    }
+
+    // stream units into file, only a small staging buffer is used
+    // instead of the whole dump, CRC32 trailer lets begin detect a corrupted file
+    // 把数据流式写入文件，只使用一个小的暂存缓冲区而不是整个数据库的拷贝，
+    // CRC32结尾让 begin 可以发现损坏的文件
+    ArrayBufferWriter writer(
+        [&file](const uint8_t *data, uint32_t length) -> bool
         {
-            ESP_LOGD(MYDB_DEBUG_HEADER, "buffer valid");
-            bool flushOK = MyFS::writeFile((this->name + ".db").c_str(), buffer, outLen);
-            if (!flushOK)
-            {
-                ESP_LOGD(MYDB_DEBUG_HEADER, "unable to flush");
-            }
-            delete buffer;
-            return flushOK;
+            return file.write(data, length) == length;
+        },
+        false, true);
+
+    for (std::vector<Unit *>::iterator it = this->container->begin(); it != this->container->end(); ++it)
+    {
+        if ((*it)->key->available() && (*it)->value->available())
+        {
+            writer.write((*it)->key);
+            writer.write((*it)->value);
         }
     }
-    return false;
+
+    // mark and trailer
+    // 标志和结尾的校验值
+    bool flushOK = writer.finish() && writer.length() == outLen + 5;
+    file.flush();
+    file.close();
+
+    ESP_LOGD(MYDB_DEBUG_HEADER, "dump length: %lu", outLen);
+
+    if (!flushOK)
+    {
+        ESP_LOGD(MYDB_DEBUG_HEADER, "unable to flush");
+    }
+    return flushOK;
 }
 
 int64_t MyDB::findIndex(Element *key)
@@ -195,20 +252,8 @@ int64_t MyDB::findIndex(Element *key)
     if (!this->container->size())
         return -2;
 
-    uint32_t length = this->container->size();
-
-    // ESP_LOGD(MYDB_DEBUG_HEADER, "length of container: %lu", length);
-
-    for (uint32_t i = 0; i < length; ++i)
-    {
-        // ESP_LOGD(MYDB_DEBUG_HEADER, "left address: %x, right address: %x", eKey, key);
-
-        if (this->container->at(i)->key->equalsTo(key))
-        {
-            return i;
-        }
-    }
-    return -2;
+    auto it = this->index.find(key);
+    return it == this->index.end() ? -2 : (int64_t)it->second;
 }
 
 Element *MyDB::operator()(const char *data)
@@ -219,14 +264,16 @@ Element *MyDB::operator()(const char *data)
     if (!strlen(data))
         return nullptr;
 
-    Element *eKey = new Element(data);
-
-    Element *value = this->operator()(eKey);
-
-    if (value->available())
-        delete eKey;
+    // look up with a stack key first, short key is stored inside Element
+    // 先用栈上的键查找，短的键存储在Element内部
+    Element key(data);
+    int64_t index = this->findIndex(&key);
+    if (index >= 0)
+        return this->container->at(index)->value;
 
-    return value;
+    // new unit owns its key
+    // 新的unit拥有自己的键
+    return this->operator()(new Element(data));
 }
 
 Element *MyDB::operator()(Element *key)
@@ -252,6 +299,7 @@ Element *MyDB::operator()(Element *key)
         }
 
         this->container->push_back(unit);
+        this->index.emplace(unit->key, this->container->size() - 1);
         return unit->value;
     }
     else
@@ -275,7 +323,9 @@ void MyDB::unload()
                 }
             }
             delete this->container;
+            this->container = nullptr;
         }
+        this->index.clear();
     }
     this->loaded = false;
 }
@@ -19,6 +19,7 @@
 #include <myfs.h>
 #include <arraybuffer.hpp>
 #include <vector>
+#include <unordered_map>
 
 #define MYDB_DEBUG_HEADER "mydb"
 
@@ -70,12 +71,12 @@ public:
 typedef std::vector<Unit *> Units;
 
 /**
- * @brief because of all data stored in RAM,
- * so directly use sequential search
- * time complexity is O(n)
+ * @brief all data stored in RAM,
+ * units are kept in order of insertion and found by a hash index on keys
+ * time complexity is O(1)
  *
- * 因为数据是存储在内存中的，所以直接使用顺序查找
- * 时间复杂度O(n)
+ * 数据是存储在内存中的，unit按插入顺序保存，通过键的哈希索引查找
+ * 时间复杂度O(1)
  *
  */
 class MyDB
@@ -89,6 +90,10 @@ private:
     // 数据库内存容器
     std::vector<Unit *> *container = nullptr;
 
+    // index of container, key points to key of unit
+    // 容器的索引，键指向unit的键
+    std::unordered_map<const Element *, uint32_t, ElementHash, ElementEqual> index;
+
     /**
      * @brief find index from container
      * 从容器中找到指定key的索引
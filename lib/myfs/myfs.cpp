@@ -86,6 +86,17 @@ bool MyFS::writeFile(const char *p, uint8_t *data, uint64_t length)
     return value;
 }
 
+File MyFS::openFile(const char *p, const char *mode)
+{
+    String path = p;
+    if (path[0] != '/')
+    {
+        path = "/" + path;
+    }
+
+    return LittleFS.open(path, mode);
+}
+
 bool MyFS::writeFile(String path, String data, bool base64Encode)
 {
     if (path[0] != '/')
@@ -246,6 +257,77 @@ bool MyFS::renameFile(String path0, String path1)
     return LittleFS.rename(path0, path1);
 }
 
+Element MyFS::createFileElement(const char *p, uint32_t offset, uint32_t length)
+{
+    String path = p;
+    if (path[0] != '/')
+    {
+        path = "/" + path;
+    }
+    File file = LittleFS.open(path);
+
+    if (!file || file.isDirectory())
+    {
+        return Element();
+    }
+
+    uint32_t size = file.size();
+    file.close();
+
+    if (offset >= size)
+    {
+        return Element();
+    }
+    if (length > size - offset)
+    {
+        length = size - offset;
+    }
+
+    MyFSFileSource *source = new (std::nothrow) MyFSFileSource(path, offset, length);
+    return source ? Element(source) : Element();
+}
+
+MyFSFileSource::~MyFSFileSource()
+{
+    if (this->file)
+    {
+        this->file.close();
+    }
+}
+
+bool MyFSFileSource::read(uint32_t offset, uint8_t *buffer, uint32_t length)
+{
+    if (offset > this->size || length > this->size - offset)
+    {
+        return false;
+    }
+
+    if (!this->file)
+    {
+        this->file = LittleFS.open(this->path);
+        if (!this->file)
+        {
+            return false;
+        }
+    }
+
+    // reads are sequential when encoding, seek only when offset jumps
+    if (this->file.position() != this->start + offset && !this->file.seek(this->start + offset))
+    {
+        this->file.close();
+        return false;
+    }
+
+    bool done = this->file.read(buffer, length) == length;
+
+    // file handles are limited, close it after last byte
+    if (!done || offset + length == this->size)
+    {
+        this->file.close();
+    }
+    return done;
+}
+
 bool MyFS::fileExist(String path)
 {
     if (path[0] != '/')
@@ -23,6 +23,7 @@
 #include <vector>
 #include <stdint.h>
 #include <mycrypto.h>
+#include <arraybuffer.hpp>
 
 using namespace std;
 
@@ -36,6 +37,27 @@ typedef struct
 #define FORMAT_LITTLEFS_IF_FAILED true
 typedef std::vector<FileElement> fileElementList;
 
+/**
+ * @brief a range of a file as payload of an Element, created by MyFS::createFileElement
+ * file is opened on first read and closed after the last byte of range is read
+ * 作为Element数据的文件的一段，由 MyFS::createFileElement 创建
+ * 第一次读取时打开文件，读取完范围内最后一个字节后关闭
+ */
+class MyFSFileSource : public ElementFileSource
+{
+private:
+    String path;
+    uint32_t start;
+    uint32_t size;
+    File file;
+
+public:
+    MyFSFileSource(const String &path, uint32_t start, uint32_t size) : path(path), start(start), size(size) {}
+    ~MyFSFileSource();
+    uint32_t length() const override { return this->size; }
+    bool read(uint32_t offset, uint8_t *buffer, uint32_t length) override;
+};
+
 class MyFS
 {
 public:
@@ -43,6 +65,7 @@ public:
     static void listFile(String path, fileElementList *list, String prefix = "");
     static bool writeFile(String path, String data, bool base64Encode = true);
     static bool writeFile(const char *path, uint8_t *data, uint64_t length);
+    static File openFile(const char *path, const char *mode = FILE_READ);
     static bool writeFile(const char *path, const char *data, bool base64Encode = true);
     static String readFile(String path, bool base64Decode = true);
     static void readFile(const char *p, std::function<void(uint8_t *output, uint64_t length)> callback);
@@ -51,6 +74,21 @@ public:
     static bool deleteFile(String path);
     static bool renameFile(String path0, String path1);
     static bool fileExist(String path);
+
+    /**
+     * @brief an uint8 array Element references a range of a file, nothing is read now,
+     * the range is read in chunks when the Element is encoded, such as sending by websocket,
+     * so a log file or firmware larger than RAM could be sent in a message
+     * 引用文件中一段数据的二进制数组Element，现在不读取任何数据，
+     * 编码时(比如通过websocket发送)分块读取，所以可以在消息中发送比内存更大的日志文件或固件
+     *
+     * @param path path of file 文件路径
+     * @param offset start of range 范围的起点
+     * @param length length of range, clamped to end of file 范围的长度，超出文件末尾的部分会被截断
+     * @return Element of ETYPE_FILE, ETYPE_VOID if file not found or range is empty
+     * ETYPE_FILE 类型的Element，文件不存在或范围为空时为 ETYPE_VOID
+     */
+    static Element createFileElement(const char *path, uint32_t offset = 0, uint32_t length = 0xffffffff);
     static void formatSPIFFS();
     static size_t getFreeSpace();
     static size_t getUsedSpace();
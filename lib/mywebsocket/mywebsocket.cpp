@@ -265,19 +265,10 @@ namespace myWebSocket
 
     uint64_t WebSocketClient::send(const char *data)
     {
-        uint64_t len = strlen(data);
-        uint8_t *d = (uint8_t *)malloc(len);
-        if (!d)
-        {
-            return 0;
-        }
-        memcpy(d, data, len);
-        uint64_t r = this->_send(TYPE_TEXT, d, strlen(data));
-        free(d);
-        return r;
+        return this->_send(TYPE_TEXT, (const uint8_t *)data, strlen(data));
     }
 
-    uint64_t WebSocketClient::_send(WebSocketEvents type, uint8_t *data, uint64_t len)
+    uint64_t WebSocketClient::_send(WebSocketEvents type, const uint8_t *data, uint64_t len)
     {
         if (!data || !len)
         {
@@ -285,11 +276,21 @@ namespace myWebSocket
             return 0;
         }
 
-        uint8_t mask[4];
+        if (!this->beginFrame(type, len))
+        {
+            return 0;
+        }
+
+        return this->writeFrame(data, len);
+    }
+
+    bool WebSocketClient::beginFrame(WebSocketEvents type, uint64_t len)
+    {
         for (int i = 0; i < 4; i++)
         {
-            mask[i] = random(0xff);
+            this->frameMask[i] = random(0xff);
         }
+        this->frameOffset = 0;
 
         // frame header
         uint8_t header[10];
@@ -320,7 +321,7 @@ namespace myWebSocket
             header[0] |= (uint8_t)10;
             break;
         default:
-            return 0;
+            return false;
         }
 
         // convert length and send it to server
@@ -348,25 +349,54 @@ namespace myWebSocket
             this->client->write((const char *)header, 10);
         }
 
-        // masking
+        // send mask byte
         if (!this->isFromServer)
         {
-            for (uint64_t i = 0; i < len; i++)
-            {
-                yield();
-                data[i] = data[i] ^ mask[i & 3];
-                yield();
-            }
+            this->client->write((const char *)(this->frameMask), 4);
         }
 
-        // send mask byte
-        if (!this->isFromServer)
+        return true;
+    }
+
+    uint64_t WebSocketClient::writeFrame(const uint8_t *data, uint64_t len)
+    {
+        if (!data || !len)
+        {
+            return 0;
+        }
+
+        // server doesn't mask, send data directly
+        if (this->isFromServer)
+        {
+            this->frameOffset += len;
+            return this->client->write((const char *)data, len);
+        }
+
+        // masking through stack buffer, mask index continues across calls
+        uint8_t masked[MY_WEBSOCKET_MASK_BUFFER_LENGTH];
+        uint64_t sent = 0;
+
+        while (sent < len)
         {
-            this->client->write((const char *)mask, 4);
+            uint32_t chunk = (len - sent) > MY_WEBSOCKET_MASK_BUFFER_LENGTH ? MY_WEBSOCKET_MASK_BUFFER_LENGTH : (len - sent);
+
+            for (uint32_t i = 0; i < chunk; ++i)
+            {
+                masked[i] = data[sent + i] ^ this->frameMask[(this->frameOffset + i) & 3];
+            }
+
+            uint64_t written = this->client->write((const char *)masked, chunk);
+            this->frameOffset += written;
+            sent += written;
+
+            if (written != chunk)
+            {
+                break;
+            }
+            yield();
         }
 
-        // send data
-        return this->client->write((const char *)data, len);
+        return sent;
     }
 
     void WebSocketClient::loop()
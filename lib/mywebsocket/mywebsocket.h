@@ -46,6 +46,10 @@
 // 握手缓冲区长度
 #define MY_WEBSOCKET_BUFFER_LENGTH 1024
 
+// stack buffer length for masking payload when sending as client
+// 作为客户端发送数据时用于掩码处理的栈缓冲区长度
+#define MY_WEBSOCKET_MASK_BUFFER_LENGTH 64
+
 // http post body length
 // http post body长度
 #define MY_WEBSOCKET_HTTP_POST_LENGTH 1024
@@ -290,22 +294,30 @@ namespace myWebSocket
         String generateHanshake();
 
         /**
-         * @brief internal universal send function, send data to server or client, attention attached
-         * 通用的内部发送数据函数，用于把数据发送到客户端或者服务器，请阅读注意事项
+         * @brief mask of frame that is currently being streamed
+         * 当前正在流式发送的数据帧的掩码
+         */
+        uint8_t frameMask[4] = {0};
+
+        /**
+         * @brief payload bytes of current frame already written, used as mask index
+         * 当前数据帧已写入的字节数，用作掩码索引
+         */
+        uint64_t frameOffset = 0;
+
+        /**
+         * @brief internal universal send function, send data to server or client
+         * 通用的内部发送数据函数，用于把数据发送到客户端或者服务器
          *
          * @param type type of websocket frame, websocket数据帧类型
          * @param data payload 数据
          * @param len length of payload 数据长度
          * @return how many data have been sent in bytes 发送了多少字节数据
          *
-         * @attention the data stored in pointer "data" will be changed because of the masking process
-         * (when act as a client), you should make a copy before send if you didn't want this function
-         * mofidy original data
-         *
-         * 客户端在发送数据时，存储于指针"data"中的数据会被masking过程修改，如果你还需要使用这些原始数据，你可以在发送数据
-         * 之前对原始数据创建一份拷贝
+         * @note masking is done through a small stack buffer, original data will NOT be changed
+         * 掩码处理使用栈上的小缓冲区完成，原始数据 [不会] 被修改
          */
-        uint64_t _send(WebSocketEvents type, uint8_t *data, uint64_t len);
+        uint64_t _send(WebSocketEvents type, const uint8_t *data, uint64_t len);
 
     public:
         /**
@@ -571,6 +583,41 @@ namespace myWebSocket
             return this->_send(TYPE_BIN, data, length);
         }
 
+        /**
+         * @brief start a frame with known payload length, payload could be written
+         * by several calls of writeFrame later, so the whole message needn't to be in RAM
+         * 以已知的数据长度开始一个数据帧，之后可以通过多次调用 writeFrame 写入数据
+         * 这样整个消息不需要同时存在于内存中
+         *
+         * @param type type of websocket frame, websocket数据帧类型
+         * @param length total length of payload 数据总长度
+         * @return true header sent 帧头已发送
+         */
+        bool beginFrame(WebSocketEvents type, uint64_t length);
+
+        /**
+         * @brief write part of payload of the frame started by beginFrame
+         * 写入由 beginFrame 开始的数据帧的一部分数据
+         *
+         * @param data payload 数据
+         * @param length length of this part 这部分数据的长度
+         * @return bytes had been sent 已被发送的数据字节数
+         */
+        uint64_t writeFrame(const uint8_t *data, uint64_t length);
+
+        /**
+         * @brief drop connection when a frame started by beginFrame can not be finished,
+         * peer can not find where next frame starts once the frame is shorter than its header says,
+         * auto reconnect is kept
+         * 由 beginFrame 开始的数据帧无法写完时断开连接，
+         * 数据帧比帧头声明的短时对方无法找到下一帧的开头，
+         * 自动重连设置保持不变
+         */
+        inline void abortFrame()
+        {
+            this->client->stop();
+        }
+
         /**
          * @brief send c string as binary type 以二进制数据格式发送c字符串
          *
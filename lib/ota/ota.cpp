@@ -14,11 +14,15 @@ WebsocketOTA::WebsocketOTA(std::vector<Element *> *startOTARequest, OTACallback
         5 arr[5] //hash
     */
 
-    // length of firmware
-    this->firmwareLength = startOTARequest->at(OFFSET_START_OTA_FIRMWARE_LENGTH)->getUint64();
+    OTAStartSchema::Values values;
+    if (OTAStartSchema::decode(startOTARequest, &values))
+    {
+        // length of firmware
+        this->firmwareLength = std::get<OFFSET_START_OTA_FIRMWARE_LENGTH>(values);
 
-    // single block size
-    this->blockLength = startOTARequest->at(OFFSET_START_OTA_BLOCK_SIZE)->getUint64();
+        // single block size
+        this->blockLength = std::get<OFFSET_START_OTA_BLOCK_SIZE>(values);
+    }
 
     // request index
     this->index = 0;
@@ -28,15 +32,12 @@ void WebsocketOTA::start(Element universalID, String domain, uint16_t port, Stri
 {
     this->client = new WebSocketClient();
 
-    // ota request container
-    // ota 请求容器
-    this->request = new std::vector<Element *>();
-
-    // prefill data
-    // 预填充数据
-    this->request->push_back(new Element(CMD_OTA_BLOCK));
-    this->request->push_back(new Element(universalID.getRawBuffer(), 32));
-    this->request->push_back(new Element(this->index));
+    // keep id for ota request
+    // 保存id用于ota请求
+    if (universalID.isBufferAvailable(32))
+    {
+        memcpy(this->universalID, universalID.getRawBuffer(), 32);
+    }
 
     // set callback for ota update websocket client
     // 为ota升级websocket客户端设置回调函数
@@ -51,56 +52,41 @@ void WebsocketOTA::start(Element universalID, String domain, uint16_t port, Stri
             }
             else if (event == TYPE_BIN && data && length)
             {
-                // using non-copy mode decode buffer
-                // 使用非拷贝模式解码原始数据
-                std::vector<Element *> *output = ArrayBuffer::decodeArrayBuffer(data, length, true);
+                // read block in place, nothing will be copied or allocated
+                // 直接在原数据上读取数据块，不拷贝也不分配内存
+                ArrayBufferView output(data, length);
 
                 // run data checks and write data to partition down bellow
                 // no need more comments
                 // 下面执行了各种数据检测然后写入ota分区，比较简单就不写注释了
 
-                if (!output->size())
-                {
-                    this->clearBuffer(output);
-                    return;
-                }
-
-                if (output->at(OFFSET_COMMAND)->getType() != ETYPE_UINT8 ||
-                    output->at(OFFSET_COMMAND)->getUint8() != CMD_OTA_BLOCK)
+                if (!output.isValid())
                 {
-                    this->clearBuffer(output);
                     return;
                 }
 
-                if (output->size() != OTA_DATA_BLOCK_VECTOR_LENGTH)
+                if (output[OFFSET_COMMAND].getType() != ETYPE_UINT8 ||
+                    output[OFFSET_COMMAND].getUint8() != CMD_OTA_BLOCK)
                 {
-                    ESP_LOGD(OTA_DEBUG_HEADER, "invalid length of arguments, someone may send hack data");
-                    this->clearBuffer(output);
-                    this->fetchNext();
                     return;
                 }
 
-                if (
-                    output->at(OFFSET_OTA_DATA)->getType() != ETYPE_BUFFER)
+                // count and types of all fields are checked in one call
+                // 一次调用校验所有字段的数量和类型
+                OTABlockSchema::Values values;
+                if (!OTABlockSchema::decode(output, &values))
                 {
-                    ESP_LOGD(OTA_DEBUG_HEADER, "invalid type of data or hash");
-                    this->clearBuffer(output);
+                    ESP_LOGD(OTA_DEBUG_HEADER, "invalid length or type of arguments, someone may send hack data");
                     this->fetchNext();
                     return;
                 }
 
-                if (output->at(OFFSET_OTA_BLOCK_INDEX)->getType(true) != ETYPE_NUMBER)
-                {
-                    ESP_LOGD(OTA_DEBUG_HEADER, "invalid type of index");
-                    this->clearBuffer(output);
-                    this->fetchNext();
-                    return;
-                }
+                const ArrayBufferBytes &hash = std::get<OFFSET_OTA_HASH>(values);
+                const ArrayBufferBytes &block = std::get<OFFSET_OTA_DATA>(values);
 
-                if (output->at(OFFSET_OTA_BLOCK_INDEX)->getUint32() < this->index)
+                if (std::get<OFFSET_OTA_BLOCK_INDEX>(values) < this->index)
                 {
                     ESP_LOGD(OTA_DEBUG_HEADER, "repetitive block");
-                    this->clearBuffer(output);
                     this->fetchNext();
                     return;
                 }
@@ -111,9 +97,9 @@ void WebsocketOTA::start(Element universalID, String domain, uint16_t port, Stri
                     1 == sha256, uint8 array, 32 bytes
                     2 == data, uint8 array
                 */
-                ESP_LOGD(OTA_DEBUG_HEADER, "block arrived, length: %d\n", output->at(2)->getRawBufferLength());
+                ESP_LOGD(OTA_DEBUG_HEADER, "block arrived, length: %d\n", block.length);
 
-                if (!output->at(OFFSET_OTA_DATA)->getRawBufferLength())
+                if (!block.length)
                 {
                     // empty block means all data has been written
                     // OTA update finished
@@ -145,30 +131,29 @@ void WebsocketOTA::start(Element universalID, String domain, uint16_t port, Stri
                     ESP.restart();
                 }
 
-                // calc hash of data block
-                String localHash = mycrypto::SHA::sha256(
-                    output->at(OFFSET_OTA_DATA)->getUint8Array(),
-                    output->at(OFFSET_OTA_DATA)->getRawBufferLength());
+                // calc binary digest of data block and compare it with the one server sent
+                // no hex string is generated
+                // 计算数据块的二进制摘要并与服务器发送的比较，不再生成十六进制字符串
+                uint8_t localHash[32] = {0};
+                mycrypto::SHA::sha256((uint8_t *)block.data, block.length, localHash);
 
-                if (localHash == output->at(OFFSET_OTA_HASH)->getString())
+                if (!memcmp(localHash, hash.data, 32))
                 {
                     // write data to ota partition
                     if (ESP_OK ==
                         esp_ota_write_with_offset(
-                            this->handle,                                               // ota partition handle
-                            (const void *)output->at(OFFSET_OTA_DATA)->getUint8Array(), // data buffer
-                            output->at(OFFSET_OTA_DATA)->getRawBufferLength(),                   // length of buffer
-                            this->writeOffset                                           // offset
+                            this->handle,                        // ota partition handle
+                            (const void *)block.data,            // data buffer
+                            block.length,                        // length of buffer
+                            this->writeOffset                    // offset
                             ))
                     {
                         ++this->index;
-                        this->writeOffset += output->at(OFFSET_OTA_DATA)->getRawBufferLength();
-                        this->clearBuffer(output);
+                        this->writeOffset += block.length;
                         this->fetchNext();
                     }
                     else
                     {
-                        this->clearBuffer(output);
                         // unknown reason can't write data into flash
                         // abort ota process
                         esp_ota_abort(this->handle);
@@ -181,7 +166,6 @@ void WebsocketOTA::start(Element universalID, String domain, uint16_t port, Stri
                 {
                     // hash failed, request last block again
                     // todo: add retry count detect
-                    this->clearBuffer(output);
                     this->fetchNext();
                 }
             }
@@ -210,31 +194,32 @@ void WebsocketOTA::start(Element universalID, String domain, uint16_t port, Stri
     }
 }
 
-void WebsocketOTA::clearBuffer(std::vector<Element *> *output)
-{
-    for (std::vector<Element *>::iterator it = output->begin();
-         it != output->end();
-         ++it)
-    {
-        delete (*it);
-    }
-    delete output;
-}
-
 void WebsocketOTA::fetchNext()
 {
     // fill ota data block index
-    this->request->at(2)->setNumber(this->index);
+    OTARequestSchema::Values request(CMD_OTA_BLOCK, ArrayBufferBytes{this->universalID, 32}, this->index);
 
-    // create buffer
-    uint8_t *buffer = ArrayBuffer::createArrayBuffer(this->request, &(this->bufferOutLen));
+    // length of request, fixed at compile time
+    this->bufferOutLen = OTARequestSchema::fixedLength;
 
     ESP_LOGD(OTA_DEBUG_HEADER, "fetching block: %d, heap: %lu\n", this->index, ESP.getFreeHeap());
 
-    // send buffer
-    this->client->send(buffer, this->bufferOutLen);
-
-    delete buffer;
+    // encode request straight into websocket frame
+    // 直接把请求编码进websocket数据帧
+    if (this->client->beginFrame(TYPE_BIN, this->bufferOutLen))
+    {
+        ArrayBufferWriter writer(
+            [this](const uint8_t *data, uint32_t length) -> bool
+            {
+                return this->client->writeFrame(data, length) == length;
+            });
+        if (!OTARequestSchema::write(&writer, request) || !writer.flush())
+        {
+            // frame header is already sent, drop connection instead of sending a short frame
+            // 帧头已经发出，断开连接而不是发送不完整的数据帧
+            this->client->abortFrame();
+        }
+    }
 }
 
 WebsocketOTA::~WebsocketOTA()
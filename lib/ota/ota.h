@@ -27,6 +27,20 @@ using namespace myWebSocket;
 
 typedef std::function<void(int)> OTACallback;
 
+// admin start ota: command, admin id, block size, firmware length, timestamp, hash
+// 管理员开始ota升级: 命令，管理员id，数据块大小，固件长度，时间戳，哈希
+typedef ArrayBufferSchema<ArrayBufferSkip, const char *, ArrayBufferNumber<uint32_t>, ArrayBufferNumber<uint32_t>, uint64_t, ArrayBufferBuffer<SHA_LENGTH>> OTAStartSchema;
+
+// server send ota data block: command, hash of block, block, block index
+// 服务器发送ota数据块: 命令，数据块哈希，数据块，数据块索引
+typedef ArrayBufferSchema<uint8_t, ArrayBufferBuffer<32>, ArrayBufferBuffer<>, ArrayBufferNumber<uint32_t>> OTABlockSchema;
+
+// esp32 request ota data block: command, id of current device, block index
+// esp32请求ota数据块: 命令，当前设备id，数据块索引
+typedef ArrayBufferSchema<uint8_t, ArrayBufferBuffer<32>, uint32_t> OTARequestSchema;
+
+static_assert(OTABlockSchema::size == OTA_DATA_BLOCK_VECTOR_LENGTH, "OTA block schema doesn't match OTA_DATA_BLOCK_VECTOR_LENGTH");
+
 class WebsocketOTA
 {
 private:
@@ -42,9 +56,9 @@ private:
     // ota升级分区
     const esp_partition_t *partition;
 
-    // for request ota block from server
-    // 用于向服务器请求ota数据块
-    std::vector<Element *> *request = nullptr;
+    // id of current device, for request ota block from server
+    // 当前设备id，用于向服务器请求ota数据块
+    uint8_t universalID[32] = {0};
 
     // callback for ota update aborted
     // ota升级中断的回调函数
@@ -76,14 +90,6 @@ private:
      */
     void fetchNext();
 
-    /**
-     * @brief clear ota data block buffer
-     * 清除ota数据块缓存
-     *
-     * @param output ota data block from server 服务器发来的ota数据块
-     */
-    void clearBuffer(std::vector<Element *> *output);
-
 public:
     // websocket client to server for ota update
     // 用于ota升级的websocket客户端
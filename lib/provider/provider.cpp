@@ -30,4 +30,46 @@ uint8_t *Provider::getBuffer(uint32_t *outLen)
     }
 
     return buffer;
-}
\ No newline at end of file
+}
+
+uint32_t Provider::getOuterBufferLength()
+{
+    Element fields[4];
+    return this->_fields(fields);
+}
+
+bool Provider::write(ArrayBufferWriter *writer)
+{
+    Element fields[4];
+    uint32_t length = this->_fields(fields);
+
+    if (!writer->writeHeader(ETYPE_BUFFER, length))
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        // empty name is skipped as createArrayBuffer does
+        if (fields[i].getOuterBufferLength() && !writer->write(fields[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t Provider::_fields(Element (&fields)[4])
+{
+    fields[0] = this->id;
+    fields[1] = this->settings;
+    fields[2] = this->name;
+    fields[3] = this->customID;
+
+    uint32_t length = 0;
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        length += fields[i].getOuterBufferLength();
+    }
+    return length;
+}
@@ -19,7 +19,9 @@
 #include <functional>
 #include <arraybuffer.hpp>
 
-typedef Elements *ProviderArguments;
+// arguments are stored by value, arguments->at(i) returns pointer of Element as before
+// 参数按值存放，arguments->at(i) 与之前一样返回Element指针
+typedef ElementList *ProviderArguments;
 
 typedef std::function<Element *(ProviderArguments arguments)> ProviderCallback;
 
@@ -128,6 +130,32 @@ public:
      * @return uint8_t* buffer 缓存
      */
     uint8_t *getBuffer(uint32_t *outLen);
+
+    /**
+     * @brief length of the buffer getBuffer creates
+     * getBuffer 创建的buffer的长度
+     */
+    uint32_t getOuterBufferLength();
+
+    /**
+     * @brief write same content as getBuffer into writer as a nested uint8 array,
+     * without creating the buffer
+     * 把与 getBuffer 相同的内容作为嵌套的二进制数组写入writer，不创建buffer
+     *
+     * @param writer output 输出
+     * @return true success 成功
+     */
+    bool write(ArrayBufferWriter *writer);
+
+private:
+    /**
+     * @brief fill fields of the buffer in order of getBuffer
+     * 按 getBuffer 的顺序填充buffer的字段
+     *
+     * @param fields output 输出
+     * @return uint32_t total length of fields 所有字段的总长度
+     */
+    uint32_t _fields(Element (&fields)[4]);
 };
 
 #endif
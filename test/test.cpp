@@ -1,7 +1,9 @@
 #include <Arduino.h>
 #include <unity.h>
 #include <arraybuffer.hpp>
+#include <arraybuffertranscoder.hpp>
 #include <vector>
+#include <unordered_map>
 #include <mycrypto.h>
 #include <mydb.h>
 
@@ -39,6 +41,35 @@ void test_base64_decode()
     TEST_ASSERT_EQUAL_STRING(result.c_str(), mycrypto::Base64::base64Decode(a).c_str());
 }
 
+void test_hex()
+{
+    uint8_t data[] = {0x00, 0x7f, 0x80, 0xab, 0xff};
+    char hex[11];
+    mycrypto::Hex::encode(data, 5, hex);
+    TEST_ASSERT_EQUAL_STRING("007f80abff", hex);
+    TEST_ASSERT_EQUAL_STRING("007F80ABFF", mycrypto::Hex::encode(data, 5, mycrypto::UPPER_CASE).c_str());
+
+    uint8_t output[5] = {0};
+    TEST_ASSERT_TRUE(mycrypto::Hex::decode("007F80abFF", 10, output));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, output, 5);
+
+    // odd length and non hex characters, output is not touched
+    TEST_ASSERT_FALSE(mycrypto::Hex::decode("007f8", 5, output));
+    TEST_ASSERT_FALSE(mycrypto::Hex::decode("00 7f", 4, output));
+    TEST_ASSERT_FALSE(mycrypto::Hex::decode("0g", 2, output));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, output, 5);
+
+    // long input is encoded in chunks
+    uint8_t buffer[200];
+    for (uint32_t i = 0; i < 200; ++i)
+        buffer[i] = (uint8_t)i;
+    String longHex = mycrypto::Hex::encode(buffer, 200);
+    TEST_ASSERT_EQUAL(400, longHex.length());
+    uint8_t decoded[200];
+    TEST_ASSERT_TRUE(mycrypto::Hex::decode(longHex.c_str(), 400, decoded));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(buffer, decoded, 200);
+}
+
 void test_aes_encode()
 {
     String key = "0123456789abcdef0123456789abcdef";
@@ -610,6 +641,11 @@ void test_element_getHex()
     Element a(buffer, 3);
     String result = a.getHex();
     TEST_ASSERT_TRUE(result == "0080ff");
+
+    char hex[7];
+    TEST_ASSERT_EQUAL(6, a.getHexLength());
+    TEST_ASSERT_EQUAL(6, a.getHex(hex, false));
+    TEST_ASSERT_EQUAL_STRING("0080FF", hex);
 }
 
 void test_element_convertHexStringIntoUint8Array()
@@ -619,6 +655,457 @@ void test_element_convertHexStringIntoUint8Array()
     uint8_t *buffer = a.getUint8Array();
     uint8_t value[] = {0, 0x80, 0xff};
     TEST_ASSERT_EQUAL_UINT8_ARRAY(value, buffer, 3);
+
+    Element b("00zz");
+    TEST_ASSERT_FALSE(b.convertHexStringIntoUint8Array());
+    TEST_ASSERT_TRUE(b == "00zz");
+}
+
+void test_element_inline_buffer()
+{
+#if ELEMENT_INLINE_BUFFER_SIZE > 0
+    Element a("token");
+    const uint8_t *begin = (const uint8_t *)(&a);
+
+    // short string stored inside object
+    TEST_ASSERT_TRUE(a.getRawBuffer() >= begin && a.getRawBuffer() < begin + sizeof(Element));
+    TEST_ASSERT_TRUE(!strcmp(a.c_str(), "token"));
+
+    // copy has its own storage
+    Element b(a);
+    TEST_ASSERT_TRUE(b.getRawBuffer() != a.getRawBuffer() && b == a);
+
+    // long string goes to heap
+    a = "this string is longer than inline buffer";
+    TEST_ASSERT_FALSE(a.getRawBuffer() >= begin && a.getRawBuffer() < begin + sizeof(Element));
+    TEST_ASSERT_TRUE(!strcmp(b.c_str(), "token"));
+
+    // and back
+    a = "OK";
+    TEST_ASSERT_TRUE(a.getRawBuffer() >= begin && a.getRawBuffer() < begin + sizeof(Element));
+    TEST_ASSERT_TRUE(a == "OK");
+#endif
+}
+
+void test_element_move()
+{
+    const char *text = "string longer than inline buffer of element";
+
+    // heap buffer changes owner only
+    Element a(text);
+    const uint8_t *heap = a.getRawBuffer();
+    Element b(std::move(a));
+    TEST_ASSERT_TRUE(b.getRawBuffer() == heap && b == text);
+    TEST_ASSERT_EQUAL(ETYPE_VOID, a.getType());
+
+    // short string moved with its own storage
+    Element c("OK");
+    Element d(std::move(c));
+    TEST_ASSERT_TRUE(d == "OK" && c.getType() == ETYPE_VOID);
+
+    // move assignment frees old data
+    d = std::move(b);
+    TEST_ASSERT_TRUE(d.getRawBuffer() == heap && d == text);
+    d = std::move(d);
+    TEST_ASSERT_TRUE(d == text);
+
+    // vector grows without copying payload
+    std::vector<Element> list;
+    list.push_back(Element(text));
+    heap = list[0].getRawBuffer();
+    for (uint8_t i = 0; i < 16; ++i)
+        list.push_back(Element(i));
+    TEST_ASSERT_TRUE(list[0].getRawBuffer() == heap);
+
+    // adopt buffer on heap
+    uint8_t *buffer = new uint8_t[32];
+    memset(buffer, 0xab, 32);
+    Element e;
+    TEST_ASSERT_TRUE(e.adoptBuffer(buffer, 32));
+    TEST_ASSERT_TRUE(e.getRawBuffer() == buffer && e.getRawBufferLength() == 32);
+
+    uint8_t *str = new uint8_t[3]{'O', 'K', 0};
+    TEST_ASSERT_TRUE(e.adoptBuffer(str, 3, ETYPE_STRING));
+    TEST_ASSERT_TRUE(e == "OK");
+
+    // not terminated string is refused
+    uint8_t *invalid = new uint8_t[2]{'O', 'K'};
+    TEST_ASSERT_FALSE(e.adoptBuffer(invalid, 2, ETYPE_STRING));
+    TEST_ASSERT_TRUE(e == "OK");
+    delete[] invalid;
+}
+
+void test_element_shared_buffer()
+{
+#if ELEMENT_SHARED_BUFFER_MIN_SIZE > 0
+    uint8_t blob[256];
+    for (uint16_t i = 0; i < 256; ++i)
+        blob[i] = i;
+
+    // copies share long payload
+    Element a(blob, 256);
+    Element b(a);
+    Element c;
+    c = b;
+    const Element &ra = a, &rb = b, &rc = c;
+    TEST_ASSERT_TRUE(rb.getRawBuffer() == ra.getRawBuffer() && rc.getRawBuffer() == ra.getRawBuffer());
+    TEST_ASSERT_TRUE(c == a && c.getRawBufferLength() == 256);
+
+    // writing through pointer from non-const object copies first
+    uint8_t *writable = b.getUint8Array();
+    TEST_ASSERT_TRUE(writable && writable != ra.getRawBuffer());
+    writable[0] = 0xff;
+    TEST_ASSERT_TRUE(ra.getRawBuffer()[0] == 0 && rc.getRawBuffer()[0] == 0 && rb.getRawBuffer()[0] == 0xff);
+
+    // payload lives until last copy is released
+    a.reset(ETYPE_VOID);
+    {
+        Element d(b);
+    }
+    b = (uint8_t)1;
+    TEST_ASSERT_TRUE(c.getRawBufferLength() == 256 && c.getRawBuffer()[255] == 255);
+
+    // modifying in place copies first
+    char hex[129];
+    for (uint8_t i = 0; i < 64; ++i)
+        sprintf(hex + i * 2, "%02x", i);
+    Element e(hex);
+    Element f(e);
+    TEST_ASSERT_TRUE(e.convertHexStringIntoUint8Array());
+    TEST_ASSERT_TRUE(e.getType() == ETYPE_BUFFER && e.getRawBufferLength() == 64 && e.getRawBuffer()[63] == 63);
+    TEST_ASSERT_TRUE(f.getType() == ETYPE_STRING && f == hex);
+
+    // appending to a typed array leaves copies unchanged
+    int32_t items[32] = {0};
+    Element g;
+    g.setArray(items, 32);
+    Element h(g);
+    TEST_ASSERT_TRUE(g.append(items, 1) && g.getArrayLength() == 33 && h.getArrayLength() == 32);
+
+    // children of a copied list share payload as well
+    Element list;
+    list.setList();
+    list.push(c);
+    Element listCopy(list);
+    TEST_ASSERT_TRUE(((const Element *)listCopy.at(0))->getRawBuffer() == rc.getRawBuffer());
+#endif
+}
+
+void test_element_hash()
+{
+    // numbers with same value are equal and have same hash whatever their type is
+    Element a((uint8_t)5), b((int64_t)5), c((double)5.0), d((float)5.5f);
+    TEST_ASSERT_TRUE(a == b && a == c);
+    TEST_ASSERT_TRUE(a.hash() == b.hash() && a.hash() == c.hash());
+    TEST_ASSERT_FALSE(a == d);
+    TEST_ASSERT_FALSE(Element((uint64_t)0xffffffffffffffffull) == Element((int64_t)-1));
+    TEST_ASSERT_FALSE(Element((uint8_t)0) == Element());
+
+    // different types other than numbers are unequal
+    uint8_t raw[] = {'a', 'b', 0};
+    TEST_ASSERT_FALSE(Element("ab") == Element(raw, (uint32_t)3));
+
+    // uint8 array is compared after zero
+    uint8_t x[] = {1, 0, 2}, y[] = {1, 0, 3};
+    TEST_ASSERT_FALSE(Element(x, (uint32_t)3) == Element(y, (uint32_t)3));
+
+    // c string has same hash as Element holding it
+    TEST_ASSERT_EQUAL(Element("wifiSSID").hash(), Element::hash("wifiSSID"));
+    TEST_ASSERT_EQUAL(Element().hash(), Element::hash(""));
+
+    // map hash doesn't depend on order of keys
+    Element m1, m2;
+    m1.setMap();
+    m1.set("a", Element((uint8_t)1));
+    m1.set("b", Element("2"));
+    m2.setMap();
+    m2.set("b", Element("2"));
+    m2.set("a", Element((int32_t)1));
+    TEST_ASSERT_TRUE(m1 == m2 && m1.hash() == m2.hash());
+
+    // unordered containers
+    std::unordered_map<Element, int> map;
+    map[Element("key")] = 1;
+    map[Element((uint16_t)300)] = 2;
+    TEST_ASSERT_EQUAL(1, map[Element("key")]);
+    TEST_ASSERT_EQUAL(2, map[Element((uint64_t)300)]);
+
+    std::unordered_map<const Element *, int, ElementHash, ElementEqual> index;
+    Element key("key");
+    index[&key] = 3;
+    Element lookup("key");
+    TEST_ASSERT_EQUAL(3, index[&lookup]);
+    TEST_ASSERT_TRUE(ElementEqual()(&key, "key") && ElementHash()("key") == ElementHash()(key));
+}
+
+void test_element_string_view()
+{
+    Element a("wifiSSID");
+    ElementStringView v = a.getStringView();
+    TEST_ASSERT_EQUAL(8, v.length());
+    TEST_ASSERT_TRUE(v.data() == a.c_str());
+    TEST_ASSERT_TRUE(v == "wifiSSID" && v != "wifi" && v < "wifiSSIE" && v > "wifi");
+    TEST_ASSERT_TRUE(a == v && a.hash() == v.hash());
+
+    // search
+    TEST_ASSERT_TRUE(a.startsWith("wifi") && a.endsWith("SSID"));
+    TEST_ASSERT_FALSE(a.startsWith("SSID"));
+    TEST_ASSERT_EQUAL(4, a.indexOf("SSID"));
+    TEST_ASSERT_EQUAL(4, a.indexOf('S'));
+    TEST_ASSERT_EQUAL(5, a.lastIndexOf('S'));
+    TEST_ASSERT_EQUAL(2, a.lastIndexOf("fi"));
+    TEST_ASSERT_EQUAL(-1, a.indexOf("ssid"));
+    TEST_ASSERT_EQUAL(-2, Element((uint8_t)1).indexOf("1"));
+    TEST_ASSERT_TRUE(v.substring(4) == "SSID" && v.substring(4, 5).toString() == "S");
+
+    // uint8 array is viewed as it is, zeros included
+    uint8_t raw[] = {'a', 0, 'b'};
+    Element b(raw, (uint32_t)3);
+    TEST_ASSERT_EQUAL(3, b.getStringView().length());
+    TEST_ASSERT_EQUAL(2, b.getStringView().indexOf('b'));
+
+    // empty view for other types
+    TEST_ASSERT_TRUE(Element().getStringView().empty());
+    TEST_ASSERT_TRUE(Element((uint32_t)100).getStringView().empty());
+    TEST_ASSERT_TRUE(Element() == ElementStringView());
+    TEST_ASSERT_EQUAL(Element().hash(), ElementStringView("").hash());
+}
+
+void test_element_slice()
+{
+    uint8_t raw[64];
+    for (uint8_t i = 0; i < 64; ++i)
+        raw[i] = i;
+    Element block(raw, (uint32_t)64);
+
+    // payload of parent is referenced, not copied
+    Element part = block.slice(16, 32);
+    TEST_ASSERT_EQUAL(ETYPE_BUFFER, part.getType());
+    TEST_ASSERT_EQUAL(16, part.getRawBufferLength());
+    TEST_ASSERT_TRUE(part.getRawBuffer() == block.getRawBuffer() + 16);
+    TEST_ASSERT_EQUAL(16, part.getUint8Array()[0]);
+
+    // same encoding and hash as a copy of that range
+    Element copied(raw, (uint32_t)16, true, 16);
+    TEST_ASSERT_TRUE(part == copied && part.hash() == copied.hash());
+    TEST_ASSERT_EQUAL(copied.hash(), Element::hash(block.getBufferView().slice(16, 32)));
+    Elements sliced = {&part}, original = {&copied};
+    uint32_t slicedLength = 0, originalLength = 0;
+    uint8_t *a = ArrayBuffer::createArrayBuffer(&sliced, &slicedLength);
+    uint8_t *b = ArrayBuffer::createArrayBuffer(&original, &originalLength);
+    TEST_ASSERT_TRUE(slicedLength == originalLength && !memcmp(a, b, slicedLength));
+    delete[] a;
+    delete[] b;
+
+    // copy of a slice owns its bytes
+    Element owned(part);
+    TEST_ASSERT_TRUE(owned.getRawBuffer() != part.getRawBuffer() && owned == part);
+
+    // range is clamped, empty range gives void
+    TEST_ASSERT_EQUAL(4, block.slice(60, 100).getRawBufferLength());
+    TEST_ASSERT_EQUAL(ETYPE_VOID, block.slice(80).getType());
+    TEST_ASSERT_EQUAL(ETYPE_VOID, Element((uint32_t)1).slice(0).getType());
+
+    // terminator of string is not included
+    Element ssid("wifiSSID");
+    TEST_ASSERT_EQUAL(4, ssid.slice(4).getRawBufferLength());
+    TEST_ASSERT_TRUE(ssid.slice(4).getStringView() == "SSID");
+}
+
+void test_element_number_operators()
+{
+    // integers are compared exactly, beyond 2^53 as well
+    Element big((uint64_t)9007199254740993ull);
+    TEST_ASSERT_TRUE(big != (uint64_t)9007199254740992ull);
+    TEST_ASSERT_TRUE(big > (uint64_t)9007199254740992ull);
+    TEST_ASSERT_TRUE(Element((uint64_t)0xffffffffffffffffull) > -1);
+    TEST_ASSERT_TRUE(Element((int8_t)-1) < (uint32_t)1);
+    TEST_ASSERT_TRUE(Element((float)1.5f) == 1.5);
+
+    // same type calculation wraps like C++ integers
+    Element a((uint8_t)5);
+    a -= (uint8_t)10;
+    TEST_ASSERT_EQUAL(ETYPE_UINT8, a.getType());
+    TEST_ASSERT_EQUAL(251, a.getUint8());
+
+    // integer division and modulo by zero result in 0
+    TEST_ASSERT_EQUAL(0, Element((int32_t)10) / (int32_t)0);
+    TEST_ASSERT_EQUAL(0, (Element((int32_t)10) % (int32_t)0).getInt32());
+    TEST_ASSERT_EQUAL(-1, (Element((int32_t)-7) % (int32_t)3).getInt32());
+
+    Element f((double)5);
+    f /= (int32_t)2;
+    TEST_ASSERT_TRUE(f == 2.5);
+
+    Element i((int32_t)3);
+    i++;
+    TEST_ASSERT_EQUAL(4, i.getInt32());
+}
+
+void test_element_array()
+{
+    int16_t samples[100];
+    for (int16_t i = 0; i < 100; ++i)
+    {
+        samples[i] = i * 10 - 300;
+    }
+
+    Element a;
+    TEST_ASSERT_TRUE(a.setArray(samples, 100));
+    TEST_ASSERT_TRUE(a.getType() == ETYPE_ARRAY && a.getArrayType() == ETYPE_INT16);
+    TEST_ASSERT_EQUAL(100, a.getArrayLength());
+    TEST_ASSERT_EQUAL(200 + 6, a.getOuterBufferLength());
+
+    // views and reductions
+    ElementArrayView<int16_t> items = a.getArray<int16_t>();
+    TEST_ASSERT_TRUE(items.size() == 100 && items[99] == 690);
+    TEST_ASSERT_TRUE(items.sum() == 19500 && items.min() == -300 && items.max() == 690);
+    TEST_ASSERT_TRUE(a.getArray<int32_t>().empty());
+    TEST_ASSERT_TRUE(a.arraySum().getType() == ETYPE_INT64 && a.arraySum().getInt64() == 19500);
+    TEST_ASSERT_TRUE(a.arrayMin().getType() == ETYPE_INT16 && a.arrayMax().getInt16() == 690);
+    TEST_ASSERT_TRUE(a.arrayMean() == 195.0);
+
+    // bulk append keeps item type
+    float f[3] = {1.5f, -2.0f, 4.0f};
+    Element b;
+    TEST_ASSERT_TRUE(b.append(f, 2) && b.append(f + 2, 1));
+    TEST_ASSERT_FALSE(b.append(samples, 1));
+    TEST_ASSERT_TRUE(b.getArrayType() == ETYPE_FLOAT && b.getArrayLength() == 3);
+    TEST_ASSERT_TRUE(b.arraySum().getDouble() == 3.5 && b.arrayMin().getFloat() == -2.0f);
+    TEST_ASSERT_TRUE(a.append(samples, 100) && a.getArrayLength() == 200 && a.arraySum().getInt64() == 39000);
+
+    // round trip in both modes, views read items in place
+    Element empty;
+    TEST_ASSERT_TRUE(empty.setArray(ETYPE_UINT32, nullptr, 0));
+    std::vector<Element *> container = {&a, &b, &empty};
+    for (int compact = 0; compact < 2; ++compact)
+    {
+        uint32_t length = 0;
+        uint8_t *encoded = compact ? ArrayBuffer::createCompactArrayBuffer(&container, &length)
+                                   : ArrayBuffer::createArrayBuffer(&container, &length);
+        Elements *output = ArrayBuffer::decodeArrayBuffer(encoded, length);
+        TEST_ASSERT_TRUE(output && output->size() == 3);
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            TEST_ASSERT_TRUE(output->at(i)->equalsTo(container[i]));
+            delete output->at(i);
+        }
+        delete output;
+
+        ArrayBufferView view(encoded, length);
+        TEST_ASSERT_TRUE(view.isValid() && view[0].getArrayLength() == 200);
+        TEST_ASSERT_TRUE(view[0].getArray<int16_t>().sum() == 39000 && view[1].getArray<float>()[2] == 4.0f);
+        TEST_ASSERT_TRUE(view[2].getArrayType() == ETYPE_UINT32 && view[2].getArray<uint32_t>().empty());
+        delete[] encoded;
+    }
+
+    // items must match item type
+    uint8_t malformed[] = {ETYPE_ARRAY, 4, 0, 0, 0, (uint8_t)ETYPE_INT16, 1, 2, 3};
+    TEST_ASSERT_TRUE(ArrayBuffer::decodeArrayBuffer(malformed, sizeof(malformed)) == nullptr);
+    TEST_ASSERT_FALSE(ArrayBufferView(malformed, sizeof(malformed)).isValid());
+}
+
+void test_element_chars()
+{
+    char buf[ELEMENT_NUMBER_CHARS_SIZE];
+
+    // integers of every width, no sign confusion beyond 2^31
+    TEST_ASSERT_EQUAL(1, Element((uint8_t)0).toChars(buf));
+    TEST_ASSERT_EQUAL_STRING("0", buf);
+    Element((uint32_t)4000000000u).toChars(buf);
+    TEST_ASSERT_EQUAL_STRING("4000000000", buf);
+    TEST_ASSERT_EQUAL(20, Element((uint64_t)0xffffffffffffffffull).toChars(buf));
+    TEST_ASSERT_EQUAL_STRING("18446744073709551615", buf);
+    Element((int64_t)0x8000000000000000ll).toChars(buf);
+    TEST_ASSERT_EQUAL_STRING("-9223372036854775808", buf);
+
+    // floating point has fixed decimals like String(double)
+    Element((double)-2.5).toChars(buf);
+    TEST_ASSERT_EQUAL_STRING("-2.50", buf);
+    Element((float)0.125f).toChars(buf, 3);
+    TEST_ASSERT_EQUAL_STRING("0.125", buf);
+    Element((double)1e300).toChars(buf);
+    TEST_ASSERT_EQUAL_STRING("1.00e+300", buf);
+    TEST_ASSERT_EQUAL(0, Element("12").toChars(buf));
+
+    // parsing picks type like setNumber
+    Element e;
+    TEST_ASSERT_TRUE(e.fromChars("200") && e.getType() == ETYPE_UINT8 && e == 200);
+    TEST_ASSERT_TRUE(e.fromChars("-40000") && e.getType() == ETYPE_INT32 && e == -40000);
+    TEST_ASSERT_TRUE(e.fromChars("18446744073709551615") && e.getType() == ETYPE_UINT64);
+    TEST_ASSERT_TRUE(e.fromChars("0.1") && e.getType() == ETYPE_DOUBLE && e.getDouble() == 0.1);
+    TEST_ASSERT_TRUE(e.fromChars("-1.5e3") && e.getDouble() == -1500.0);
+    TEST_ASSERT_TRUE(e.fromChars("12345678901234567890123e-3") && e.getDouble() == 12345678901234567890.123);
+
+    // whole text must be a number, nothing changes otherwise
+    TEST_ASSERT_FALSE(e.fromChars("18446744073709551616"));
+    TEST_ASSERT_FALSE(e.fromChars("12a") || e.fromChars("-") || e.fromChars(".") || e.fromChars(""));
+    TEST_ASSERT_TRUE(e.getDouble() == 12345678901234567890.123);
+
+    // an exponent without digits is not part of the number
+    ElementNumber n;
+    TEST_ASSERT_EQUAL(2, ElementNumber::fromChars("80e", 3, &n));
+    TEST_ASSERT_TRUE(n.kind == ElementNumber::UNSIGNED && n.u == 80);
+
+    // string and number concatenation
+    TEST_ASSERT_EQUAL_STRING("port 8080", (Element("port ") + Element((uint16_t)8080)).c_str());
+    TEST_ASSERT_EQUAL_STRING("5000000000s", (Element((uint64_t)5000000000ull) + Element("s")).c_str());
+    TEST_ASSERT_EQUAL_STRING("t=", (Element("t=1.50") - Element((double)1.5)).c_str());
+}
+
+struct ElementDescriber
+{
+    template <class T>
+    String operator()(T n) const
+    {
+        char buf[ELEMENT_NUMBER_CHARS_SIZE];
+        ElementNumber::of(n).toChars(buf);
+        return String((int)ElementNumber::typeOf<T>()) + ":" + buf;
+    }
+    template <class T>
+    String operator()(ElementArrayView<T> a) const
+    {
+        return String("array:") + (int)ElementNumber::typeOf<T>() + ":" + (int)a.size() + ":" + (int)a.sum();
+    }
+    String operator()(ElementVoid) const { return "void"; }
+    String operator()(ElementStringView s) const { return String("string:") + s.toString(); }
+    String operator()(ElementBufferView b) const { return String("buffer:") + (int)b.size() + ":" + (int)b[1]; }
+    String operator()(ElementListView l) const { return String("list:") + (int)l.size() + ":" + l[1]->visit(*this); }
+    String operator()(ElementMapView m) const { return String("map:") + (int)m.size() + ":" + m.key(0)->c_str(); }
+};
+
+void test_element_visit()
+{
+    ElementDescriber describe;
+
+    // every number is visited as its own type
+    TEST_ASSERT_EQUAL_STRING("1:200", Element((uint8_t)200).visit(describe).c_str());
+    TEST_ASSERT_EQUAL_STRING("-2:-300", Element((int16_t)-300).visit(describe).c_str());
+    TEST_ASSERT_EQUAL_STRING("8:5000000000", Element((uint64_t)5000000000ull).visit(describe).c_str());
+    TEST_ASSERT_EQUAL_STRING("6:1.50", Element((float)1.5f).visit(describe).c_str());
+    TEST_ASSERT_EQUAL_STRING("void", Element().visit(describe).c_str());
+
+    // views over payload, nothing is copied
+    TEST_ASSERT_EQUAL_STRING("string:hello", Element("hello").visit(describe).c_str());
+    uint8_t bytes[3] = {1, 2, 3};
+    TEST_ASSERT_EQUAL_STRING("buffer:3:2", Element(bytes, 3).visit(describe).c_str());
+
+    // typed array is dispatched by item type
+    int16_t samples[4] = {1, -2, 3, 10};
+    Element a;
+    a.setArray(samples, 4);
+    TEST_ASSERT_EQUAL_STRING("array:-2:4:12", a.visit(describe).c_str());
+
+    // containers, visitor may visit children
+    Element list;
+    list.setList();
+    list.push(Element("first"));
+    list.push(Element((int8_t)-1));
+    TEST_ASSERT_EQUAL_STRING("list:2:-1:-1", list.visit(describe).c_str());
+    Element map;
+    map.setMap();
+    map.set("key", Element((uint8_t)1));
+    TEST_ASSERT_EQUAL_STRING("map:1:key", map.visit(describe).c_str());
 }
 
 void test_createArrayBuffer_and_decodeArrayBuffer()
@@ -679,6 +1166,821 @@ void test_createArrayBuffer_and_decodeArrayBuffer()
         });
 }
 
+void test_decodeArrayBuffer_malformed()
+{
+    uint32_t length = 0;
+    uint8_t *encoded = ArrayBuffer::createArrayBuffer(
+        {Element((uint8_t)0xac),
+         Element("Hello world!"),
+         Element((uint32_t)1024)},
+        &length);
+
+    // every cut inside a field is rejected, cut on boundary of fields is valid
+    for (uint32_t i = 1; i < length; ++i)
+    {
+        std::vector<Element *> *output = ArrayBuffer::decodeArrayBuffer(encoded, i);
+        TEST_ASSERT_TRUE((i == 2 || i == 20) == (output != nullptr));
+        if (output)
+        {
+            for (auto e : *output)
+                delete e;
+            delete output;
+        }
+    }
+
+    // declared length runs past the end
+    Element e;
+    uint32_t declared = 0xfffffff0;
+    memcpy(encoded + 3, &declared, 4);
+    TEST_ASSERT_EQUAL(-2, e.setFromOuterBuffer(encoded, 2, length));
+    TEST_ASSERT_NULL(ArrayBuffer::decodeArrayBuffer(encoded, length));
+
+    // string without trailing '\0'
+    declared = 12;
+    memcpy(encoded + 3, &declared, 4);
+    TEST_ASSERT_EQUAL(-2, e.setFromOuterBuffer(encoded, 2, length));
+    TEST_ASSERT_EQUAL(ETYPE_VOID, e.getType());
+
+    // unknown mark
+    encoded[0] = 0x55;
+    TEST_ASSERT_EQUAL(-2, e.setFromOuterBuffer(encoded, 0, length));
+    delete encoded;
+}
+
+void test_arraybuffer_view()
+{
+    uint8_t buffer[64] = {0};
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        buffer[i] = random(0, 0xff);
+    }
+    uint32_t length = 0;
+    uint8_t *encoded = ArrayBuffer::createArrayBuffer(
+        {Element(0xac),
+         Element(-40000),
+         Element(-2147483666ll),
+         Element((double)3.1415926),
+         Element("Hello world!"),
+         Element(buffer, (uint32_t)64)},
+        &length);
+
+    ArrayBufferView view(encoded, length);
+    TEST_ASSERT_TRUE(view.isValid());
+    TEST_ASSERT_EQUAL(6, view.size());
+
+    TEST_ASSERT_TRUE(view[0].getType() == ETYPE_UINT8 && view[0].getUint8() == 0xac);
+    TEST_ASSERT_TRUE(view[1].getType(true) == ETYPE_NUMBER && view[1].getNumber() == -40000);
+    TEST_ASSERT_TRUE(view[2].getInt64() == -2147483666ll);
+    TEST_ASSERT_TRUE(view[3].getDouble() == 3.1415926);
+    TEST_ASSERT_TRUE(!strcmp(view[4].c_str(), "Hello world!") && view[4].getStringLength() == 12);
+    TEST_ASSERT_TRUE(view[5].isBufferAvailable(64) && !memcmp(view[5].getUint8Array(), buffer, 64));
+
+    // pointers reference source buffer, nothing copied
+    TEST_ASSERT_TRUE(view[5].getRawBuffer() > encoded && view[5].getRawBuffer() < encoded + length);
+
+    // out of range
+    TEST_ASSERT_TRUE(view[6].getType() == ETYPE_VOID);
+
+    // cursor
+    uint32_t count = 0;
+    for (ArrayBufferView::Cursor it = view.begin(); it != view.end(); ++it)
+    {
+        Element e;
+        TEST_ASSERT_TRUE(it->copyTo(&e));
+        TEST_ASSERT_TRUE(e.getType() == it->getType());
+        ++count;
+    }
+    TEST_ASSERT_EQUAL(6, count);
+
+    // truncated or corrupted buffer must be rejected
+    TEST_ASSERT_FALSE(ArrayBufferView(encoded, length - 1).isValid());
+    encoded[0] = 0x7e;
+    TEST_ASSERT_FALSE(ArrayBufferView(encoded, length).isValid());
+    TEST_ASSERT_FALSE(ArrayBufferView(nullptr, 0).isValid());
+
+    delete encoded;
+}
+
+void test_arraybuffer_writer()
+{
+    uint8_t buffer[256] = {0};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        buffer[i] = random(0, 0xff);
+    }
+    std::vector<Element *> container =
+        {
+            new Element(0x01),
+            new Element(-160),
+            new Element((float)1.23f),
+            new Element("Hello world!"),
+            new Element(buffer, (uint32_t)256),
+            new Element(0xffff)};
+
+    uint32_t length = 0;
+    uint8_t *expected = ArrayBuffer::createArrayBuffer(&container, &length);
+    TEST_ASSERT_EQUAL(length, ArrayBufferWriter::getOuterBufferLength(&container));
+
+    // growing buffer
+    std::vector<uint8_t> output;
+    {
+        ArrayBufferWriter writer(ArrayBufferWriter::toVector(&output));
+        TEST_ASSERT_TRUE(writer.write(&container));
+        TEST_ASSERT_TRUE(writer.flush());
+        TEST_ASSERT_EQUAL(length, writer.length());
+    }
+    TEST_ASSERT_TRUE(output.size() == length && !memcmp(output.data(), expected, length));
+
+    // fixed caller owned buffer
+    uint8_t fixed[512] = {0};
+    uint32_t offset = 0;
+    {
+        ArrayBufferWriter writer(ArrayBufferWriter::toBuffer(fixed, 512, &offset));
+        TEST_ASSERT_TRUE(writer.write(&container) && writer.flush());
+    }
+    TEST_ASSERT_TRUE(offset == length && !memcmp(fixed, expected, length));
+
+    // forward fields of another buffer without decoding
+    output.clear();
+    {
+        ArrayBufferView view(expected, length);
+        ArrayBufferWriter writer(ArrayBufferWriter::toVector(&output));
+        for (ArrayBufferView::Cursor it = view.begin(); it != view.end(); ++it)
+        {
+            TEST_ASSERT_TRUE(writer.write(*it));
+        }
+    }
+    TEST_ASSERT_TRUE(output.size() == length && !memcmp(output.data(), expected, length));
+
+    // sink full
+    offset = 0;
+    ArrayBufferWriter small(ArrayBufferWriter::toBuffer(fixed, 32, &offset));
+    TEST_ASSERT_FALSE(small.write(&container) && small.flush());
+    TEST_ASSERT_TRUE(small.hasError());
+
+    delete expected;
+    for (uint32_t i = 0; i < container.size(); ++i)
+    {
+        delete container.at(i);
+    }
+}
+
+void test_arraybuffer_compact()
+{
+    uint8_t buffer[200] = {0};
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        buffer[i] = random(0, 0xff);
+    }
+    std::vector<Element *> container =
+        {
+            new Element(0x01),
+            new Element(-160),
+            new Element((uint32_t)0xffffffff),
+            new Element((int64_t)-0x7fffffffffffffffll),
+            new Element((uint64_t)300),
+            new Element((float)1.23f),
+            new Element(3.1415926),
+            new Element("Hello world!"),
+            new Element(buffer, (uint32_t)200)};
+
+    uint32_t normalLength = 0, length = 0;
+    uint8_t *normal = ArrayBuffer::createArrayBuffer(&container, &normalLength);
+    uint8_t *compact = ArrayBuffer::createCompactArrayBuffer(&container, &length);
+    TEST_ASSERT_TRUE(compact && compact[0] == ARRAY_BUFFER_COMPACT_MARK);
+    TEST_ASSERT_TRUE(length < normalLength);
+    TEST_ASSERT_EQUAL(length, ArrayBufferWriter::getOuterBufferLength(&container, true));
+
+    // round trip, types are kept
+    Elements *output = ArrayBuffer::decodeArrayBuffer(compact, length);
+    TEST_ASSERT_TRUE(output && output->size() == container.size());
+    for (uint32_t i = 0; i < container.size(); ++i)
+    {
+        TEST_ASSERT_EQUAL(container.at(i)->getType(), output->at(i)->getType());
+        TEST_ASSERT_TRUE(container.at(i)->equalsTo(output->at(i)));
+    }
+
+    // view reads compact buffer in place
+    ArrayBufferView view(compact, length);
+    TEST_ASSERT_TRUE(view.isValid() && view.isCompact() && view.size() == container.size());
+    TEST_ASSERT_EQUAL(-160, view[1].getInt16());
+    TEST_ASSERT_TRUE(view[3].getInt64() == -0x7fffffffffffffffll);
+    TEST_ASSERT_TRUE(!strcmp(view[7].c_str(), "Hello world!"));
+
+    ElementArena arena;
+    Elements *fromArena = ArrayBuffer::decodeArrayBuffer(compact, length, &arena);
+    TEST_ASSERT_TRUE(fromArena && fromArena->size() == container.size());
+    TEST_ASSERT_TRUE(fromArena->at(2)->equalsTo(container.at(2)) && fromArena->at(8)->equalsTo(container.at(8)));
+
+    // writer, and conversion between modes
+    std::vector<uint8_t> stream;
+    {
+        ArrayBufferWriter writer(ArrayBufferWriter::toVector(&stream), true);
+        TEST_ASSERT_TRUE(writer.write(&container));
+    }
+    TEST_ASSERT_TRUE(stream.size() == length && !memcmp(stream.data(), compact, length));
+
+    stream.clear();
+    {
+        ArrayBufferView normalView(normal, normalLength);
+        ArrayBufferWriter writer(ArrayBufferWriter::toVector(&stream), true);
+        for (ArrayBufferView::Cursor it = normalView.begin(); it != normalView.end(); ++it)
+            TEST_ASSERT_TRUE(writer.write(*it));
+    }
+    TEST_ASSERT_TRUE(stream.size() == length && !memcmp(stream.data(), compact, length));
+
+    // normal decoder rejects value out of range and truncated data
+    uint8_t outOfRange[] = {ARRAY_BUFFER_COMPACT_MARK, ETYPE_UINT8, 0x80, 0x02};
+    TEST_ASSERT_NULL(ArrayBuffer::decodeArrayBuffer(outOfRange, 4));
+    TEST_ASSERT_NULL(ArrayBuffer::decodeArrayBuffer(compact, length - 1));
+    Element e;
+    TEST_ASSERT_TRUE(e.setFromOuterBuffer(compact, 0, length) < 0);
+
+    for (uint32_t i = 0; i < container.size(); ++i)
+    {
+        delete container.at(i);
+        delete output->at(i);
+    }
+    delete output;
+    delete normal;
+    delete compact;
+}
+
+void test_arraybuffer_checked()
+{
+    // check value of IEEE CRC32
+    TEST_ASSERT_EQUAL_HEX32(0xcbf43926, mycrypto::CRC32::checksum((const uint8_t *)"123456789", 9));
+    uint32_t crc = mycrypto::CRC32::update(0, (const uint8_t *)"1234", 4);
+    TEST_ASSERT_EQUAL_HEX32(0xcbf43926, mycrypto::CRC32::update(crc, (const uint8_t *)"56789", 5));
+
+    Element a((uint16_t)0x1234), b("Hello world!"), c((double)-2.5);
+    std::vector<Element *> container = {&a, &b, &c};
+
+    for (int compact = 0; compact < 2; ++compact)
+    {
+        uint32_t length = 0, plainLength = 0;
+        uint8_t *checked = ArrayBuffer::createCheckedArrayBuffer(&container, &length, compact);
+        uint8_t *plain = compact ? ArrayBuffer::createCompactArrayBuffer(&container, &plainLength)
+                                 : ArrayBuffer::createArrayBuffer(&container, &plainLength);
+        TEST_ASSERT_TRUE(checked && checked[0] == ARRAY_BUFFER_CHECKED_MARK && length == plainLength + 5);
+        TEST_ASSERT_TRUE(!memcmp(checked + 1, plain, plainLength) && ArrayBuffer::verifyChecksum(checked, length));
+
+        Elements *output = ArrayBuffer::decodeArrayBuffer(checked, length);
+        TEST_ASSERT_TRUE(output && output->size() == 3 && output->at(1)->equalsTo(&b));
+        for (uint32_t i = 0; i < output->size(); ++i)
+            delete output->at(i);
+        delete output;
+
+        ArrayBufferView view(checked, length);
+        TEST_ASSERT_TRUE(view.isValid() && view.isCompact() == (bool)compact && view[2].getDouble() == -2.5);
+
+        // same bytes from writer
+        std::vector<uint8_t> stream;
+        {
+            ArrayBufferWriter writer(ArrayBufferWriter::toVector(&stream), compact, true);
+            TEST_ASSERT_TRUE(writer.write(&container) && writer.finish());
+        }
+        TEST_ASSERT_TRUE(stream.size() == length && !memcmp(stream.data(), checked, length));
+
+        // flipped bit in string payload is still well formed, but rejected
+        checked[length - 8] ^= 0x01;
+        TEST_ASSERT_TRUE(ArrayBuffer::decodeArrayBuffer(checked, length) == nullptr);
+        TEST_ASSERT_FALSE(ArrayBufferView(checked, length).isValid());
+        output = ArrayBuffer::decodeArrayBuffer(plain, plainLength);
+        TEST_ASSERT_TRUE(output != nullptr);
+        for (uint32_t i = 0; i < output->size(); ++i)
+            delete output->at(i);
+        delete output;
+
+        delete[] checked;
+        delete[] plain;
+    }
+}
+
+void test_arraybuffer_sorted()
+{
+    std::vector<Element *> container = {
+        new Element("wifiSSID"), new Element("myHomeWiFi"),
+        new Element("token"), new Element("a1b2c3"),
+        new Element("websocketPort"), new Element((uint16_t)8080),
+        new Element("nickname"), new Element("kitchen"),
+        new Element("token"), new Element("duplicated"),
+        new Element("unset"), new Element()};
+
+    uint32_t length = 0;
+    uint8_t *sorted = ArrayBuffer::createSortedArrayBuffer(&container, &length);
+    TEST_ASSERT_TRUE(sorted && sorted[0] == ARRAY_BUFFER_SORTED_MARK);
+
+    // binary search in place, first one wins, empty values are skipped
+    ArrayBufferSortedView view(sorted, length);
+    TEST_ASSERT_TRUE(view.isValid() && view.size() == 4);
+    TEST_ASSERT_TRUE(!strcmp(view.keyAt(0).c_str(), "nickname") && !strcmp(view.keyAt(3).c_str(), "wifiSSID"));
+    TEST_ASSERT_TRUE(!strcmp(view.get("token").c_str(), "a1b2c3"));
+    TEST_ASSERT_EQUAL(8080, view.get("websocketPort").getUint16());
+    TEST_ASSERT_TRUE(!strcmp(view.get("wifiSSID").c_str(), "myHomeWiFi"));
+    TEST_ASSERT_TRUE(view.get("unset").getType() == ETYPE_VOID && view.get("zzz").getType() == ETYPE_VOID);
+
+    // decoded as keys and values as usual
+    Elements *output = ArrayBuffer::decodeArrayBuffer(sorted, length);
+    TEST_ASSERT_TRUE(output && output->size() == 8);
+    TEST_ASSERT_TRUE(!strcmp(output->at(0)->c_str(), "nickname") && !strcmp(output->at(3)->c_str(), "a1b2c3"));
+    for (uint32_t i = 0; i < output->size(); ++i)
+        delete output->at(i);
+    delete output;
+
+    // offset table runs past the end
+    TEST_ASSERT_FALSE(ArrayBufferSortedView(sorted, 9).isValid());
+    TEST_ASSERT_FALSE(ArrayBufferView(sorted, 9).isValid());
+
+    // keys must be strings
+    container.push_back(new Element((uint8_t)1));
+    container.push_back(new Element((uint8_t)2));
+    uint32_t invalidLength = 0;
+    TEST_ASSERT_TRUE(ArrayBuffer::createSortedArrayBuffer(&container, &invalidLength) == nullptr);
+
+    for (uint32_t i = 0; i < container.size(); ++i)
+        delete container.at(i);
+    delete[] sorted;
+}
+
+void test_arraybuffer_transcoder()
+{
+    int16_t samples[] = {-1, 2, 3};
+    Element readings;
+    readings.setArray(samples, 3);
+    Element settings;
+    settings.setMap();
+    settings.set("port", Element((uint16_t)8080));
+    std::vector<Element *> container = {
+        new Element((uint8_t)5), new Element((int32_t)-300), new Element("hi"), new Element(1.5f),
+        new Element(settings), new Element(readings)};
+
+    uint32_t length = 0;
+    uint8_t *buffer = ArrayBuffer::createArrayBuffer(&container, &length);
+
+    // smallest forms, typed array becomes array of numbers
+    const uint8_t packed[] = {0x96, 0x05, 0xd1, 0xfe, 0xd4, 0xa2, 'h', 'i', 0xca, 0x3f, 0xc0, 0x00, 0x00,
+                              0x81, 0xa4, 'p', 'o', 'r', 't', 0xcd, 0x1f, 0x90, 0x93, 0xff, 0x02, 0x03};
+    std::vector<uint8_t> output;
+    TEST_ASSERT_TRUE(ArrayBufferTranscoder::toMessagePack(buffer, length, ArrayBufferWriter::toVector(&output)));
+    TEST_ASSERT_TRUE(output.size() == sizeof(packed) && !memcmp(output.data(), packed, sizeof(packed)));
+
+    // typed array keeps its type in CBOR, so the message comes back unchanged, compact as well
+    std::vector<uint8_t> cbor, restored;
+    TEST_ASSERT_TRUE(ArrayBufferTranscoder::toCBOR(buffer, length, ArrayBufferWriter::toVector(&cbor)));
+    {
+        ArrayBufferWriter writer(ArrayBufferWriter::toVector(&restored));
+        TEST_ASSERT_TRUE(ArrayBufferTranscoder::fromCBOR(cbor.data(), cbor.size(), &writer));
+    }
+    TEST_ASSERT_TRUE(restored.size() == length && !memcmp(restored.data(), buffer, length));
+
+    uint32_t compactLength = 0;
+    uint8_t *compact = ArrayBuffer::createCompactArrayBuffer(&container, &compactLength);
+    restored.clear();
+    {
+        ArrayBufferWriter writer(ArrayBufferWriter::toVector(&restored), true);
+        TEST_ASSERT_TRUE(ArrayBufferTranscoder::fromCBOR(cbor.data(), cbor.size(), &writer));
+    }
+    TEST_ASSERT_TRUE(restored.size() == compactLength && !memcmp(restored.data(), compact, compactLength));
+
+    // back from MessagePack, typed array is a list now
+    restored.clear();
+    {
+        ArrayBufferWriter writer(ArrayBufferWriter::toVector(&restored));
+        TEST_ASSERT_TRUE(ArrayBufferTranscoder::fromMessagePack(output.data(), output.size(), &writer));
+    }
+    ArrayBufferView view(restored.data(), restored.size());
+    TEST_ASSERT_TRUE(view.isValid() && view.size() == 6);
+    TEST_ASSERT_EQUAL(8080, view[4].get("port").getUint16());
+    TEST_ASSERT_TRUE(view[5].getType() == ETYPE_LIST && view[5].getList()[0].getInt8() == -1);
+
+    // truncated, nil and keys other than strings are rejected
+    std::vector<uint8_t> ignored;
+    ArrayBufferWriter writer(ArrayBufferWriter::toVector(&ignored));
+    TEST_ASSERT_FALSE(ArrayBufferTranscoder::fromMessagePack(output.data(), output.size() - 1, &writer));
+    const uint8_t nil[] = {0x91, 0xc0}, key[] = {0x91, 0x81, 0x01, 0x02};
+    TEST_ASSERT_FALSE(ArrayBufferTranscoder::fromMessagePack(nil, sizeof(nil), &writer));
+    TEST_ASSERT_FALSE(ArrayBufferTranscoder::fromMessagePack(key, sizeof(key), &writer));
+
+    for (uint32_t i = 0; i < container.size(); ++i)
+        delete container.at(i);
+    delete[] buffer;
+    delete[] compact;
+}
+
+void test_element_list_and_map()
+{
+    uint8_t hash[32] = {0};
+    for (uint32_t i = 0; i < 32; ++i)
+    {
+        hash[i] = random(0, 0xff);
+    }
+
+    Element provider;
+    TEST_ASSERT_TRUE(provider.setMap());
+    TEST_ASSERT_TRUE(provider.set("id", Element((uint16_t)3)));
+    TEST_ASSERT_TRUE(provider.set("name", Element("turn on")));
+    TEST_ASSERT_TRUE(provider.set("hash", new Element(hash, (uint32_t)32)));
+    TEST_ASSERT_TRUE(provider.set("id", Element((uint16_t)4)));
+    TEST_ASSERT_EQUAL(3, provider.size());
+    TEST_ASSERT_EQUAL(4, provider.get("id")->getUint16());
+    TEST_ASSERT_NULL(provider.get("none"));
+
+    Element *providers = new Element();
+    TEST_ASSERT_TRUE(providers->setList());
+    TEST_ASSERT_TRUE(providers->push(provider));
+    TEST_ASSERT_TRUE(providers->push(Element("OK")));
+    TEST_ASSERT_FALSE(provider.push(Element("OK")));
+
+    std::vector<Element *> container = {new Element(0x01), providers};
+
+    // one pass encoding, nested payload is a whole ArrayBuffer
+    uint32_t length = 0;
+    uint8_t *buffer = ArrayBuffer::createArrayBuffer(&container, &length);
+    TEST_ASSERT_EQUAL(length, ArrayBufferWriter::getOuterBufferLength(&container));
+    TEST_ASSERT_EQUAL(ETYPE_LIST, (int8_t)buffer[2]);
+
+    std::vector<uint8_t> stream;
+    {
+        ArrayBufferWriter writer(ArrayBufferWriter::toVector(&stream));
+        TEST_ASSERT_TRUE(writer.write(&container));
+    }
+    TEST_ASSERT_TRUE(stream.size() == length && !memcmp(stream.data(), buffer, length));
+
+    // decode on heap
+    Elements *output = ArrayBuffer::decodeArrayBuffer(buffer, length);
+    TEST_ASSERT_TRUE(output && output->size() == 2);
+    TEST_ASSERT_TRUE(output->at(1)->equalsTo(providers));
+    TEST_ASSERT_TRUE(*(output->at(1)->at(0)->get("name")) == "turn on");
+    TEST_ASSERT_TRUE(output->at(1)->at(0)->get("hash")->isBufferAvailable(32));
+
+    // read in place
+    ArrayBufferView view(buffer, length);
+    TEST_ASSERT_TRUE(view.isValid() && view.size() == 2);
+    ArrayBufferView list = view[1].getList();
+    TEST_ASSERT_EQUAL(2, list.size());
+    TEST_ASSERT_EQUAL(4, list[0].get("id").getUint16());
+    TEST_ASSERT_TRUE(!strcmp(list[1].c_str(), "OK"));
+
+    // decode into arena, compact mode
+    uint32_t compactLength = 0;
+    uint8_t *compact = ArrayBuffer::createCompactArrayBuffer(&container, &compactLength);
+    ElementArena arena;
+    Elements *fromArena = ArrayBuffer::decodeArrayBuffer(compact, compactLength, &arena);
+    TEST_ASSERT_TRUE(fromArena && fromArena->at(1)->equalsTo(providers));
+    arena.reset();
+
+    // key of map must be string, payload must not overflow
+    uint8_t invalidMap[] = {ETYPE_MAP, 4, 0, 0, 0, ETYPE_UINT8, 1, ETYPE_UINT8, 2};
+    TEST_ASSERT_NULL(ArrayBuffer::decodeArrayBuffer(invalidMap, sizeof(invalidMap)));
+    TEST_ASSERT_FALSE(ArrayBufferView(invalidMap, sizeof(invalidMap)).isValid());
+    buffer[3] = 0xff;
+    TEST_ASSERT_NULL(ArrayBuffer::decodeArrayBuffer(buffer, length));
+
+    // nesting deeper than ARRAY_BUFFER_MAX_DEPTH is refused
+    uint8_t deep[(ARRAY_BUFFER_MAX_DEPTH + 1) * 5 + 2] = {0};
+    for (uint32_t i = 0; i <= ARRAY_BUFFER_MAX_DEPTH; ++i)
+    {
+        uint32_t payload = sizeof(deep) - (i + 1) * 5;
+        deep[i * 5] = ETYPE_LIST;
+        memcpy(deep + i * 5 + 1, &payload, 4);
+    }
+    deep[sizeof(deep) - 2] = ETYPE_UINT8;
+    TEST_ASSERT_NULL(ArrayBuffer::decodeArrayBuffer(deep, sizeof(deep)));
+    TEST_ASSERT_FALSE(ArrayBufferView(deep, sizeof(deep)).isValid());
+
+    // copy from itself, or from one of its own children
+    Element copy(*providers);
+    copy = &copy;
+    TEST_ASSERT_TRUE(copy.equalsTo(providers));
+    copy = copy.at(0);
+    TEST_ASSERT_TRUE(copy.getType() == ETYPE_MAP && copy.equalsTo(&provider));
+    TEST_ASSERT_TRUE(copy.copyFrom(copy.get("name")));
+    TEST_ASSERT_TRUE(copy == "turn on");
+
+    // move from one of its own children
+    Element moved(*providers);
+    moved = std::move(*(moved.at(0)));
+    TEST_ASSERT_TRUE(moved.getType() == ETYPE_MAP && moved.equalsTo(&provider));
+    moved = std::move(*(moved.get("hash")));
+    TEST_ASSERT_TRUE(moved.isBufferAvailable(32) && !memcmp(moved.getUint8Array(), hash, 32));
+
+    for (uint32_t i = 0; i < output->size(); ++i)
+    {
+        delete output->at(i);
+    }
+    delete output;
+    delete container.at(0);
+    delete container.at(1);
+    delete buffer;
+    delete compact;
+}
+
+void test_arraybuffer_schema()
+{
+    typedef ArrayBufferSchema<uint8_t, ArrayBufferBuffer<32>, ArrayBufferNumber<uint32_t>> Request;
+    typedef ArrayBufferSchema<uint8_t, const char *, ArrayBufferNumber<uint32_t>, ArrayBufferBuffer<>> Block;
+
+    TEST_ASSERT_EQUAL(3, Request::size);
+    TEST_ASSERT_TRUE(Request::isFixed);
+    TEST_ASSERT_EQUAL(2 + 37 + 5, Request::fixedLength);
+    TEST_ASSERT_FALSE(Block::isFixed);
+
+    uint8_t id[32] = {0};
+    for (uint32_t i = 0; i < 32; ++i)
+    {
+        id[i] = random(0, 0xff);
+    }
+
+    // same bytes as encoding Elements
+    Request::Values request(0xAC, ArrayBufferBytes{id, 32}, 1024);
+    uint8_t buffer[Request::fixedLength];
+    TEST_ASSERT_EQUAL(Request::fixedLength, Request::getOuterBufferLength(request));
+    TEST_ASSERT_EQUAL(Request::fixedLength, Request::createArrayBuffer(request, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL(0, Request::createArrayBuffer(request, buffer, sizeof(buffer) - 1));
+
+    std::vector<Element *> container = {new Element((uint8_t)0xAC), new Element(id, (uint32_t)32), new Element((uint32_t)1024)};
+    uint32_t length = 0;
+    uint8_t *encoded = ArrayBuffer::createArrayBuffer(&container, &length);
+    TEST_ASSERT_TRUE(length == sizeof(buffer) && !memcmp(encoded, buffer, length));
+    delete encoded;
+
+    // decode from view and from Elements
+    Request::Values decoded;
+    TEST_ASSERT_TRUE(Request::decode(ArrayBufferView(buffer, sizeof(buffer)), &decoded));
+    TEST_ASSERT_EQUAL(1024, std::get<2>(decoded));
+    TEST_ASSERT_TRUE(std::get<1>(decoded).data == buffer + 7);
+    TEST_ASSERT_TRUE(Request::validate(&container));
+
+    // any number is accepted by ArrayBufferNumber, plain type must match
+    container.at(2)->setNumber(5);
+    TEST_ASSERT_TRUE(Request::decode(&container, &decoded));
+    TEST_ASSERT_EQUAL(5, std::get<2>(decoded));
+    TEST_ASSERT_FALSE((ArrayBufferSchema<uint8_t, ArrayBufferBuffer<32>, uint32_t>::validate(&container)));
+
+    // wrong length of buffer, wrong count of fields
+    container.at(1)->setUint8Array(id, 16);
+    TEST_ASSERT_FALSE(Request::validate(&container));
+    container.push_back(new Element("extra"));
+    container.at(1)->setUint8Array(id, 32);
+    TEST_ASSERT_FALSE(Request::validate(&container));
+    TEST_ASSERT_TRUE(Request::validate(&container, true));
+    for (auto i : container)
+        delete i;
+
+    // strings and empty buffer, compact mode
+    std::vector<uint8_t> stream;
+    {
+        ArrayBufferWriter writer(ArrayBufferWriter::toVector(&stream), true);
+        TEST_ASSERT_TRUE(Block::write(&writer, Block::Values(0xAC, "admin", 300, ArrayBufferBytes{nullptr, 0})));
+    }
+    TEST_ASSERT_EQUAL(stream.size(), Block::getOuterBufferLength(Block::Values(0xAC, "admin", 300, ArrayBufferBytes{nullptr, 0}), true));
+
+    Block::Values block;
+    ArrayBufferView view(stream.data(), stream.size());
+    TEST_ASSERT_TRUE(view.isCompact() && Block::decode(view, &block));
+    TEST_ASSERT_EQUAL_STRING("admin", std::get<1>(block));
+    TEST_ASSERT_EQUAL(300, std::get<2>(block));
+    TEST_ASSERT_EQUAL(0, std::get<3>(block).length);
+}
+
+void test_element_arena()
+{
+    uint8_t buffer[64] = {0};
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        buffer[i] = random(0, 0xff);
+    }
+    uint32_t length = 0;
+    uint8_t *encoded = ArrayBuffer::createArrayBuffer(
+        {Element(0xac), Element(-40000), Element("Hello world!"), Element(buffer, (uint32_t)64)},
+        &length);
+
+    // small block size to make arena chain blocks
+    ElementArena arena(128);
+
+    for (int round = 0; round < 3; ++round)
+    {
+        Elements *decoded = ArrayBuffer::decodeArrayBuffer(encoded, length, &arena);
+        TEST_ASSERT_TRUE(decoded && decoded->size() == 4);
+        TEST_ASSERT_TRUE(*(decoded->at(0)) == 0xac);
+        TEST_ASSERT_TRUE(*(decoded->at(1)) == -40000);
+        TEST_ASSERT_TRUE(*(decoded->at(2)) == "Hello world!");
+        TEST_ASSERT_TRUE(!memcmp(decoded->at(3)->getUint8Array(), buffer, 64));
+
+        // element in arena could still be modified as usual
+        *(decoded->at(2)) = "a string longer than inline buffer of element";
+
+        Element *e = arena.create("extra");
+        TEST_ASSERT_TRUE(e && *e == "extra");
+
+        uint32_t outLen = 0;
+        uint8_t *reencoded = ArrayBuffer::createArrayBuffer(decoded, &outLen, &arena);
+        TEST_ASSERT_TRUE(reencoded && outLen);
+
+        // only the first block is kept after reset
+        TEST_ASSERT_TRUE(arena.getCapacity() > 128);
+        arena.reset();
+        TEST_ASSERT_EQUAL(0, arena.getUsed());
+        TEST_ASSERT_EQUAL(128, arena.getCapacity());
+    }
+
+    // every allocation is aligned, including one in its own oversized block
+    const uint32_t lengths[] = {1, 3, 13, 200, 5};
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        void *p = arena.allocate(lengths[i]);
+        TEST_ASSERT_TRUE(p != nullptr);
+        TEST_ASSERT_EQUAL(0, (uintptr_t)p % alignof(std::max_align_t));
+    }
+    Element *aligned = arena.create((double)1.5);
+    TEST_ASSERT_TRUE(aligned && ((uintptr_t)aligned % alignof(Element)) == 0 && *aligned == 1.5);
+    arena.reset();
+    TEST_ASSERT_EQUAL(128, arena.getCapacity());
+
+    // malformed input
+    TEST_ASSERT_TRUE(ArrayBuffer::decodeArrayBuffer(encoded, length - 1, &arena) == nullptr);
+
+    delete encoded;
+}
+
+void test_element_list()
+{
+    uint8_t buffer[64] = {0};
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        buffer[i] = random(0, 0xff);
+    }
+
+    ElementList list = {Element(0xac), Element(-40000), Element("Hello world!")};
+    list.emplace_back(buffer, (uint32_t)64);
+    TEST_ASSERT_EQUAL(4, list.size());
+    TEST_ASSERT_TRUE(list[0] == 0xac);
+    TEST_ASSERT_TRUE(*(list.at(2)) == "Hello world!");
+    TEST_ASSERT_TRUE(list.at(4) == nullptr);
+
+    uint32_t length = 0;
+    uint8_t *encoded = ArrayBuffer::createArrayBuffer(&list, &length);
+    TEST_ASSERT_EQUAL(ArrayBufferWriter::getOuterBufferLength(&list), length);
+
+    // same bytes as Elements
+    Elements elements = {&list[0], &list[1], &list[2], &list[3]};
+    uint32_t expectedLength = 0;
+    uint8_t *expected = ArrayBuffer::createArrayBuffer(&elements, &expectedLength);
+    TEST_ASSERT_TRUE(length == expectedLength && !memcmp(encoded, expected, length));
+    delete expected;
+
+    // decode on heap and in arena, appended after existing Elements
+    ElementArena arena(128);
+    for (int round = 0; round < 2; ++round)
+    {
+        ElementList decoded;
+        decoded.emplace_back("head");
+        TEST_ASSERT_TRUE(ArrayBuffer::decodeArrayBuffer(encoded, length, &decoded, round ? &arena : nullptr));
+        TEST_ASSERT_EQUAL(5, decoded.size());
+        TEST_ASSERT_TRUE(decoded[1] == 0xac);
+        TEST_ASSERT_TRUE(decoded[2] == -40000);
+        TEST_ASSERT_TRUE(decoded[3] == "Hello world!");
+        TEST_ASSERT_TRUE(!memcmp(decoded[4].getUint8Array(), buffer, 64));
+
+        // malformed input leaves list as it was
+        TEST_ASSERT_FALSE(ArrayBuffer::decodeArrayBuffer(encoded, length - 1, &decoded, round ? &arena : nullptr));
+        TEST_ASSERT_EQUAL(5, decoded.size());
+    }
+    arena.reset();
+
+    // grows beyond inline capacity, Elements are moved
+    ElementList big;
+    for (uint32_t i = 0; i < ELEMENT_LIST_INLINE_CAPACITY * 3; ++i)
+    {
+        big.push_back(Element("a string longer than inline buffer of element"));
+        big.emplace_back(big[0]);
+    }
+    TEST_ASSERT_EQUAL(ELEMENT_LIST_INLINE_CAPACITY * 6, big.size());
+    for (const Element &e : big)
+        TEST_ASSERT_TRUE(e == "a string longer than inline buffer of element");
+
+    ElementList moved(std::move(big));
+    TEST_ASSERT_EQUAL(0, big.size());
+    TEST_ASSERT_EQUAL(ELEMENT_LIST_INLINE_CAPACITY * 6, moved.size());
+
+    ElementList copied(list);
+    copied[2] = "changed";
+    TEST_ASSERT_TRUE(list[2] == "Hello world!");
+
+    std::vector<uint8_t> streamed;
+    {
+        ArrayBufferWriter writer(ArrayBufferWriter::toVector(&streamed));
+        TEST_ASSERT_TRUE(writer.write(&list) && writer.flush());
+    }
+    TEST_ASSERT_TRUE(streamed.size() == length && !memcmp(streamed.data(), encoded, length));
+
+    delete encoded;
+}
+
+// payload in RAM standing for a file, counts reads
+class TestFileSource : public ElementFileSource
+{
+public:
+    const uint8_t *data;
+    uint32_t size;
+    uint32_t largestRead = 0;
+    bool fail = false;
+    bool *deleted;
+
+    TestFileSource(const uint8_t *data, uint32_t size, bool *deleted) : data(data), size(size), deleted(deleted) {}
+    ~TestFileSource() { *(this->deleted) = true; }
+    uint32_t length() const override { return this->size; }
+    bool read(uint32_t offset, uint8_t *buffer, uint32_t length) override
+    {
+        if (this->fail || offset + length > this->size)
+            return false;
+        memcpy(buffer, this->data + offset, length);
+        if (length > this->largestRead)
+            this->largestRead = length;
+        return true;
+    }
+};
+
+void test_element_file()
+{
+    uint32_t size = ARRAY_BUFFER_WRITER_FILE_CHUNK_SIZE * 4 + 17;
+    uint8_t *blob = new uint8_t[size];
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        blob[i] = random(0, 0xff);
+    }
+
+    bool deleted = false;
+    TestFileSource *source = new TestFileSource(blob, size, &deleted);
+    Element file(source);
+    Element inRAM(blob, size);
+    TEST_ASSERT_EQUAL(ETYPE_FILE, file.getType());
+    TEST_ASSERT_TRUE(file.getFileSource() == source);
+    TEST_ASSERT_TRUE(file.getRawBuffer() == nullptr);
+    TEST_ASSERT_EQUAL(size, file.getRawBufferLength());
+    TEST_ASSERT_EQUAL(inRAM.getOuterBufferLength(), file.getOuterBufferLength());
+    TEST_ASSERT_EQUAL(inRAM.getOuterBufferLength(true), file.getOuterBufferLength(true));
+
+    // encoded as uint8 array, same bytes as one in RAM
+    Elements expectedFields = {new Element((uint8_t)0xab), &inRAM};
+    Elements fileFields = {new Element((uint8_t)0xab), &file};
+    uint32_t expectedLength = 0, length = 0;
+    uint8_t *expected = ArrayBuffer::createArrayBuffer(&expectedFields, &expectedLength);
+    uint8_t *encoded = ArrayBuffer::createArrayBuffer(&fileFields, &length);
+    TEST_ASSERT_TRUE(encoded && length == expectedLength && !memcmp(encoded, expected, length));
+
+    Elements *decoded = ArrayBuffer::decodeArrayBuffer(encoded, length);
+    TEST_ASSERT_TRUE(decoded && decoded->size() == 2);
+    TEST_ASSERT_EQUAL(ETYPE_BUFFER, decoded->at(1)->getType());
+    TEST_ASSERT_TRUE(decoded->at(1)->equalsTo(&inRAM));
+    for (auto it = decoded->begin(); it != decoded->end(); ++it)
+        delete (*it);
+    delete decoded;
+    delete encoded;
+
+    // streamed by writer in chunks, compact mode too
+    for (int compact = 0; compact < 2; ++compact)
+    {
+        std::vector<uint8_t> streamed, reference;
+        source->largestRead = 0;
+        {
+            ArrayBufferWriter writer(ArrayBufferWriter::toVector(&streamed), compact);
+            ArrayBufferWriter referenceWriter(ArrayBufferWriter::toVector(&reference), compact);
+            TEST_ASSERT_TRUE(writer.write(&fileFields) && writer.flush());
+            TEST_ASSERT_TRUE(referenceWriter.write(&expectedFields) && referenceWriter.flush());
+        }
+        TEST_ASSERT_TRUE(streamed == reference);
+        TEST_ASSERT_EQUAL(ARRAY_BUFFER_WRITER_FILE_CHUNK_SIZE, source->largestRead);
+    }
+
+    // copies share source, nothing is read
+    Element *copy = new Element(file);
+    TEST_ASSERT_TRUE(copy->getFileSource() == source);
+
+    // reading failed
+    source->fail = true;
+    TEST_ASSERT_TRUE(ArrayBuffer::createArrayBuffer(&fileFields, &length) == nullptr);
+    TEST_ASSERT_EQUAL(0, length);
+    {
+        std::vector<uint8_t> streamed;
+        ArrayBufferWriter writer(ArrayBufferWriter::toVector(&streamed));
+        TEST_ASSERT_FALSE(writer.write(file));
+        TEST_ASSERT_TRUE(writer.hasError());
+    }
+
+    // source is deleted by last owner
+    file = "released";
+    TEST_ASSERT_FALSE(deleted);
+    delete copy;
+    TEST_ASSERT_TRUE(deleted);
+
+    delete fileFields.at(0);
+    delete expectedFields.at(0);
+    delete expected;
+    delete[] blob;
+}
+
 void test_element_SHA()
 {
     Element a = "Hello World!";
@@ -755,15 +2057,35 @@ void test_mydb()
     *db_unit_test("key") = 100;
     TEST_ASSERT_TRUE(*db_unit_test("key") == 100);
 
+    // found by hash index, same unit for every lookup
+    for (int i = 0; i < 20; ++i)
+        *db_unit_test(String("key") + i) = i;
+    TEST_ASSERT_TRUE(db_unit_test("key7") == db_unit_test(Element("key7")));
+    TEST_ASSERT_EQUAL(21, db_unit_test.count());
+
     TEST_ASSERT_TRUE(db_unit_test.flush());
 
     db_unit_test.unload();
 
     db_unit_test.begin();
     TEST_ASSERT_TRUE(*db_unit_test("key") == 100);
+    TEST_ASSERT_TRUE(*db_unit_test("key19") == 19);
+    TEST_ASSERT_EQUAL(21, db_unit_test.count());
 
     TEST_ASSERT_TRUE(MyFS::fileExist("db_unit_test.db"));
 
+    // corrupted main file is detected by checksum, backup is loaded instead
+    TEST_ASSERT_TRUE(db_unit_test.flush());
+    uint64_t length = 0;
+    uint8_t *file = MyFS::readFile("db_unit_test.db", &length);
+    file[length / 2] ^= 0x10;
+    MyFS::writeFile("db_unit_test.db", file, length);
+    delete[] file;
+    db_unit_test.unload();
+    TEST_ASSERT_TRUE(db_unit_test.begin());
+    TEST_ASSERT_TRUE(*db_unit_test("key19") == 19);
+    TEST_ASSERT_EQUAL(21, db_unit_test.count());
+
     TEST_ASSERT_TRUE(db_unit_test.unloadAndRemoveFile("db_unit_test"));
 
     TEST_ASSERT_FALSE(MyFS::fileExist("db_unit_test.db"));
@@ -781,7 +2103,29 @@ void setup()
     RUN_TEST(test_element_new_operators);
     RUN_TEST(test_element_getHex);
     RUN_TEST(test_element_convertHexStringIntoUint8Array);
+    RUN_TEST(test_element_inline_buffer);
+    RUN_TEST(test_element_move);
+    RUN_TEST(test_element_shared_buffer);
+    RUN_TEST(test_element_hash);
+    RUN_TEST(test_element_string_view);
+    RUN_TEST(test_element_slice);
+    RUN_TEST(test_element_number_operators);
+    RUN_TEST(test_element_array);
+    RUN_TEST(test_element_chars);
+    RUN_TEST(test_element_visit);
     RUN_TEST(test_createArrayBuffer_and_decodeArrayBuffer);
+    RUN_TEST(test_decodeArrayBuffer_malformed);
+    RUN_TEST(test_arraybuffer_view);
+    RUN_TEST(test_arraybuffer_writer);
+    RUN_TEST(test_arraybuffer_compact);
+    RUN_TEST(test_arraybuffer_checked);
+    RUN_TEST(test_arraybuffer_sorted);
+    RUN_TEST(test_arraybuffer_transcoder);
+    RUN_TEST(test_element_list_and_map);
+    RUN_TEST(test_arraybuffer_schema);
+    RUN_TEST(test_element_arena);
+    RUN_TEST(test_element_list);
+    RUN_TEST(test_element_file);
     RUN_TEST(test_element_SHA);
     RUN_TEST(test_element_crypto);
 
@@ -790,6 +2134,7 @@ void setup()
     RUN_TEST(test_sha256);
     RUN_TEST(test_base64_encode);
     RUN_TEST(test_base64_decode);
+    RUN_TEST(test_hex);
     RUN_TEST(test_aes_encode);
     RUN_TEST(test_aes_decode);
 